@@ -0,0 +1,110 @@
+#include "cpu/cpu.hpp"
+#include "cpu/instructions.hpp"
+#include "cpu/jit/jit_compiler.hpp"
+#include "memory/mmu.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+/**
+ * Measure the number of instructions per second executed by the CPU.
+ *
+ * The CPU runs a loop in the work RAM mixing loads, arithmetic/logical operations,
+ * stack operations, extended instructions and jumps, no other component is stepped.
+ * The instructions are counted from the instruction executed callback of the CPU,
+ * the compiled code executes several instructions each time the CPU is called.
+ *
+ * Usage: cpu_benchmark [number of instructions] [interpreter|cached-interpreter|jit]
+ */
+int main(int argc, char** argv)
+{
+    using namespace standardInstructions;
+
+    long long numberOfInstructions = 50000000;
+    if (argc > 1)
+    {
+        numberOfInstructions = std::atoll(argv[1]);
+    }
+
+    CPU::ExecutionMode mode = CPU::ExecutionMode::INTERPRETER;
+    const char* modeName = "interpreter";
+    if (argc > 2)
+    {
+        modeName = argv[2];
+        std::string name = modeName;
+        if (name == "cached-interpreter")
+        {
+            mode = CPU::ExecutionMode::CACHED_INTERPRETER;
+        }
+        else if (name == "jit")
+        {
+            if (!JitCompiler::isSupported())
+            {
+                std::printf("jit: skipped, the JIT is not supported on this platform\n");
+                return 0;
+            }
+            mode = CPU::ExecutionMode::JIT;
+        }
+        else if (name != "interpreter")
+        {
+            std::printf("Usage: %s [number of instructions] [interpreter|cached-interpreter|jit]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // clang-format off
+    std::vector<byte> program = {
+        LD_HL_nn, 0x00, 0xD0,
+        LD_B_n, 0x40,
+        LD_A_HLm,
+        ADD_A_B,
+        XOR_C,
+        LD_HLm_I_A,
+        INC_C,
+        EXT_OPS, extendedInstructions::RLC_A,
+        EXT_OPS, extendedInstructions::SWAP_A,
+        EXT_OPS, extendedInstructions::BIT_3_A,
+        EXT_OPS, extendedInstructions::SET_1_D,
+        EXT_OPS, extendedInstructions::RES_1_D,
+        PUSH_BC,
+        POP_DE,
+        SUB_A_E,
+        AND_n, 0x7F,
+        OR_D,
+        CP_n, 0x10,
+        DEC_B,
+        JR_NZ_n, 0x00,
+        JR_n, 0x00
+    };
+    // clang-format on
+    const size_t innerLoopStart = 5;
+    program[program.size() - 3] = static_cast<byte>(innerLoopStart - (program.size() - 2));
+    program[program.size() - 1] = static_cast<byte>(-static_cast<int>(program.size()));
+
+    MMU mmu;
+    CPU cpu(mmu);
+    for (size_t i = 0; i < program.size(); ++i)
+    {
+        mmu.write(static_cast<word>(0xC000 + i), program[i]);
+    }
+    cpu.setExecutionMode(mode);
+    cpu.setProgramCounter(0xC000);
+    cpu.setStackPointer(0xDFF0);
+    long long numberOfExecutedInstructions = 0;
+    cpu.setInstructionExecutedCallback([&numberOfExecutedInstructions](int) { numberOfExecutedInstructions++; });
+
+    auto start = std::chrono::steady_clock::now();
+    while (numberOfExecutedInstructions < numberOfInstructions)
+    {
+        cpu.fetchDecodeAndExecute();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::printf("%s: %lld instructions in %.3f s, %.2f million instructions/s\n", modeName,
+                numberOfExecutedInstructions, elapsed.count(),
+                static_cast<double>(numberOfExecutedInstructions) / elapsed.count() / 1e6);
+
+    return 0;
+}
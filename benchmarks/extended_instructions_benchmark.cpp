@@ -0,0 +1,92 @@
+#include "cpu/cpu.hpp"
+#include "cpu/instructions.hpp"
+#include "memory/mmu.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+/**
+ * Measure the number of extended instructions per second executed by the CPU.
+ *
+ * The CPU runs a loop in the work RAM made of BIT, RES and SET instructions spread over
+ * all the bits and operands, including (HL), no other component is stepped.
+ *
+ * Usage: extended_instructions_benchmark [number of instructions] [interpreter|cached-interpreter]
+ */
+int main(int argc, char** argv)
+{
+    using namespace standardInstructions;
+    using namespace extendedInstructions;
+
+    long long numberOfInstructions = 50000000;
+    if (argc > 1)
+    {
+        numberOfInstructions = std::atoll(argv[1]);
+    }
+
+    CPU::ExecutionMode mode = CPU::ExecutionMode::INTERPRETER;
+    const char* modeName = "interpreter";
+    if (argc > 2)
+    {
+        modeName = argv[2];
+        std::string name = modeName;
+        if (name == "cached-interpreter")
+        {
+            mode = CPU::ExecutionMode::CACHED_INTERPRETER;
+        }
+    }
+
+    // clang-format off
+    std::vector<byte> program = {
+        LD_HL_nn, 0x00, 0xD0,
+        EXT_OPS, BIT_0_A,
+        EXT_OPS, SET_1_B,
+        EXT_OPS, BIT_2_C,
+        EXT_OPS, RES_3_D,
+        EXT_OPS, SET_4_E,
+        EXT_OPS, BIT_5_H,
+        EXT_OPS, RES_6_L,
+        EXT_OPS, SET_7_HLm,
+        EXT_OPS, BIT_7_HLm,
+        EXT_OPS, RES_7_HLm,
+        EXT_OPS, BIT_1_B,
+        EXT_OPS, RES_1_B,
+        EXT_OPS, SET_3_D,
+        EXT_OPS, BIT_3_D,
+        EXT_OPS, RES_4_E,
+        EXT_OPS, SET_6_L,
+        EXT_OPS, BIT_6_L,
+        EXT_OPS, SET_0_A,
+        EXT_OPS, RES_0_A,
+        EXT_OPS, RL_C,
+        EXT_OPS, SWAP_A,
+        JR_n, 0x00
+    };
+    // clang-format on
+    const size_t loopStart = 3;
+    program[program.size() - 1] = static_cast<byte>(loopStart - program.size());
+
+    MMU mmu;
+    CPU cpu(mmu);
+    for (size_t i = 0; i < program.size(); ++i)
+    {
+        mmu.write(static_cast<word>(0xC000 + i), program[i]);
+    }
+    cpu.setExecutionMode(mode);
+    cpu.setProgramCounter(0xC000);
+    cpu.setStackPointer(0xDFF0);
+
+    auto start = std::chrono::steady_clock::now();
+    for (long long i = 0; i < numberOfInstructions; ++i)
+    {
+        cpu.fetchDecodeAndExecute();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::printf("%s: %lld instructions in %.3f s, %.2f million instructions/s\n", modeName, numberOfInstructions,
+                elapsed.count(), static_cast<double>(numberOfInstructions) / elapsed.count() / 1e6);
+
+    return 0;
+}
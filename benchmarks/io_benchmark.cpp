@@ -0,0 +1,46 @@
+#include "emulator.hpp"
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+/**
+ * Measure the number of I/O register accesses per second handled by the MMU.
+ *
+ * The accesses mimic a game polling the joypad, the LCD status and the timer,
+ * and updating the scrolling and the sound registers, all the components are attached.
+ *
+ * Usage: io_benchmark [number of accesses]
+ */
+int main(int argc, char** argv)
+{
+    long long numberOfAccesses = 100000000;
+    if (argc > 1)
+    {
+        numberOfAccesses = std::atoll(argv[1]);
+    }
+
+    // P1, SC, DIV, TIMA, TAC, IF, NR52, LCDC, STAT, SCY, LY, LYC, BGP, WX, KEY1, SVBK
+    const std::array<word, 16> readAddresses = {0xFF00, 0xFF02, 0xFF04, 0xFF05, 0xFF07, 0xFF0F, 0xFF26, 0xFF40,
+                                                0xFF41, 0xFF42, 0xFF44, 0xFF45, 0xFF47, 0xFF4B, 0xFF4D, 0xFF70};
+    // P1, TMA, NR50, SCY, SCX, WY, WX, BGP
+    const std::array<word, 8> writeAddresses = {0xFF00, 0xFF06, 0xFF24, 0xFF42, 0xFF43, 0xFF4A, 0xFF4B, 0xFF47};
+
+    Emulator emulator;
+    MMU& mmu = emulator.getMMU();
+
+    unsigned int checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (long long i = 0; i < numberOfAccesses; i += 3)
+    {
+        checksum += mmu.read(readAddresses[i % readAddresses.size()]);
+        checksum += mmu.read(readAddresses[(i + 7) % readAddresses.size()]);
+        mmu.write(writeAddresses[i % writeAddresses.size()], static_cast<byte>(i));
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::printf("%lld accesses in %.3f s, %.2f million accesses/s (checksum %u)\n", numberOfAccesses,
+                elapsed.count(), static_cast<double>(numberOfAccesses) / elapsed.count() / 1e6, checksum);
+
+    return 0;
+}
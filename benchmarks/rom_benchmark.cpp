@@ -0,0 +1,70 @@
+#include "cpu/jit/jit_compiler.hpp"
+#include "emulator.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+/**
+ * Measure the time taken by the whole emulator to run the frames of a ROM in an execution mode of the CPU.
+ *
+ * The idle loop detection is disabled so that every instruction of the ROM is executed by the mode measured.
+ *
+ * Usage: rom_benchmark <rom> [number of frames] [interpreter|cached-interpreter|jit]
+ */
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::printf("Usage: %s <rom> [number of frames] [interpreter|cached-interpreter|jit]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    int numberOfFrames = 200;
+    if (argc > 2)
+    {
+        numberOfFrames = std::atoi(argv[2]);
+    }
+
+    CPU::ExecutionMode mode = CPU::ExecutionMode::INTERPRETER;
+    std::string modeName = argc > 3 ? argv[3] : "interpreter";
+    if (modeName == "cached-interpreter")
+    {
+        mode = CPU::ExecutionMode::CACHED_INTERPRETER;
+    }
+    else if (modeName == "jit")
+    {
+        if (!JitCompiler::isSupported())
+        {
+            std::printf("jit: skipped, the JIT is not supported on this platform\n");
+            return 0;
+        }
+        mode = CPU::ExecutionMode::JIT;
+    }
+    else if (modeName != "interpreter")
+    {
+        std::printf("Usage: %s <rom> [number of frames] [interpreter|cached-interpreter|jit]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    Emulator emulator;
+    if (!emulator.getMMU().loadCartridgeFromFile(argv[1]))
+    {
+        std::printf("Couldn't load rom file: %s\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+    emulator.getCPU().setIdleLoopDetectionEnabled(false);
+    emulator.getCPU().setExecutionMode(mode);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < numberOfFrames; ++i)
+    {
+        emulator.runFrame();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::printf("%s: %d frames in %.3f s, %.1f frames/s\n", modeName.c_str(), numberOfFrames, elapsed.count(),
+                numberOfFrames / elapsed.count());
+
+    return 0;
+}
@@ -0,0 +1,94 @@
+#include "cpu/instructions.hpp"
+#include "emulator.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+/**
+ * Run the program in the work RAM of a new emulator and measure the time per instruction.
+ *
+ * @param program               The instructions of the program, copied at 0xC000
+ * @param numberOfInstructions  The number of instructions to execute
+ * @param isCatchUpEnabled      true to bring the components up to date lazily, false to step them in lockstep
+ * @return the number of nanoseconds per instruction
+ */
+static double measureNanosecondsPerInstruction(const std::vector<byte>& program, long long numberOfInstructions,
+                                               bool isCatchUpEnabled)
+{
+    Emulator emulator;
+    MMU& mmu = emulator.getMMU();
+    // Monochrome cartridge, the display is on
+    mmu.loadCartridgeData(std::vector<byte>(2 * 0x4000));
+    mmu.write(0xFF50, 0x01);
+    mmu.write(0xFF47, 0xE4);
+    mmu.write(0xFF40, 0x91);
+    for (size_t i = 0; i < program.size(); ++i)
+    {
+        mmu.write(static_cast<word>(0xC000 + i), program[i]);
+    }
+    emulator.getCPU().setIdleLoopDetectionEnabled(false);
+    emulator.getCPU().setProgramCounter(0xC000);
+    emulator.setCatchUpSynchronizationEnabled(isCatchUpEnabled);
+
+    auto start = std::chrono::steady_clock::now();
+    for (long long i = 0; i < numberOfInstructions; ++i)
+    {
+        emulator.exec();
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+    return elapsed.count() / static_cast<double>(numberOfInstructions);
+}
+
+/**
+ * Measure the time spent per instruction by the whole emulator, with the components (PPU, timer, APU)
+ * stepped after every instruction and with the catch-up synchronization, where each of them is brought up to date
+ * only when the CPU accesses it or one of its events is reached.
+ *
+ * The CPU runs a loop in the work RAM doing arithmetic and polling LY once per iteration, while the PPU draws.
+ *
+ * Usage: synchronization_benchmark [number of instructions]
+ */
+int main(int argc, char** argv)
+{
+    using namespace standardInstructions;
+
+    long long numberOfInstructions = 20000000;
+    if (argc > 1)
+    {
+        numberOfInstructions = std::atoll(argv[1]);
+    }
+
+    // clang-format off
+    std::vector<byte> program = {
+        LD_B_n, 0x10,
+        LDH_A_nm, 0x44,
+        ADD_A_B,
+        XOR_C,
+        LD_C_A,
+        INC_D,
+        DEC_E,
+        OR_D,
+        AND_n, 0x7F,
+        DEC_B,
+        JR_NZ_n, 0x00,
+        JR_n, 0x00
+    };
+    // clang-format on
+    const size_t innerLoopStart = 2;
+    program[program.size() - 3] = static_cast<byte>(innerLoopStart - (program.size() - 2));
+    program[program.size() - 1] = static_cast<byte>(-static_cast<int>(program.size()));
+
+    double lockstepNanoseconds = measureNanosecondsPerInstruction(program, numberOfInstructions, false);
+    double catchUpNanoseconds = measureNanosecondsPerInstruction(program, numberOfInstructions, true);
+
+    std::printf("lockstep: %.2f ns/instruction, %.2f million instructions/s\n", lockstepNanoseconds,
+                1e3 / lockstepNanoseconds);
+    std::printf("catch-up: %.2f ns/instruction, %.2f million instructions/s\n", catchUpNanoseconds,
+                1e3 / catchUpNanoseconds);
+    std::printf("%.2f ns saved per instruction (x%.2f)\n", lockstepNanoseconds - catchUpNanoseconds,
+                lockstepNanoseconds / catchUpNanoseconds);
+
+    return 0;
+}
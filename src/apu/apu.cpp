@@ -1,12 +1,9 @@
 #include "apu.hpp"
 #include "cpu/cpu.hpp"
 
+#include <algorithm>
 #include <cmath>
 
-const utils::AddressRange APU::CH1_ADDR_RANGE = utils::AddressRange(0xFF10, 0xFF14);
-const utils::AddressRange APU::CH2_ADDR_RANGE = utils::AddressRange(0xFF15, 0xFF19);
-const utils::AddressRange APU::CH3_WAVE_PATTERN_ADDR = utils::AddressRange(0xFF30, 0xFF3F);
-
 APU::APU(Timer* timer, int samplingFrequency) : _timer(timer)
 {
     float subsamplingRatio = CPU::CLOCK_FREQUENCY_HZ / static_cast<float>(samplingFrequency);
@@ -29,8 +26,9 @@ void APU::step(int cycles)
 {
     if (_enabled)
     {
-        // TODO: Bit 5 instead of bit 4 in double CG mode
-        if (_fallingEdgeDetector.detectFallingEdge(_timer->getDividerRegisterValue() & 0x10))
+        byte dividerMask =
+            _isDoubleSpeedEnabled ? FRAME_SEQUENCER_DIVIDER_MASK_DOUBLE_SPEED : FRAME_SEQUENCER_DIVIDER_MASK;
+        if (_fallingEdgeDetector.detectFallingEdge(_timer->getDividerRegisterValue() & dividerMask))
         {
             for (Channel* channel : _channels)
             {
@@ -55,6 +53,31 @@ void APU::step(int cycles)
     }
 }
 
+int APU::getCyclesUntilNextEvent() const
+{
+    int cycles = _numberOfCyclesPerAudioSample - _cycleCounter;
+    if (_enabled)
+    {
+        // The counters of the channels are ticked by the divider register, which counts CPU ticks
+        int ticksUntilDividerIncrement = _timer->getTicksUntilDividerIncrement();
+        if (_isDoubleSpeedEnabled)
+        {
+            ticksUntilDividerIncrement = (ticksUntilDividerIncrement + 1) / 2;
+        }
+        cycles = std::min(cycles, ticksUntilDividerIncrement);
+
+        for (const Channel* channel : _channels)
+        {
+            if (channel->isEnabled())
+            {
+                cycles = std::min(cycles, channel->getCyclesUntilNextValue());
+            }
+        }
+    }
+
+    return std::max(cycles, 1);
+}
+
 void APU::addSampleToAudioBuffer()
 {
     AudioMixer::Sample sample{0.0f, 0.0f};
@@ -81,251 +104,350 @@ void APU::reset()
 {
     _cycleCounter = 0;
     _audioBuffer.clear();
+    _isDoubleSpeedEnabled = false;
 }
 
-byte APU::readRegister(const word& addr)
+void APU::setDoubleSpeedEnabled(bool enabled)
 {
-    if (addr == CH1_SWEEP_REG_ADDR)
-    {
-        return 0x80 | _channel1->getFrequencySweepControl();
-    }
-    else if (addr == CH1_LENGTH_TIMER_AND_DUTY || addr == CH2_LENGTH_TIMER_AND_DUTY)
-    {
-        return 0x3F | (getChannelWaveFromRegAddr(addr).getWave().getDutyPattern() << 6);
-    }
-    else if (addr == CH1_VOLUME_CTRL_ADDR || addr == CH2_VOLUME_CTRL_ADDR)
-    {
-        return getChannelWaveFromRegAddr(addr).getVolumeControl();
-    }
-    else if (addr == CH1_FREQUENCY_LOW_REG_ADDR || addr == CH2_FREQUENCY_LOW_REG_ADDR)
-    {
-        return 0xFF;
-    }
-    else if (addr == CH1_FREQUENCY_AND_CONTROL_REG_ADDR || addr == CH2_FREQUENCY_AND_CONTROL_REG_ADDR)
-    {
-        return getChannelWaveFromRegAddr(addr).isLengthTimerEnabled() ? 0xFF : 0xBF;
-    }
-    else if (addr == SOUND_CTRL_ADDR)
-    {
-        return 0x70 | (_enabled << 7) | (_channel4->isEnabled() << 3) | (_channel3->isEnabled() << 2) |
-               (_channel2->isEnabled() << 1) | static_cast<byte>(_channel1->isEnabled());
-    }
-    else if (addr == CH3_DAC_REG_ADDR)
-    {
-        return 0x7F | (_channel3->isDACEnabled() << 7);
-    }
-    else if (addr == CH3_LENGTH_TIMER_REG_ADDR)
+    _isDoubleSpeedEnabled = enabled;
+}
+
+byte APU::getChannel1Sweep()
+{
+    return 0x80 | _channel1->getFrequencySweepControl();
+}
+
+void APU::setChannel1Sweep(byte value)
+{
+    if (_enabled)
     {
-        return 0xFF;
+        _channel1->setFrequencySweepControl(value);
     }
-    else if (addr == CH3_OUTPUT_LEVEL_ADDR)
+}
+
+byte APU::getChannel1LengthTimerAndDuty()
+{
+    return getLengthTimerAndDuty(*_channel1);
+}
+
+void APU::setChannel1LengthTimerAndDuty(byte value)
+{
+    setLengthTimerAndDuty(*_channel1, value);
+}
+
+byte APU::getChannel1VolumeControl()
+{
+    return _channel1->getVolumeControl();
+}
+
+void APU::setChannel1VolumeControl(byte value)
+{
+    setVolumeControl(*_channel1, value);
+}
+
+void APU::setChannel1FrequencyLow(byte value)
+{
+    setFrequencyLow(*_channel1, value);
+}
+
+byte APU::getChannel1FrequencyAndControl()
+{
+    return getFrequencyAndControl(*_channel1);
+}
+
+void APU::setChannel1FrequencyAndControl(byte value)
+{
+    setFrequencyAndControl(*_channel1, value);
+}
+
+byte APU::getChannel2LengthTimerAndDuty()
+{
+    return getLengthTimerAndDuty(*_channel2);
+}
+
+void APU::setChannel2LengthTimerAndDuty(byte value)
+{
+    setLengthTimerAndDuty(*_channel2, value);
+}
+
+byte APU::getChannel2VolumeControl()
+{
+    return _channel2->getVolumeControl();
+}
+
+void APU::setChannel2VolumeControl(byte value)
+{
+    setVolumeControl(*_channel2, value);
+}
+
+void APU::setChannel2FrequencyLow(byte value)
+{
+    setFrequencyLow(*_channel2, value);
+}
+
+byte APU::getChannel2FrequencyAndControl()
+{
+    return getFrequencyAndControl(*_channel2);
+}
+
+void APU::setChannel2FrequencyAndControl(byte value)
+{
+    setFrequencyAndControl(*_channel2, value);
+}
+
+byte APU::getChannel3DAC()
+{
+    return 0x7F | (_channel3->isDACEnabled() << 7);
+}
+
+void APU::setChannel3DAC(byte value)
+{
+    if (_enabled)
     {
-        return 0x9F | (_channel3->getVolumeControl() << 5);
+        bool dacValue = utils::isNthBitSet(value, 7);
+        _channel3->enableDAC(dacValue);
+        // Disabling DAC also disables the channel
+        if (!dacValue)
+        {
+            _channel3->enable(false);
+        }
     }
-    else if (addr == CH3_FREQUENCY_LOW_REG_ADDR)
+}
+
+void APU::setChannel3LengthTimer(byte value)
+{
+    if (_enabled)
     {
-        return 0xFF;
+        setLengthTimer(*_channel3, value);
     }
-    else if (addr == CH3_FREQUENCY_AND_CONTROL_REG_ADDR)
+}
+
+byte APU::getChannel3OutputLevel()
+{
+    return 0x9F | (_channel3->getVolumeControl() << 5);
+}
+
+void APU::setChannel3OutputLevel(byte value)
+{
+    if (_enabled)
     {
-        return _channel3->isLengthTimerEnabled() ? 0xFF : 0xBF;
+        _channel3->setVolumeControl((value >> 5) & 0x03);
     }
-    else if (CH3_WAVE_PATTERN_ADDR.contains(addr))
+}
+
+void APU::setChannel3FrequencyLow(byte value)
+{
+    if (_enabled)
     {
-        int relativeAddr = CH3_WAVE_PATTERN_ADDR.relative(addr);
-        int sampleIndex = relativeAddr * 2;
-        return (_channel3->getWave().getSample(sampleIndex) << 4) | _channel3->getWave().getSample(sampleIndex + 1);
+        int frequencyHigh = _channel3->getFrequency() & 0xFF00;
+        _channel3->setFrequency(frequencyHigh | value);
     }
-    else if (addr == CH4_LENGTH_TIMER)
+}
+
+byte APU::getChannel3FrequencyAndControl()
+{
+    return getFrequencyAndControl(*_channel3);
+}
+
+void APU::setChannel3FrequencyAndControl(byte value)
+{
+    if (_enabled)
     {
-        return 0xFF;
+        _channel3->enableLengthTimer(utils::isNthBitSet(value, 6));
+
+        int frequencyLow = _channel3->getFrequency() & 0xFF;
+        _channel3->setFrequency(((value & 0b00000111) << 8) | frequencyLow);
+
+        if (utils::isNthBitSet(value, 7) && _channel3->isDACEnabled())
+        {
+            _channel3->trigger();
+        }
     }
-    else if (addr == CH4_VOLUME_CTRL_ADDR)
+}
+
+byte APU::getChannel3WavePattern(int index)
+{
+    int sampleIndex = index * 2;
+    return (_channel3->getWave().getSample(sampleIndex) << 4) | _channel3->getWave().getSample(sampleIndex + 1);
+}
+
+void APU::setChannel3WavePattern(int index, byte value)
+{
+    int sampleIndex = index * 2;
+    _channel3->getWave().setSample(sampleIndex, (value >> 4) & 0x0F);
+    _channel3->getWave().setSample(sampleIndex + 1, value & 0x0F);
+}
+
+void APU::setChannel4LengthTimer(byte value)
+{
+    if (_enabled)
     {
-        return _channel4->getVolumeControl();
+        setLengthTimer(*_channel4, value & 0b00111111);
     }
-    else if (addr == CH4_NOISE_CTRL_ADDR)
+}
+
+byte APU::getChannel4VolumeControl()
+{
+    return _channel4->getVolumeControl();
+}
+
+void APU::setChannel4VolumeControl(byte value)
+{
+    if (_enabled)
     {
-        return _channel4->getNoiseControl();
+        if ((value & 0xF8) == 0)
+        {
+            _channel4->enableDAC(false);
+            _channel4->enable(false);
+        }
+        else
+        {
+            _channel4->enableDAC(true);
+        }
+        _channel4->setVolumeControl(value);
     }
-    else if (addr == CH4_CHANNEL_CTRL_ADDR)
+}
+
+byte APU::getChannel4NoiseControl()
+{
+    return _channel4->getNoiseControl();
+}
+
+void APU::setChannel4NoiseControl(byte value)
+{
+    if (_enabled)
     {
-        return _channel4->isLengthTimerEnabled() ? 0xFF : 0xBF;
+        _channel4->setNoiseControl(value);
     }
-    else if (addr == MASTER_VOLUME_ADDR)
+}
+
+byte APU::getChannel4Control()
+{
+    return getFrequencyAndControl(*_channel4);
+}
+
+void APU::setChannel4Control(byte value)
+{
+    if (_enabled)
     {
-        return static_cast<byte>((_mixer->isVinLeftEnabled() << 7) | (_mixer->getVolumeScaleLeft() << 4) |
-                                 (_mixer->isVinRightEnabled() << 3) | _mixer->getVolumeScaleRight());
+        _channel4->enableLengthTimer(utils::isNthBitSet(value, 6));
+        if (utils::isNthBitSet(value, 7) && _channel4->isDACEnabled())
+        {
+            _channel4->trigger();
+        }
     }
-    else if (addr == SOUND_PANNING_ADDR)
+}
+
+byte APU::getMasterVolume()
+{
+    return static_cast<byte>((_mixer->isVinLeftEnabled() << 7) | (_mixer->getVolumeScaleLeft() << 4) |
+                             (_mixer->isVinRightEnabled() << 3) | _mixer->getVolumeScaleRight());
+}
+
+void APU::setMasterVolume(byte value)
+{
+    if (_enabled)
     {
-        return static_cast<byte>((_mixer->getPanningControlLeft() << 4) | _mixer->getPanningControlRight());
+        _mixer->enableVinLeft(utils::isNthBitSet(value, 7));
+        _mixer->enableVinRight(utils::isNthBitSet(value, 3));
+        _mixer->setVolumeScaleRight(value & 0x7);
+        _mixer->setVolumeScaleLeft((value >> 4) & 0x7);
     }
+}
 
-    // Unmapped register should return FF
-    return 0xFF;
+byte APU::getSoundPanning()
+{
+    return static_cast<byte>((_mixer->getPanningControlLeft() << 4) | _mixer->getPanningControlRight());
 }
 
-void APU::writeRegister(const word& addr, const byte& value)
+void APU::setSoundPanning(byte value)
 {
     if (_enabled)
     {
-        if (addr == CH1_SWEEP_REG_ADDR)
-        {
-            _channel1->setFrequencySweepControl(value);
-        }
-        else if (addr == CH1_LENGTH_TIMER_AND_DUTY || addr == CH2_LENGTH_TIMER_AND_DUTY)
-        {
-            PulseChannel& channel = getChannelWaveFromRegAddr(addr);
-            channel.getWave().setDutyPattern(value >> 6);
-            setLengthTimer(channel, value & 0b00111111);
-        }
-        else if (addr == CH1_VOLUME_CTRL_ADDR || addr == CH2_VOLUME_CTRL_ADDR)
-        {
-            PulseChannel& channel = getChannelWaveFromRegAddr(addr);
-            if ((value & 0xF8) == 0)
-            {
-                channel.enableDAC(false);
-                channel.enable(false);
-            }
-            else
-            {
-                channel.enableDAC(true);
-            }
-            channel.setVolumeControl(value);
-        }
-        else if (addr == CH1_FREQUENCY_LOW_REG_ADDR || addr == CH2_FREQUENCY_LOW_REG_ADDR)
-        {
-            PulseChannel& channel = getChannelWaveFromRegAddr(addr);
-            int frequencyHigh = channel.getFrequency() & 0xFF00;
-            channel.setFrequency(frequencyHigh | value);
-        }
-        else if (addr == CH1_FREQUENCY_AND_CONTROL_REG_ADDR || addr == CH2_FREQUENCY_AND_CONTROL_REG_ADDR)
-        {
-            PulseChannel& channel = getChannelWaveFromRegAddr(addr);
-            channel.enableLengthTimer(utils::isNthBitSet(value, 6));
+        _mixer->setPanningControlRight(value & 0xF);
+        _mixer->setPanningControlLeft((value >> 4) & 0xF);
+    }
+}
 
-            int frequencyLow = channel.getFrequency() & 0xFF;
-            channel.setFrequency(((value & 0b00000111) << 8) | frequencyLow);
+byte APU::getSoundControl()
+{
+    return 0x70 | (_enabled << 7) | (_channel4->isEnabled() << 3) | (_channel3->isEnabled() << 2) |
+           (_channel2->isEnabled() << 1) | static_cast<byte>(_channel1->isEnabled());
+}
 
-            if (utils::isNthBitSet(value, 7) && channel.isDACEnabled())
-            {
-                channel.trigger();
-            }
-        }
-        else if (addr == MASTER_VOLUME_ADDR)
-        {
-            _mixer->enableVinLeft(utils::isNthBitSet(value, 7));
-            _mixer->enableVinRight(utils::isNthBitSet(value, 3));
-            _mixer->setVolumeScaleRight(value & 0x7);
-            _mixer->setVolumeScaleLeft((value >> 4) & 0x7);
-        }
-        else if (addr == SOUND_PANNING_ADDR)
-        {
-            _mixer->setPanningControlRight(value & 0xF);
-            _mixer->setPanningControlLeft((value >> 4) & 0xF);
-        }
-        else if (addr == CH3_DAC_REG_ADDR)
-        {
-            bool dacValue = utils::isNthBitSet(value, 7);
-            _channel3->enableDAC(dacValue);
-            // Disabling DAC also disables the channel
-            if (!dacValue)
-            {
-                _channel3->enable(false);
-            }
-        }
-        else if (addr == CH3_LENGTH_TIMER_REG_ADDR)
-        {
-            setLengthTimer(*_channel3, value);
-        }
-        else if (addr == CH3_OUTPUT_LEVEL_ADDR)
-        {
-            _channel3->setVolumeControl((value >> 5) & 0x03);
-        }
-        else if (addr == CH3_FREQUENCY_LOW_REG_ADDR)
+void APU::setSoundControl(byte value)
+{
+    _enabled = (value >> 7);
+    if (!_enabled)
+    {
+        for (auto& channel : _channels)
         {
-            int frequencyHigh = _channel3->getFrequency() & 0xFF00;
-            _channel3->setFrequency(frequencyHigh | value);
+            channel->enable(false);
+            channel->reset();
         }
-        else if (addr == CH3_FREQUENCY_AND_CONTROL_REG_ADDR)
-        {
-            _channel3->enableLengthTimer(utils::isNthBitSet(value, 6));
+        _mixer->reset();
+    }
+}
 
-            int frequencyLow = _channel3->getFrequency() & 0xFF;
-            _channel3->setFrequency(((value & 0b00000111) << 8) | frequencyLow);
+byte APU::getLengthTimerAndDuty(PulseChannel& channel)
+{
+    return 0x3F | (channel.getWave().getDutyPattern() << 6);
+}
 
-            if (utils::isNthBitSet(value, 7) && _channel3->isDACEnabled())
-            {
-                _channel3->trigger();
-            }
-        }
-        else if (addr == CH4_LENGTH_TIMER)
-        {
-            setLengthTimer(*_channel4, value & 0b00111111);
-        }
-        else if (addr == CH4_VOLUME_CTRL_ADDR)
-        {
-            if ((value & 0xF8) == 0)
-            {
-                _channel4->enableDAC(false);
-                _channel4->enable(false);
-            }
-            else
-            {
-                _channel4->enableDAC(true);
-            }
-            _channel4->setVolumeControl(value);
-        }
-        else if (addr == CH4_NOISE_CTRL_ADDR)
-        {
-            _channel4->setNoiseControl(value);
-        }
-        else if (addr == CH4_CHANNEL_CTRL_ADDR)
-        {
-            _channel4->enableLengthTimer(utils::isNthBitSet(value, 6));
-            if (utils::isNthBitSet(value, 7) && _channel4->isDACEnabled())
-            {
-                _channel4->trigger();
-            }
-        }
+void APU::setLengthTimerAndDuty(PulseChannel& channel, byte value)
+{
+    if (_enabled)
+    {
+        channel.getWave().setDutyPattern(value >> 6);
+        setLengthTimer(channel, value & 0b00111111);
     }
+}
 
-    if (addr == SOUND_CTRL_ADDR)
+void APU::setVolumeControl(PulseChannel& channel, byte value)
+{
+    if (_enabled)
     {
-        _enabled = (value >> 7);
-        if (!_enabled)
+        if ((value & 0xF8) == 0)
         {
-            for (auto& channel : _channels)
-            {
-                channel->enable(false);
-                channel->reset();
-            }
-            _mixer->reset();
+            channel.enableDAC(false);
+            channel.enable(false);
         }
-    }
-    else if (CH3_WAVE_PATTERN_ADDR.contains(addr))
-    {
-        int relativeAddr = CH3_WAVE_PATTERN_ADDR.relative(addr);
-        int sampleIndex = relativeAddr * 2;
-        _channel3->getWave().setSample(sampleIndex, (value >> 4) & 0x0F);
-        _channel3->getWave().setSample(sampleIndex + 1, value & 0x0F);
+        else
+        {
+            channel.enableDAC(true);
+        }
+        channel.setVolumeControl(value);
     }
 }
 
-PulseChannel& APU::getChannelWaveFromRegAddr(word addr)
+void APU::setFrequencyLow(PulseChannel& channel, byte value)
 {
-    if (CH1_ADDR_RANGE.contains(addr))
+    if (_enabled)
     {
-        return *_channel1;
+        int frequencyHigh = channel.getFrequency() & 0xFF00;
+        channel.setFrequency(frequencyHigh | value);
     }
+}
+
+byte APU::getFrequencyAndControl(const Channel& channel)
+{
+    return channel.isLengthTimerEnabled() ? 0xFF : 0xBF;
+}
 
-    else if (CH2_ADDR_RANGE.contains(addr))
+void APU::setFrequencyAndControl(PulseChannel& channel, byte value)
+{
+    if (_enabled)
     {
-        return *_channel2;
-    }
+        channel.enableLengthTimer(utils::isNthBitSet(value, 6));
+
+        int frequencyLow = channel.getFrequency() & 0xFF;
+        channel.setFrequency(((value & 0b00000111) << 8) | frequencyLow);
 
-    throw std::runtime_error("Couldn't infer APU channel from register address");
+        if (utils::isNthBitSet(value, 7) && channel.isDACEnabled())
+        {
+            channel.trigger();
+        }
+    }
 }
 
 void APU::setLengthTimer(Channel& channel, int duration)
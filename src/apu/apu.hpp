@@ -17,15 +17,80 @@ class APU
 
     explicit APU(Timer* timer, int samplingFrequency);
     void step(int cycles);
+
+    /**
+     * Get the number of cycles that can be given at once to step() with the same result
+     * as giving them one by one, it stops at the next audio sample or change of a channel.
+     *
+     * @return a number of cycles, at least 1
+     */
+    int getCyclesUntilNextEvent() const;
     const AudioBuffer& getAudioBuffer();
     void resetAudioBuffer();
     void reset();
-    byte readRegister(const word& addr);
-    void writeRegister(const word& addr, const byte& value);
 
-  private:
-    static const utils::AddressRange CH1_ADDR_RANGE;
-    static const utils::AddressRange CH2_ADDR_RANGE;
+    /**
+     * Switch the APU to the double speed mode of the CGB, where the divider register
+     * that clocks the frame sequencer runs twice as fast.
+     *
+     * @param enabled true in double speed mode, false in normal speed mode
+     */
+    void setDoubleSpeedEnabled(bool enabled);
+
+    /**
+     * Access the sound registers, each one is mapped to its own accessor by the MMU.
+     * The writes are ignored while the APU is disabled, except for the sound control register and the wave pattern.
+     * The frequency low registers and the length timers of the channels 3 and 4 are write-only.
+     */
+    byte getChannel1Sweep();
+    void setChannel1Sweep(byte value);
+    byte getChannel1LengthTimerAndDuty();
+    void setChannel1LengthTimerAndDuty(byte value);
+    byte getChannel1VolumeControl();
+    void setChannel1VolumeControl(byte value);
+    void setChannel1FrequencyLow(byte value);
+    byte getChannel1FrequencyAndControl();
+    void setChannel1FrequencyAndControl(byte value);
+
+    byte getChannel2LengthTimerAndDuty();
+    void setChannel2LengthTimerAndDuty(byte value);
+    byte getChannel2VolumeControl();
+    void setChannel2VolumeControl(byte value);
+    void setChannel2FrequencyLow(byte value);
+    byte getChannel2FrequencyAndControl();
+    void setChannel2FrequencyAndControl(byte value);
+
+    byte getChannel3DAC();
+    void setChannel3DAC(byte value);
+    void setChannel3LengthTimer(byte value);
+    byte getChannel3OutputLevel();
+    void setChannel3OutputLevel(byte value);
+    void setChannel3FrequencyLow(byte value);
+    byte getChannel3FrequencyAndControl();
+    void setChannel3FrequencyAndControl(byte value);
+
+    /**
+     * Access a byte of the wave pattern of the channel 3, which holds two samples.
+     *
+     * @param index the index of the byte, from 0 to 15
+     */
+    byte getChannel3WavePattern(int index);
+    void setChannel3WavePattern(int index, byte value);
+
+    void setChannel4LengthTimer(byte value);
+    byte getChannel4VolumeControl();
+    void setChannel4VolumeControl(byte value);
+    byte getChannel4NoiseControl();
+    void setChannel4NoiseControl(byte value);
+    byte getChannel4Control();
+    void setChannel4Control(byte value);
+
+    byte getMasterVolume();
+    void setMasterVolume(byte value);
+    byte getSoundPanning();
+    void setSoundPanning(byte value);
+    byte getSoundControl();
+    void setSoundControl(byte value);
 
     static const int CH1_SWEEP_REG_ADDR = 0xFF10;
     static const int CH1_LENGTH_TIMER_AND_DUTY = 0xFF11;
@@ -43,7 +108,8 @@ class APU
     static const int CH3_OUTPUT_LEVEL_ADDR = 0xFF1C;
     static const int CH3_FREQUENCY_LOW_REG_ADDR = 0xFF1D;
     static const int CH3_FREQUENCY_AND_CONTROL_REG_ADDR = 0xFF1E;
-    static const utils::AddressRange CH3_WAVE_PATTERN_ADDR;
+    static const int CH3_WAVE_PATTERN_START_ADDR = 0xFF30;
+    static const int CH3_WAVE_PATTERN_END_ADDR = 0xFF3F;
 
     static const int CH4_LENGTH_TIMER = 0xFF20;
     static const int CH4_VOLUME_CTRL_ADDR = 0xFF21;
@@ -54,14 +120,26 @@ class APU
     static const int SOUND_PANNING_ADDR = 0xFF25;
     static const int SOUND_CTRL_ADDR = 0xFF26;
 
+  private:
     /**
      * High-pass filter coefficient that is close to real hardware behavior.
      * See https://gbdev.gg8.se/wiki/articles/Gameboy_sound_hardware#Obscure_Behavior
      */
     static constexpr float HIGHPASS_BASE_COEFF = 0.999958f;
 
+    /**
+     * The bit of the divider register whose falling edge clocks the frame sequencer, at 512 Hz
+     */
+    static const byte FRAME_SEQUENCER_DIVIDER_MASK = 0x10;
+    static const byte FRAME_SEQUENCER_DIVIDER_MASK_DOUBLE_SPEED = 0x20;
+
     void addSampleToAudioBuffer();
-    PulseChannel& getChannelWaveFromRegAddr(word addr);
+    byte getLengthTimerAndDuty(PulseChannel& channel);
+    void setLengthTimerAndDuty(PulseChannel& channel, byte value);
+    void setVolumeControl(PulseChannel& channel, byte value);
+    void setFrequencyLow(PulseChannel& channel, byte value);
+    byte getFrequencyAndControl(const Channel& channel);
+    void setFrequencyAndControl(PulseChannel& channel, byte value);
     void setLengthTimer(Channel& channel, int duration);
 
     Timer* _timer;
@@ -76,6 +154,7 @@ class APU
     AudioBuffer _audioBuffer = {0};
     FallingEdgeDetector _fallingEdgeDetector;
     bool _enabled = false;
+    bool _isDoubleSpeedEnabled = false;
 };
 
 #endif // GROUBOY_APU_HPP
@@ -11,6 +11,11 @@ bool Channel::isEnabled() const
     return _enable;
 }
 
+int Channel::getCyclesUntilNextValue() const
+{
+    return 1;
+}
+
 void Channel::tickCounter()
 {
     _frameSequencer.tick();
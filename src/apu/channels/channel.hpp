@@ -43,6 +43,14 @@ class Channel
      */
     virtual void step(int cycles) = 0;
 
+    /**
+     * Get the number of CPU cycles that can be given at once to step() with the same result
+     * as giving them one by one, it stops when the generated signal changes.
+     * By default the channel is stepped one cycle at a time.
+     * @return a number of CPU cycles, at least 1
+     */
+    virtual int getCyclesUntilNextValue() const;
+
     /**
      * Whether or not the channel is enabled.
      * When a channel is disabled the output is always 0.
@@ -1,5 +1,6 @@
 #include "channel3.hpp"
 
+#include <algorithm>
 #include <stdexcept>
 
 Channel3::Channel3(float highpassCoeff) : Channel(LENGTH_TIMER_DURATION, highpassCoeff)
@@ -16,6 +17,11 @@ void Channel3::step(int cycles)
     _wave.step(cycles);
 }
 
+int Channel3::getCyclesUntilNextValue() const
+{
+    return std::max(_wave.getFrequencyTimerValue(), 1);
+}
+
 void Channel3::trigger()
 {
     enable(true);
@@ -12,6 +12,7 @@ class Channel3 : public Channel
     ~Channel3() = default;
     float getAudioSample() override;
     void step(int cycles) override;
+    int getCyclesUntilNextValue() const override;
     void trigger() override;
     void setFrequency(int frequency);
     int getFrequency();
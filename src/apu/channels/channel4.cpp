@@ -1,5 +1,6 @@
 #include "channel4.hpp"
 #include "common/utils.hpp"
+#include <algorithm>
 
 Channel4::Channel4(float highpassCoeff) : Channel(LENGTH_TIMER_DURATION, highpassCoeff)
 {
@@ -11,6 +12,11 @@ void Channel4::step(int cycles)
     _noiseSignal.step(cycles);
 }
 
+int Channel4::getCyclesUntilNextValue() const
+{
+    return std::max(_noiseSignal.getFrequencyTimerValue(), 1);
+}
+
 void Channel4::trigger()
 {
     _noiseSignal.reset();
@@ -9,6 +9,7 @@ class Channel4 : public Channel
   public:
     explicit Channel4(float highpassCoeff);
     void step(int cycles) override;
+    int getCyclesUntilNextValue() const override;
     void trigger() override;
     void setVolumeControl(byte value);
     byte getVolumeControl() const;
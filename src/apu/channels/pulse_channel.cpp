@@ -1,6 +1,7 @@
 #include "pulse_channel.hpp"
 #include "channel.hpp"
 #include "common/utils.hpp"
+#include <algorithm>
 
 PulseChannel::PulseChannel(float highpassCoeff) : Channel(LENGTH_TIMER_DURATION, highpassCoeff)
 {
@@ -17,6 +18,11 @@ void PulseChannel::step(int cycles)
     _squareWave.step(cycles);
 }
 
+int PulseChannel::getCyclesUntilNextValue() const
+{
+    return std::max(_squareWave.getFrequencyTimerValue(), 1);
+}
+
 void PulseChannel::trigger()
 {
     enable(true);
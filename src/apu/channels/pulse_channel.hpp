@@ -25,6 +25,7 @@ class PulseChannel : public Channel
     virtual ~PulseChannel() = default;
     float getAudioSample() override;
     void step(int cycles) override;
+    int getCyclesUntilNextValue() const override;
     void trigger() override;
 
     /**
@@ -48,6 +48,11 @@ int NoiseSignal::getFrequency() const
     return _frequency;
 }
 
+int NoiseSignal::getFrequencyTimerValue() const
+{
+    return _frequencyTimerValue;
+}
+
 void NoiseSignal::enableWideMode(bool enabled)
 {
     _wideModeEnabled = enabled;
@@ -44,6 +44,12 @@ class NoiseSignal
      */
     int getFrequency() const;
 
+    /**
+     * Get the number of CPU cycles before the signal moves to its next value.
+     * @return a value in CPU cycles, 0 or less if it moves at the next step.
+     */
+    int getFrequencyTimerValue() const;
+
     /**
      * Enable or disable "wide mode".
      * When "wide mode" is enabled, the generated noise signal
@@ -63,6 +63,11 @@ int SquareWave::getFrequency() const
     return _frequency;
 }
 
+int SquareWave::getFrequencyTimerValue() const
+{
+    return _frequencyTimerValue;
+}
+
 void SquareWave::reset()
 {
     _waveDutyPosition = 0;
@@ -49,6 +49,12 @@ class SquareWave
      */
     int getFrequency() const;
 
+    /**
+     * Get the number of CPU cycles before the signal moves to its next value.
+     * @return a value in CPU cycles, 0 or less if it moves at the next step.
+     */
+    int getFrequencyTimerValue() const;
+
     /**
      *
      * Select which wave is used for the generation.
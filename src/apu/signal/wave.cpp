@@ -55,6 +55,12 @@ int Wave<SZ>::getFrequency() const
     return _frequency;
 }
 
+template <int SZ>
+int Wave<SZ>::getFrequencyTimerValue() const
+{
+    return _frequencyTimerValue;
+}
+
 template <int SZ>
 void Wave<SZ>::setSample(int index, byte value)
 {
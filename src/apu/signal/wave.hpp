@@ -49,6 +49,12 @@ class Wave
      */
     int getFrequency() const;
 
+    /**
+     * Get the number of CPU cycles before the signal moves to its next value.
+     * @return a value in CPU cycles, 0 or less if it moves at the next step.
+     */
+    int getFrequencyTimerValue() const;
+
     /**
      * Set the value of a sample in the wave
      *
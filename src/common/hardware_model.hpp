@@ -0,0 +1,16 @@
+#ifndef GBEMULATOR_HARDWARE_MODEL_HPP
+#define GBEMULATOR_HARDWARE_MODEL_HPP
+
+/**
+ * The hardware emulated, the monochrome GameBoy or the GameBoy Color.
+ *
+ * The hot paths of the PPU and the MMU are compiled for each model,
+ * the model is chosen when the cartridge is loaded and the boot ROM unmapped.
+ */
+enum class HardwareModel
+{
+    DMG,
+    CGB
+};
+
+#endif // GBEMULATOR_HARDWARE_MODEL_HPP
@@ -1,8 +1,13 @@
 #include "utils.hpp"
+#include <cassert>
 #include <cmath>
 #include <fstream>
 #include <vector>
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 namespace utils
 {
 
@@ -42,6 +47,19 @@ bool isNthBitSet(int value, int bitPosition)
     return (value & (1 << bitPosition)) > 0;
 }
 
+int getLowestSetBitPosition(unsigned int value)
+{
+    // The position is undefined for 0
+    assert(value != 0);
+#if defined(_MSC_VER)
+    unsigned long bitPosition;
+    _BitScanForward(&bitPosition, value);
+    return static_cast<int>(bitPosition);
+#else
+    return __builtin_ctz(value);
+#endif
+}
+
 template <typename T>
 void setNthBit(T& value, int bitPosition, bool state)
 {
@@ -66,10 +84,36 @@ bool readBinaryDataFromFile(const std::string& filepath, std::vector<byte>& out)
         return false;
     }
 
-    out = std::vector<byte>((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    // Read the whole file at once instead of byte by byte
+    input.seekg(0, std::ios::end);
+    std::streamoff size = input.tellg();
+    input.seekg(0, std::ios::beg);
+    if (size < 0)
+    {
+        return false;
+    }
+
+    out.resize(static_cast<size_t>(size));
+    input.read(reinterpret_cast<char*>(out.data()), size);
     input.close();
 
-    return true;
+    return !input.fail();
+}
+
+uint64_t computeHash(const std::vector<byte>& data)
+{
+    return computeHash(data.data(), data.size());
+}
+
+uint64_t computeHash(const byte* data, size_t size)
+{
+    uint64_t hash = 0xCBF29CE484222325;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= data[i];
+        hash *= 0x100000001B3;
+    }
+    return hash;
 }
 
 byte convertFrom5BitsTo8Bits(byte value)
@@ -2,6 +2,7 @@
 #define GBEMULATOR_UTILS_HPP
 
 #include "types.hpp"
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -83,6 +84,14 @@ void decrement16BitsValueStoredIn8BitsValues(byte& msb, byte& lsb);
  */
 bool isNthBitSet(int value, int bitPosition);
 
+/**
+ * Returns the position of the lowest bit set in the given number.
+ * The result is undefined for 0, the caller must check that a bit is set.
+ * @param value         the number to test, it must not be 0
+ * @return the 0-based position of the lowest bit set
+ */
+int getLowestSetBitPosition(unsigned int value);
+
 /**
  * Sets the nth bit of the given value to the specified state.
  *
@@ -103,6 +112,23 @@ void setNthBit(T& value, int bitPosition, bool state);
  */
 bool readBinaryDataFromFile(const std::string& filepath, std::vector<byte>& out);
 
+/**
+ * Compute the 64 bits FNV-1a hash of some binary data.
+ *
+ * @param data  The data to hash
+ * @return the hash of the data
+ */
+uint64_t computeHash(const std::vector<byte>& data);
+
+/**
+ * Compute the 64 bits FNV-1a hash of some binary data.
+ *
+ * @param data  The data to hash
+ * @param size  The size of the data in bytes
+ * @return the hash of the data
+ */
+uint64_t computeHash(const byte* data, size_t size);
+
 /**
  * Convert a value from 5 bits range to 8 bits range.
  * This will map the maximum 5 bits value to the maximum 8 bits value.
@@ -0,0 +1,82 @@
+#ifndef GBEMULATOR_RECOMPILED_CODE_HPP
+#define GBEMULATOR_RECOMPILED_CODE_HPP
+
+#include "cpu/aot/recompiled_module.hpp"
+#include "cpu/cpu.hpp"
+#include "cpu/instruction_handlers.hpp"
+#include "cpu/instructions.hpp"
+
+/**
+ * Runtime of the code generated by gb2cpp, this is only meant to be included by the generated code.
+ *
+ * Each instruction of a recompiled block is a call to execute() specialized on its opcode,
+ * the handler of the instruction is known at compile time and its immediate operand is a constant,
+ * so the C++ compiler can inline the whole block without any fetching, decoding or dispatching.
+ *
+ * Like the code generated by the JIT, a block synchronizes the other components after each instruction
+ * and gives the control back to the CPU when an interrupt needs to be serviced, when the CPU is halted,
+ * when the memory mapping changed or when the ticks given to CPU::fetchDecodeAndExecute() are reached.
+ */
+class RecompiledCode
+{
+  public:
+    /**
+     * Execute an instruction of a recompiled block, the program counter is at the opcode.
+     *
+     * @tparam OPCODE           The opcode of the instruction
+     * @tparam EXTENDED_OPCODE  The opcode following the prefix of an extended instruction
+     * @param cpu               The CPU executing the block
+     * @param operand           The immediate operand of the instruction
+     * @return true if the next instruction of the block can be executed, false if the block needs to exit
+     */
+    template <byte OPCODE, byte EXTENDED_OPCODE = 0>
+    static bool execute(CPU* cpu, word operand = 0)
+    {
+        if (cpu->interruptsEnabledRequested)
+        {
+            cpu->_interruptManager.setInterruptMasterEnable(true);
+            cpu->interruptsEnabledRequested = false;
+        }
+
+        cpu->pc++;
+        cpu->_recompiledInstruction.operand = operand;
+        cpu->_decodedInstruction = &cpu->_recompiledInstruction;
+        if constexpr (OPCODE == standardInstructions::EXT_OPS)
+        {
+            cpu->pc++;
+            constexpr CPU::InstructionHandlers::Handler handler =
+                CPU::InstructionHandlers::extendedHandler<EXTENDED_OPCODE>();
+            handler(*cpu);
+        }
+        else
+        {
+            constexpr CPU::InstructionHandlers::Handler handler = CPU::InstructionHandlers::standardHandler<OPCODE>();
+            handler(*cpu);
+        }
+        cpu->_decodedInstruction = nullptr;
+
+        return synchronize(cpu);
+    }
+
+  private:
+    /**
+     * Synchronize the system after an instruction.
+     *
+     * @return true if the block can continue, false if it needs to exit
+     */
+    static bool synchronize(CPU* cpu)
+    {
+        int ticks = cpu->lastInstructionTicks;
+        cpu->tick += ticks;
+        cpu->_jitExecutedTicks += ticks;
+        cpu->notifyInstructionExecuted(ticks);
+
+        bool isInterruptRequested = cpu->_interruptManager.hasInterruptToHandle();
+        bool isMappingChanged = cpu->_jitEntryEpoch != cpu->_basicBlockCache.getEpoch();
+        bool isTickLimitReached = cpu->_jitExecutedTicks >= cpu->_maxExecutedTicks;
+
+        return !isInterruptRequested && !isMappingChanged && !cpu->halted && !isTickLimitReached;
+    }
+};
+
+#endif // GBEMULATOR_RECOMPILED_CODE_HPP
@@ -0,0 +1,43 @@
+#include "recompiled_module.hpp"
+#include <algorithm>
+
+const RecompiledBlock* RecompiledModule::findBlock(int bankKey, word addr) const
+{
+    const RecompiledBlock* end = blocks + numberOfBlocks;
+    const RecompiledBlock* it =
+        std::lower_bound(blocks, end, std::make_pair(bankKey, addr), [](const RecompiledBlock& block, const auto& key) {
+            return std::make_pair(block.bankKey, block.startAddress) < key;
+        });
+
+    if (it == end || it->bankKey != bankKey || it->startAddress != addr)
+    {
+        return nullptr;
+    }
+
+    return it;
+}
+
+void RecompiledModuleRegistry::registerModule(const RecompiledModule& module)
+{
+    getModules().push_back(&module);
+}
+
+const RecompiledModule* RecompiledModuleRegistry::findModule(uint64_t cartridgeHash)
+{
+    for (const RecompiledModule* module : getModules())
+    {
+        if (module->cartridgeHash == cartridgeHash)
+        {
+            return module;
+        }
+    }
+
+    return nullptr;
+}
+
+std::vector<const RecompiledModule*>& RecompiledModuleRegistry::getModules()
+{
+    // Constructed on first use since the modules register themselves during the static initialization
+    static std::vector<const RecompiledModule*> modules;
+    return modules;
+}
@@ -0,0 +1,105 @@
+#ifndef GBEMULATOR_RECOMPILED_MODULE_HPP
+#define GBEMULATOR_RECOMPILED_MODULE_HPP
+
+#include "common/types.hpp"
+#include "cpu/basic_block_cache.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * A basic block of a ROM that was translated to C++ ahead of time by gb2cpp.
+ */
+struct RecompiledBlock
+{
+    /**
+     * The key of the ROM bank of the block, as returned by MMU::getMemoryBankKey()
+     */
+    int bankKey;
+
+    /**
+     * The address of the first instruction of the block
+     */
+    word startAddress;
+
+    /**
+     * The number of instructions that were recompiled,
+     * the block can stop before the end of the decoded block (HALT and STOP are left to the interpreter)
+     */
+    size_t numberOfInstructions;
+
+    /**
+     * The compiled code, it has the same contract as the code generated by the JIT
+     */
+    BasicBlock::CompiledCode code;
+};
+
+/**
+ * The code generated by gb2cpp for a ROM, linked in the executable.
+ */
+struct RecompiledModule
+{
+    /**
+     * The hash of the cartridge the module was generated from, see Cartridge::getHash()
+     */
+    uint64_t cartridgeHash;
+
+    /**
+     * The title of the cartridge the module was generated from
+     */
+    const char* title;
+
+    /**
+     * The recompiled blocks, sorted by bank key and start address
+     */
+    const RecompiledBlock* blocks;
+
+    size_t numberOfBlocks;
+
+    /**
+     * Find the recompiled block starting at the given address of a ROM bank.
+     *
+     * @param bankKey   The key of the ROM bank of the block
+     * @param addr      The address of the first instruction of the block
+     * @return the block or nullptr if the block was not recompiled
+     */
+    const RecompiledBlock* findBlock(int bankKey, word addr) const;
+};
+
+/**
+ * The modules linked in the executable, they register themselves when the program starts.
+ */
+class RecompiledModuleRegistry
+{
+  public:
+    /**
+     * Make a module available to the emulator.
+     *
+     * @param module The module to register, it needs to stay alive until the end of the program
+     */
+    static void registerModule(const RecompiledModule& module);
+
+    /**
+     * Find the module generated from a cartridge.
+     *
+     * @param cartridgeHash The hash of the cartridge
+     * @return the module or nullptr if the cartridge wasn't recompiled
+     */
+    static const RecompiledModule* findModule(uint64_t cartridgeHash);
+
+  private:
+    static std::vector<const RecompiledModule*>& getModules();
+};
+
+/**
+ * Registers a module when it's constructed, used by the generated code.
+ */
+struct RecompiledModuleRegistration
+{
+    explicit RecompiledModuleRegistration(const RecompiledModule& module)
+    {
+        RecompiledModuleRegistry::registerModule(module);
+    }
+};
+
+#endif // GBEMULATOR_RECOMPILED_MODULE_HPP
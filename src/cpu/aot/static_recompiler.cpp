@@ -0,0 +1,282 @@
+#include "static_recompiler.hpp"
+#include "common/utils.hpp"
+#include "cpu/basic_block_cache.hpp"
+#include "cpu/instructions.hpp"
+#include "memory/cartridge.hpp"
+#include <algorithm>
+#include <sstream>
+
+using namespace standardInstructions;
+
+const std::vector<word> StaticRecompiler::VECTORS = {0x00, 0x08, 0x10, 0x18, 0x20, 0x28, 0x30,
+                                                      0x38, 0x40, 0x48, 0x50, 0x58, 0x60};
+
+StaticRecompiler::StaticRecompiler(Cartridge& cartridge)
+    : _rom(cartridge.getData()), _cartridgeHash(cartridge.getHash()), _title(cartridge.getTitle())
+{
+    _numberOfBanks = static_cast<int>((_rom.size() + ROM_BANK_SIZE - 1) / ROM_BANK_SIZE);
+
+    queueTarget(0, ENTRY_POINT);
+    for (word vector : VECTORS)
+    {
+        queueTarget(0, vector);
+    }
+
+    while (!_queue.empty())
+    {
+        std::pair<int, word> target = _queue.back();
+        _queue.pop_back();
+        discoverBlock(target.first, target.second);
+    }
+}
+
+void StaticRecompiler::queueTarget(int fromBank, int addr)
+{
+    // The code in RAM is left to the interpreter
+    if (addr < 0 || addr >= 2 * ROM_BANK_SIZE)
+    {
+        return;
+    }
+
+    if (addr < ROM_BANK_SIZE)
+    {
+        _queue.emplace_back(0, static_cast<word>(addr));
+    }
+    else if (fromBank != 0)
+    {
+        _queue.emplace_back(fromBank, static_cast<word>(addr));
+    }
+    else
+    {
+        // The bank selected when jumping from the fixed bank is not known
+        for (int bank = 1; bank < _numberOfBanks; ++bank)
+        {
+            _queue.emplace_back(bank, static_cast<word>(addr));
+        }
+    }
+}
+
+const byte* StaticRecompiler::getBankData(int bank, word addr, size_t& size) const
+{
+    size_t offset = bank == 0 ? addr : static_cast<size_t>(bank) * ROM_BANK_SIZE + (addr - ROM_BANK_SIZE);
+    size_t bankEnd = bank == 0 ? ROM_BANK_SIZE : 2 * ROM_BANK_SIZE;
+    if (offset >= _rom.size())
+    {
+        size = 0;
+        return nullptr;
+    }
+
+    size = std::min(bankEnd - addr, _rom.size() - offset);
+    return _rom.data() + offset;
+}
+
+void StaticRecompiler::discoverBlock(int bank, word addr)
+{
+    if (_blocks.count({bank, addr}) > 0)
+    {
+        return;
+    }
+
+    Block block;
+    block.bank = bank;
+    block.startAddress = addr;
+
+    // Split like BasicBlockCache::decodeBlock() does
+    int currentAddr = addr;
+    size_t size = 0;
+    const byte* data = getBankData(bank, addr, size);
+    while (data != nullptr && block.instructions.size() < BasicBlockCache::MAX_INSTRUCTIONS_PER_BLOCK)
+    {
+        DecodedInstruction instruction = InstructionDecoder::decode(data, size, static_cast<word>(currentAddr));
+        if (instruction.length == 0)
+        {
+            break;
+        }
+
+        block.instructions.push_back(instruction);
+        currentAddr += instruction.length;
+        data += instruction.length;
+        size -= instruction.length;
+
+        if (InstructionDecoder::isBlockTerminator(instruction.opCode) || size == 0)
+        {
+            break;
+        }
+    }
+
+    if (block.instructions.empty())
+    {
+        return;
+    }
+
+    // HALT and STOP take no tick, the CPU could not tell if a block made of them was executed
+    while (block.numberOfRecompiledInstructions < block.instructions.size())
+    {
+        byte opCode = block.instructions[block.numberOfRecompiledInstructions].opCode;
+        if (opCode == HALT || opCode == STOP)
+        {
+            break;
+        }
+        block.numberOfRecompiledInstructions++;
+    }
+
+    const DecodedInstruction& last = block.instructions.back();
+    int nextAddr = last.address + last.length;
+    bool isFallingThrough = true;
+    switch (last.opCode)
+    {
+    case JR_n:
+        isFallingThrough = false;
+        queueTarget(bank, nextAddr + static_cast<sbyte>(last.operand));
+        break;
+    case JR_NZ_n:
+    case JR_Z_n:
+    case JR_NC_n:
+    case JR_C_n:
+        queueTarget(bank, nextAddr + static_cast<sbyte>(last.operand));
+        break;
+    case JP_nn:
+        isFallingThrough = false;
+        queueTarget(bank, last.operand);
+        break;
+    case JP_NZ_nn:
+    case JP_Z_nn:
+    case JP_NC_nn:
+    case JP_C_nn:
+    case CALL_nn:
+    case CALL_NZ_nn:
+    case CALL_Z_nn:
+    case CALL_NC_nn:
+    case CALL_C_nn:
+        queueTarget(bank, last.operand);
+        break;
+    case RST_0:
+    case RST_8:
+    case RST_10:
+    case RST_18:
+    case RST_20:
+    case RST_28:
+    case RST_30:
+    case RST_38:
+        queueTarget(bank, last.opCode & 0x38);
+        break;
+    case JP_HLm:
+    case RET:
+    case RETI:
+        isFallingThrough = false;
+        break;
+    default:
+        // Invalid opcodes lock the CPU
+        isFallingThrough = InstructionDecoder::getInstructionLength(last.opCode) != 0;
+        break;
+    }
+
+    if (isFallingThrough)
+    {
+        queueTarget(bank, nextAddr);
+    }
+
+    _blocks.emplace(std::make_pair(bank, addr), std::move(block));
+}
+
+std::vector<const StaticRecompiler::Block*> StaticRecompiler::getBlocks() const
+{
+    std::vector<const Block*> blocks;
+    for (const auto& entry : _blocks)
+    {
+        blocks.push_back(&entry.second);
+    }
+    return blocks;
+}
+
+const StaticRecompiler::Block* StaticRecompiler::findBlock(int bank, word addr) const
+{
+    auto it = _blocks.find({bank, addr});
+    return it != _blocks.end() ? &it->second : nullptr;
+}
+
+std::string StaticRecompiler::getFunctionName(const Block& block)
+{
+    return utils::string_format("block_%02X_%04X", block.bank, block.startAddress);
+}
+
+std::string StaticRecompiler::generateBlockFunction(const Block& block)
+{
+    std::ostringstream source;
+    source << "int " << getFunctionName(block) << "(CPU* cpu)\n{\n";
+    for (size_t i = 0; i < block.numberOfRecompiledInstructions; ++i)
+    {
+        const DecodedInstruction& instruction = block.instructions[i];
+        std::string call;
+        if (instruction.opCode == EXT_OPS)
+        {
+            call = utils::string_format("RecompiledCode::execute<0x%02X, 0x%02X>(cpu)", instruction.opCode,
+                                        instruction.operand);
+        }
+        else if (instruction.length > 1)
+        {
+            call = utils::string_format("RecompiledCode::execute<0x%02X>(cpu, 0x%04X)", instruction.opCode,
+                                        instruction.operand);
+        }
+        else
+        {
+            call = utils::string_format("RecompiledCode::execute<0x%02X>(cpu)", instruction.opCode);
+        }
+
+        source << utils::string_format("    // %04X\n", instruction.address);
+        if (i + 1 < block.numberOfRecompiledInstructions)
+        {
+            source << "    if (!" << call << ")\n    {\n        return " << i + 1 << ";\n    }\n";
+        }
+        else
+        {
+            source << "    " << call << ";\n";
+        }
+    }
+    source << "    return " << block.numberOfRecompiledInstructions << ";\n}\n\n";
+    return source.str();
+}
+
+std::string StaticRecompiler::generateSource() const
+{
+    std::string title;
+    for (char c : _title)
+    {
+        bool isPrintable = c >= 0x20 && c < 0x7F && c != '"' && c != '\\';
+        title += isPrintable ? c : '?';
+    }
+
+    std::ostringstream source;
+    source << "// Generated by gb2cpp from the cartridge \"" << title << "\", do not edit.\n";
+    source << "#include \"cpu/aot/recompiled_code.hpp\"\n\n";
+    source << "namespace\n{\n";
+
+    std::ostringstream table;
+    size_t numberOfBlocks = 0;
+    for (const auto& entry : _blocks)
+    {
+        const Block& block = entry.second;
+        if (block.numberOfRecompiledInstructions == 0)
+        {
+            continue;
+        }
+
+        source << generateBlockFunction(block);
+        table << utils::string_format("    {%d, 0x%04X, %d, &", block.bank, block.startAddress,
+                                      static_cast<int>(block.numberOfRecompiledInstructions))
+              << getFunctionName(block) << "},\n";
+        numberOfBlocks++;
+    }
+
+    if (numberOfBlocks > 0)
+    {
+        source << "const RecompiledBlock BLOCKS[] = {\n" << table.str() << "};\n\n";
+    }
+
+    source << "const RecompiledModule MODULE = {"
+           << utils::string_format("0x%016llXULL", static_cast<unsigned long long>(_cartridgeHash)) << ", \""
+           << title << "\", " << (numberOfBlocks > 0 ? "BLOCKS" : "nullptr") << ", " << numberOfBlocks << "};\n";
+    source << "const RecompiledModuleRegistration REGISTRATION(MODULE);\n";
+    source << "} // namespace\n";
+    return source.str();
+}
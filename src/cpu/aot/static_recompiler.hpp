@@ -0,0 +1,147 @@
+#ifndef GBEMULATOR_STATIC_RECOMPILER_HPP
+#define GBEMULATOR_STATIC_RECOMPILER_HPP
+
+#include "common/types.hpp"
+#include "cpu/instruction_decoder.hpp"
+#include "memory/rom_image.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Forward declaration
+class Cartridge;
+
+/**
+ * Ahead of time recompiler translating the code of a ROM to C++, used by the gb2cpp tool.
+ *
+ * The code reachable from the entry point and the interrupt vectors is discovered by following
+ * the jumps, calls and restarts whose target is known statically, across all the ROM banks:
+ *  - a target in the fixed bank is always in bank 0,
+ *  - a target in the switchable area is in the same bank when coming from a switchable bank,
+ *    and can be in any bank when coming from the fixed bank.
+ * The code only reached through JP (HL), RET or code in RAM is missed, it's left to the interpreter.
+ *
+ * The blocks are split exactly like the basic block cache splits them at runtime,
+ * so that a recompiled block can be found from the start address and the bank of a decoded block.
+ * The generated C++ registers a RecompiledModule keyed by the hash of the cartridge.
+ */
+class StaticRecompiler
+{
+  public:
+    /**
+     * A block discovered in the ROM.
+     */
+    struct Block
+    {
+        /**
+         * The ROM bank of the block, 0 for the fixed bank
+         */
+        int bank = 0;
+
+        /**
+         * The address of the first instruction of the block once mapped in memory
+         */
+        word startAddress = 0;
+
+        /**
+         * The instructions of the block, split like the basic block cache does
+         */
+        std::vector<DecodedInstruction> instructions;
+
+        /**
+         * The number of instructions that are recompiled, HALT and STOP end the recompiled part
+         */
+        size_t numberOfRecompiledInstructions = 0;
+    };
+
+    /**
+     * Discover the code of a cartridge.
+     *
+     * @param cartridge The cartridge to recompile
+     */
+    explicit StaticRecompiler(Cartridge& cartridge);
+
+    /**
+     * @return the blocks found, sorted by bank and start address
+     */
+    std::vector<const Block*> getBlocks() const;
+
+    /**
+     * Find a block that was discovered.
+     *
+     * @param bank  The ROM bank of the block
+     * @param addr  The start address of the block
+     * @return the block or nullptr if no block starts at this address
+     */
+    const Block* findBlock(int bank, word addr) const;
+
+    /**
+     * Generate the C++ code of the module, it needs to be linked with gbemulator_core.
+     *
+     * @return the content of the C++ source file
+     */
+    std::string generateSource() const;
+
+  private:
+    /**
+     * Decode the block starting at the given address and queue its successors.
+     */
+    void discoverBlock(int bank, word addr);
+
+    /**
+     * Queue a block to be discovered, from the fixed bank or from the given bank.
+     *
+     * @param fromBank  The bank of the instruction jumping to the address
+     * @param addr      The address of the block
+     */
+    void queueTarget(int fromBank, int addr);
+
+    /**
+     * Get the bytes that can be decoded from the given address of a bank.
+     *
+     * @param bank  The ROM bank
+     * @param addr  The address once mapped in memory
+     * @param size  Set to the number of bytes that can be read until the end of the bank
+     * @return the bytes or nullptr if the address is outside of the ROM
+     */
+    const byte* getBankData(int bank, word addr, size_t& size) const;
+
+    /**
+     * Generate the C++ function of a block.
+     */
+    static std::string generateBlockFunction(const Block& block);
+
+    static std::string getFunctionName(const Block& block);
+
+    const ROMImage& _rom;
+    uint64_t _cartridgeHash = 0;
+    std::string _title;
+    int _numberOfBanks = 0;
+
+    /**
+     * The blocks discovered, indexed by their bank and start address
+     */
+    std::map<std::pair<int, word>, Block> _blocks;
+
+    /**
+     * The blocks waiting to be discovered
+     */
+    std::vector<std::pair<int, word>> _queue;
+
+    /**
+     * The address of the interrupt vectors and the restart routines
+     */
+    static const std::vector<word> VECTORS;
+
+    /**
+     * The address where the execution of the cartridge starts
+     */
+    static const word ENTRY_POINT = 0x0100;
+
+    static const int ROM_BANK_SIZE = 0x4000;
+};
+
+#endif // GBEMULATOR_STATIC_RECOMPILER_HPP
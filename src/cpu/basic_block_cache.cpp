@@ -0,0 +1,258 @@
+#include "basic_block_cache.hpp"
+#include "cpu/aot/recompiled_module.hpp"
+#include "memory/mmu.hpp"
+#include <algorithm>
+
+BasicBlockCache::BasicBlockCache(MMU& mmu) : _mmu(mmu)
+{
+}
+
+BasicBlockCache::~BasicBlockCache()
+{
+    saveTranslationCache();
+}
+
+BasicBlock* BasicBlockCache::getBlock(word addr)
+{
+    // The mapping doesn't change during an epoch, neither does the block at an address
+    if (_lastBlock != nullptr && _lastBlockEpoch == _epoch && _lastBlock->startAddress == addr)
+    {
+        return _lastBlock;
+    }
+
+    _invalidatedBlocks.clear();
+    int bankKey = _mmu.getMemoryBankKey(addr);
+    if (bankKey == MMU::UNCACHEABLE_BANK_KEY)
+    {
+        return nullptr;
+    }
+
+    uint64_t blockKey = createBlockKey(bankKey, addr);
+    auto it = _blocks.find(blockKey);
+    if (it != _blocks.end())
+    {
+        _lastBlock = it->second.get();
+        _lastBlockEpoch = _epoch;
+        return _lastBlock;
+    }
+
+    std::unique_ptr<BasicBlock> block;
+    const TranslationCache::BlockEntry* entry = nullptr;
+    if (MMU::isROMBankKey(bankKey))
+    {
+        entry = _translationCache.findBlock(bankKey, addr);
+    }
+
+    if (entry != nullptr)
+    {
+        block = loadBlock(*entry);
+    }
+    else
+    {
+        block = decodeBlock(addr, bankKey);
+        if (block == nullptr)
+        {
+            return nullptr;
+        }
+
+        if (MMU::isROMBankKey(bankKey))
+        {
+            _numberOfDecodedROMBlocks++;
+        }
+    }
+
+    if (MMU::isWritableBankKey(bankKey))
+    {
+        trackWritableBlock(blockKey, *block, true);
+    }
+    else if (_recompiledModule != nullptr && MMU::isROMBankKey(bankKey))
+    {
+        // The recompiled block can stop before the end of the block, the rest is left to the interpreter
+        const RecompiledBlock* recompiledBlock = _recompiledModule->findBlock(bankKey, addr);
+        if (recompiledBlock != nullptr && recompiledBlock->numberOfInstructions <= block->instructions.size())
+        {
+            block->nativeCode = recompiledBlock->code;
+        }
+    }
+
+    _lastBlock = _blocks.emplace(blockKey, std::move(block)).first->second.get();
+    _lastBlockEpoch = _epoch;
+    return _lastBlock;
+}
+
+std::unique_ptr<BasicBlock> BasicBlockCache::decodeBlock(word addr, int bankKey)
+{
+    auto block = std::make_unique<BasicBlock>();
+    block->bankKey = bankKey;
+    block->startAddress = addr;
+
+    int currentAddr = addr;
+    while (block->instructions.size() < MAX_INSTRUCTIONS_PER_BLOCK)
+    {
+        DecodedInstruction instruction = InstructionDecoder::decode(_mmu, static_cast<word>(currentAddr));
+        if (instruction.length == 0)
+        {
+            break;
+        }
+
+        // The whole instruction needs to come from the same memory bank
+        bool isInSameBank = true;
+        for (int i = 1; i < instruction.length && isInSameBank; ++i)
+        {
+            int addrToCheck = currentAddr + i;
+            isInSameBank = addrToCheck < 0x10000 && _mmu.getMemoryBankKey(static_cast<word>(addrToCheck)) == bankKey;
+        }
+
+        if (!isInSameBank)
+        {
+            break;
+        }
+
+        block->instructions.push_back(instruction);
+        currentAddr += instruction.length;
+
+        if (InstructionDecoder::isBlockTerminator(instruction.opCode) || currentAddr >= 0x10000 ||
+            _mmu.getMemoryBankKey(static_cast<word>(currentAddr)) != bankKey)
+        {
+            break;
+        }
+    }
+
+    if (block->instructions.empty())
+    {
+        return nullptr;
+    }
+
+    block->size = currentAddr - addr;
+    return block;
+}
+
+std::unique_ptr<BasicBlock> BasicBlockCache::loadBlock(const TranslationCache::BlockEntry& entry) const
+{
+    auto block = std::make_unique<BasicBlock>();
+    block->bankKey = entry.bankKey;
+    block->startAddress = entry.startAddress;
+    block->size = entry.size;
+    const DecodedInstruction* instructions = _translationCache.getInstructions(entry);
+    block->instructions.assign(instructions, instructions + entry.numberOfInstructions);
+    return block;
+}
+
+void BasicBlockCache::clear()
+{
+    saveTranslationCache();
+
+    _blocks.clear();
+    _invalidatedBlocks.clear();
+    _lastBlock = nullptr;
+    for (auto& page : _writableBlocksByPage)
+    {
+        page.clear();
+    }
+    std::fill(_writableCodeCoverage.begin(), _writableCodeCoverage.end(), 0);
+    _epoch++;
+
+    Cartridge* cartridge = _mmu.getCartridge();
+    _cartridgeHash = cartridge != nullptr ? cartridge->getHash() : 0;
+    _recompiledModule = cartridge != nullptr ? RecompiledModuleRegistry::findModule(_cartridgeHash) : nullptr;
+    loadTranslationCache();
+}
+
+void BasicBlockCache::setTranslationCacheDirectory(const std::string& directory)
+{
+    saveTranslationCache();
+    _translationCacheDirectory = directory;
+    loadTranslationCache();
+}
+
+void BasicBlockCache::loadTranslationCache()
+{
+    _translationCache.unload();
+    _numberOfDecodedROMBlocks = 0;
+    if (!_translationCacheDirectory.empty() && _mmu.getCartridge() != nullptr)
+    {
+        _translationCache.load(TranslationCache::getFilePath(_translationCacheDirectory, _cartridgeHash),
+                               _cartridgeHash);
+    }
+}
+
+bool BasicBlockCache::saveTranslationCache()
+{
+    if (_translationCacheDirectory.empty() || _numberOfDecodedROMBlocks == 0)
+    {
+        return true;
+    }
+
+    std::vector<const BasicBlock*> blocks;
+    for (const auto& entry : _blocks)
+    {
+        if (MMU::isROMBankKey(entry.second->bankKey))
+        {
+            blocks.push_back(entry.second.get());
+        }
+    }
+
+    // The blocks of the file that were not executed during this run are kept
+    std::vector<std::unique_ptr<BasicBlock>> unusedBlocks;
+    for (size_t i = 0; i < _translationCache.getNumberOfBlocks(); ++i)
+    {
+        const TranslationCache::BlockEntry& entry = _translationCache.getBlocks()[i];
+        if (_blocks.count(createBlockKey(entry.bankKey, entry.startAddress)) == 0)
+        {
+            unusedBlocks.push_back(loadBlock(entry));
+            blocks.push_back(unusedBlocks.back().get());
+        }
+    }
+
+    std::string path = TranslationCache::getFilePath(_translationCacheDirectory, _cartridgeHash);
+    if (!TranslationCache::save(path, _cartridgeHash, blocks))
+    {
+        return false;
+    }
+
+    _numberOfDecodedROMBlocks = 0;
+    return true;
+}
+
+void BasicBlockCache::invalidateBlocksAt(word addr)
+{
+    // Copy the keys since the page will be modified when removing blocks
+    std::vector<uint64_t> pageBlockKeys = _writableBlocksByPage[addr / PAGE_SIZE];
+    for (uint64_t blockKey : pageBlockKeys)
+    {
+        auto it = _blocks.find(blockKey);
+        const BasicBlock& block = *it->second;
+        if (addr >= block.startAddress && addr < block.startAddress + block.size)
+        {
+            trackWritableBlock(blockKey, block, false);
+            _invalidatedBlocks.push_back(std::move(it->second));
+            _blocks.erase(it);
+        }
+    }
+
+    _epoch++;
+}
+
+void BasicBlockCache::trackWritableBlock(uint64_t blockKey, const BasicBlock& block, bool added)
+{
+    int firstPage = block.startAddress / PAGE_SIZE;
+    int lastPage = (block.startAddress + block.size - 1) / PAGE_SIZE;
+    for (int page = firstPage; page <= lastPage; ++page)
+    {
+        std::vector<uint64_t>& pageBlockKeys = _writableBlocksByPage[page];
+        if (added)
+        {
+            pageBlockKeys.push_back(blockKey);
+        }
+        else
+        {
+            pageBlockKeys.erase(std::remove(pageBlockKeys.begin(), pageBlockKeys.end(), blockKey),
+                                pageBlockKeys.end());
+        }
+    }
+
+    for (int addr = block.startAddress; addr < block.startAddress + block.size; ++addr)
+    {
+        _writableCodeCoverage[addr] += added ? 1 : -1;
+    }
+}
@@ -0,0 +1,339 @@
+#ifndef GBEMULATOR_BASIC_BLOCK_CACHE_HPP
+#define GBEMULATOR_BASIC_BLOCK_CACHE_HPP
+
+#include "common/types.hpp"
+#include "cpu/instruction_decoder.hpp"
+#include "cpu/translation_cache.hpp"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Forward declaration
+class CPU;
+class MMU;
+struct RecompiledModule;
+
+/**
+ * A basic block is a sequence of instructions that are executed one after the other,
+ * it ends with an instruction that can change the control flow (jump, call, return, ...).
+ */
+struct BasicBlock
+{
+    /**
+     * Signature of the native code compiled for a block,
+     * it returns the number of instructions of the block that were executed.
+     */
+    typedef int (*CompiledCode)(CPU* cpu);
+
+    /**
+     * Signature of the function executing an instruction of the block.
+     */
+    typedef void (*InstructionHandler)(CPU& cpu);
+
+    /**
+     * A block executed right after this one.
+     */
+    struct Link
+    {
+        word address = 0;
+        BasicBlock* block = nullptr;
+    };
+
+    /**
+     * The key identifying the memory bank the block was decoded from
+     */
+    int bankKey = 0;
+
+    /**
+     * The address of the first instruction of the block
+     */
+    word startAddress = 0;
+
+    /**
+     * The number of bytes covered by the block
+     */
+    int size = 0;
+
+    /**
+     * The instructions of the block in execution order
+     */
+    std::vector<DecodedInstruction> instructions;
+
+    /**
+     * The handlers of the instructions, resolved by the CPU the first time it executes the block
+     */
+    std::vector<InstructionHandler> handlers;
+
+    /**
+     * The blocks executed after this one, the next block in memory and the target of the last jump taken.
+     * They are only valid during the epoch of the cache they were linked in.
+     */
+    std::array<Link, 2> successors;
+
+    /**
+     * The epoch of the cache when the successors were linked
+     */
+    uint32_t successorsEpoch = 0;
+
+    /**
+     * The number of times the execution entered the block from its first instruction
+     */
+    uint32_t executionCount = 0;
+
+    /**
+     * The native code generated for the block by the JIT, nullptr if the block is not compiled
+     */
+    CompiledCode nativeCode = nullptr;
+};
+
+/**
+ * Cache of the basic blocks that were decoded from memory, keyed by the memory bank they were
+ * decoded from and their start address.
+ *
+ * Blocks decoded from ROM stay valid for the lifetime of the cartridge since the bank is part of the key,
+ * blocks decoded from RAM (WRAM, HRAM) are invalidated when the memory they cover is written to.
+ *
+ * When the cartridge was recompiled ahead of time by gb2cpp, the blocks decoded from ROM get
+ * the native code of the recompiled module when they are decoded.
+ *
+ * When a translation cache directory is set, the blocks decoded from ROM are saved to a TranslationCache
+ * file of the cartridge and read back from it instead of being decoded on the next runs.
+ */
+class BasicBlockCache
+{
+  public:
+    /**
+     * Create a new cache decoding instructions from the given MMU.
+     *
+     * @param mmu The MMU to read instructions from
+     */
+    explicit BasicBlockCache(MMU& mmu);
+
+    /**
+     * Save the translation cache of the cartridge if new blocks were decoded from its ROM.
+     */
+    ~BasicBlockCache();
+
+    /**
+     * Get the block starting at the given address in the memory currently mapped,
+     * decoding it if it's not in the cache yet.
+     * The blocks invalidated since the last call are destroyed.
+     *
+     * @param addr The address of the first instruction of the block
+     * @return the block or nullptr if the memory at this address cannot be cached
+     */
+    BasicBlock* getBlock(word addr);
+
+    /**
+     * Notify the cache that a value was written in memory.
+     * All the blocks covering this address will be invalidated, they stay allocated until the next lookup
+     * since the instruction that wrote the value can be part of them.
+     *
+     * @param addr The address that was written to
+     */
+    void notifyWrite(word addr)
+    {
+        if (_writableCodeCoverage[addr] != 0)
+        {
+            invalidateBlocksAt(addr);
+        }
+    }
+
+    /**
+     * Notify the cache that the memory mapping changed (bank switch, bootrom unmapped, ...).
+     * Blocks are kept in the cache but the ones being executed need to be looked up again.
+     */
+    void notifyMappingChanged()
+    {
+        _epoch++;
+    }
+
+    /**
+     * Remove all the blocks from the cache.
+     * The translation cache of the previous cartridge is saved, then the recompiled module
+     * and the translation cache of the cartridge currently loaded are looked up again.
+     */
+    void clear();
+
+    /**
+     * Set the directory where the translation caches of the cartridges are stored,
+     * the translation cache of the cartridge currently loaded is used right away.
+     *
+     * @param directory The directory, the translation caches are disabled when empty
+     */
+    void setTranslationCacheDirectory(const std::string& directory);
+
+    /**
+     * Write the blocks decoded from the ROM of the cartridge to its translation cache,
+     * along with the ones read from the file that were not used during this run.
+     * Nothing is written if no new block was decoded since the file was loaded.
+     *
+     * @return true if the file is up to date
+     */
+    bool saveTranslationCache();
+
+    /**
+     * @return the translation cache of the cartridge currently loaded
+     */
+    const TranslationCache& getTranslationCache() const
+    {
+        return _translationCache;
+    }
+
+    /**
+     * @return the module recompiled ahead of time for the loaded cartridge, nullptr if there is none
+     */
+    const RecompiledModule* getRecompiledModule() const
+    {
+        return _recompiledModule;
+    }
+
+    /**
+     * Get the current epoch of the cache.
+     * The epoch changes everytime a block is invalidated or the memory mapping changes,
+     * a block retrieved during an epoch should not be used during another one.
+     *
+     * @return the current epoch
+     */
+    uint32_t getEpoch() const
+    {
+        return _epoch;
+    }
+
+    /**
+     * @return the number of blocks currently in the cache
+     */
+    size_t getNumberOfBlocks() const
+    {
+        return _blocks.size();
+    }
+
+    /**
+     * @return the number of blocks that were decoded from ROM instead of being read from the translation cache
+     */
+    size_t getNumberOfDecodedROMBlocks() const
+    {
+        return _numberOfDecodedROMBlocks;
+    }
+
+    /**
+     * The maximum number of instructions in a block
+     */
+    static const size_t MAX_INSTRUCTIONS_PER_BLOCK = 64;
+
+  private:
+    /**
+     * Create the key used to store a block in the cache.
+     *
+     * @param bankKey   The key of the memory bank of the block
+     * @param addr      The start address of the block
+     * @return the key of the block
+     */
+    static uint64_t createBlockKey(int bankKey, word addr)
+    {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(bankKey)) << 16) | addr;
+    }
+
+    /**
+     * Decode a block from memory.
+     *
+     * @param addr      The start address of the block
+     * @param bankKey   The key of the memory bank mapped at this address
+     * @return the decoded block, or nullptr if not even a single instruction could be decoded
+     */
+    std::unique_ptr<BasicBlock> decodeBlock(word addr, int bankKey);
+
+    /**
+     * Create a block from the translation cache.
+     *
+     * @param entry The block stored in the translation cache
+     * @return the block
+     */
+    std::unique_ptr<BasicBlock> loadBlock(const TranslationCache::BlockEntry& entry) const;
+
+    /**
+     * Load the translation cache of the cartridge currently loaded, if any.
+     */
+    void loadTranslationCache();
+
+    /**
+     * Invalidate all the blocks covering the given address.
+     *
+     * @param addr The address to invalidate
+     */
+    void invalidateBlocksAt(word addr);
+
+    /**
+     * Keep track of a block decoded from writable memory.
+     *
+     * @param blockKey  The key of the block in the cache
+     * @param block     The block to track
+     * @param added     True when the block is added to the cache, false when it's removed
+     */
+    void trackWritableBlock(uint64_t blockKey, const BasicBlock& block, bool added);
+
+    /**
+     * The size of a page used to track blocks in writable memory
+     */
+    static const int PAGE_SIZE = 256;
+
+    MMU& _mmu;
+
+    /**
+     * The decoded blocks, indexed by their key
+     */
+    std::unordered_map<uint64_t, std::unique_ptr<BasicBlock>> _blocks;
+
+    /**
+     * The blocks invalidated since the last lookup
+     */
+    std::vector<std::unique_ptr<BasicBlock>> _invalidatedBlocks;
+
+    /**
+     * The block returned by the last lookup, valid during the epoch it was retrieved in
+     */
+    BasicBlock* _lastBlock = nullptr;
+    uint32_t _lastBlockEpoch = 0;
+
+    /**
+     * Keys of the blocks decoded from writable memory, indexed by the memory pages they cover
+     */
+    std::array<std::vector<uint64_t>, 65536 / PAGE_SIZE> _writableBlocksByPage;
+
+    /**
+     * For each address, the number of blocks from writable memory that cover it
+     */
+    std::vector<uint16_t> _writableCodeCoverage = std::vector<uint16_t>(65536);
+
+    /**
+     * The current epoch of the cache
+     */
+    uint32_t _epoch = 0;
+
+    /**
+     * The module recompiled ahead of time for the loaded cartridge
+     */
+    const RecompiledModule* _recompiledModule = nullptr;
+
+    /**
+     * The blocks decoded from ROM during the previous runs
+     */
+    TranslationCache _translationCache;
+
+    /**
+     * The directory where the translation caches are stored, empty when they are disabled
+     */
+    std::string _translationCacheDirectory;
+
+    /**
+     * The hash of the cartridge the blocks in the cache belong to
+     */
+    uint64_t _cartridgeHash = 0;
+
+    size_t _numberOfDecodedROMBlocks = 0;
+};
+
+#endif // GBEMULATOR_BASIC_BLOCK_CACHE_HPP
@@ -3,9 +3,15 @@
 
 #include "common/types.hpp"
 #include "common/utils.hpp"
+#include "cpu/basic_block_cache.hpp"
+#include "cpu/idle_loop_detector.hpp"
+#include "cpu/jit/jit_compiler.hpp"
+#include "cpu/register_pair.hpp"
 #include "instructions.hpp"
-#include "interrupt_handler.hpp"
+#include "interrupt_manager.hpp"
 #include "memory/mmu.hpp"
+#include <functional>
+#include <limits>
 #include <map>
 
 /**
@@ -51,15 +57,150 @@ class CPU
         NONE = 0x00
     };
 
+    /**
+     * The different ways the CPU can execute instructions.
+     */
+    enum class ExecutionMode
+    {
+        /**
+         * Every instruction is fetched and decoded from memory before being executed.
+         */
+        INTERPRETER,
+        /**
+         * Instructions are decoded once per basic block and kept in a cache,
+         * the operands and cycle costs are resolved ahead of execution.
+         * The blocks recompiled ahead of time by gb2cpp for the loaded cartridge are executed natively.
+         */
+        CACHED_INTERPRETER,
+        /**
+         * Same as the cached interpreter, but the blocks executed often are compiled to native code.
+         * Only available when JitCompiler::isSupported(), the cached interpreter is used otherwise.
+         */
+        JIT
+    };
+
+    /**
+     * Callback called after each instruction with the number of ticks it took.
+     */
+    typedef std::function<void(int)> InstructionExecutedCallback;
+
+    /**
+     * Callback returning the number of ticks the other components can be stepped at once
+     * without missing an event that could raise an interrupt.
+     */
+    typedef std::function<int()> NextEventCallback;
+
+    /**
+     * Set the way the CPU executes instructions.
+     * The result of the execution is the same for all modes.
+     *
+     * @param mode The execution mode to use
+     */
+    void setExecutionMode(ExecutionMode mode);
+
+    /**
+     * Set the function to call after each instruction executed by the CPU,
+     * it's used to keep the other components in sync with the CPU.
+     * In the cached and JIT execution modes, the consecutive instructions ending before the next event
+     * given by the next event callback can be reported in one call, see flushPendingTicks().
+     *
+     * @param callback The function to call, with the number of ticks taken by the instruction
+     */
+    void setInstructionExecutedCallback(InstructionExecutedCallback callback);
+
+    /**
+     * Report the instructions whose ticks are deferred to the instruction executed callback,
+     * the next instructions of the current call to fetchDecodeAndExecute() are then reported one by one.
+     * It needs to be called before the other components are brought up to date while an instruction is executed.
+     */
+    void flushPendingTicks()
+    {
+        _deferrableTicks = 0;
+        if (_pendingTicks > 0)
+        {
+            int ticks = _pendingTicks;
+            _pendingTicks = 0;
+            if (_instructionExecutedCallback)
+            {
+                _instructionExecutedCallback(ticks);
+            }
+        }
+    }
+
+    /**
+     * Set the function giving the number of ticks until the next event of the other components.
+     * When the CPU is halted, it's used to step the other components up to that event at once
+     * instead of one tick at a time, nothing can wake up the CPU before it.
+     * The instructions executed before the event are reported at once in the cached and JIT execution modes.
+     *
+     * @param callback The function to call, or nullptr to step one tick at a time
+     */
+    void setNextEventCallback(NextEventCallback callback);
+
+    /**
+     * Get the way the CPU executes instructions.
+     *
+     * @return The execution mode in use
+     */
+    ExecutionMode getExecutionMode() const;
+
+    /**
+     * Get the cache of basic blocks used by the cached interpreter.
+     *
+     * @return the cache of basic blocks
+     */
+    const BasicBlockCache& getBasicBlockCache() const;
+
+    /**
+     * Set the directory where the basic blocks decoded from the ROM of the cartridges are persisted,
+     * so that the next runs of the same cartridge don't decode them again. See TranslationCache.
+     *
+     * @param directory The directory, the persistence is disabled when empty
+     */
+    void setTranslationCacheDirectory(const std::string& directory);
+
+    /**
+     * Get the compiler used to translate the basic blocks to native code.
+     *
+     * @return the JIT compiler
+     */
+    const JitCompiler& getJitCompiler() const;
+
+    /**
+     * Enable or disable the fast-forwarding of idle loops, see IdleLoopDetector.
+     * The result of the execution is the same, the other components are updated with the ticks
+     * of the skipped instructions as if they were executed.
+     *
+     * @param enabled Whether the idle loops should be fast-forwarded
+     */
+    void setIdleLoopDetectionEnabled(bool enabled);
+
+    /**
+     * Get the detector of idle loops, along with the number of ticks it skipped.
+     *
+     * @return the idle loop detector
+     */
+    const IdleLoopDetector& getIdleLoopDetector() const;
+
     /**
      * Fetch the next instruction from the memory, decode it and execute it.
+     * When cached or compiled blocks are executed, or an idle loop is fast-forwarded, all the instructions
+     * executed are counted and reported to the instruction executed callback before it returns.
+     * They stop once the given number of ticks is reached, at least one instruction is executed.
+     *
+     * @param maxTicks The number of ticks after which no other instruction is started
      *
      * @throws UnhandledInstructionException if an instruction is not handled by the CPU
      * @throws UnhandledExtendedInstructionException if an extended instruction is not handled by the CPU
      *
      * @return the number of ticks taken by the instructions to be executed
      */
-    int fetchDecodeAndExecute();
+    int fetchDecodeAndExecute(int maxTicks = std::numeric_limits<int>::max());
+
+    /**
+     * Number of times a block needs to be executed before being compiled by the JIT
+     */
+    static const uint32_t JIT_COMPILATION_THRESHOLD = 16;
 
     /**
      * Get the current value of the 8 bits register A.
@@ -67,7 +208,7 @@ class CPU
      */
     byte getRegisterA() const
     {
-        return a;
+        return a();
     }
 
     /**
@@ -77,7 +218,7 @@ class CPU
      */
     void setRegisterA(byte value)
     {
-        a = value;
+        a() = value;
     }
 
     /**
@@ -86,7 +227,7 @@ class CPU
      */
     byte getRegisterB() const
     {
-        return b;
+        return b();
     }
 
     /**
@@ -96,7 +237,7 @@ class CPU
      */
     void setRegisterB(byte value)
     {
-        b = value;
+        b() = value;
     }
 
     /**
@@ -105,7 +246,7 @@ class CPU
      */
     byte getRegisterC() const
     {
-        return c;
+        return c();
     }
 
     /**
@@ -115,7 +256,7 @@ class CPU
      */
     void setRegisterC(byte value)
     {
-        c = value;
+        c() = value;
     }
 
     /**
@@ -124,7 +265,7 @@ class CPU
      */
     byte getRegisterD() const
     {
-        return d;
+        return d();
     }
 
     /**
@@ -134,7 +275,7 @@ class CPU
      */
     void setRegisterD(byte value)
     {
-        d = value;
+        d() = value;
     }
 
     /**
@@ -143,7 +284,7 @@ class CPU
      */
     byte getRegisterE() const
     {
-        return e;
+        return e();
     }
 
     /**
@@ -153,7 +294,7 @@ class CPU
      */
     void setRegisterE(byte value)
     {
-        e = value;
+        e() = value;
     }
 
     /**
@@ -162,7 +303,7 @@ class CPU
      */
     byte getRegisterH() const
     {
-        return h;
+        return h();
     }
 
     /**
@@ -172,7 +313,7 @@ class CPU
      */
     void setRegisterH(byte value)
     {
-        h = value;
+        h() = value;
     }
 
     /**
@@ -181,7 +322,7 @@ class CPU
      */
     byte getRegisterL() const
     {
-        return l;
+        return l();
     }
 
     /**
@@ -191,7 +332,85 @@ class CPU
      */
     void setRegisterL(byte value)
     {
-        l = value;
+        l() = value;
+    }
+
+    /**
+     * Get the current value of the 16 bits register AF.
+     * @return the value of the register
+     */
+    word getRegisterAF() const
+    {
+        return static_cast<word>((a() << 8) | getFlag());
+    }
+
+    /**
+     * Set the value of register AF,
+     * the 4 lower bits of the flag register are always 0.
+     *
+     * @param value     The value to set.
+     */
+    void setRegisterAF(word value)
+    {
+        _lazyFlags.operation = FlagsOperation::NONE;
+        _af.value() = value & 0xFFF0;
+    }
+
+    /**
+     * Get the current value of the 16 bits register BC.
+     * @return the value of the register
+     */
+    word getRegisterBC() const
+    {
+        return _bc.value();
+    }
+
+    /**
+     * Set the value of register BC.
+     *
+     * @param value     The value to set.
+     */
+    void setRegisterBC(word value)
+    {
+        _bc.value() = value;
+    }
+
+    /**
+     * Get the current value of the 16 bits register DE.
+     * @return the value of the register
+     */
+    word getRegisterDE() const
+    {
+        return _de.value();
+    }
+
+    /**
+     * Set the value of register DE.
+     *
+     * @param value     The value to set.
+     */
+    void setRegisterDE(word value)
+    {
+        _de.value() = value;
+    }
+
+    /**
+     * Get the current value of the 16 bits register HL.
+     * @return the value of the register
+     */
+    word getRegisterHL() const
+    {
+        return _hl.value();
+    }
+
+    /**
+     * Set the value of register HL.
+     *
+     * @param value     The value to set.
+     */
+    void setRegisterHL(word value)
+    {
+        _hl.value() = value;
     }
 
     /**
@@ -390,7 +609,14 @@ class CPU
 
   private:
     /**
-     * Execute an instruction that is part of the standard instruction set.
+     * Handlers of the instructions, specialized for each opcode at compile time.
+     * See cpu/instruction_handlers.hpp.
+     */
+    struct InstructionHandlers;
+
+    /**
+     * Execute an instruction that is part of the standard instruction set,
+     * the instruction is dispatched to its handler through a table indexed by the opcode.
      *
      * @throws UnhandledInstructionException if the given instruction is not handled by the CPU
      * @param opCode the opcode of the instruction to execute
@@ -398,68 +624,177 @@ class CPU
     void executeInstruction(const byte& opCode);
 
     /**
-     * Execute an instruction that is part of the extended instruction set.
+     * Execute an instruction that is part of the extended instruction set,
+     * the instruction is dispatched to the kernel of its group, which decodes the bit and the operand from the opcode.
      *
-     * @throws UnhandledExtendedInstructionException if the given instruction is not handled by the CPU
      * @param opCode the opcode of the instruction to execute
      */
     void executeExtendedInstruction(const byte& opCode);
 
     /**
-     * Perform no operation.
+     * Is the instruction at the program counter the next one of the current block.
      *
-     * @opcodes:
-     *     0x00
-     * @flags_affected: N/A
-     * @number_of_ticks: 1
+     * @return true if the instruction can be executed from the current block, false if a block needs to be entered
      */
-    void NoOperation();
+    bool isNextInstructionInCurrentBlock() const;
+
+    /**
+     * Enter the block starting at the program counter, following the link from the previous block if there is one,
+     * and execute its compiled code if it has some.
+     *
+     * @return the number of ticks taken by the compiled code, 0 if no instruction was executed
+     */
+    int enterBlock();
+
+    /**
+     * Execute the next instruction of the current block in place, with its handler resolved when the block was
+     * entered for the first time. Falls back to the interpreter if the memory at the program counter cannot be cached.
+     */
+    void executeCachedInstruction();
+
+    /**
+     * Execute the blocks linked from the current one, in place or with their compiled code,
+     * until the next event of the other components: the instructions executed before it are reported
+     * at once to the instruction executed callback. Stops at the end of a block once the event or the given number
+     * of ticks is reached, when there is no block at the program counter, when the idle loop detector observes
+     * a loop, or before an instruction that needs to go through fetchDecodeAndExecute().
+     *
+     * @param maxTicks The number of ticks after which no other instruction is started
+     * @return the number of ticks taken by the executed instructions, -1 if no instruction was executed
+     */
+    int executeCachedBlocks(int maxTicks);
+
+    /**
+     * Execute the rest of the current block in place, like executeCachedInstruction().
+     * Stops at the end of the block, once the given number of ticks is reached,
+     * or before an instruction that needs to go through fetchDecodeAndExecute():
+     * an interrupt to handle, the CPU halted, the interrupts being enabled, or the block modified.
+     *
+     * @param maxTicks The number of ticks after which no other instruction is started
+     * @return the number of ticks taken by the executed instructions
+     */
+    int executeCachedBlock(int maxTicks);
+
+    /**
+     * Execute the compiled code of a block, either recompiled ahead of time
+     * or compiled by the JIT, in which case it's compiled first if it's executed often enough.
+     *
+     * @param block The block entered
+     * @return the number of ticks taken by the executed instructions, 0 if no instruction was executed
+     */
+    int executeCompiledBlock(BasicBlock& block);
+
+    /**
+     * Call the instruction executed callback if there is one.
+     * While the ticks are deferred, the instructions ending before the next event of the other components
+     * are only counted, they are reported with the instruction reaching the event.
+     *
+     * @param ticks The number of ticks taken by the instruction
+     */
+    void notifyInstructionExecuted(int ticks)
+    {
+        if (_deferrableTicks > 0)
+        {
+            if (_pendingTicks + ticks < _deferrableTicks)
+            {
+                _pendingTicks += ticks;
+                return;
+            }
+            flushPendingTicks();
+        }
+
+        if (_instructionExecutedCallback)
+        {
+            _instructionExecutedCallback(ticks);
+        }
+    }
+
+    /**
+     * Defer the report of the instructions executed until the next event of the other components,
+     * see notifyInstructionExecuted().
+     *
+     * @return the number of ticks until the event, 0 if the instructions are reported one by one
+     */
+    int deferTicksUntilNextEvent()
+    {
+        _deferrableTicks = _nextEventCallback ? _nextEventCallback() : 0;
+        return _deferrableTicks;
+    }
+
+    /**
+     * Fetch the 8 bits immediate operand of the current instruction and move the program counter after it.
+     *
+     * @return the value of the operand
+     */
+    byte fetchImmediateByte()
+    {
+        if (_decodedInstruction != nullptr)
+        {
+            pc++;
+            return static_cast<byte>(_decodedInstruction->operand);
+        }
+
+        return mmu.read(pc++);
+    }
 
     /**
-     * Load the 16 bits pointed by the program counter into registers.
+     * Fetch the 16 bits immediate operand of the current instruction and move the program counter after it.
+     *
+     * @return the value of the operand
+     */
+    word fetchImmediateWord()
+    {
+        if (_decodedInstruction != nullptr)
+        {
+            pc += 2;
+            return _decodedInstruction->operand;
+        }
+
+        word value = mmu.readWord(pc);
+        pc += 2;
+        return value;
+    }
+
+    /**
+     * Perform no operation.
      *
-     * @param msbRegister the register that will be set to the 8 bit MSB of the value.
-     * @param lsbRegister the register that will be set to the 8 bit LSB of the value.
      * @opcodes:
-     *     0x01 0x11 0x21 0x31
+     *     0x00
      * @flags_affected: N/A
-     * @number_of_ticks: 3
+     * @number_of_ticks: 1
      */
-    void load16BitsValueInRegisters(byte& msbRegister, byte& lsbRegister);
+    void NoOperation();
 
     /**
      * Load a 16 bits register + an immediate signed offset into another 16 bits register.
      *
-     * @param msbRegister   the register that will be set to the 8 bit MSB of the value.
-     * @param lsbRegister   the register that will be set to the 8 bit LSB of the value.
+     * @param reg           the register where to load the value
      * @param otherReg      The register containing the value to load
      * @opcodes:
      *     0xF8
      * @flags_affected: Zero, Substraction, Half-carry, Carry
      * @number_of_ticks: 3
      */
-    void load16BitsRegisterAndImmediateOffsetIn16BitsRegister(byte& msbRegister, byte& lsbRegister, word otherReg);
+    void load16BitsRegisterAndImmediateOffsetIn16BitsRegister(word& reg, word otherReg);
 
     /**
-     * Load two 8 bits register into a 16 bits register.
+     * Load a 16 bits register into another 16 bits register.
      *
      * @param reg      The register where to load the value
-     * @param msbValue   the msb value to use.
-     * @param lsbValue   the lsb value to use.
-
+     * @param value    the value to load
      * @opcodes:
      *     0xF9
      * @flags_affected: N/A
      * @number_of_ticks: 2
      */
-    void loadTwo8BitsRegisterIn16BitsRegister(word& reg, byte msbValue, byte lsbValue);
+    void load16BitsRegisterIn16BitsRegister(word& reg, word value);
 
     /**
      * Load the 16 bits immediate value into the given register.
      *
      * @param reg   the register in which to load the value
      * @opcodes:
-     *     0x31
+     *     0x01 0x11 0x21 0x31
      * @flags_affected: N/A
      * @number_of_ticks: 3
      */
@@ -512,96 +847,89 @@ class CPU
     /**
      * Load the given value to the memory pointed by the given address.
      *
-     * @param addrMsb   the MSB part of the address
-     * @param addrLsb   the LSB part of the address
+     * @param addr      the address
      * @param value     the value to load in memory
      * @opcodes:
      *     0x02 0x12 0x70 0x71 0x72 0x73 0x74 0x75 0x76
      * @flags_affected: N/A
      * @number_of_ticks: 2
      */
-    void loadValueToMemoryAtAddr(byte addrMsb, byte addrLsb, byte value);
+    void loadValueToMemoryAtAddr(word addr, byte value);
 
     /**
      * Load the 8 bits immediate value into memory at the given address.
      *
-     * @param addrMsb   the MSB part of the address
-     * @param addrLsb   the LSB part of the address
+     * @param addr      the address
      * @opcodes:
      *     0x36
      * @flags_affected: N/A
      * @number_of_ticks: 3
      */
-    void load8BitsImmediateValueAtMemoryAddress(byte addrMsb, byte addrLsb);
+    void load8BitsImmediateValueAtMemoryAddress(word addr);
 
     /**
      * Load the given value to the memory pointed by the given address and
      * increment the address.
      *
-     * @param addrMsb   the MSB part of the address
-     * @param addrLsb   the LSB part of the address
+     * @param addr      the address
      * @param value     the value to load in memory
      * @opcodes:
      *     0x22
      * @flags_affected: N/A
      * @number_of_ticks: 2
      */
-    void loadValueToMemoryAndIncrementAddr(byte& addrMsb, byte& addrLsb, byte value);
+    void loadValueToMemoryAndIncrementAddr(word& addr, byte value);
 
     /**
      * Load value from memory into the given register and
      * increment the address.
      *
      * @param reg       the register where to load the value
-     * @param addrMsb   the MSB part of the address
-     * @param addrLsb   the LSB part of the address
+     * @param addr      the address
      * @opcodes:
      *     0x2A
      * @flags_affected: N/A
      * @number_of_ticks: 2
      */
-    void loadValueFromMemoryAndIncrementAddr(byte& reg, byte& addrMsb, byte& addrLsb);
+    void loadValueFromMemoryAndIncrementAddr(byte& reg, word& addr);
 
     /**
      * Load value from memory into the given register and
      * decrement the address.
      *
      * @param reg       the register where to load the value
-     * @param addrMsb   the MSB part of the address
-     * @param addrLsb   the LSB part of the address
+     * @param addr      the address
      * @opcodes:
      *     0x3A
      * @flags_affected: N/A
      * @number_of_ticks: 2
      */
-    void loadValueFromMemoryAndDecreaseAddr(byte& reg, byte& addrMsb, byte& addrLsb);
+    void loadValueFromMemoryAndDecreaseAddr(byte& reg, word& addr);
 
     /**
      * Load the given value to the memory pointed by the given address and
      * decrement the address.
      *
-     * @param addrMsb   the MSB part of the address
-     * @param addrLsb   the LSB part of the address
+     * @param addr      the address
      * @param value     the value to load in memory
      * @opcodes:
      *     0x32
      * @flags_affected: N/A
      * @number_of_ticks: 2
      */
-    void loadValueToMemoryAndDecreaseAddr(byte& addrMsb, byte& addrLsb, byte value);
+    void loadValueToMemoryAndDecreaseAddr(word& addr, byte value);
 
     /**
      * Load the value from memory at the given address into the given register.
      *
      * @param reg       The 8 bits register where the value will be loaded
-     * @param addrMsb   The msb of the address
-     * @param addrLsb   The lsb of the address
+     * @param addr      the address
      * @opcodes:
      *     0x46 0x56 0x66 0x0A 0x1A 0x4E 0x5E 0x6E 0x7E
      * @flags_affected: N/A
      * @number_of_ticks: 2
      */
-    void loadValueFromMemoryInto8BitsRegister(byte& reg, byte addrMsb, byte addrLsb);
+    void loadValueFromMemoryInto8BitsRegister(byte& reg, word addr);
 
     /**
      * Load an 8 value into into an 8 bit register.
@@ -618,24 +946,12 @@ class CPU
      */
     void load8BitsValueInRegister(byte& reg, byte value);
 
-    /**
-     * Increment the 16 bits value of the register made of two 8 bits registers.
-     *
-     * @param msbRegister   the MSB register
-     * @param lsbRegister   the LSB register
-     * @opcodes:
-     *     0x03 0x13 0x23
-     * @flags_affected: N/A
-     * @number_of_ticks: 2
-     */
-    void incrementRegistersValue(byte& msbRegister, byte& lsbRegister);
-
     /**
      * Increment the 16 bits value of the register.
      *
      * @param reg   the register to increment
      * @opcodes:
-     *     0x33
+     *     0x03 0x13 0x23 0x33
      * @flags_affected: N/A
      * @number_of_ticks: 2
      */
@@ -644,14 +960,13 @@ class CPU
     /**
      * Increment the value in memory pointed by the given address.
      *
-     * @param addrMsb   the MSB part of the address
-     * @param addrLsb   the LSB part of the address
+     * @param addr      the address
      * @opcodes:
      *     0x34
      * @flags_affected: Zero, Half-carry, Substraction
      * @number_of_ticks: 3
      */
-    void incrementValueInMemoryAtAddr(byte addrMsb, byte addrLsb);
+    void incrementValueInMemoryAtAddr(word addr);
 
     /**
      * Increment the 8 bits value of the register.
@@ -667,14 +982,13 @@ class CPU
     /**
      * Decrement the value in memory pointed by the given address.
      *
-     * @param addrMsb   the MSB part of the address
-     * @param addrLsb   the LSB part of the address
+     * @param addr      the address
      * @opcodes:
      *     0x35
      * @flags_affected: Zero, Half-carry, Substraction
      * @number_of_ticks: 3
      */
-    void decrementValueInMemoryAtAddr(byte addrMsb, byte addrLsb);
+    void decrementValueInMemoryAtAddr(word addr);
 
     /**
      * Decrement the 8 bits value of the register.
@@ -687,24 +1001,12 @@ class CPU
      */
     void decrementRegisterValue(byte& reg);
 
-    /**
-     * Decrement the 16 bits value of the register made of two 8 bits registers.
-     *
-     * @param msbRegister   the MSB register
-     * @param lsbRegister   the LSB register
-     * @opcodes:
-     *     0x0B 0x1B 0x2B
-     * @flags_affected: N/A
-     * @number_of_ticks: 2
-     */
-    void decrementRegistersValue(byte& msgRegister, byte& lsbRegister);
-
     /**
      * Decrement the 16 bits value of the register.
      *
-     * @param reg   the register to increment
+     * @param reg   the register to decrement
      * @opcodes:
-     *     0x3B
+     *     0x0B 0x1B 0x2B 0x3B
      * @flags_affected: N/A
      * @number_of_ticks: 2
      */
@@ -747,14 +1049,13 @@ class CPU
      * Rotate left circularly for a value in memory.
      * See {@link #rotateRegisterLeftCircular(byte&)} for details.
      *
-     * @param addrMsb   the msb part of the address where to perform the operation
-     * @param addrLsb   the Lsb part of the address where to perform the operation
+     * @param addr      the address where to perform the operation
      * @opcodes:
      *     0x06
      * @flags_affected: Zero, Carry, Half-carry, Substraction
      * @number_of_ticks: 4
      */
-    void rotateValueInMemoryLeftCircular(byte addrMsb, byte addrLsb);
+    void rotateValueInMemoryLeftCircular(word addr);
 
     /**
      * Rotate circularly the value inside the given register to the
@@ -793,14 +1094,13 @@ class CPU
      * Rotate right circularly for a value in memory.
      * See {@link #rotateRegisterRightCircular(byte&)} for details.
      *
-     * @param addrMsb   the msb part of the address where to perform the operation
-     * @param addrLsb   the Lsb part of the address where to perform the operation
+     * @param addr      the address where to perform the operation
      * @opcodes:
      *     0x0E
      * @flags_affected: Zero, Carry, Half-carry, Substraction
      * @number_of_ticks: 4
      */
-    void rotateValueInMemoryRightCircular(byte addrMsb, byte addrLsb);
+    void rotateValueInMemoryRightCircular(word addr);
 
     /**
      * Rotate the value inside the given register to the
@@ -843,14 +1143,13 @@ class CPU
      * Rotate left a value in memory.
      * See {@link #rotateRegisterLeftExtended(byte&)} for details.
      *
-     * @param addrMsb   the msb part of the address where to perform the operation
-     * @param addrLsb   the Lsb part of the address where to perform the operation
+     * @param addr      the address where to perform the operation
      * @opcodes:
      *     0x16
      * @flags_affected: Zero, Carry, Half-carry, Substraction
      * @number_of_ticks: 4
      */
-    void rotateValueInMemoryLeft(byte addrMsb, byte addrLsb);
+    void rotateValueInMemoryLeft(word addr);
 
     /**
      * Rotate the value inside the given register to the
@@ -894,14 +1193,13 @@ class CPU
      * Rotate right a value in memory.
      * See {@link #rotateRegisterRightExtended(byte&)} for details.
      *
-     * @param addrMsb   the msb part of the address where to perform the operation
-     * @param addrLsb   the Lsb part of the address where to perform the operation
+     * @param addr      the address where to perform the operation
      * @opcodes:
      *     0x1E
      * @flags_affected: Zero, Carry, Half-carry, Substraction
      * @number_of_ticks: 4
      */
-    void rotateValueInMemoryRight(byte addrMsb, byte addrLsb);
+    void rotateValueInMemoryRight(word addr);
 
     /**
      * Shift left arithmetic of a register.
@@ -1111,20 +1409,16 @@ class CPU
     void setBitInMemory(word memoryAddr, byte bitPosition);
 
     /**
-     * Arithmetic operation of adding the 16 bits value made from two
-     * 8 bits register (YZ) to another two 8 bits register (WX)
+     * Arithmetic operation of adding a 16 bits value to a 16 bits register.
      *
-     * @param resultRegMsb    the msb of the register where the value will be added
-     * @param resultRegLsb    the lsb of the register where the value will be added
-     * @param valueRegMsb     the msb of the register containing the value to add
-     * @param valueRegLsb     the lsb of the register containing the value to add
+     * @param reg       the register where the value will be added
+     * @param value     the value to add
      * @opcodes:
      *     0x09 0x19 0x29 0x39
      * @flags_affected: Carry, Half-carry, Substraction
      * @number_of_ticks: 2
      */
-    void addTwo8BitsRegistersToTwo8BitsRegisters(byte& resultRegMsb, byte& resultRegLsb, byte valueRegMsb,
-                                                 byte valueRegLsb);
+    void add16BitsValueTo16BitsRegister(word& reg, word value);
 
     /**
      * Arithmetic add an 8 bits value to an 8 bits register
@@ -1153,14 +1447,13 @@ class CPU
      * Arithmetic add value from memory to an 8 bits register
      *
      * @param reg      the register to add the value to
-     * @param addrMsb   the msb part of the address where the value is stored
-     * @param addrLsb   the Lsb part of the address where the value is stored
+     * @param addr      the address where the value is stored
      * @opcodes:
      *     0x86
      * @flags_affected: Zero, Carry, Half-carry, Substraction
      * @number_of_ticks: 2
      */
-    void addValueFromMemoryTo8BitsRegister(byte& reg, byte addrMsb, byte addrLsb);
+    void addValueFromMemoryTo8BitsRegister(byte& reg, word addr);
 
     /**
      * Arithmetic add an 8 bits value and the carry to an 8 bits register
@@ -1189,14 +1482,13 @@ class CPU
      * Arithmetic add value from memory and carry to an 8 bits register
      *
      * @param reg      the register to add the value to
-     * @param addrMsb   the msb part of the address where the value is stored
-     * @param addrLsb   the Lsb part of the address where the value is stored
+     * @param addr      the address where the value is stored
      * @opcodes:
      *     0x8E
      * @flags_affected: Zero, Carry, Half-carry, Substraction
      * @number_of_ticks: 2
      */
-    void addValueFromMemoryAndCarryTo8BitsRegister(byte& reg, byte addrMsb, byte addrLsb);
+    void addValueFromMemoryAndCarryTo8BitsRegister(byte& reg, word addr);
 
     /**
      * Arithmetic subtract an 8 bits value from an 8 bits register
@@ -1225,14 +1517,13 @@ class CPU
      * Arithmetic substract value in memory from an 8 bits register
      *
      * @param reg      the register to substract the value from
-     * @param addrMsb   the msb part of the address where the value is stored
-     * @param addrLsb   the Lsb part of the address where the value is stored
+     * @param addr      the address where the value is stored
      * @opcodes:
      *     0x96
      * @flags_affected: Zero, Carry, Half-carry, Substraction
      * @number_of_ticks: 2
      */
-    void substractValueInMemoryFrom8BitsRegister(byte& reg, byte addrMsb, byte addrLsb);
+    void substractValueInMemoryFrom8BitsRegister(byte& reg, word addr);
 
     /**
      * Arithmetic substract an 8 bits value and the carry from an 8 bits register
@@ -1261,14 +1552,13 @@ class CPU
      * Arithmetic subtract a value from memory and the carry from an 8 bits register
      *
      * @param reg      the register to substract the value from
-     * @param addrMsb   the msb part of the address where the value is stored
-     * @param addrLsb   the Lsb part of the address where the value is stored
+     * @param addr      the address where the value is stored
      * @opcodes:
      *     0x9E
      * @flags_affected: Zero, Carry, Half-carry, Substraction
      * @number_of_ticks: 2
      */
-    void subValueFromMemoryAndCarryTo8BitsRegister(byte& reg, byte addrMsb, byte addrLsb);
+    void subValueFromMemoryAndCarryTo8BitsRegister(byte& reg, word addr);
 
     /**
      * Logical "AND" between the accumulator and an 8 bits register.
@@ -1296,14 +1586,13 @@ class CPU
     /**
      * Logical "AND" between the accumulator and a value in memory.
      *
-     * @param addrMsb   the msb part of the address where the second operand is stored
-     * @param addrLsb   the Lsb part of the address where the second operand is stored
+     * @param addr      the address where the second operand is stored
      * @opcodes:
      *     0xA6
      * @flags_affected: Zero, Carry, Half-carry, Substraction
      * @number_of_ticks: 2
      */
-    void logicalAndBetweenAccumulatorAndValueInMemory(byte addrMsb, byte addrLsb);
+    void logicalAndBetweenAccumulatorAndValueInMemory(word addr);
 
     /**
      * Logical "XOR" between the accumulator and an 8 bits register.
@@ -1331,14 +1620,13 @@ class CPU
     /**
      * Logical "XOR" between the accumulator and a value in memory.
      *
-     * @param addrMsb   the msb part of the address where the second operand is stored
-     * @param addrLsb   the Lsb part of the address where the second operand is stored
+     * @param addr      the address where the second operand is stored
      * @opcodes:
      *     0xAE
      * @flags_affected: Zero, Carry, Half-carry, Substraction
      * @number_of_ticks: 2
      */
-    void logicalXorBetweenAccumulatorAndValueInMemory(byte addrMsb, byte addrLsb);
+    void logicalXorBetweenAccumulatorAndValueInMemory(word addr);
 
     /**
      * Logical "OR" between the accumulator and an 8 bits register.
@@ -1366,14 +1654,13 @@ class CPU
     /**
      * Logical "OR" between the accumulator and a value in memory.
      *
-     * @param addrMsb   the msb part of the address where the second operand is stored
-     * @param addrLsb   the Lsb part of the address where the second operand is stored
+     * @param addr      the address where the second operand is stored
      * @opcodes:
      *     0xB6
      * @flags_affected: Zero, Carry, Half-carry, Substraction
      * @number_of_ticks: 2
      */
-    void logicalOrBetweenAccumulatorAndValueInMemory(byte addrMsb, byte addrLsb);
+    void logicalOrBetweenAccumulatorAndValueInMemory(word addr);
 
     /**
      * Compare the accumulator with the value of a register.
@@ -1395,14 +1682,13 @@ class CPU
      * If the accumulator is greater than the value, "Half carry" flag is set
      * If the accumulator is smaller than the value, "Carry" flag is set
      *
-     * @param addrMsb   the msb part of the address where the value is stored
-     * @param addrLsb   the Lsb part of the address where the value is stored
+     * @param addr      the address where the value is stored
      * @opcodes:
      *     0xBE
      * @flags_affected: Zero, Carry, Half-carry, Substraction
      * @number_of_ticks: 2
      */
-    void compareAccumulatorAndValueInMemory(byte addrMsb, byte addrLsb);
+    void compareAccumulatorAndValueInMemory(word addr);
 
     /**
      * Compare the accumulator with an immediate value.
@@ -1418,17 +1704,16 @@ class CPU
     void compareAccumulatorAndImmediateValue();
 
     /**
-     * Pop contents from the memory stack into register pairs.
+     * Pop contents from the memory stack into a register pair.
      *
-     * @param regMsb   the register where the msb will be stored
-     * @param regLsb   the register where the lsb will be stored
+     * @param reg   the register pair where the value will be stored
      *
      * @opcodes:
      *     0xC1 0xD1 0xE1 0xF1
      * @flags_affected: N/A
      * @number_of_ticks: 3
      */
-    void popMemoryIntoRegisterPair(byte& regMsb, byte& regLsb);
+    void popMemoryIntoRegisterPair(word& reg);
 
     /**
      * Stop system clock and oscillator circuit.
@@ -1554,15 +1839,14 @@ class CPU
     /**
      * Jump to the address pointed by the program counter
      *
-     * @param addrMsb   the msb part of the address
-     * @param addrLsb   the Lsb part of the address
+     * @param addr      the address
      *
      * @opcodes:
      *     0xE9
      * @flags_affected: N/A
      * @number_of_ticks: 1
      */
-    void jumpToAddrIn16BitsRegister(byte addrMsb, byte addrLsb);
+    void jumpToAddrIn16BitsRegister(word addr);
 
     /**
      * Adjusts the sum of two packed BCD values to create a packed BCD result.
@@ -1608,15 +1892,14 @@ class CPU
     /**
      * Push the content of a register pair onto the stack pointer.
      *
-     * @param regMsb   the register containing the msb that will be pushed on the sp
-     * @param regLsb   the register containing the lsb that will be pushed on the sp
+     * @param value   the value of the register pair that will be pushed on the sp
      *
      * @opcodes:
      *     0xC5 0xD5 0xE5 0xF5
      * @flags_affected: N/A
      * @number_of_ticks: 4
      */
-    void push16BitsOntoStackPointer(byte regMsb, byte regLsb);
+    void push16BitsOntoStackPointer(word value);
 
     /**
      * Call one of the predefined restart routine.
@@ -1698,17 +1981,159 @@ class CPU
      */
     void resetFlags();
 
-    // internal registers
-    byte a{};
-    byte b{};
-    byte c{};
-    byte d{};
-    byte e{};
-    byte h{};
-    byte l{};
+    /**
+     * The arithmetic and logical operations whose flags are only computed when they are read.
+     */
+    enum class FlagsOperation : byte
+    {
+        NONE,
+        ADD,
+        SUB,
+        AND,
+        OR_XOR,
+        INCREMENT,
+        DECREMENT
+    };
+
+    /**
+     * The last operation that affected the flags along with its operands.
+     * Most of the time, the flags set by an operation are overwritten by the next one before being read,
+     * so instead of computing them eagerly, the operation is recorded and the flags are computed on read.
+     */
+    struct LazyFlags
+    {
+        FlagsOperation operation = FlagsOperation::NONE;
+        /**
+         * The left operand for ADD/SUB, the result for the other operations
+         */
+        byte lhs = 0;
+        byte rhs = 0;
+        /**
+         * The carry taken into account by ADC/SBC
+         */
+        byte carry = 0;
+    };
+
+    /**
+     * Record an operation whose flags will be computed when they are read.
+     * All the flags are affected by the operation, except the carry for INC/DEC.
+     */
+    void setLazyFlags(FlagsOperation operation, byte lhs, byte rhs = 0, byte carry = 0)
+    {
+        if (operation == FlagsOperation::INCREMENT || operation == FlagsOperation::DECREMENT)
+        {
+            // The carry is kept from the previous operation
+            materializeFlags();
+        }
+        _lazyFlags = {operation, lhs, rhs, carry};
+    }
+
+    /**
+     * Compute the flags of the recorded operation and store them in the flag register.
+     * This needs to be called before accessing the flag register directly.
+     */
+    void materializeFlags()
+    {
+        if (_lazyFlags.operation != FlagsOperation::NONE)
+        {
+            f() = computeLazyFlags();
+            _lazyFlags.operation = FlagsOperation::NONE;
+        }
+    }
+
+    /**
+     * Compute the value of the flag register from the recorded operation.
+     */
+    byte computeLazyFlags() const;
+
+    // internal registers, the 8 bits registers are views on the pairs
+    RegisterPair _af;
+    RegisterPair _bc;
+    RegisterPair _de;
+    RegisterPair _hl;
+
+    byte& a()
+    {
+        return _af.msb();
+    }
+
+    const byte& a() const
+    {
+        return _af.msb();
+    }
+
+    byte& b()
+    {
+        return _bc.msb();
+    }
+
+    const byte& b() const
+    {
+        return _bc.msb();
+    }
+
+    byte& c()
+    {
+        return _bc.lsb();
+    }
+
+    const byte& c() const
+    {
+        return _bc.lsb();
+    }
+
+    byte& d()
+    {
+        return _de.msb();
+    }
+
+    const byte& d() const
+    {
+        return _de.msb();
+    }
+
+    byte& e()
+    {
+        return _de.lsb();
+    }
+
+    const byte& e() const
+    {
+        return _de.lsb();
+    }
+
+    byte& h()
+    {
+        return _hl.msb();
+    }
+
+    const byte& h() const
+    {
+        return _hl.msb();
+    }
+
+    byte& l()
+    {
+        return _hl.lsb();
+    }
+
+    const byte& l() const
+    {
+        return _hl.lsb();
+    }
+
+    // flag register, only up to date when no operation is recorded in _lazyFlags
+    byte& f()
+    {
+        return _af.lsb();
+    }
+
+    const byte& f() const
+    {
+        return _af.lsb();
+    }
 
-    // flag register
-    byte f{};
+    LazyFlags _lazyFlags;
 
     // current CPU tick
     int tick;
@@ -1728,15 +2153,102 @@ class CPU
     // Whether of not the CPU is halted
     bool halted;
 
-    // Whether or not interrupts are enabled
-    bool interruptsEnabled;
-
+    // Whether or not the interrupts will be enabled before the next instruction (EI is delayed by one instruction)
     bool interruptsEnabledRequested;
 
     /**
      * The interrupt manager used by the CPU.
      */
     InterruptManager _interruptManager;
+
+    /**
+     * The way the CPU executes instructions.
+     */
+    ExecutionMode _executionMode = ExecutionMode::INTERPRETER;
+
+    /**
+     * The cache of decoded basic blocks, used by the cached interpreter.
+     */
+    BasicBlockCache _basicBlockCache;
+
+    /**
+     * The block being executed by the cached interpreter, only valid during the epoch it was retrieved in.
+     * Once its last instruction is executed, the next block is linked to it.
+     */
+    BasicBlock* _currentBlock = nullptr;
+
+    /**
+     * The index in the current block of the next instruction to execute.
+     */
+    size_t _currentBlockIndex = 0;
+
+    /**
+     * The epoch of the cache when the current block was retrieved.
+     */
+    uint32_t _currentBlockEpoch = 0;
+
+    /**
+     * The decoded instruction being executed, its operands are used instead of the memory.
+     * nullptr when the instruction is read from memory.
+     */
+    const DecodedInstruction* _decodedInstruction = nullptr;
+
+    /**
+     * The instruction executed by the code recompiled ahead of time, only its operand is set.
+     */
+    DecodedInstruction _recompiledInstruction;
+
+    /**
+     * The compiler used in JIT mode.
+     */
+    JitCompiler _jitCompiler;
+
+    /**
+     * The epoch of the cache when entering a compiled block.
+     */
+    uint32_t _jitEntryEpoch = 0;
+
+    /**
+     * The number of ticks taken by the instructions of the compiled block being executed.
+     */
+    int _jitExecutedTicks = 0;
+
+    /**
+     * The number of ticks after which the compiled block being executed doesn't start other instructions.
+     */
+    int _maxExecutedTicks = std::numeric_limits<int>::max();
+
+    /**
+     * The ticks taken by the instructions executed but not reported yet, see notifyInstructionExecuted().
+     */
+    int _pendingTicks = 0;
+
+    /**
+     * The number of ticks the instructions can take without being reported, until the next event
+     * of the other components, 0 when each instruction is reported.
+     */
+    int _deferrableTicks = 0;
+
+    /**
+     * The function called after each instruction.
+     */
+    InstructionExecutedCallback _instructionExecutedCallback;
+
+    /**
+     * The function giving the number of ticks until the next event of the other components.
+     */
+    NextEventCallback _nextEventCallback;
+
+    /**
+     * Detects and fast-forwards the loops polling hardware registers.
+     */
+    IdleLoopDetector _idleLoopDetector;
+
+    bool _isIdleLoopDetectionEnabled = false;
+
+    friend class JitCompiler;
+    friend class IdleLoopDetector;
+    friend class RecompiledCode;
 };
 
 #endif
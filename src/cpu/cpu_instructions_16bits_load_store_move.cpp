@@ -2,60 +2,46 @@
 
 using namespace utils;
 
-void CPU::load16BitsValueInRegisters(byte& msbRegister, byte& lsbRegister)
-{
-    lsbRegister = mmu.read(pc);
-    msbRegister = mmu.read(pc + 1);
-    pc += 2;
-    lastInstructionTicks = 3;
-}
-
 void CPU::load16BitsImmediateValueIntoRegister(word& reg)
 {
-    reg = mmu.readWord(pc);
-    pc += 2;
+    reg = fetchImmediateWord();
     lastInstructionTicks = 3;
 }
 
 void CPU::load16BitsRegisterAtImmediateAddress(word reg)
 {
-    mmu.writeWord(mmu.readWord(pc), reg);
-    pc += 2;
+    mmu.writeWord(fetchImmediateWord(), reg);
     lastInstructionTicks = 5;
 }
 
-void CPU::popMemoryIntoRegisterPair(byte& regMsb, byte& regLsb)
+void CPU::popMemoryIntoRegisterPair(word& reg)
 {
-    regLsb = mmu.read(sp);
-    regMsb = mmu.read(sp + 1);
+    reg = createWordFromBytes(mmu.read(sp + 1), mmu.read(sp));
     sp += 2;
     lastInstructionTicks = 3;
 }
 
-void CPU::push16BitsOntoStackPointer(byte regMsb, byte regLsb)
+void CPU::push16BitsOntoStackPointer(word value)
 {
     sp -= 2;
     lastInstructionTicks = 4;
-    mmu.write(sp, regLsb);
-    mmu.write(sp + 1, regMsb);
+    mmu.write(sp, getLsbFromWord(value));
+    mmu.write(sp + 1, getMsbFromWord(value));
 }
 
-void CPU::load16BitsRegisterAndImmediateOffsetIn16BitsRegister(byte& msbRegister, byte& lsbRegister, word otherReg)
+void CPU::load16BitsRegisterAndImmediateOffsetIn16BitsRegister(word& reg, word otherReg)
 {
     unsetFlag(CpuFlags::ZERO);
     unsetFlag(CpuFlags::SUBSTRACTION);
-    sbyte offset = static_cast<sbyte>(mmu.read(pc));
-    word newValue = otherReg + offset;
-    pc++;
-    msbRegister = getMsbFromWord(newValue);
-    lsbRegister = getLsbFromWord(newValue);
+    sbyte offset = static_cast<sbyte>(fetchImmediateByte());
+    reg = otherReg + offset;
     setHalfCarryFlag((((otherReg & 0xF) + (offset & 0xF)) & 0x10) == 0x10);
     setCarryFlag((((otherReg & 0xFF) + (offset & 0xFF)) & 0x100) == 0x100);
     lastInstructionTicks = 3;
 }
 
-void CPU::loadTwo8BitsRegisterIn16BitsRegister(word& reg, byte msbValue, byte lsbValue)
+void CPU::load16BitsRegisterIn16BitsRegister(word& reg, word value)
 {
-    reg = createWordFromBytes(msbValue, lsbValue);
+    reg = value;
     lastInstructionTicks = 2;
 }
\ No newline at end of file
@@ -8,48 +8,36 @@ void CPU::incrementRegisterValue(word& reg)
     lastInstructionTicks = 2;
 }
 
-void CPU::incrementValueInMemoryAtAddr(byte addrMsb, byte addrLsb)
+void CPU::incrementValueInMemoryAtAddr(word addr)
 {
-    unsetFlag(CpuFlags::SUBSTRACTION);
-    word addr = createWordFromBytes(addrMsb, addrLsb);
     byte oldvalue = mmu.read(addr);
     byte value = oldvalue + 1;
     mmu.write(addr, value);
-    changeZeroValueFlag(value);
-    setHalfCarryFlag((value & 0x0F) == 0x00);
+    setLazyFlags(FlagsOperation::INCREMENT, value);
 
     lastInstructionTicks = 3;
 }
 
-void CPU::decrementValueInMemoryAtAddr(byte addrMsb, byte addrLsb)
+void CPU::decrementValueInMemoryAtAddr(word addr)
 {
-    setFlag(CpuFlags::SUBSTRACTION);
-    word addr = createWordFromBytes(addrMsb, addrLsb);
     byte oldvalue = mmu.read(addr);
     byte value = oldvalue - 1;
     mmu.write(addr, value);
-    changeZeroValueFlag(value);
-    setHalfCarryFlag((value & 0x0F) == 0x0F);
+    setLazyFlags(FlagsOperation::DECREMENT, value);
     lastInstructionTicks = 3;
 }
 
 void CPU::incrementRegisterValue(byte& reg)
 {
-    unsetFlag(CpuFlags::SUBSTRACTION);
-
     reg++;
-    setHalfCarryFlag((reg & 0x0F) == 0x00);
-    changeZeroValueFlag(reg);
+    setLazyFlags(FlagsOperation::INCREMENT, reg);
     lastInstructionTicks = 1;
 }
 
 void CPU::decrementRegisterValue(byte& reg)
 {
-    setFlag(CpuFlags::SUBSTRACTION);
-
     reg--;
-    setHalfCarryFlag((reg & 0x0F) == 0x0F);
-    changeZeroValueFlag(reg);
+    setLazyFlags(FlagsOperation::DECREMENT, reg);
     lastInstructionTicks = 1;
 }
 
@@ -64,14 +52,14 @@ void CPU::decimalAdjustAccumulator()
     // After an addition, adjust if (half-)carry occurred or if result is out of bounds
     if (!isFlagSet(SUBSTRACTION))
     {
-        if (isFlagSet(CpuFlags::CARRY) || a > 0x99)
+        if (isFlagSet(CpuFlags::CARRY) || a() > 0x99)
         {
-            a += 0x60;
+            a() += 0x60;
             setFlag(CpuFlags::CARRY);
         }
-        if (isFlagSet(CpuFlags::HALF_CARRY) || ((a & 0x0F) > 9))
+        if (isFlagSet(CpuFlags::HALF_CARRY) || ((a() & 0x0F) > 9))
         {
-            a += 0x06;
+            a() += 0x06;
         }
     }
     // after a subtraction, only adjust if (half-)carry occurred
@@ -79,15 +67,15 @@ void CPU::decimalAdjustAccumulator()
     {
         if (isFlagSet(CpuFlags::CARRY))
         {
-            a -= 0x60;
+            a() -= 0x60;
         }
         if (isFlagSet(CpuFlags::HALF_CARRY))
         {
-            a -= 0x06;
+            a() -= 0x06;
         }
     }
 
-    setFlagIfTrue(a == 0, CpuFlags::ZERO);
+    setFlagIfTrue(a() == 0, CpuFlags::ZERO);
     unsetFlag(CpuFlags::HALF_CARRY);
     lastInstructionTicks = 1;
 }
@@ -118,179 +106,153 @@ void CPU::complementRegister(byte& reg)
 
 void CPU::addImmediateValueTo8BitsRegister(byte& reg)
 {
-    add8BitsValueTo8BitsRegister(reg, mmu.read(pc++));
+    add8BitsValueTo8BitsRegister(reg, fetchImmediateByte());
     lastInstructionTicks = 2;
 }
 
 void CPU::add8BitsValueAndCarryTo8BitsRegister(byte& reg, byte value)
 {
-    unsetFlag(CpuFlags::SUBSTRACTION);
-    word result = reg + value;
-    word offset = isFlagSet(CpuFlags::CARRY) ? 1 : 0;
-    result += offset;
-    setCarryFlag(result > 0xFF);
-    setHalfCarryFlag((((reg & 0xF) + (value & 0xF) + offset) & 0x10) == 0x10);
-    reg = static_cast<byte>(result);
-    changeZeroValueFlag(reg);
+    byte offset = isFlagSet(CpuFlags::CARRY) ? 1 : 0;
+    setLazyFlags(FlagsOperation::ADD, reg, value, offset);
+    reg = static_cast<byte>(reg + value + offset);
     lastInstructionTicks = 1;
 }
 
 void CPU::addImmediateValueAndCarryTo8BitsRegister(byte& reg)
 {
-    add8BitsValueAndCarryTo8BitsRegister(reg, mmu.read(pc++));
+    add8BitsValueAndCarryTo8BitsRegister(reg, fetchImmediateByte());
     lastInstructionTicks = 2;
 }
 
-void CPU::addValueFromMemoryTo8BitsRegister(byte& reg, byte addrMsb, byte addrLsb)
+void CPU::addValueFromMemoryTo8BitsRegister(byte& reg, word addr)
 {
-    add8BitsValueTo8BitsRegister(reg, mmu.read(createWordFromBytes(addrMsb, addrLsb)));
+    add8BitsValueTo8BitsRegister(reg, mmu.read(addr));
     lastInstructionTicks = 2;
 }
 
-void CPU::addValueFromMemoryAndCarryTo8BitsRegister(byte& reg, byte addrMsb, byte addrLsb)
+void CPU::addValueFromMemoryAndCarryTo8BitsRegister(byte& reg, word addr)
 {
-    add8BitsValueAndCarryTo8BitsRegister(reg, mmu.read(createWordFromBytes(addrMsb, addrLsb)));
+    add8BitsValueAndCarryTo8BitsRegister(reg, mmu.read(addr));
     lastInstructionTicks = 2;
 }
 
 void CPU::substract8BitsValueFrom8BitsRegister(byte& reg, byte value)
 {
-    setFlag(CpuFlags::SUBSTRACTION);
-    word result = reg - value;
-    setCarryFlag(result > 0xFF);
-    setHalfCarryFlag(((reg & 0xF) - (value & 0xF)) < 0);
-    reg = static_cast<byte>(result);
-    changeZeroValueFlag(reg);
+    setLazyFlags(FlagsOperation::SUB, reg, value);
+    reg = static_cast<byte>(reg - value);
     lastInstructionTicks = 1;
 }
 
 void CPU::substractImmediateValueFrom8BitsRegister(byte& reg)
 {
-    substract8BitsValueFrom8BitsRegister(reg, mmu.read(pc++));
+    substract8BitsValueFrom8BitsRegister(reg, fetchImmediateByte());
     lastInstructionTicks = 2;
 }
 
-void CPU::substractValueInMemoryFrom8BitsRegister(byte& reg, byte addrMsb, byte addrLsb)
+void CPU::substractValueInMemoryFrom8BitsRegister(byte& reg, word addr)
 {
-    substract8BitsValueFrom8BitsRegister(reg, mmu.read(createWordFromBytes(addrMsb, addrLsb)));
+    substract8BitsValueFrom8BitsRegister(reg, mmu.read(addr));
     lastInstructionTicks = 2;
 }
 
 void CPU::sub8BitsValueAndCarryTo8BitsRegister(byte& reg, byte value)
 {
-    setFlag(CpuFlags::SUBSTRACTION);
-    word result = reg - value;
-    word offset = isFlagSet(CpuFlags::CARRY) ? 1 : 0;
-    result -= offset;
-    setCarryFlag(result > 0xFF);
-    setHalfCarryFlag(((reg & 0xF) - (value & 0xF) - offset) < 0);
-    reg = static_cast<byte>(result);
-    changeZeroValueFlag(reg);
+    byte offset = isFlagSet(CpuFlags::CARRY) ? 1 : 0;
+    setLazyFlags(FlagsOperation::SUB, reg, value, offset);
+    reg = static_cast<byte>(reg - value - offset);
     lastInstructionTicks = 1;
 }
 
 void CPU::subImmediateValueAndCarryTo8BitsRegister(byte& reg)
 {
-    sub8BitsValueAndCarryTo8BitsRegister(reg, mmu.read(pc++));
+    sub8BitsValueAndCarryTo8BitsRegister(reg, fetchImmediateByte());
     lastInstructionTicks = 2;
 }
 
-void CPU::subValueFromMemoryAndCarryTo8BitsRegister(byte& reg, byte addrMsb, byte addrLsb)
+void CPU::subValueFromMemoryAndCarryTo8BitsRegister(byte& reg, word addr)
 {
-    sub8BitsValueAndCarryTo8BitsRegister(reg, mmu.read(createWordFromBytes(addrMsb, addrLsb)));
+    sub8BitsValueAndCarryTo8BitsRegister(reg, mmu.read(addr));
     lastInstructionTicks = 2;
 }
 
 void CPU::logicalAndBetweenAccumulatorAnd8BitsRegister(byte value)
 {
-    unsetFlag(CpuFlags::SUBSTRACTION);
-    setFlag(CpuFlags::HALF_CARRY);
-    unsetFlag(CpuFlags::CARRY);
-    a &= value;
-    changeZeroValueFlag(a);
+    a() &= value;
+    setLazyFlags(FlagsOperation::AND, a());
     lastInstructionTicks = 1;
 }
 
-void CPU::logicalAndBetweenAccumulatorAndValueInMemory(byte addrMsb, byte addrLsb)
+void CPU::logicalAndBetweenAccumulatorAndValueInMemory(word addr)
 {
-    logicalAndBetweenAccumulatorAnd8BitsRegister(mmu.read(createWordFromBytes(addrMsb, addrLsb)));
+    logicalAndBetweenAccumulatorAnd8BitsRegister(mmu.read(addr));
     lastInstructionTicks = 2;
 }
 
 void CPU::logicalAndBetweenAccumulatorAndImmediateValue()
 {
-    logicalAndBetweenAccumulatorAnd8BitsRegister(mmu.read(pc++));
+    logicalAndBetweenAccumulatorAnd8BitsRegister(fetchImmediateByte());
     lastInstructionTicks = 2;
 }
 
 void CPU::logicalXorBetweenAccumulatorAnd8BitsRegister(byte value)
 {
-    unsetFlag(CpuFlags::SUBSTRACTION);
-    unsetFlag(CpuFlags::HALF_CARRY);
-    unsetFlag(CpuFlags::CARRY);
-    a ^= value;
-    changeZeroValueFlag(a);
+    a() ^= value;
+    setLazyFlags(FlagsOperation::OR_XOR, a());
     lastInstructionTicks = 1;
 }
 
-void CPU::logicalXorBetweenAccumulatorAndValueInMemory(byte addrMsb, byte addrLsb)
+void CPU::logicalXorBetweenAccumulatorAndValueInMemory(word addr)
 {
-    logicalXorBetweenAccumulatorAnd8BitsRegister(mmu.read(createWordFromBytes(addrMsb, addrLsb)));
+    logicalXorBetweenAccumulatorAnd8BitsRegister(mmu.read(addr));
     lastInstructionTicks = 2;
 }
 
 void CPU::logicalXorBetweenAccumulatorAndImmediateValue()
 {
-    logicalXorBetweenAccumulatorAnd8BitsRegister(mmu.read(pc++));
+    logicalXorBetweenAccumulatorAnd8BitsRegister(fetchImmediateByte());
     lastInstructionTicks = 2;
 }
 
 void CPU::logicalOrBetweenAccumulatorAnd8BitsRegister(byte value)
 {
-    unsetFlag(CpuFlags::SUBSTRACTION);
-    unsetFlag(CpuFlags::HALF_CARRY);
-    unsetFlag(CpuFlags::CARRY);
-    a |= value;
-    changeZeroValueFlag(a);
+    a() |= value;
+    setLazyFlags(FlagsOperation::OR_XOR, a());
     lastInstructionTicks = 1;
 }
 
-void CPU::logicalOrBetweenAccumulatorAndValueInMemory(byte addrMsb, byte addrLsb)
+void CPU::logicalOrBetweenAccumulatorAndValueInMemory(word addr)
 {
-    logicalOrBetweenAccumulatorAnd8BitsRegister(mmu.read(createWordFromBytes(addrMsb, addrLsb)));
+    logicalOrBetweenAccumulatorAnd8BitsRegister(mmu.read(addr));
     lastInstructionTicks = 2;
 }
 
 void CPU::logicalOrBetweenAccumulatorAndImmediateValue()
 {
-    logicalOrBetweenAccumulatorAnd8BitsRegister(mmu.read(pc++));
+    logicalOrBetweenAccumulatorAnd8BitsRegister(fetchImmediateByte());
     lastInstructionTicks = 2;
 }
 
 void CPU::compareAccumulatorAndRegister(byte value)
 {
-    setFlag(CpuFlags::SUBSTRACTION);
-    setFlagIfTrue(a == value, CpuFlags::ZERO);
-    setHalfCarryFlag(((a & 0xf) - (value & 0xf)) < 0);
-    setCarryFlag(a < value);
+    setLazyFlags(FlagsOperation::SUB, a(), value);
     lastInstructionTicks = 1;
 }
 
-void CPU::compareAccumulatorAndValueInMemory(byte addrMsb, byte addrLsb)
+void CPU::compareAccumulatorAndValueInMemory(word addr)
 {
-    compareAccumulatorAndRegister(mmu.read(createWordFromBytes(addrMsb, addrLsb)));
+    compareAccumulatorAndRegister(mmu.read(addr));
     lastInstructionTicks = 2;
 }
 
 void CPU::compareAccumulatorAndImmediateValue()
 {
-    compareAccumulatorAndRegister(mmu.read(pc++));
+    compareAccumulatorAndRegister(fetchImmediateByte());
     lastInstructionTicks = 2;
 }
 
 bool CPU::areInterruptsEnabled() const
 {
-    return interruptsEnabled;
+    return _interruptManager.isInterruptMasterEnabled();
 }
 
 bool CPU::isHalted() const
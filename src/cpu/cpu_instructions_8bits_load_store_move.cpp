@@ -2,58 +2,56 @@
 
 using namespace utils;
 
-void CPU::loadValueToMemoryAtAddr(byte addrMsb, byte addrLsb, byte value)
+void CPU::loadValueToMemoryAtAddr(word addr, byte value)
 {
-    mmu.write(createWordFromBytes(addrMsb, addrLsb), value);
+    mmu.write(addr, value);
     lastInstructionTicks = 2;
 }
 
-void CPU::load8BitsImmediateValueAtMemoryAddress(byte addrMsb, byte addrLsb)
+void CPU::load8BitsImmediateValueAtMemoryAddress(word addr)
 {
-    byte value = mmu.read(pc);
-    pc++;
-    mmu.write(createWordFromBytes(addrMsb, addrLsb), value);
+    byte value = fetchImmediateByte();
+    mmu.write(addr, value);
     lastInstructionTicks = 3;
 }
 
 void CPU::loadImmediateValueInRegister(byte& reg)
 {
-    reg = mmu.read(pc);
-    pc++;
+    reg = fetchImmediateByte();
     lastInstructionTicks = 2;
 }
 
-void CPU::loadValueToMemoryAndIncrementAddr(byte& addrMsb, byte& addrLsb, byte value)
+void CPU::loadValueToMemoryAndIncrementAddr(word& addr, byte value)
 {
-    mmu.write(createWordFromBytes(addrMsb, addrLsb), value);
-    increment16BitsValueStoredIn8BitsValues(addrMsb, addrLsb);
+    mmu.write(addr, value);
+    addr++;
     lastInstructionTicks = 2;
 }
 
-void CPU::loadValueFromMemoryAndIncrementAddr(byte& reg, byte& addrMsb, byte& addrLsb)
+void CPU::loadValueFromMemoryAndIncrementAddr(byte& reg, word& addr)
 {
-    reg = mmu.read(createWordFromBytes(addrMsb, addrLsb));
-    increment16BitsValueStoredIn8BitsValues(addrMsb, addrLsb);
+    reg = mmu.read(addr);
+    addr++;
     lastInstructionTicks = 2;
 }
 
-void CPU::loadValueFromMemoryAndDecreaseAddr(byte& reg, byte& addrMsb, byte& addrLsb)
+void CPU::loadValueFromMemoryAndDecreaseAddr(byte& reg, word& addr)
 {
-    reg = mmu.read(createWordFromBytes(addrMsb, addrLsb));
-    decrement16BitsValueStoredIn8BitsValues(addrMsb, addrLsb);
+    reg = mmu.read(addr);
+    addr--;
     lastInstructionTicks = 2;
 }
 
-void CPU::loadValueToMemoryAndDecreaseAddr(byte& addrMsb, byte& addrLsb, byte value)
+void CPU::loadValueToMemoryAndDecreaseAddr(word& addr, byte value)
 {
-    mmu.write(createWordFromBytes(addrMsb, addrLsb), value);
-    decrement16BitsValueStoredIn8BitsValues(addrMsb, addrLsb);
+    mmu.write(addr, value);
+    addr--;
     lastInstructionTicks = 2;
 }
 
-void CPU::loadValueFromMemoryInto8BitsRegister(byte& reg, byte addrMsb, byte addrLsb)
+void CPU::loadValueFromMemoryInto8BitsRegister(byte& reg, word addr)
 {
-    reg = mmu.read(createWordFromBytes(addrMsb, addrLsb));
+    reg = mmu.read(addr);
     lastInstructionTicks = 2;
 }
 
@@ -65,51 +63,43 @@ void CPU::load8BitsValueInRegister(byte& reg, byte value)
 
 void CPU::load8BitsRegisterAtImmediateAddress(byte reg)
 {
-    mmu.write(mmu.readWord(pc), reg);
-    pc += 2;
+    mmu.write(fetchImmediateWord(), reg);
     lastInstructionTicks = 4;
 }
 
 void CPU::add8BitsValueTo8BitsRegister(byte& reg, byte value)
 {
-    unsetFlag(CpuFlags::SUBSTRACTION);
-    word result = reg + value;
-    setCarryFlag(result > 0xFF);
-    setHalfCarryFlag((((reg & 0xF) + (value & 0xF)) & 0x10) == 0x10);
-    reg = static_cast<byte>(result);
-    changeZeroValueFlag(reg);
+    setLazyFlags(FlagsOperation::ADD, reg, value);
+    reg = static_cast<byte>(reg + value);
     lastInstructionTicks = 1;
 }
 
 void CPU::loadAccumulatorInHighMemoryValue()
 {
-    mmu.write(0xFF00 | mmu.read(pc), a);
-    pc++;
+    mmu.write(0xFF00 | fetchImmediateByte(), a());
     lastInstructionTicks = 3;
 }
 
 void CPU::loadHighMemoryValueInAccumulator()
 {
-    a = mmu.read(0xFF00 | mmu.read(pc));
-    pc++;
+    a() = mmu.read(0xFF00 | fetchImmediateByte());
     lastInstructionTicks = 3;
 }
 
 void CPU::loadAccumulatorInHighMemoryValue(byte reg)
 {
-    mmu.write(0xFF00 | reg, a);
+    mmu.write(0xFF00 | reg, a());
     lastInstructionTicks = 2;
 }
 
 void CPU::loadHighMemoryValueInAccumulator(byte reg)
 {
-    a = mmu.read(0xFF00 | reg);
+    a() = mmu.read(0xFF00 | reg);
     lastInstructionTicks = 2;
 }
 
 void CPU::loadImmediate16BitsValueIn8BitsRegister(byte& reg)
 {
-    reg = mmu.read(mmu.readWord(pc));
-    pc += 2;
+    reg = mmu.read(fetchImmediateWord());
     lastInstructionTicks = 4;
 }
\ No newline at end of file
@@ -15,9 +15,8 @@ void CPU::rotateRegisterLeftCircular(byte& reg)
     lastInstructionTicks = 1;
 }
 
-void CPU::rotateValueInMemoryLeftCircular(byte addrMsb, byte addrLsb)
+void CPU::rotateValueInMemoryLeftCircular(word addr)
 {
-    word addr = createWordFromBytes(addrMsb, addrLsb);
     byte value = mmu.read(addr);
     rotateRegisterLeftCircular(value);
     mmu.write(addr, value);
@@ -38,9 +37,8 @@ void CPU::rotateRegisterRightCircular(byte& reg)
     lastInstructionTicks = 1;
 }
 
-void CPU::rotateValueInMemoryRightCircular(byte addrMsb, byte addrLsb)
+void CPU::rotateValueInMemoryRightCircular(word addr)
 {
-    word addr = createWordFromBytes(addrMsb, addrLsb);
     byte value = mmu.read(addr);
     rotateRegisterRightCircular(value);
     mmu.write(addr, value);
@@ -69,9 +67,8 @@ void CPU::rotateRegisterLeftExtended(byte& reg)
     lastInstructionTicks = 2;
 }
 
-void CPU::rotateValueInMemoryLeft(byte addrMsb, byte addrLsb)
+void CPU::rotateValueInMemoryLeft(word addr)
 {
-    word addr = createWordFromBytes(addrMsb, addrLsb);
     byte value = mmu.read(addr);
     rotateRegisterLeftExtended(value);
     mmu.write(addr, value);
@@ -99,9 +96,8 @@ void CPU::rotateRegisterRightExtended(byte& reg)
     lastInstructionTicks = 2;
 }
 
-void CPU::rotateValueInMemoryRight(byte addrMsb, byte addrLsb)
+void CPU::rotateValueInMemoryRight(word addr)
 {
-    word addr = createWordFromBytes(addrMsb, addrLsb);
     byte value = mmu.read(addr);
     rotateRegisterRightExtended(value);
     mmu.write(addr, value);
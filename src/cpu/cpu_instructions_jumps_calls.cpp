@@ -4,8 +4,7 @@ using namespace utils;
 
 void CPU::jumpConditional(bool condition)
 {
-    word addr = mmu.readWord(pc);
-    pc += 2;
+    word addr = fetchImmediateWord();
     if (condition)
     {
         pc = addr;
@@ -19,21 +18,19 @@ void CPU::jumpConditional(bool condition)
 
 void CPU::jump()
 {
-    word addr = mmu.readWord(pc);
-    pc = addr;
+    pc = fetchImmediateWord();
     lastInstructionTicks = 4;
 }
 
-void CPU::jumpToAddrIn16BitsRegister(byte addrMsb, byte addrLsb)
+void CPU::jumpToAddrIn16BitsRegister(word addr)
 {
-    pc = createWordFromBytes(addrMsb, addrLsb);
+    pc = addr;
     lastInstructionTicks = 1;
 }
 
 void CPU::jumpRelativeConditional(bool condition)
 {
-    auto offset = static_cast<int8_t>(mmu.read(pc));
-    pc++;
+    auto offset = static_cast<int8_t>(fetchImmediateByte());
     if (condition)
     {
         pc += offset;
@@ -47,8 +44,7 @@ void CPU::jumpRelativeConditional(bool condition)
 
 void CPU::jumpRelative()
 {
-    auto offset = static_cast<int8_t>(mmu.read(pc));
-    pc++;
+    auto offset = static_cast<int8_t>(fetchImmediateByte());
     pc += offset;
     lastInstructionTicks = 3;
 }
@@ -79,7 +75,7 @@ void CPU::returnInstructionConditional(bool cond)
 void CPU::returnInstructionAfterInterrupt()
 {
     returnInstruction();
-    interruptsEnabled = true;
+    _interruptManager.setInterruptMasterEnable(true);
 }
 
 void CPU::callImmediateSubroutineIfConditionSatisfied(bool condition)
@@ -97,9 +93,10 @@ void CPU::callImmediateSubroutineIfConditionSatisfied(bool condition)
 
 void CPU::callImmediateSubroutine()
 {
+    word addr = fetchImmediateWord();
     sp -= 2;
-    mmu.writeWord(sp, pc + 2);
-    pc = mmu.readWord(pc);
+    mmu.writeWord(sp, pc);
+    pc = addr;
     lastInstructionTicks = 6;
 }
 
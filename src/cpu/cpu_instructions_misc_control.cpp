@@ -14,13 +14,15 @@ void CPU::enableInterrupts()
 void CPU::disableInterrupts()
 {
     interruptsEnabledRequested = false;
-    interruptsEnabled = false;
+    _interruptManager.setInterruptMasterEnable(false);
     lastInstructionTicks = 1;
 }
 
 void CPU::stopInstruction()
 {
-    // TODO: Stop CPU properly
+    // In color mode, STOP is used to switch the speed of the CPU
+    // TODO: Stop CPU properly otherwise
+    mmu.switchSpeedIfRequested();
 
     // Stop instruction is always followed by a 0 that we need to swallow
     pc++;
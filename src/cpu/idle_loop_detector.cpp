@@ -0,0 +1,312 @@
+#include "idle_loop_detector.hpp"
+#include "cpu/cpu.hpp"
+#include "cpu/instructions.hpp"
+#include "memory/mmu.hpp"
+#include <algorithm>
+
+using namespace utils;
+
+IdleLoopDetector::IdleLoopDetector(CPU& cpu, MMU& mmu) : _cpu(cpu), _mmu(mmu)
+{
+}
+
+bool IdleLoopDetector::isPolledRegister(word addr)
+{
+    // Joypad, DIV, IF, STAT, LY
+    return addr == 0xFF00 || addr == 0xFF04 || addr == 0xFF0F || addr == 0xFF41 || addr == 0xFF44;
+}
+
+void IdleLoopDetector::onInstructionExecuted(word instructionAddress)
+{
+    if (_state == State::WAITING)
+    {
+        // Looking for a jump back to a potential loop start
+        word start = _cpu.pc;
+        if (start >= instructionAddress || instructionAddress - start > MAX_LOOP_SIZE || start == _rejectedLoopStart)
+        {
+            return;
+        }
+
+        if (!analyzeLoop(start, instructionAddress))
+        {
+            // The loop won't be analyzed again until another loop is found
+            _rejectedLoopStart = start;
+            return;
+        }
+
+        _loopStart = start;
+        startObservation();
+        return;
+    }
+
+    if (_state != State::OBSERVING ||
+        instructionAddress != _instructions[_numberOfObservedInstructions].instruction.address)
+    {
+        // The execution left the loop, an interrupt was serviced for example
+        _state = State::WAITING;
+        return;
+    }
+
+    LoopInstruction& loopInstruction = _instructions[_numberOfObservedInstructions];
+    const RegisterSnapshot& stateBefore = _numberOfObservedInstructions == 0
+                                              ? _loopStartState
+                                              : _instructions[_numberOfObservedInstructions - 1].stateAfter;
+    loopInstruction.ticks = _cpu.lastInstructionTicks;
+    loopInstruction.readAddress = getReadAddress(loopInstruction.instruction, stateBefore);
+    loopInstruction.stateAfter = takeSnapshot();
+    // All the instructions reading memory load the value in A
+    loopInstruction.readValue = loopInstruction.stateAfter.a;
+
+    if (loopInstruction.readAddress >= 0 && !isPolledRegister(static_cast<word>(loopInstruction.readAddress)))
+    {
+        _rejectedLoopStart = _loopStart;
+        _state = State::WAITING;
+        return;
+    }
+
+    _numberOfObservedInstructions++;
+    if (_numberOfObservedInstructions < _instructions.size())
+    {
+        return;
+    }
+
+    // The iteration is over, the loop is idle if it didn't change anything
+    if (_cpu.pc != _loopStart)
+    {
+        _state = State::WAITING;
+        return;
+    }
+
+    if (loopInstruction.stateAfter != _loopStartState)
+    {
+        // A polled value may have changed during the iteration, or the loop is counting
+        startObservation();
+        return;
+    }
+
+    _state = State::CONFIRMED;
+    _fastForwardIndex = 0;
+    _interruptFlag = _cpu._interruptManager.getInterruptFlag();
+    _statistics.numberOfDetectedLoops++;
+}
+
+int IdleLoopDetector::fastForward(int maxTicks)
+{
+    if (_state != State::CONFIRMED)
+    {
+        return 0;
+    }
+
+    // The previous fast-forward may have stopped in the middle of the loop
+    size_t index = _fastForwardIndex;
+    const RegisterSnapshot& stateBefore = index == 0 ? _loopStartState : _instructions[index - 1].stateAfter;
+    if (_cpu.pc != _instructions[index].instruction.address || takeSnapshot() != stateBefore)
+    {
+        reset();
+        return 0;
+    }
+
+    // The components reaching an event can raise an interrupt or complete a frame, the run checks them after it.
+    // The instructions before it are reported at once.
+    int maxSkippedTicks = std::min(maxTicks, MAX_FAST_FORWARD_TICKS);
+    int ticksUntilNextEvent = _cpu.deferTicksUntilNextEvent();
+    if (ticksUntilNextEvent > 0)
+    {
+        maxSkippedTicks = std::min(maxSkippedTicks, ticksUntilNextEvent);
+    }
+
+    int skippedTicks = 0;
+    bool isLoopExited = false;
+    while (skippedTicks < maxSkippedTicks)
+    {
+        const LoopInstruction& loopInstruction = _instructions[index];
+        // Any interrupt raised can change the control flow or the polled value (IF)
+        if (_cpu._interruptManager.getInterruptFlag() != _interruptFlag)
+        {
+            isLoopExited = true;
+            break;
+        }
+
+        if (loopInstruction.readAddress >= 0 &&
+            _mmu.read(static_cast<word>(loopInstruction.readAddress)) != loopInstruction.readValue)
+        {
+            isLoopExited = true;
+            break;
+        }
+
+        // The instruction would do exactly what it did during the observed iteration
+        _cpu.lastInstructionTicks = loopInstruction.ticks;
+        _cpu.tick += loopInstruction.ticks;
+        _cpu.notifyInstructionExecuted(loopInstruction.ticks);
+        skippedTicks += loopInstruction.ticks;
+        _statistics.skippedInstructions++;
+        index = (index + 1) % _instructions.size();
+    }
+
+    _cpu.flushPendingTicks();
+
+    // Put the CPU in the state it would be in before executing the next instruction
+    restoreSnapshot(index == 0 ? _loopStartState : _instructions[index - 1].stateAfter,
+                    _instructions[index].instruction.address);
+    _statistics.skippedTicks += skippedTicks;
+    _fastForwardIndex = index;
+    if (isLoopExited)
+    {
+        reset();
+    }
+
+    return skippedTicks;
+}
+
+void IdleLoopDetector::reset()
+{
+    _state = State::WAITING;
+    _fastForwardIndex = 0;
+    _rejectedLoopStart = -1;
+}
+
+void IdleLoopDetector::resetStatistics()
+{
+    _statistics = Statistics();
+}
+
+void IdleLoopDetector::startObservation()
+{
+    _loopStartState = takeSnapshot();
+    _numberOfObservedInstructions = 0;
+    _state = State::OBSERVING;
+}
+
+bool IdleLoopDetector::analyzeLoop(word start, word end)
+{
+    // The code is read through the MMU, the loop must not be in the I/O registers
+    if (start >= 0xFE00 && start < 0xFF80)
+    {
+        return false;
+    }
+
+    _instructions.clear();
+    word addr = start;
+    while (addr <= end)
+    {
+        DecodedInstruction instruction = InstructionDecoder::decode(_mmu, addr);
+        bool isLast = addr == end;
+        if (instruction.length == 0 || !isInstructionAllowed(instruction, isLast))
+        {
+            return false;
+        }
+
+        LoopInstruction loopInstruction;
+        loopInstruction.instruction = instruction;
+        _instructions.push_back(loopInstruction);
+        if (isLast)
+        {
+            return true;
+        }
+        addr += instruction.length;
+    }
+
+    // The jump is not aligned with the other instructions
+    return false;
+}
+
+bool IdleLoopDetector::isInstructionAllowed(const DecodedInstruction& instruction, bool isLast) const
+{
+    using namespace standardInstructions;
+
+    byte opCode = instruction.opCode;
+    if (InstructionDecoder::isBranch(opCode))
+    {
+        // Only the jump back to the start, the target was checked by the caller
+        bool isJump = opCode == JR_n || opCode == JR_NZ_n || opCode == JR_Z_n || opCode == JR_NC_n ||
+                      opCode == JR_C_n || opCode == JP_nn || opCode == JP_NZ_nn || opCode == JP_Z_nn ||
+                      opCode == JP_NC_nn || opCode == JP_C_nn;
+        return isLast && isJump;
+    }
+
+    if (isLast)
+    {
+        return false;
+    }
+
+    // Reads of the polled registers, the address is checked when the instruction is executed
+    if (opCode == LDH_A_nm || opCode == LD_A_Cm || opCode == LD_A_nnm || opCode == LD_A_HLm)
+    {
+        return true;
+    }
+
+    if (opCode == EXT_OPS)
+    {
+        // Everything but the operations on (HL)
+        return (instruction.operand & 0x07) != 0x06;
+    }
+
+    // Operations between registers or with an immediate value: LD r,r', ALU A,r, ALU A,n
+    int x = opCode >> 6;
+    int y = (opCode >> 3) & 0x07;
+    int z = opCode & 0x07;
+    if (x == 1)
+    {
+        return y != 6 && z != 6;
+    }
+    if (x == 2)
+    {
+        return z != 6;
+    }
+    if (x == 3)
+    {
+        return z == 6;
+    }
+
+    // NOP, INC/DEC rr, INC/DEC r, LD r,n, RLCA/RRCA/RLA/RRA/DAA/CPL/SCF/CCF
+    return opCode == NOP || (z == 3) || ((z == 4 || z == 5 || z == 6) && y != 6) || z == 7;
+}
+
+int IdleLoopDetector::getReadAddress(const DecodedInstruction& instruction, const RegisterSnapshot& state)
+{
+    using namespace standardInstructions;
+
+    switch (instruction.opCode)
+    {
+    case LDH_A_nm:
+        return 0xFF00 | (instruction.operand & 0xFF);
+    case LD_A_Cm:
+        return 0xFF00 | state.c;
+    case LD_A_nnm:
+        return instruction.operand;
+    case LD_A_HLm:
+        return createWordFromBytes(state.h, state.l);
+    default:
+        return -1;
+    }
+}
+
+IdleLoopDetector::RegisterSnapshot IdleLoopDetector::takeSnapshot() const
+{
+    RegisterSnapshot snapshot;
+    snapshot.a = _cpu.a();
+    snapshot.b = _cpu.b();
+    snapshot.c = _cpu.c();
+    snapshot.d = _cpu.d();
+    snapshot.e = _cpu.e();
+    snapshot.h = _cpu.h();
+    snapshot.l = _cpu.l();
+    snapshot.f = _cpu.getFlag();
+    snapshot.sp = _cpu.sp;
+    return snapshot;
+}
+
+void IdleLoopDetector::restoreSnapshot(const RegisterSnapshot& snapshot, word pc)
+{
+    _cpu.a() = snapshot.a;
+    _cpu.b() = snapshot.b;
+    _cpu.c() = snapshot.c;
+    _cpu.d() = snapshot.d;
+    _cpu.e() = snapshot.e;
+    _cpu.h() = snapshot.h;
+    _cpu.l() = snapshot.l;
+    _cpu.resetFlags();
+    _cpu.f() = snapshot.f;
+    _cpu.sp = snapshot.sp;
+    _cpu.pc = pc;
+}
@@ -0,0 +1,257 @@
+#ifndef GBEMULATOR_IDLE_LOOP_DETECTOR_HPP
+#define GBEMULATOR_IDLE_LOOP_DETECTOR_HPP
+
+#include "common/types.hpp"
+#include "cpu/instruction_decoder.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Forward declaration
+class CPU;
+class MMU;
+
+/**
+ * Detects the loops polling a hardware register until it changes, like LDH A,(FF44); CP n; JR NZ,
+ * and fast-forwards them.
+ *
+ * A loop is considered idle when:
+ *  - it's a short straight sequence of instructions ending with a jump back to its start,
+ *  - its instructions only work on registers, except reads of LY, STAT, IF, DIV or the joypad register,
+ *  - an iteration leaves all the registers exactly as they were at the start of the iteration.
+ *
+ * As long as the polled values and the interrupt flag register don't change, the next iterations
+ * are going to do exactly the same thing, so instead of executing them the other components
+ * are stepped with the ticks each instruction took during the observed iteration.
+ * The polled registers are read without side effects before each replayed read to know when to stop,
+ * the CPU is then left at the exact instruction and state it would have reached by executing the loop.
+ */
+class IdleLoopDetector
+{
+  public:
+    /**
+     * Counters for the loaded ROM, used to measure the speedup.
+     */
+    struct Statistics
+    {
+        /**
+         * The number of times a loop was confirmed to be idle
+         */
+        uint64_t numberOfDetectedLoops = 0;
+        /**
+         * The number of ticks that were fast-forwarded instead of being executed by the CPU
+         */
+        uint64_t skippedTicks = 0;
+        /**
+         * The number of instructions that were fast-forwarded instead of being executed by the CPU
+         */
+        uint64_t skippedInstructions = 0;
+    };
+
+    /**
+     * Create a detector for the given CPU.
+     *
+     * @param cpu The CPU executing the loops
+     * @param mmu The MMU used to read the code and the polled registers
+     */
+    IdleLoopDetector(CPU& cpu, MMU& mmu);
+
+    /**
+     * Called after each instruction executed by the CPU, once the other components are updated.
+     *
+     * @param instructionAddress The address of the instruction that was executed
+     */
+    void onInstructionExecuted(word instructionAddress);
+
+    /**
+     * Called before the CPU executes an instruction,
+     * fast-forwards the loop if the program counter is at the start of an idle loop.
+     * It stops once the given number of ticks or the next event of the other components is reached,
+     * and resumes from the same instruction of the loop at the next call.
+     *
+     * @param maxTicks The number of ticks after which no other instruction is fast-forwarded
+     * @return the number of ticks that were fast-forwarded, 0 if the instruction needs to be executed
+     */
+    int fastForward(int maxTicks);
+
+    /**
+     * Is the detector observing an iteration of a loop.
+     */
+    bool isObservingLoop() const
+    {
+        return _state != State::WAITING;
+    }
+
+    /**
+     * Forget the loop being observed, the statistics are kept.
+     */
+    void reset();
+
+    /**
+     * Reset the statistics.
+     */
+    void resetStatistics();
+
+    /**
+     * @return the statistics since the last reset
+     */
+    const Statistics& getStatistics() const
+    {
+        return _statistics;
+    }
+
+    /**
+     * Is the given address one of the registers that can be polled by an idle loop.
+     */
+    static bool isPolledRegister(word addr);
+
+    /**
+     * The maximum size in bytes of a loop
+     */
+    static const int MAX_LOOP_SIZE = 16;
+
+    /**
+     * The maximum number of ticks that are fast-forwarded at once when the CPU doesn't know
+     * the next event of the other components, this is one frame so that the emulator can process the inputs.
+     */
+    static const int MAX_FAST_FORWARD_TICKS = 70224;
+
+  private:
+    enum class State
+    {
+        /**
+         * Waiting for a jump back to the start of a potential idle loop
+         */
+        WAITING,
+        /**
+         * Executing an iteration of the loop and recording what each instruction does
+         */
+        OBSERVING,
+        /**
+         * The loop is idle and can be fast-forwarded from its start
+         */
+        CONFIRMED
+    };
+
+    /**
+     * The registers of the CPU between two instructions.
+     */
+    struct RegisterSnapshot
+    {
+        byte a = 0;
+        byte b = 0;
+        byte c = 0;
+        byte d = 0;
+        byte e = 0;
+        byte h = 0;
+        byte l = 0;
+        byte f = 0;
+        word sp = 0;
+
+        bool operator==(const RegisterSnapshot& other) const
+        {
+            return a == other.a && b == other.b && c == other.c && d == other.d && e == other.e && h == other.h &&
+                   l == other.l && f == other.f && sp == other.sp;
+        }
+
+        bool operator!=(const RegisterSnapshot& other) const
+        {
+            return !(*this == other);
+        }
+    };
+
+    /**
+     * An instruction of the loop as observed during an iteration.
+     */
+    struct LoopInstruction
+    {
+        DecodedInstruction instruction;
+        /**
+         * The number of ticks the instruction took
+         */
+        int ticks = 0;
+        /**
+         * The registers after executing the instruction
+         */
+        RegisterSnapshot stateAfter;
+        /**
+         * The address of the polled register read by the instruction, -1 if it doesn't read memory
+         */
+        int readAddress = -1;
+        /**
+         * The value read from the polled register
+         */
+        byte readValue = 0;
+    };
+
+    /**
+     * Decode the instructions from start to the jump at end and check that they can be part of an idle loop.
+     *
+     * @return true if the loop can be observed, false otherwise
+     */
+    bool analyzeLoop(word start, word end);
+
+    /**
+     * Can the instruction be part of an idle loop.
+     *
+     * @param instruction   The instruction to check
+     * @param isLast        Whether this is the jump ending the loop
+     */
+    bool isInstructionAllowed(const DecodedInstruction& instruction, bool isLast) const;
+
+    /**
+     * Get the address read by an instruction of the loop, -1 if it doesn't read memory.
+     *
+     * @param instruction   The instruction reading memory
+     * @param state         The registers before executing the instruction
+     */
+    static int getReadAddress(const DecodedInstruction& instruction, const RegisterSnapshot& state);
+
+    /**
+     * Start observing an iteration of the loop, the program counter is at the start of the loop.
+     */
+    void startObservation();
+
+    RegisterSnapshot takeSnapshot() const;
+
+    void restoreSnapshot(const RegisterSnapshot& snapshot, word pc);
+
+    CPU& _cpu;
+    MMU& _mmu;
+    State _state = State::WAITING;
+    std::vector<LoopInstruction> _instructions;
+
+    /**
+     * The address of the first instruction of the loop
+     */
+    word _loopStart = 0;
+
+    /**
+     * The registers at the start of an iteration
+     */
+    RegisterSnapshot _loopStartState;
+
+    /**
+     * The number of instructions observed during the current iteration
+     */
+    size_t _numberOfObservedInstructions = 0;
+
+    /**
+     * The index of the instruction of the loop the next fast-forward starts from
+     */
+    size_t _fastForwardIndex = 0;
+
+    /**
+     * The interrupt flag register when the loop was confirmed, the fast-forward stops when it changes
+     */
+    byte _interruptFlag = 0;
+
+    /**
+     * The start of the last loop that was rejected, to avoid analyzing it at every iteration
+     */
+    int _rejectedLoopStart = -1;
+
+    Statistics _statistics;
+};
+
+#endif // GBEMULATOR_IDLE_LOOP_DETECTOR_HPP
@@ -0,0 +1,225 @@
+#include "instruction_decoder.hpp"
+#include "cpu/instructions.hpp"
+#include "memory/mmu.hpp"
+
+// clang-format off
+const std::array<byte, 256> InstructionDecoder::INSTRUCTION_LENGTHS = {
+    // 0x00
+    1, 3, 1, 1, 1, 1, 2, 1, 3, 1, 1, 1, 1, 1, 2, 1,
+    // 0x10
+    2, 3, 1, 1, 1, 1, 2, 1, 2, 1, 1, 1, 1, 1, 2, 1,
+    // 0x20
+    2, 3, 1, 1, 1, 1, 2, 1, 2, 1, 1, 1, 1, 1, 2, 1,
+    // 0x30
+    2, 3, 1, 1, 1, 1, 2, 1, 2, 1, 1, 1, 1, 1, 2, 1,
+    // 0x40
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    // 0x50
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    // 0x60
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    // 0x70
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    // 0x80
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    // 0x90
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    // 0xA0
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    // 0xB0
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    // 0xC0
+    1, 1, 3, 3, 3, 1, 2, 1, 1, 1, 3, 2, 3, 3, 2, 1,
+    // 0xD0
+    1, 1, 3, 0, 3, 1, 2, 1, 1, 1, 3, 0, 3, 0, 2, 1,
+    // 0xE0
+    2, 1, 1, 0, 0, 1, 2, 1, 2, 1, 3, 0, 0, 0, 2, 1,
+    // 0xF0
+    2, 1, 1, 1, 0, 1, 2, 1, 2, 1, 3, 1, 0, 0, 2, 1,
+};
+
+const std::array<byte, 256> InstructionDecoder::INSTRUCTION_TICKS = {
+    // 0x00
+    1, 3, 2, 2, 1, 1, 2, 1, 5, 2, 2, 2, 1, 1, 2, 1,
+    // 0x10
+    0, 3, 2, 2, 1, 1, 2, 1, 3, 2, 2, 2, 1, 1, 2, 1,
+    // 0x20
+    2, 3, 2, 2, 1, 1, 2, 1, 2, 2, 2, 2, 1, 1, 2, 1,
+    // 0x30
+    2, 3, 2, 2, 3, 3, 3, 1, 2, 2, 2, 2, 1, 1, 2, 1,
+    // 0x40
+    1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
+    // 0x50
+    1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
+    // 0x60
+    1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
+    // 0x70
+    2, 2, 2, 2, 2, 2, 0, 2, 1, 1, 1, 1, 1, 1, 2, 1,
+    // 0x80
+    1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
+    // 0x90
+    1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
+    // 0xA0
+    1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
+    // 0xB0
+    1, 1, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 1, 2, 1,
+    // 0xC0
+    2, 3, 3, 4, 3, 4, 2, 4, 2, 4, 3, 0, 3, 6, 2, 4,
+    // 0xD0
+    2, 3, 3, 0, 3, 4, 2, 4, 2, 4, 3, 0, 3, 0, 2, 4,
+    // 0xE0
+    3, 3, 2, 0, 0, 4, 2, 4, 4, 1, 4, 0, 0, 0, 2, 4,
+    // 0xF0
+    3, 3, 2, 1, 0, 4, 2, 4, 3, 2, 4, 1, 0, 0, 2, 4,
+};
+// clang-format on
+
+const std::array<byte, 256> InstructionDecoder::INSTRUCTION_BRANCH_TICKS = [] {
+    using namespace standardInstructions;
+
+    std::array<byte, 256> ticks = INSTRUCTION_TICKS;
+    for (byte opCode : {JR_NZ_n, JR_Z_n, JR_NC_n, JR_C_n})
+    {
+        ticks[opCode] = 3;
+    }
+    for (byte opCode : {RET_NZ, RET_Z, RET_NC, RET_C})
+    {
+        ticks[opCode] = 5;
+    }
+    for (byte opCode : {JP_NZ_nn, JP_Z_nn, JP_NC_nn, JP_C_nn})
+    {
+        ticks[opCode] = 4;
+    }
+    for (byte opCode : {CALL_NZ_nn, CALL_Z_nn, CALL_NC_nn, CALL_C_nn})
+    {
+        ticks[opCode] = 6;
+    }
+    return ticks;
+}();
+
+DecodedInstruction InstructionDecoder::decode(MMU& mmu, word addr)
+{
+    DecodedInstruction instruction;
+    instruction.address = addr;
+    instruction.opCode = mmu.read(addr);
+    instruction.length = getInstructionLength(instruction.opCode);
+
+    if (instruction.length == 2)
+    {
+        instruction.operand = mmu.read(static_cast<word>(addr + 1));
+    }
+    else if (instruction.length == 3)
+    {
+        instruction.operand =
+            utils::createWordFromBytes(mmu.read(static_cast<word>(addr + 2)), mmu.read(static_cast<word>(addr + 1)));
+    }
+
+    resolveTicks(instruction);
+    return instruction;
+}
+
+DecodedInstruction InstructionDecoder::decode(const byte* data, size_t size, word addr)
+{
+    DecodedInstruction instruction;
+    instruction.address = addr;
+    if (size == 0)
+    {
+        return instruction;
+    }
+
+    instruction.opCode = data[0];
+    instruction.length = getInstructionLength(instruction.opCode);
+    if (instruction.length > size)
+    {
+        instruction.length = 0;
+        return instruction;
+    }
+
+    if (instruction.length == 2)
+    {
+        instruction.operand = data[1];
+    }
+    else if (instruction.length == 3)
+    {
+        instruction.operand = utils::createWordFromBytes(data[2], data[1]);
+    }
+
+    resolveTicks(instruction);
+    return instruction;
+}
+
+void InstructionDecoder::resolveTicks(DecodedInstruction& instruction)
+{
+    if (instruction.opCode == standardInstructions::EXT_OPS)
+    {
+        instruction.ticks = getExtendedInstructionTicks(static_cast<byte>(instruction.operand));
+        instruction.branchTicks = instruction.ticks;
+    }
+    else
+    {
+        instruction.ticks = INSTRUCTION_TICKS[instruction.opCode];
+        instruction.branchTicks = INSTRUCTION_BRANCH_TICKS[instruction.opCode];
+    }
+}
+
+bool InstructionDecoder::isBlockTerminator(byte opCode)
+{
+    using namespace standardInstructions;
+
+    return isBranch(opCode) || opCode == HALT || opCode == STOP || getInstructionLength(opCode) == 0;
+}
+
+bool InstructionDecoder::isBranch(byte opCode)
+{
+    using namespace standardInstructions;
+
+    switch (opCode)
+    {
+    case JR_n:
+    case JR_NZ_n:
+    case JR_Z_n:
+    case JR_NC_n:
+    case JR_C_n:
+    case JP_nn:
+    case JP_NZ_nn:
+    case JP_Z_nn:
+    case JP_NC_nn:
+    case JP_C_nn:
+    case JP_HLm:
+    case CALL_nn:
+    case CALL_NZ_nn:
+    case CALL_Z_nn:
+    case CALL_NC_nn:
+    case CALL_C_nn:
+    case RET:
+    case RET_NZ:
+    case RET_Z:
+    case RET_NC:
+    case RET_C:
+    case RETI:
+    case RST_0:
+    case RST_8:
+    case RST_10:
+    case RST_18:
+    case RST_20:
+    case RST_28:
+    case RST_30:
+    case RST_38:
+        return true;
+    default:
+        return false;
+    }
+}
+
+byte InstructionDecoder::getExtendedInstructionTicks(byte opCode)
+{
+    bool isMemoryOperand = (opCode & 0x07) == 0x06;
+    if (!isMemoryOperand)
+    {
+        return 2;
+    }
+
+    // BIT b,(HL) only reads the memory
+    bool isBitInstruction = (opCode >> 6) == 0x01;
+    return isBitInstruction ? 3 : 4;
+}
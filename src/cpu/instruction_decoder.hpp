@@ -0,0 +1,141 @@
+#ifndef GBEMULATOR_INSTRUCTION_DECODER_HPP
+#define GBEMULATOR_INSTRUCTION_DECODER_HPP
+
+#include "common/types.hpp"
+#include <array>
+#include <cstddef>
+
+// Forward declaration
+class MMU;
+
+/**
+ * An instruction that was read from memory ahead of its execution.
+ * The operands and the cycle costs are resolved at decoding time so that
+ * the CPU does not have to go through the MMU to fetch them again.
+ */
+struct DecodedInstruction
+{
+    /**
+     * The address in memory of the opcode
+     */
+    word address = 0;
+
+    /**
+     * The opcode of the instruction
+     */
+    byte opCode = 0;
+
+    /**
+     * The total length of the instruction in bytes, including the opcode
+     */
+    byte length = 0;
+
+    /**
+     * The immediate operand of the instruction, 8 or 16 bits.
+     * For extended instructions this is the extended opcode.
+     */
+    word operand = 0;
+
+    /**
+     * The number of ticks taken by the instruction when no branch is taken
+     */
+    byte ticks = 0;
+
+    /**
+     * The number of ticks taken by the instruction when the branch is taken
+     */
+    byte branchTicks = 0;
+};
+
+/**
+ * The instruction decoder knows the encoding of the instruction set
+ * (length, timing and control flow of each opcode) and is able to decode
+ * an instruction from memory without executing it.
+ */
+class InstructionDecoder
+{
+  public:
+    /**
+     * Decode the instruction stored at the given address.
+     * Memory is only read through the MMU, the caller is in charge of making sure
+     * that reading the address does not have side effects.
+     *
+     * @param mmu   The MMU to read the instruction from
+     * @param addr  The address of the opcode
+     * @return the decoded instruction, with a length of 0 if the opcode is not valid
+     */
+    static DecodedInstruction decode(MMU& mmu, word addr);
+
+    /**
+     * Decode the instruction stored in a buffer, used to decode code that is not mapped in memory.
+     *
+     * @param data  The bytes of the instruction, starting with the opcode
+     * @param size  The number of bytes that can be read from data
+     * @param addr  The address of the opcode once mapped in memory
+     * @return the decoded instruction, with a length of 0 if the opcode is not valid
+     *         or if the instruction doesn't fit in the buffer
+     */
+    static DecodedInstruction decode(const byte* data, size_t size, word addr);
+
+    /**
+     * Get the length of an instruction from its opcode.
+     *
+     * @param opCode    The opcode of the standard instruction set
+     * @return the length in bytes of the instruction or 0 if the opcode is not valid
+     */
+    static byte getInstructionLength(byte opCode)
+    {
+        return INSTRUCTION_LENGTHS[opCode];
+    }
+
+    /**
+     * Is the instruction ending a basic block, i.e. it can change the program counter
+     * to something else than the next instruction or it changes the execution state of the CPU.
+     *
+     * @param opCode    The opcode of the standard instruction set
+     * @return true if the instruction ends a block, false otherwise
+     */
+    static bool isBlockTerminator(byte opCode);
+
+    /**
+     * Is the instruction a conditional or unconditional branch, i.e. it can change the program counter
+     * to something else than the next instruction.
+     *
+     * @param opCode    The opcode of the standard instruction set
+     * @return true if the instruction is a branch, false otherwise
+     */
+    static bool isBranch(byte opCode);
+
+  private:
+    /**
+     * Set the number of ticks of a decoded instruction from its opcode and operand.
+     *
+     * @param instruction The instruction to update
+     */
+    static void resolveTicks(DecodedInstruction& instruction);
+
+    /**
+     * Length in bytes of each instruction of the standard instruction set, 0 for invalid opcodes.
+     */
+    static const std::array<byte, 256> INSTRUCTION_LENGTHS;
+
+    /**
+     * Number of ticks of each instruction of the standard instruction set, when no branch is taken.
+     */
+    static const std::array<byte, 256> INSTRUCTION_TICKS;
+
+    /**
+     * Number of ticks of each instruction of the standard instruction set, when the branch is taken.
+     */
+    static const std::array<byte, 256> INSTRUCTION_BRANCH_TICKS;
+
+    /**
+     * Get the number of ticks of an instruction of the extended instruction set.
+     *
+     * @param opCode    The opcode of the extended instruction set
+     * @return the number of ticks, including the prefix
+     */
+    static byte getExtendedInstructionTicks(byte opCode);
+};
+
+#endif // GBEMULATOR_INSTRUCTION_DECODER_HPP
@@ -0,0 +1,1165 @@
+#ifndef GBEMULATOR_INSTRUCTION_HANDLERS_HPP
+#define GBEMULATOR_INSTRUCTION_HANDLERS_HPP
+
+#include "cpu/cpu.hpp"
+#include <array>
+#include <cstddef>
+#include <utility>
+
+/**
+ * Handlers of the standard and extended instructions, generated at compile time.
+ *
+ * Each opcode gets its own function specialized on its operands, the operands are decoded
+ * from the bitfields of the opcode:
+ *
+ *     7 6 5 4 3 2 1 0
+ *     x x y y y z z z
+ *         p p q
+ *
+ * See https://gb-archive.github.io/salvage/decoding_gbz80_opcodes/Decoding%20Gamboy%20Z80%20Opcodes.html
+ *
+ * The handlers of the standard instructions are stored in a dense table of 256 entries indexed by the opcode.
+ * The extended instructions are a regular grid of {operation x bit x operand}, the interpreter executes them
+ * with 4 kernels (rotation/shift, BIT, RES, SET) decoding the bit and the operand at runtime so that the
+ * code of the extended instructions stays small. The handlers specialized on each extended opcode are
+ * still used where the opcode is known at compile time (recompiled code).
+ * This is only meant to be included by the implementation of the CPU.
+ */
+struct CPU::InstructionHandlers
+{
+    /**
+     * Signature of the function executing an instruction.
+     */
+    typedef void (*Handler)(CPU& cpu);
+
+    typedef std::array<Handler, 256> HandlerTable;
+
+    /**
+     * Signature of the function executing a group of extended instructions,
+     * the operands are decoded from the opcode.
+     */
+    typedef void (*ExtendedKernel)(CPU& cpu, byte opCode);
+
+    /**
+     * The 8 bits operands as encoded in the opcodes.
+     */
+    enum Operand : int
+    {
+        B = 0,
+        C = 1,
+        D = 2,
+        E = 3,
+        H = 4,
+        L = 5,
+        HL_MEMORY = 6,
+        A = 7
+    };
+
+    /**
+     * The register pairs as encoded in the opcodes,
+     * the last one is SP for most of the instructions and AF for PUSH and POP.
+     */
+    enum RegisterPair : int
+    {
+        BC = 0,
+        DE = 1,
+        HL = 2,
+        SP_OR_AF = 3
+    };
+
+    /**
+     * The conditions of the conditional jumps, calls and returns as encoded in the opcodes.
+     */
+    enum Condition : int
+    {
+        NOT_ZERO = 0,
+        ZERO = 1,
+        NOT_CARRY = 2,
+        CARRY = 3
+    };
+
+    template <int R>
+    static byte& reg(CPU& cpu)
+    {
+        static_assert(R != HL_MEMORY, "(HL) is not a register");
+        if constexpr (R == B)
+        {
+            return cpu.b();
+        }
+        else if constexpr (R == C)
+        {
+            return cpu.c();
+        }
+        else if constexpr (R == D)
+        {
+            return cpu.d();
+        }
+        else if constexpr (R == E)
+        {
+            return cpu.e();
+        }
+        else if constexpr (R == H)
+        {
+            return cpu.h();
+        }
+        else if constexpr (R == L)
+        {
+            return cpu.l();
+        }
+        else
+        {
+            return cpu.a();
+        }
+    }
+
+    /**
+     * The register of an operand decoded at runtime.
+     */
+    static byte& reg(CPU& cpu, int r)
+    {
+        switch (r)
+        {
+        case B:
+            return cpu.b();
+        case C:
+            return cpu.c();
+        case D:
+            return cpu.d();
+        case E:
+            return cpu.e();
+        case H:
+            return cpu.h();
+        case L:
+            return cpu.l();
+        default:
+            return cpu.a();
+        }
+    }
+
+    /**
+     * The 16 bits register of the pair, SP_OR_AF is SP.
+     */
+    template <int P>
+    static word& pair(CPU& cpu)
+    {
+        if constexpr (P == BC)
+        {
+            return cpu._bc.value();
+        }
+        else if constexpr (P == DE)
+        {
+            return cpu._de.value();
+        }
+        else if constexpr (P == HL)
+        {
+            return cpu._hl.value();
+        }
+        else
+        {
+            return cpu.sp;
+        }
+    }
+
+    template <int CONDITION>
+    static bool isConditionSatisfied(const CPU& cpu)
+    {
+        if constexpr (CONDITION == NOT_ZERO)
+        {
+            return !cpu.isFlagSet(CpuFlags::ZERO);
+        }
+        else if constexpr (CONDITION == ZERO)
+        {
+            return cpu.isFlagSet(CpuFlags::ZERO);
+        }
+        else if constexpr (CONDITION == NOT_CARRY)
+        {
+            return !cpu.isFlagSet(CpuFlags::CARRY);
+        }
+        else
+        {
+            return cpu.isFlagSet(CpuFlags::CARRY);
+        }
+    }
+
+    /******************************************************/
+    /*************** Standard instructions ****************/
+    /******************************************************/
+
+    template <byte OPCODE>
+    static void unhandled(CPU&)
+    {
+        throw UnhandledInstructionException(OPCODE);
+    }
+
+    static void noOperation(CPU& cpu)
+    {
+        cpu.NoOperation();
+    }
+
+    static void stop(CPU& cpu)
+    {
+        cpu.stopInstruction();
+    }
+
+    static void halt(CPU& cpu)
+    {
+        cpu.haltInstruction();
+    }
+
+    static void loadStackPointerAtImmediateAddress(CPU& cpu)
+    {
+        cpu.load16BitsRegisterAtImmediateAddress(cpu.sp);
+    }
+
+    static void jumpRelative(CPU& cpu)
+    {
+        cpu.jumpRelative();
+    }
+
+    template <int CONDITION>
+    static void jumpRelativeConditional(CPU& cpu)
+    {
+        cpu.jumpRelativeConditional(isConditionSatisfied<CONDITION>(cpu));
+    }
+
+    template <int P>
+    static void loadImmediateInRegisterPair(CPU& cpu)
+    {
+        cpu.load16BitsImmediateValueIntoRegister(pair<P>(cpu));
+    }
+
+    template <int P>
+    static void addRegisterPairToHL(CPU& cpu)
+    {
+        cpu.add16BitsValueTo16BitsRegister(cpu._hl.value(), pair<P>(cpu));
+    }
+
+    /**
+     * LD (BC),A / LD (DE),A / LD (HL+),A / LD (HL-),A
+     */
+    template <int P>
+    static void storeAccumulatorIndirect(CPU& cpu)
+    {
+        if constexpr (P == HL)
+        {
+            cpu.loadValueToMemoryAndIncrementAddr(cpu._hl.value(), cpu.a());
+        }
+        else if constexpr (P == SP_OR_AF)
+        {
+            cpu.loadValueToMemoryAndDecreaseAddr(cpu._hl.value(), cpu.a());
+        }
+        else
+        {
+            cpu.loadValueToMemoryAtAddr(pair<P>(cpu), cpu.a());
+        }
+    }
+
+    /**
+     * LD A,(BC) / LD A,(DE) / LD A,(HL+) / LD A,(HL-)
+     */
+    template <int P>
+    static void loadAccumulatorIndirect(CPU& cpu)
+    {
+        if constexpr (P == HL)
+        {
+            cpu.loadValueFromMemoryAndIncrementAddr(cpu.a(), cpu._hl.value());
+        }
+        else if constexpr (P == SP_OR_AF)
+        {
+            cpu.loadValueFromMemoryAndDecreaseAddr(cpu.a(), cpu._hl.value());
+        }
+        else
+        {
+            cpu.loadValueFromMemoryInto8BitsRegister(cpu.a(), pair<P>(cpu));
+        }
+    }
+
+    template <int P>
+    static void incrementRegisterPair(CPU& cpu)
+    {
+        cpu.incrementRegisterValue(pair<P>(cpu));
+    }
+
+    template <int P>
+    static void decrementRegisterPair(CPU& cpu)
+    {
+        cpu.decrementRegisterValue(pair<P>(cpu));
+    }
+
+    template <int R>
+    static void increment(CPU& cpu)
+    {
+        if constexpr (R == HL_MEMORY)
+        {
+            cpu.incrementValueInMemoryAtAddr(cpu._hl.value());
+        }
+        else
+        {
+            cpu.incrementRegisterValue(reg<R>(cpu));
+        }
+    }
+
+    template <int R>
+    static void decrement(CPU& cpu)
+    {
+        if constexpr (R == HL_MEMORY)
+        {
+            cpu.decrementValueInMemoryAtAddr(cpu._hl.value());
+        }
+        else
+        {
+            cpu.decrementRegisterValue(reg<R>(cpu));
+        }
+    }
+
+    template <int R>
+    static void loadImmediate(CPU& cpu)
+    {
+        if constexpr (R == HL_MEMORY)
+        {
+            cpu.load8BitsImmediateValueAtMemoryAddress(cpu._hl.value());
+        }
+        else
+        {
+            cpu.loadImmediateValueInRegister(reg<R>(cpu));
+        }
+    }
+
+    /**
+     * RLCA / RRCA / RLA / RRA / DAA / CPL / SCF / CCF
+     */
+    template <int Y>
+    static void accumulatorOperation(CPU& cpu)
+    {
+        if constexpr (Y == 0)
+        {
+            cpu.rotateRegisterLeftCircular(cpu.a());
+        }
+        else if constexpr (Y == 1)
+        {
+            cpu.rotateRegisterRightCircular(cpu.a());
+        }
+        else if constexpr (Y == 2)
+        {
+            cpu.rotateRegisterLeft(cpu.a());
+        }
+        else if constexpr (Y == 3)
+        {
+            cpu.rotateRegisterRight(cpu.a());
+        }
+        else if constexpr (Y == 4)
+        {
+            cpu.decimalAdjustAccumulator();
+        }
+        else if constexpr (Y == 5)
+        {
+            cpu.complementRegister(cpu.a());
+        }
+        else if constexpr (Y == 6)
+        {
+            cpu.setCarryFlagInstruction();
+        }
+        else
+        {
+            cpu.invertsCarryFlag();
+        }
+    }
+
+    template <int DST, int SRC>
+    static void load(CPU& cpu)
+    {
+        if constexpr (DST == HL_MEMORY)
+        {
+            cpu.loadValueToMemoryAtAddr(cpu._hl.value(), reg<SRC>(cpu));
+        }
+        else if constexpr (SRC == HL_MEMORY)
+        {
+            cpu.loadValueFromMemoryInto8BitsRegister(reg<DST>(cpu), cpu._hl.value());
+        }
+        else
+        {
+            cpu.load8BitsValueInRegister(reg<DST>(cpu), reg<SRC>(cpu));
+        }
+    }
+
+    /**
+     * ADD / ADC / SUB / SBC / AND / XOR / OR / CP between A and a register or (HL)
+     */
+    template <int OPERATION, int SRC>
+    static void arithmeticLogical(CPU& cpu)
+    {
+        if constexpr (SRC == HL_MEMORY)
+        {
+            if constexpr (OPERATION == 0)
+            {
+                cpu.addValueFromMemoryTo8BitsRegister(cpu.a(), cpu._hl.value());
+            }
+            else if constexpr (OPERATION == 1)
+            {
+                cpu.addValueFromMemoryAndCarryTo8BitsRegister(cpu.a(), cpu._hl.value());
+            }
+            else if constexpr (OPERATION == 2)
+            {
+                cpu.substractValueInMemoryFrom8BitsRegister(cpu.a(), cpu._hl.value());
+            }
+            else if constexpr (OPERATION == 3)
+            {
+                cpu.subValueFromMemoryAndCarryTo8BitsRegister(cpu.a(), cpu._hl.value());
+            }
+            else if constexpr (OPERATION == 4)
+            {
+                cpu.logicalAndBetweenAccumulatorAndValueInMemory(cpu._hl.value());
+            }
+            else if constexpr (OPERATION == 5)
+            {
+                cpu.logicalXorBetweenAccumulatorAndValueInMemory(cpu._hl.value());
+            }
+            else if constexpr (OPERATION == 6)
+            {
+                cpu.logicalOrBetweenAccumulatorAndValueInMemory(cpu._hl.value());
+            }
+            else
+            {
+                cpu.compareAccumulatorAndValueInMemory(cpu._hl.value());
+            }
+        }
+        else
+        {
+            if constexpr (OPERATION == 0)
+            {
+                cpu.add8BitsValueTo8BitsRegister(cpu.a(), reg<SRC>(cpu));
+            }
+            else if constexpr (OPERATION == 1)
+            {
+                cpu.add8BitsValueAndCarryTo8BitsRegister(cpu.a(), reg<SRC>(cpu));
+            }
+            else if constexpr (OPERATION == 2)
+            {
+                cpu.substract8BitsValueFrom8BitsRegister(cpu.a(), reg<SRC>(cpu));
+            }
+            else if constexpr (OPERATION == 3)
+            {
+                cpu.sub8BitsValueAndCarryTo8BitsRegister(cpu.a(), reg<SRC>(cpu));
+            }
+            else if constexpr (OPERATION == 4)
+            {
+                cpu.logicalAndBetweenAccumulatorAnd8BitsRegister(reg<SRC>(cpu));
+            }
+            else if constexpr (OPERATION == 5)
+            {
+                cpu.logicalXorBetweenAccumulatorAnd8BitsRegister(reg<SRC>(cpu));
+            }
+            else if constexpr (OPERATION == 6)
+            {
+                cpu.logicalOrBetweenAccumulatorAnd8BitsRegister(reg<SRC>(cpu));
+            }
+            else
+            {
+                cpu.compareAccumulatorAndRegister(reg<SRC>(cpu));
+            }
+        }
+    }
+
+    /**
+     * ADD / ADC / SUB / SBC / AND / XOR / OR / CP between A and an immediate value
+     */
+    template <int OPERATION>
+    static void arithmeticLogicalImmediate(CPU& cpu)
+    {
+        if constexpr (OPERATION == 0)
+        {
+            cpu.addImmediateValueTo8BitsRegister(cpu.a());
+        }
+        else if constexpr (OPERATION == 1)
+        {
+            cpu.addImmediateValueAndCarryTo8BitsRegister(cpu.a());
+        }
+        else if constexpr (OPERATION == 2)
+        {
+            cpu.substractImmediateValueFrom8BitsRegister(cpu.a());
+        }
+        else if constexpr (OPERATION == 3)
+        {
+            cpu.subImmediateValueAndCarryTo8BitsRegister(cpu.a());
+        }
+        else if constexpr (OPERATION == 4)
+        {
+            cpu.logicalAndBetweenAccumulatorAndImmediateValue();
+        }
+        else if constexpr (OPERATION == 5)
+        {
+            cpu.logicalXorBetweenAccumulatorAndImmediateValue();
+        }
+        else if constexpr (OPERATION == 6)
+        {
+            cpu.logicalOrBetweenAccumulatorAndImmediateValue();
+        }
+        else
+        {
+            cpu.compareAccumulatorAndImmediateValue();
+        }
+    }
+
+    template <int CONDITION>
+    static void returnConditional(CPU& cpu)
+    {
+        cpu.returnInstructionConditional(isConditionSatisfied<CONDITION>(cpu));
+    }
+
+    template <int CONDITION>
+    static void jumpConditional(CPU& cpu)
+    {
+        cpu.jumpConditional(isConditionSatisfied<CONDITION>(cpu));
+    }
+
+    template <int CONDITION>
+    static void callConditional(CPU& cpu)
+    {
+        cpu.callImmediateSubroutineIfConditionSatisfied(isConditionSatisfied<CONDITION>(cpu));
+    }
+
+    template <int P>
+    static void pop(CPU& cpu)
+    {
+        if constexpr (P == SP_OR_AF)
+        {
+            // The flag register is accessed directly
+            cpu.materializeFlags();
+            cpu.popMemoryIntoRegisterPair(cpu._af.value());
+            // The lower nibble of the flag register is hardwired to 0
+            // We reset this part if it was affected by the operation
+            cpu.f() &= 0xF0;
+        }
+        else
+        {
+            cpu.popMemoryIntoRegisterPair(pair<P>(cpu));
+        }
+    }
+
+    template <int P>
+    static void push(CPU& cpu)
+    {
+        if constexpr (P == SP_OR_AF)
+        {
+            // The flag register is accessed directly
+            cpu.materializeFlags();
+            cpu.push16BitsOntoStackPointer(cpu._af.value());
+        }
+        else
+        {
+            cpu.push16BitsOntoStackPointer(pair<P>(cpu));
+        }
+    }
+
+    template <byte ADDRESS>
+    static void restart(CPU& cpu)
+    {
+        cpu.callRestartRoutine(ADDRESS);
+    }
+
+    static void loadAccumulatorInHighMemory(CPU& cpu)
+    {
+        cpu.loadAccumulatorInHighMemoryValue();
+    }
+
+    static void loadHighMemoryInAccumulator(CPU& cpu)
+    {
+        cpu.loadHighMemoryValueInAccumulator();
+    }
+
+    static void loadAccumulatorInHighMemoryAtC(CPU& cpu)
+    {
+        cpu.loadAccumulatorInHighMemoryValue(cpu.c());
+    }
+
+    static void loadHighMemoryAtCInAccumulator(CPU& cpu)
+    {
+        cpu.loadHighMemoryValueInAccumulator(cpu.c());
+    }
+
+    static void loadAccumulatorAtImmediateAddress(CPU& cpu)
+    {
+        cpu.load8BitsRegisterAtImmediateAddress(cpu.a());
+    }
+
+    static void loadImmediateAddressInAccumulator(CPU& cpu)
+    {
+        cpu.loadImmediate16BitsValueIn8BitsRegister(cpu.a());
+    }
+
+    static void addImmediateToStackPointer(CPU& cpu)
+    {
+        cpu.addImmediateValueToStackPointer();
+    }
+
+    static void loadStackPointerWithOffsetInHL(CPU& cpu)
+    {
+        cpu.load16BitsRegisterAndImmediateOffsetIn16BitsRegister(cpu._hl.value(), cpu.sp);
+    }
+
+    static void loadHLInStackPointer(CPU& cpu)
+    {
+        cpu.load16BitsRegisterIn16BitsRegister(cpu.sp, cpu._hl.value());
+    }
+
+    static void returnFromSubroutine(CPU& cpu)
+    {
+        cpu.returnInstruction();
+    }
+
+    static void returnFromInterrupt(CPU& cpu)
+    {
+        cpu.returnInstructionAfterInterrupt();
+    }
+
+    static void jumpToHL(CPU& cpu)
+    {
+        cpu.jumpToAddrIn16BitsRegister(cpu._hl.value());
+    }
+
+    static void jump(CPU& cpu)
+    {
+        cpu.jump();
+    }
+
+    static void call(CPU& cpu)
+    {
+        cpu.callImmediateSubroutine();
+    }
+
+    static void disableInterrupts(CPU& cpu)
+    {
+        cpu.disableInterrupts();
+    }
+
+    static void enableInterrupts(CPU& cpu)
+    {
+        cpu.enableInterrupts();
+    }
+
+    static void extendedOperation(CPU& cpu)
+    {
+        cpu.executeExtendedInstruction(cpu.fetchImmediateByte());
+    }
+
+    /**
+     * Select the handler of a standard instruction from its opcode.
+     */
+    template <byte OPCODE>
+    static constexpr Handler standardHandler()
+    {
+        constexpr int x = OPCODE >> 6;
+        constexpr int y = (OPCODE >> 3) & 0x07;
+        constexpr int z = OPCODE & 0x07;
+        constexpr int p = y >> 1;
+        constexpr int q = y & 0x01;
+
+        if constexpr (x == 0)
+        {
+            if constexpr (z == 0)
+            {
+                if constexpr (y == 0)
+                {
+                    return &noOperation;
+                }
+                else if constexpr (y == 1)
+                {
+                    return &loadStackPointerAtImmediateAddress;
+                }
+                else if constexpr (y == 2)
+                {
+                    return &stop;
+                }
+                else if constexpr (y == 3)
+                {
+                    return &jumpRelative;
+                }
+                else
+                {
+                    return &jumpRelativeConditional<y - 4>;
+                }
+            }
+            else if constexpr (z == 1)
+            {
+                return q == 0 ? &loadImmediateInRegisterPair<p> : &addRegisterPairToHL<p>;
+            }
+            else if constexpr (z == 2)
+            {
+                return q == 0 ? &storeAccumulatorIndirect<p> : &loadAccumulatorIndirect<p>;
+            }
+            else if constexpr (z == 3)
+            {
+                return q == 0 ? &incrementRegisterPair<p> : &decrementRegisterPair<p>;
+            }
+            else if constexpr (z == 4)
+            {
+                return &increment<y>;
+            }
+            else if constexpr (z == 5)
+            {
+                return &decrement<y>;
+            }
+            else if constexpr (z == 6)
+            {
+                return &loadImmediate<y>;
+            }
+            else
+            {
+                return &accumulatorOperation<y>;
+            }
+        }
+        else if constexpr (x == 1)
+        {
+            if constexpr (y == HL_MEMORY && z == HL_MEMORY)
+            {
+                return &halt;
+            }
+            else
+            {
+                return &load<y, z>;
+            }
+        }
+        else if constexpr (x == 2)
+        {
+            return &arithmeticLogical<y, z>;
+        }
+        else
+        {
+            if constexpr (z == 0)
+            {
+                if constexpr (y < 4)
+                {
+                    return &returnConditional<y>;
+                }
+                else if constexpr (y == 4)
+                {
+                    return &loadAccumulatorInHighMemory;
+                }
+                else if constexpr (y == 5)
+                {
+                    return &addImmediateToStackPointer;
+                }
+                else if constexpr (y == 6)
+                {
+                    return &loadHighMemoryInAccumulator;
+                }
+                else
+                {
+                    return &loadStackPointerWithOffsetInHL;
+                }
+            }
+            else if constexpr (z == 1)
+            {
+                if constexpr (q == 0)
+                {
+                    return &pop<p>;
+                }
+                else if constexpr (p == 0)
+                {
+                    return &returnFromSubroutine;
+                }
+                else if constexpr (p == 1)
+                {
+                    return &returnFromInterrupt;
+                }
+                else if constexpr (p == 2)
+                {
+                    return &jumpToHL;
+                }
+                else
+                {
+                    return &loadHLInStackPointer;
+                }
+            }
+            else if constexpr (z == 2)
+            {
+                if constexpr (y < 4)
+                {
+                    return &jumpConditional<y>;
+                }
+                else if constexpr (y == 4)
+                {
+                    return &loadAccumulatorInHighMemoryAtC;
+                }
+                else if constexpr (y == 5)
+                {
+                    return &loadAccumulatorAtImmediateAddress;
+                }
+                else if constexpr (y == 6)
+                {
+                    return &loadHighMemoryAtCInAccumulator;
+                }
+                else
+                {
+                    return &loadImmediateAddressInAccumulator;
+                }
+            }
+            else if constexpr (z == 3)
+            {
+                if constexpr (y == 0)
+                {
+                    return &jump;
+                }
+                else if constexpr (y == 1)
+                {
+                    return &extendedOperation;
+                }
+                else if constexpr (y == 6)
+                {
+                    return &disableInterrupts;
+                }
+                else if constexpr (y == 7)
+                {
+                    return &enableInterrupts;
+                }
+                else
+                {
+                    return &unhandled<OPCODE>;
+                }
+            }
+            else if constexpr (z == 4)
+            {
+                return y < 4 ? &callConditional<y & 0x03> : &unhandled<OPCODE>;
+            }
+            else if constexpr (z == 5)
+            {
+                if constexpr (q == 0)
+                {
+                    return &push<p>;
+                }
+                else
+                {
+                    return p == 0 ? &call : &unhandled<OPCODE>;
+                }
+            }
+            else if constexpr (z == 6)
+            {
+                return &arithmeticLogicalImmediate<y>;
+            }
+            else
+            {
+                return &restart<static_cast<byte>(y * 8)>;
+            }
+        }
+    }
+
+    /******************************************************/
+    /*************** Extended instructions ****************/
+    /******************************************************/
+
+    /**
+     * RLC / RRC / RL / RR / SLA / SRA / SWAP / SRL on a register or (HL)
+     */
+    template <int OPERATION, int R>
+    static void rotateShift(CPU& cpu)
+    {
+        if constexpr (R == HL_MEMORY)
+        {
+            if constexpr (OPERATION == 0)
+            {
+                cpu.rotateValueInMemoryLeftCircular(cpu._hl.value());
+            }
+            else if constexpr (OPERATION == 1)
+            {
+                cpu.rotateValueInMemoryRightCircular(cpu._hl.value());
+            }
+            else if constexpr (OPERATION == 2)
+            {
+                cpu.rotateValueInMemoryLeft(cpu._hl.value());
+            }
+            else if constexpr (OPERATION == 3)
+            {
+                cpu.rotateValueInMemoryRight(cpu._hl.value());
+            }
+            else if constexpr (OPERATION == 4)
+            {
+                cpu.shiftLeftArithmeticMemory(cpu._hl.value());
+            }
+            else if constexpr (OPERATION == 5)
+            {
+                cpu.shiftRightArithmeticMemory(cpu._hl.value());
+            }
+            else if constexpr (OPERATION == 6)
+            {
+                cpu.swapNibblesInMemory(cpu._hl.value());
+            }
+            else
+            {
+                cpu.shiftRightLogicalMemory(cpu._hl.value());
+            }
+        }
+        else
+        {
+            if constexpr (OPERATION == 0)
+            {
+                cpu.rotateRegisterLeftCircularExtended(reg<R>(cpu));
+            }
+            else if constexpr (OPERATION == 1)
+            {
+                cpu.rotateRegisterRightCircularExtended(reg<R>(cpu));
+            }
+            else if constexpr (OPERATION == 2)
+            {
+                cpu.rotateRegisterLeftExtended(reg<R>(cpu));
+            }
+            else if constexpr (OPERATION == 3)
+            {
+                cpu.rotateRegisterRightExtended(reg<R>(cpu));
+            }
+            else if constexpr (OPERATION == 4)
+            {
+                cpu.shiftLeftArithmeticRegister(reg<R>(cpu));
+            }
+            else if constexpr (OPERATION == 5)
+            {
+                cpu.shiftRightArithmeticRegister(reg<R>(cpu));
+            }
+            else if constexpr (OPERATION == 6)
+            {
+                cpu.swapNibblesInRegister(reg<R>(cpu));
+            }
+            else
+            {
+                cpu.shiftRightLogicalRegister(reg<R>(cpu));
+            }
+        }
+    }
+
+    template <int BIT, int R>
+    static void testBit(CPU& cpu)
+    {
+        if constexpr (R == HL_MEMORY)
+        {
+            cpu.isBitSetInMemory(cpu._hl.value(), BIT);
+        }
+        else
+        {
+            cpu.isBitSetForValue(reg<R>(cpu), BIT);
+        }
+    }
+
+    template <int BIT, int R>
+    static void resetBit(CPU& cpu)
+    {
+        if constexpr (R == HL_MEMORY)
+        {
+            cpu.resetBitInMemory(cpu._hl.value(), BIT);
+        }
+        else
+        {
+            cpu.resetBitForValue(reg<R>(cpu), BIT);
+        }
+    }
+
+    template <int BIT, int R>
+    static void setBit(CPU& cpu)
+    {
+        if constexpr (R == HL_MEMORY)
+        {
+            cpu.setBitInMemory(cpu._hl.value(), BIT);
+        }
+        else
+        {
+            cpu.setBitForValue(reg<R>(cpu), BIT);
+        }
+    }
+
+    /**
+     * RLC / RRC / RL / RR / SLA / SRA / SWAP / SRL on the operand decoded from the opcode
+     */
+    static void rotateShiftKernel(CPU& cpu, byte opCode)
+    {
+        const int operation = (opCode >> 3) & 0x07;
+        const int r = opCode & 0x07;
+        if (r == HL_MEMORY)
+        {
+            const word addr = cpu._hl.value();
+            switch (operation)
+            {
+            case 0:
+                cpu.rotateValueInMemoryLeftCircular(addr);
+                break;
+            case 1:
+                cpu.rotateValueInMemoryRightCircular(addr);
+                break;
+            case 2:
+                cpu.rotateValueInMemoryLeft(addr);
+                break;
+            case 3:
+                cpu.rotateValueInMemoryRight(addr);
+                break;
+            case 4:
+                cpu.shiftLeftArithmeticMemory(addr);
+                break;
+            case 5:
+                cpu.shiftRightArithmeticMemory(addr);
+                break;
+            case 6:
+                cpu.swapNibblesInMemory(addr);
+                break;
+            default:
+                cpu.shiftRightLogicalMemory(addr);
+                break;
+            }
+            return;
+        }
+
+        byte& value = reg(cpu, r);
+        switch (operation)
+        {
+        case 0:
+            cpu.rotateRegisterLeftCircularExtended(value);
+            break;
+        case 1:
+            cpu.rotateRegisterRightCircularExtended(value);
+            break;
+        case 2:
+            cpu.rotateRegisterLeftExtended(value);
+            break;
+        case 3:
+            cpu.rotateRegisterRightExtended(value);
+            break;
+        case 4:
+            cpu.shiftLeftArithmeticRegister(value);
+            break;
+        case 5:
+            cpu.shiftRightArithmeticRegister(value);
+            break;
+        case 6:
+            cpu.swapNibblesInRegister(value);
+            break;
+        default:
+            cpu.shiftRightLogicalRegister(value);
+            break;
+        }
+    }
+
+    /**
+     * BIT b, r with the bit and the operand decoded from the opcode
+     */
+    static void testBitKernel(CPU& cpu, byte opCode)
+    {
+        const byte bit = (opCode >> 3) & 0x07;
+        const int r = opCode & 0x07;
+        if (r == HL_MEMORY)
+        {
+            cpu.isBitSetInMemory(cpu._hl.value(), bit);
+        }
+        else
+        {
+            cpu.isBitSetForValue(reg(cpu, r), bit);
+        }
+    }
+
+    /**
+     * RES b, r with the bit and the operand decoded from the opcode
+     */
+    static void resetBitKernel(CPU& cpu, byte opCode)
+    {
+        const byte bit = (opCode >> 3) & 0x07;
+        const int r = opCode & 0x07;
+        if (r == HL_MEMORY)
+        {
+            cpu.resetBitInMemory(cpu._hl.value(), bit);
+        }
+        else
+        {
+            cpu.resetBitForValue(reg(cpu, r), bit);
+        }
+    }
+
+    /**
+     * SET b, r with the bit and the operand decoded from the opcode
+     */
+    static void setBitKernel(CPU& cpu, byte opCode)
+    {
+        const byte bit = (opCode >> 3) & 0x07;
+        const int r = opCode & 0x07;
+        if (r == HL_MEMORY)
+        {
+            cpu.setBitInMemory(cpu._hl.value(), bit);
+        }
+        else
+        {
+            cpu.setBitForValue(reg(cpu, r), bit);
+        }
+    }
+
+    /**
+     * Select the handler of an extended instruction from its opcode.
+     */
+    template <byte OPCODE>
+    static constexpr Handler extendedHandler()
+    {
+        constexpr int x = OPCODE >> 6;
+        constexpr int y = (OPCODE >> 3) & 0x07;
+        constexpr int z = OPCODE & 0x07;
+
+        if constexpr (x == 0)
+        {
+            return &rotateShift<y, z>;
+        }
+        else if constexpr (x == 1)
+        {
+            return &testBit<y, z>;
+        }
+        else if constexpr (x == 2)
+        {
+            return &resetBit<y, z>;
+        }
+        else
+        {
+            return &setBit<y, z>;
+        }
+    }
+
+    /**
+     * Execute an extended instruction whose opcode is already known, the prefix was already skipped.
+     */
+    template <byte OPCODE>
+    static void prefixedExtendedOperation(CPU& cpu)
+    {
+        constexpr Handler handler = extendedHandler<OPCODE>();
+        cpu.pc++;
+        handler(cpu);
+    }
+
+    template <size_t... OPCODES>
+    static constexpr HandlerTable makeStandardTable(std::index_sequence<OPCODES...>)
+    {
+        return {{standardHandler<static_cast<byte>(OPCODES)>()...}};
+    }
+
+    template <size_t... OPCODES>
+    static constexpr HandlerTable makeExtendedTable(std::index_sequence<OPCODES...>)
+    {
+        return {{&prefixedExtendedOperation<static_cast<byte>(OPCODES)>...}};
+    }
+
+    /**
+     * @return the handlers of the 256 standard instructions, indexed by opcode
+     */
+    static constexpr HandlerTable standardTable()
+    {
+        return makeStandardTable(std::make_index_sequence<256>{});
+    }
+
+    /**
+     * @return the handlers of the 256 extended instructions, indexed by extended opcode,
+     *         used when the extended opcode is decoded ahead of time
+     */
+    static constexpr HandlerTable extendedTable()
+    {
+        return makeExtendedTable(std::make_index_sequence<256>{});
+    }
+
+    /**
+     * @return the kernels of the extended instructions, indexed by the 2 highest bits of the opcode
+     */
+    static constexpr std::array<ExtendedKernel, 4> extendedKernels()
+    {
+        return {{&rotateShiftKernel, &testBitKernel, &resetBitKernel, &setBitKernel}};
+    }
+};
+
+#endif // GBEMULATOR_INSTRUCTION_HANDLERS_HPP
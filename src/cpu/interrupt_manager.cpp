@@ -1,24 +1,26 @@
 #include "cpu/interrupt_manager.hpp"
-#include "cpu/interrupt_handler.hpp"
+#include "cpu/cpu.hpp"
 
 bool InterruptManager::isInterruptEnabled(InterruptType type)
 {
-    return utils::isNthBitSet(_interruptEnableFlag, bitPositionInFlagForInterruptType[type]);
+    return utils::isNthBitSet(_interruptEnableFlag, getBitPosition(type));
 }
 
 bool InterruptManager::isInterruptPending(InterruptType type)
 {
-    return utils::isNthBitSet(_interruptFlag, bitPositionInFlagForInterruptType[type]);
+    return utils::isNthBitSet(_interruptFlag, getBitPosition(type));
 }
 
 void InterruptManager::raiseInterrupt(InterruptType type)
 {
-    utils::setNthBit(_interruptFlag, bitPositionInFlagForInterruptType[type], true);
+    utils::setNthBit(_interruptFlag, getBitPosition(type), true);
+    updateInterruptsToHandle();
 }
 
 void InterruptManager::clearInterrupt(InterruptType type)
 {
-    utils::setNthBit(_interruptFlag, bitPositionInFlagForInterruptType[type], false);
+    utils::setNthBit(_interruptFlag, getBitPosition(type), false);
+    updateInterruptsToHandle();
 }
 
 bool InterruptManager::isAnyInterruptEnabled()
@@ -31,29 +33,30 @@ bool InterruptManager::isAnyInterruptPending()
     return (_interruptFlag & 0x1F) > 0;
 }
 
-InterruptManager::InterruptManager(CPU* cpu)
+InterruptManager::InterruptManager(CPU* cpu) : _cpu(cpu)
 {
-    _interruptHandlers.push_back(std::make_unique<InterruptHandlerVBlank>(cpu, this));
-    _interruptHandlers.push_back(std::make_unique<InterruptHandlerLCDStat>(cpu, this));
-    _interruptHandlers.push_back(std::make_unique<InterruptHandlerTimer>(cpu, this));
-    _interruptHandlers.push_back(std::make_unique<InterruptHandlerSerial>(cpu, this));
-    _interruptHandlers.push_back(std::make_unique<InterruptHandlerJoypad>(cpu, this));
 }
 
-bool InterruptManager::handleInterrupts()
+void InterruptManager::setInterruptMasterEnable(bool enable)
 {
-    if (isAnyInterruptEnabled() && isAnyInterruptPending())
-    {
-        for (auto& handler : _interruptHandlers)
-        {
-            if (handler->handle())
-            {
-                return true;
-            }
-        }
-    }
+    _interruptMasterEnable = enable;
+    updateInterruptsToHandle();
+}
 
-    return false;
+void InterruptManager::updateInterruptsToHandle()
+{
+    _enabledPendingInterrupts = _interruptEnableFlag & _interruptFlag & 0x1F;
+    _interruptsToHandle = _interruptMasterEnable ? _enabledPendingInterrupts : 0;
+}
+
+void InterruptManager::handleFirstInterrupt()
+{
+    // The lowest bit set has the highest priority
+    int bitPosition = utils::getLowestSetBitPosition(_interruptsToHandle);
+    utils::setNthBit(_interruptFlag, bitPosition, false);
+    _interruptMasterEnable = false;
+    updateInterruptsToHandle();
+    _cpu->callInterruptRoutine(INTERRUPT_ROUTINE_ADDRESSES[bitPosition]);
 }
 
 byte InterruptManager::getInterruptEnableFlag() const
@@ -64,6 +67,7 @@ byte InterruptManager::getInterruptEnableFlag() const
 void InterruptManager::setInterruptEnableFlag(byte interruptEnableFlag)
 {
     _interruptEnableFlag = interruptEnableFlag;
+    updateInterruptsToHandle();
 }
 
 byte InterruptManager::getInterruptFlag() const
@@ -74,4 +78,5 @@ byte InterruptManager::getInterruptFlag() const
 void InterruptManager::setInterruptFlag(byte interruptFlag)
 {
     _interruptFlag = interruptFlag;
+    updateInterruptsToHandle();
 }
@@ -4,12 +4,15 @@
 #include "cpu/interrupt_manager.hpp"
 #include "memory/mmu.hpp"
 
+#include <array>
+
 // Forward declaration
 class CPU;
-class InterruptHandler;
 
 /**
  * The possible type of interrupts that can be triggered by the system.
+ * The value of a type is its bit position in the "interrupt flag" and "interrupt enable" values,
+ * the lowest bit having the highest priority.
  */
 enum class InterruptType
 {
@@ -41,7 +44,10 @@ enum class InterruptType
  * A generic Manager class for system interrupts.
  * This class is responsible for enabling/disabling interrupts,
  * Raising/checking/clearing pending interrupts,
- * and calling interrupt handlers to handle pending interrupts.
+ * and calling the interrupt routines to handle pending interrupts.
+ *
+ * The interrupts that can be handled (enabled, pending and with the interrupt master enable flag set)
+ * are kept in a latch updated when one of these values changes, so checking them before each instruction is cheap.
  */
 class InterruptManager
 {
@@ -91,12 +97,55 @@ class InterruptManager
      */
     void clearInterrupt(InterruptType type);
 
+    /**
+     * Is there any interrupt that is both enabled and pending, regardless of the interrupt master enable flag.
+     * Such an interrupt wakes up a halted CPU.
+     * @return true if an enabled interrupt is pending, false otherwise.
+     */
+    bool isAnyEnabledInterruptPending() const
+    {
+        return _enabledPendingInterrupts != 0;
+    }
+
+    /**
+     * Is there any interrupt that can be handled: enabled, pending and with the interrupt master enable flag set.
+     * @return true if an interrupt can be handled, false otherwise.
+     */
+    bool hasInterruptToHandle() const
+    {
+        return _interruptsToHandle != 0;
+    }
+
     /**
      * Handle the first (ordered by priority) enabled and pending interrupts.
-     * Handling an interrupt involves clearing it and calling the interrupt routine.
+     * Handling an interrupt involves clearing it, disabling the interrupts and calling the interrupt routine.
      * @return Return true if any interrupt was handled, false otherwise.
      */
-    bool handleInterrupts();
+    bool handleInterrupts()
+    {
+        if (_interruptsToHandle == 0)
+        {
+            return false;
+        }
+
+        handleFirstInterrupt();
+        return true;
+    }
+
+    /**
+     * Is the interrupt master enable flag (IME) set, allowing the interrupts to be handled.
+     * @return true if the interrupts can be handled, false otherwise.
+     */
+    bool isInterruptMasterEnabled() const
+    {
+        return _interruptMasterEnable;
+    }
+
+    /**
+     * Set the interrupt master enable flag (IME).
+     * @param enable true to allow the interrupts to be handled, false otherwise.
+     */
+    void setInterruptMasterEnable(bool enable);
 
     /**
      * Retrieves the interrupt enable flag.
@@ -131,23 +180,43 @@ class InterruptManager
      * @param interruptFlag The value to set the interrupt flag to.
      */
     void setInterruptFlag(byte interruptFlag);
+
   private:
     /**
-     * The mapping between an interrupt type and the bit position for the
-     * different bitflags.
-     * Can be used to access a specific value in the "interrupt flag" and "interrupt enable" value.
+     * Get the bit of an interrupt type in the "interrupt flag" and "interrupt enable" values.
+     * @param type The type of the interrupt.
+     * @return the position of the bit.
+     */
+    static constexpr int getBitPosition(InterruptType type)
+    {
+        return static_cast<int>(type);
+    }
+
+    /**
+     * Compute again the interrupts that are enabled and pending, and the ones that can be handled.
      */
-    std::map<InterruptType, int> bitPositionInFlagForInterruptType = {
-        {InterruptType::VBLANK, 0}, {InterruptType::LCD_STAT, 1}, {InterruptType::TIMER, 2},
-        {InterruptType::SERIAL, 3}, {InterruptType::JOYPAD, 4},
-    };
+    void updateInterruptsToHandle();
 
     /**
-     * A list of interrupts handlers to be used to handle the different interrupts type.
-     * The order of the handlers in the list represents their priorities:
-     * _interruptHandlers[0] has a higher priority than _interruptHandlers[1]
+     * Handle the interrupt with the highest priority that can be handled, there must be one.
      */
-    std::vector<std::unique_ptr<InterruptHandler>> _interruptHandlers;
+    void handleFirstInterrupt();
+
+    /**
+     * The number of interrupt types, the upper bits of the flags are unused.
+     */
+    static constexpr int NUMBER_OF_INTERRUPT_TYPES = 5;
+
+    /**
+     * The address of the routine of each interrupt type, indexed by the bit position of the type.
+     */
+    static constexpr std::array<word, NUMBER_OF_INTERRUPT_TYPES> INTERRUPT_ROUTINE_ADDRESSES = {0x40, 0x48, 0x50, 0x58,
+                                                                                                0x60};
+
+    /**
+     * Pointer towards the CPU, to call the interrupt routines.
+     */
+    CPU* _cpu = nullptr;
 
     /**
      * This value tells us which interrupt type is enabled and should be treated
@@ -155,7 +224,7 @@ class InterruptManager
      * This value is a bitset where bits position represents a certain interrupt type.
      * If a bit is set, then the interrupt type is enabled.
      *
-     * @see bitPositionInFlagForInterruptType for the bit mapping
+     * @see InterruptType for the bit mapping
      */
     byte _interruptEnableFlag = 0;
 
@@ -164,9 +233,24 @@ class InterruptManager
      * This value is a bitset where bits position represents a certain interrupt type.
      * If a bit is set, then the interrupt type is pending.
      *
-     * @see bitPositionInFlagForInterruptType for the bit mapping
+     * @see InterruptType for the bit mapping
      */
     byte _interruptFlag = 0;
+
+    /**
+     * The interrupt master enable flag (IME), if not set no interrupt is handled.
+     */
+    bool _interruptMasterEnable = false;
+
+    /**
+     * The interrupts that are enabled and pending, "interrupt enable" & "interrupt flag".
+     */
+    byte _enabledPendingInterrupts = 0;
+
+    /**
+     * The interrupts that can be handled, the enabled and pending ones if the interrupt master enable flag is set.
+     */
+    byte _interruptsToHandle = 0;
 };
 
 #endif // GBEMULATOR_INTERRUPT_MANAGER_HPP
@@ -0,0 +1,693 @@
+#include "jit_compiler.hpp"
+#include "cpu/cpu.hpp"
+#include <cstring>
+
+#if defined(__x86_64__) && defined(__linux__)
+#define JIT_SUPPORTED
+#include <sys/mman.h>
+#endif
+
+using namespace standardInstructions;
+
+namespace
+{
+/**
+ * Opcodes of the operations on the accumulator, indexed by bits 3-5 of the opcode.
+ */
+enum AccumulatorOperation
+{
+    ACC_ADD = 0,
+    ACC_ADC = 1,
+    ACC_SUB = 2,
+    ACC_SBC = 3,
+    ACC_AND = 4,
+    ACC_XOR = 5,
+    ACC_OR = 6,
+    ACC_CP = 7
+};
+
+/**
+ * Index of the (HL) operand in the 3 bits register encoding.
+ */
+const int MEMORY_OPERAND_INDEX = 6;
+
+const byte FLAG_ZERO = CPU::CpuFlags::ZERO;
+const byte FLAG_SUBSTRACTION = CPU::CpuFlags::SUBSTRACTION;
+const byte FLAG_HALF_CARRY = CPU::CpuFlags::HALF_CARRY;
+const byte FLAG_CARRY = CPU::CpuFlags::CARRY;
+const byte ALL_FLAGS = FLAG_ZERO | FLAG_SUBSTRACTION | FLAG_HALF_CARRY | FLAG_CARRY;
+
+/**
+ * Is the address mapped to an I/O register, the interrupt enable register included.
+ */
+bool isIORegister(int addr)
+{
+    return (addr >= 0xFF00 && addr < 0xFF80) || addr == 0xFFFF;
+}
+
+int32_t getOffset(const CPU& cpu, const void* field)
+{
+    return static_cast<int32_t>(static_cast<const uint8_t*>(field) - reinterpret_cast<const uint8_t*>(&cpu));
+}
+} // namespace
+
+JitCompiler::JitCompiler(CPU& cpu)
+{
+    _offsetA = getOffset(cpu, &cpu.a());
+    _offsetB = getOffset(cpu, &cpu.b());
+    _offsetC = getOffset(cpu, &cpu.c());
+    _offsetD = getOffset(cpu, &cpu.d());
+    _offsetE = getOffset(cpu, &cpu.e());
+    _offsetH = getOffset(cpu, &cpu.h());
+    _offsetL = getOffset(cpu, &cpu.l());
+    _offsetF = getOffset(cpu, &cpu.f());
+    _offsetPC = getOffset(cpu, &cpu.pc);
+    _offsetSP = getOffset(cpu, &cpu.sp);
+}
+
+JitCompiler::~JitCompiler()
+{
+#ifdef JIT_SUPPORTED
+    if (_codeBuffer != nullptr)
+    {
+        munmap(_codeBuffer, CODE_BUFFER_SIZE);
+    }
+#endif
+}
+
+bool JitCompiler::isSupported()
+{
+#ifdef JIT_SUPPORTED
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool JitCompiler::isFull() const
+{
+    return _isFull;
+}
+
+void JitCompiler::reset()
+{
+    _codeBufferUsedSize = 0;
+    _numberOfCompiledBlocks = 0;
+    _isFull = false;
+}
+
+bool JitCompiler::isInstructionSupported(const DecodedInstruction& instruction)
+{
+    byte opCode = instruction.opCode;
+
+    // LD r,r' / LD r,(HL) / LD (HL),r, HALT is in the middle of the range
+    if (opCode >= LD_B_B && opCode <= LD_A_A)
+    {
+        return opCode != HALT;
+    }
+
+    // Arithmetic/logical operations on the accumulator
+    if (opCode >= ADD_A_B && opCode <= CP_A)
+    {
+        return true;
+    }
+
+    switch (opCode)
+    {
+    case NOP:
+    case LD_BC_nn:
+    case LD_DE_nn:
+    case LD_HL_nn:
+    case LD_SP_nn:
+    case LD_BCm_A:
+    case LD_DEm_A:
+    case LD_A_BCm:
+    case LD_A_DEm:
+    case LD_HLm_I_A:
+    case LD_HLm_D_A:
+    case LD_A_HLm_I:
+    case LD_A_HLm_D:
+    case LD_HLm_n:
+    case LD_nnm_A:
+    case LD_A_nnm:
+    case INC_BC:
+    case INC_DE:
+    case INC_HL:
+    case INC_SP:
+    case DEC_BC:
+    case DEC_DE:
+    case DEC_HL:
+    case DEC_SP:
+    case INC_A:
+    case INC_B:
+    case INC_C:
+    case INC_D:
+    case INC_E:
+    case INC_H:
+    case INC_L:
+    case DEC_A:
+    case DEC_B:
+    case DEC_C:
+    case DEC_D:
+    case DEC_E:
+    case DEC_H:
+    case DEC_L:
+    case LD_A_n:
+    case LD_B_n:
+    case LD_C_n:
+    case LD_D_n:
+    case LD_E_n:
+    case LD_H_n:
+    case LD_L_n:
+    case ADD_A_n:
+    case ADC_A_n:
+    case SUB_A_n:
+    case SBC_A_n:
+    case AND_n:
+    case XOR_n:
+    case OR_n:
+    case CP_n:
+    case RLC_A:
+    case RRC_A:
+    case RL_A:
+    case RR_A:
+    case CPL:
+    case SCF:
+    case CCF:
+    case JR_n:
+    case JR_NZ_n:
+    case JR_Z_n:
+    case JR_NC_n:
+    case JR_C_n:
+    case JP_nn:
+    case JP_NZ_nn:
+    case JP_Z_nn:
+    case JP_NC_nn:
+    case JP_C_nn:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool JitCompiler::compile(BasicBlock& block)
+{
+#ifdef JIT_SUPPORTED
+    size_t numberOfInstructions = 0;
+    while (numberOfInstructions < block.instructions.size() &&
+           isInstructionSupported(block.instructions[numberOfInstructions]))
+    {
+        numberOfInstructions++;
+    }
+
+    if (numberOfInstructions == 0)
+    {
+        return false;
+    }
+
+    if (_codeBuffer == nullptr)
+    {
+        void* memory = mmap(nullptr, CODE_BUFFER_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED)
+        {
+            return false;
+        }
+        _codeBuffer = static_cast<uint8_t*>(memory);
+    }
+
+    _emitter.clear();
+    _emitter.prologue();
+    for (size_t i = 0; i < numberOfInstructions; ++i)
+    {
+        compileInstruction(block.instructions[i], static_cast<int>(i), i == numberOfInstructions - 1);
+    }
+
+    const std::vector<uint8_t>& code = _emitter.getCode();
+    if (_codeBufferUsedSize + code.size() > CODE_BUFFER_SIZE)
+    {
+        _isFull = true;
+        return false;
+    }
+
+    // The buffer is never writable and executable at the same time
+    uint8_t* blockCode = _codeBuffer + _codeBufferUsedSize;
+    mprotect(_codeBuffer, CODE_BUFFER_SIZE, PROT_READ | PROT_WRITE);
+    std::memcpy(blockCode, code.data(), code.size());
+    mprotect(_codeBuffer, CODE_BUFFER_SIZE, PROT_READ | PROT_EXEC);
+
+    // Keep the blocks aligned on 16 bytes
+    _codeBufferUsedSize += (code.size() + 15) & ~static_cast<size_t>(15);
+    _numberOfCompiledBlocks++;
+    block.nativeCode = reinterpret_cast<CompiledBlock>(blockCode);
+    return true;
+#else
+    (void)block;
+    return false;
+#endif
+}
+
+int32_t JitCompiler::getRegisterOffset(int registerIndex) const
+{
+    switch (registerIndex)
+    {
+    case 0:
+        return _offsetB;
+    case 1:
+        return _offsetC;
+    case 2:
+        return _offsetD;
+    case 3:
+        return _offsetE;
+    case 4:
+        return _offsetH;
+    case 5:
+        return _offsetL;
+    default:
+        return _offsetA;
+    }
+}
+
+void JitCompiler::compileInstruction(const DecodedInstruction& instruction, int index, bool isLast)
+{
+    using Reg = X86Emitter::Register;
+
+    byte opCode = instruction.opCode;
+    auto operand8 = static_cast<byte>(instruction.operand);
+    auto nextAddress = static_cast<word>(instruction.address + instruction.length);
+
+    switch (opCode)
+    {
+    case JR_n:
+    case JR_NZ_n:
+    case JR_Z_n:
+    case JR_NC_n:
+    case JR_C_n:
+        emitJump(instruction, index, static_cast<word>(nextAddress + static_cast<int8_t>(operand8)), opCode);
+        return;
+    case JP_nn:
+    case JP_NZ_nn:
+    case JP_Z_nn:
+    case JP_NC_nn:
+    case JP_C_nn:
+        emitJump(instruction, index, instruction.operand, opCode);
+        return;
+    default:
+        break;
+    }
+
+    if (opCode >= LD_B_B && opCode <= LD_A_A)
+    {
+        int dst = (opCode >> 3) & 0x07;
+        int src = opCode & 0x07;
+        if (src == MEMORY_OPERAND_INDEX)
+        {
+            emitLoadRegisterPair(_offsetH, _offsetL);
+            emitMemoryRead(index);
+        }
+        else if (dst == MEMORY_OPERAND_INDEX)
+        {
+            emitLoadRegisterPair(_offsetH, _offsetL);
+            _emitter.loadByte(Reg::EDX, getRegisterOffset(src));
+            emitMemoryWrite(index);
+        }
+        else
+        {
+            _emitter.loadByte(Reg::EAX, getRegisterOffset(src));
+        }
+
+        if (dst != MEMORY_OPERAND_INDEX)
+        {
+            _emitter.storeByte(getRegisterOffset(dst), Reg::EAX);
+        }
+    }
+    else if (opCode >= ADD_A_B && opCode <= CP_A)
+    {
+        int src = opCode & 0x07;
+        if (src == MEMORY_OPERAND_INDEX)
+        {
+            emitLoadRegisterPair(_offsetH, _offsetL);
+            emitMemoryRead(index);
+            _emitter.move(Reg::ECX, Reg::EAX);
+        }
+        else
+        {
+            _emitter.loadByte(Reg::ECX, getRegisterOffset(src));
+        }
+        emitAccumulatorOperation((opCode >> 3) & 0x07);
+    }
+    else
+    {
+        switch (opCode)
+        {
+        case NOP:
+            break;
+        case LD_BC_nn:
+        case LD_DE_nn:
+        case LD_HL_nn:
+            _emitter.storeByteImmediate(getRegisterOffset((opCode >> 3) & 0x06),
+                                        static_cast<uint8_t>(instruction.operand >> 8));
+            _emitter.storeByteImmediate(getRegisterOffset(((opCode >> 3) & 0x06) + 1), operand8);
+            break;
+        case LD_SP_nn:
+            _emitter.storeWordImmediate(_offsetSP, instruction.operand);
+            break;
+        case INC_BC:
+        case INC_DE:
+        case INC_HL:
+        case DEC_BC:
+        case DEC_DE:
+        case DEC_HL:
+            emitIncrementRegisterPair(getRegisterOffset((opCode >> 3) & 0x06),
+                                      getRegisterOffset(((opCode >> 3) & 0x06) + 1), (opCode & 0x08) != 0);
+            break;
+        case INC_SP:
+        case DEC_SP:
+            _emitter.incrementWordMemory(_offsetSP, opCode == DEC_SP);
+            break;
+        case LD_BCm_A:
+        case LD_DEm_A:
+            emitLoadRegisterPair(opCode == LD_BCm_A ? _offsetB : _offsetD, opCode == LD_BCm_A ? _offsetC : _offsetE);
+            _emitter.loadByte(Reg::EDX, _offsetA);
+            emitMemoryWrite(index);
+            break;
+        case LD_A_BCm:
+        case LD_A_DEm:
+            emitLoadRegisterPair(opCode == LD_A_BCm ? _offsetB : _offsetD, opCode == LD_A_BCm ? _offsetC : _offsetE);
+            emitMemoryRead(index);
+            _emitter.storeByte(_offsetA, Reg::EAX);
+            break;
+        case LD_HLm_I_A:
+        case LD_HLm_D_A:
+            emitLoadRegisterPair(_offsetH, _offsetL);
+            _emitter.loadByte(Reg::EDX, _offsetA);
+            emitMemoryWrite(index);
+            emitIncrementRegisterPair(_offsetH, _offsetL, opCode == LD_HLm_D_A);
+            break;
+        case LD_A_HLm_I:
+        case LD_A_HLm_D:
+            emitLoadRegisterPair(_offsetH, _offsetL);
+            emitMemoryRead(index);
+            _emitter.storeByte(_offsetA, Reg::EAX);
+            emitIncrementRegisterPair(_offsetH, _offsetL, opCode == LD_A_HLm_D);
+            break;
+        case LD_HLm_n:
+            emitLoadRegisterPair(_offsetH, _offsetL);
+            _emitter.moveImmediate(Reg::EDX, operand8);
+            emitMemoryWrite(index);
+            break;
+        case LD_nnm_A:
+            _emitter.moveImmediate(Reg::ESI, instruction.operand);
+            _emitter.loadByte(Reg::EDX, _offsetA);
+            emitMemoryWrite(index);
+            break;
+        case LD_A_nnm:
+            _emitter.moveImmediate(Reg::ESI, instruction.operand);
+            emitMemoryRead(index);
+            _emitter.storeByte(_offsetA, Reg::EAX);
+            break;
+        case INC_A:
+        case INC_B:
+        case INC_C:
+        case INC_D:
+        case INC_E:
+        case INC_H:
+        case INC_L:
+        case DEC_A:
+        case DEC_B:
+        case DEC_C:
+        case DEC_D:
+        case DEC_E:
+        case DEC_H:
+        case DEC_L: {
+            bool isDecrement = (opCode & 0x01) != 0;
+            int32_t offset = getRegisterOffset((opCode >> 3) & 0x07);
+            _emitter.loadByte(Reg::EAX, offset);
+            _emitter.incrementByte(Reg::EAX, isDecrement);
+            _emitter.loadHostFlagsInEdx();
+            _emitter.storeByte(offset, Reg::EAX);
+            emitFlags(FLAG_ZERO | FLAG_HALF_CARRY, isDecrement ? FLAG_SUBSTRACTION : 0,
+                      FLAG_ZERO | FLAG_SUBSTRACTION | FLAG_HALF_CARRY);
+            break;
+        }
+        case LD_A_n:
+        case LD_B_n:
+        case LD_C_n:
+        case LD_D_n:
+        case LD_E_n:
+        case LD_H_n:
+        case LD_L_n:
+            _emitter.storeByteImmediate(getRegisterOffset((opCode >> 3) & 0x07), operand8);
+            break;
+        case ADD_A_n:
+        case ADC_A_n:
+        case SUB_A_n:
+        case SBC_A_n:
+        case AND_n:
+        case XOR_n:
+        case OR_n:
+        case CP_n:
+            _emitter.moveImmediate(Reg::ECX, operand8);
+            emitAccumulatorOperation((opCode >> 3) & 0x07);
+            break;
+        case RLC_A:
+        case RRC_A:
+        case RL_A:
+        case RR_A: {
+            static const X86Emitter::RotateOperation rotations[] = {X86Emitter::ROL, X86Emitter::ROR,
+                                                                     X86Emitter::RCL, X86Emitter::RCR};
+            bool isThroughCarry = opCode == RL_A || opCode == RR_A;
+            _emitter.loadByte(Reg::EAX, _offsetA);
+            if (isThroughCarry)
+            {
+                // Move the carry flag of the CPU to the carry flag of the host
+                _emitter.loadByte(Reg::EDX, _offsetF);
+                _emitter.shiftRight(Reg::EDX, 5);
+            }
+            _emitter.rotateByte(rotations[opCode >> 3], Reg::EAX);
+            _emitter.loadHostFlagsInEdx();
+            _emitter.storeByte(_offsetA, Reg::EAX);
+            emitFlags(FLAG_CARRY, 0, ALL_FLAGS);
+            break;
+        }
+        case CPL:
+            _emitter.loadByte(Reg::EAX, _offsetA);
+            _emitter.notByte(Reg::EAX);
+            _emitter.storeByte(_offsetA, Reg::EAX);
+            _emitter.aluByteMemoryImmediate(X86Emitter::OR, _offsetF, FLAG_SUBSTRACTION | FLAG_HALF_CARRY);
+            break;
+        case SCF:
+            _emitter.aluByteMemoryImmediate(X86Emitter::AND, _offsetF,
+                                            static_cast<uint8_t>(~(FLAG_SUBSTRACTION | FLAG_HALF_CARRY)));
+            _emitter.aluByteMemoryImmediate(X86Emitter::OR, _offsetF, FLAG_CARRY);
+            break;
+        case CCF:
+            _emitter.aluByteMemoryImmediate(X86Emitter::AND, _offsetF,
+                                            static_cast<uint8_t>(~(FLAG_SUBSTRACTION | FLAG_HALF_CARRY)));
+            _emitter.aluByteMemoryImmediate(X86Emitter::XOR, _offsetF, FLAG_CARRY);
+            break;
+        default:
+            break;
+        }
+    }
+
+    _emitter.storeWordImmediate(_offsetPC, nextAddress);
+    emitSynchronization(index, instruction.ticks, isLast);
+}
+
+void JitCompiler::emitSynchronization(int index, int ticks, bool isLast)
+{
+    _emitter.moveImmediate(X86Emitter::ESI, static_cast<uint32_t>(ticks));
+    _emitter.callWithCpu(reinterpret_cast<const void*>(&JitCompiler::synchronize));
+
+    if (!isLast)
+    {
+        _emitter.test(X86Emitter::EAX);
+        size_t continueLabel = _emitter.jumpForward(X86Emitter::NOT_ZERO);
+        emitExit(index + 1);
+        _emitter.bindLabel(continueLabel);
+    }
+    else
+    {
+        emitExit(index + 1);
+    }
+}
+
+void JitCompiler::emitExit(int numberOfExecutedInstructions)
+{
+    _emitter.moveImmediate(X86Emitter::EAX, static_cast<uint32_t>(numberOfExecutedInstructions));
+    _emitter.epilogue();
+}
+
+void JitCompiler::emitFlags(byte fromHost, byte forced, byte affected)
+{
+    using Reg = X86Emitter::Register;
+
+    // Host flags: carry is bit 0, half-carry is bit 4, zero is bit 6
+    _emitter.move(Reg::ECX, Reg::EDX);
+    _emitter.aluImmediate(X86Emitter::AND, Reg::ECX, 0x50);
+    _emitter.shiftLeft(Reg::ECX, 1);
+    _emitter.aluImmediate(X86Emitter::AND, Reg::EDX, 0x01);
+    _emitter.shiftLeft(Reg::EDX, 4);
+    _emitter.alu(X86Emitter::OR, Reg::ECX, Reg::EDX);
+    _emitter.aluImmediate(X86Emitter::AND, Reg::ECX, fromHost);
+    if (forced != 0)
+    {
+        _emitter.aluImmediate(X86Emitter::OR, Reg::ECX, forced);
+    }
+
+    // Keep the flags that are not affected by the operation
+    _emitter.loadByte(Reg::EDX, _offsetF);
+    _emitter.aluImmediate(X86Emitter::AND, Reg::EDX, static_cast<byte>(~affected));
+    _emitter.alu(X86Emitter::OR, Reg::ECX, Reg::EDX);
+    _emitter.storeByte(_offsetF, Reg::ECX);
+}
+
+void JitCompiler::emitLoadRegisterPair(int32_t msbOffset, int32_t lsbOffset)
+{
+    using Reg = X86Emitter::Register;
+
+    _emitter.loadByte(Reg::ESI, msbOffset);
+    _emitter.shiftLeft(Reg::ESI, 8);
+    _emitter.loadByte(Reg::EAX, lsbOffset);
+    _emitter.alu(X86Emitter::OR, Reg::ESI, Reg::EAX);
+}
+
+void JitCompiler::emitIncrementRegisterPair(int32_t msbOffset, int32_t lsbOffset, bool decrement)
+{
+    using Reg = X86Emitter::Register;
+
+    _emitter.loadByte(Reg::EAX, msbOffset);
+    _emitter.shiftLeft(Reg::EAX, 8);
+    _emitter.loadByte(Reg::ECX, lsbOffset);
+    _emitter.alu(X86Emitter::OR, Reg::EAX, Reg::ECX);
+    _emitter.increment(Reg::EAX, decrement);
+    _emitter.storeByte(lsbOffset, Reg::EAX);
+    _emitter.shiftRight(Reg::EAX, 8);
+    _emitter.storeByte(msbOffset, Reg::EAX);
+}
+
+void JitCompiler::emitMemoryRead(int index)
+{
+    _emitter.callWithCpu(reinterpret_cast<const void*>(&JitCompiler::readMemory));
+    _emitter.test(X86Emitter::EAX);
+    size_t continueLabel = _emitter.jumpForward(X86Emitter::NOT_SIGN);
+    emitExit(index);
+    _emitter.bindLabel(continueLabel);
+}
+
+void JitCompiler::emitMemoryWrite(int index)
+{
+    _emitter.callWithCpu(reinterpret_cast<const void*>(&JitCompiler::writeMemory));
+    _emitter.test(X86Emitter::EAX);
+    size_t continueLabel = _emitter.jumpForward(X86Emitter::NOT_ZERO);
+    emitExit(index);
+    _emitter.bindLabel(continueLabel);
+}
+
+void JitCompiler::emitAccumulatorOperation(int operation)
+{
+    using Reg = X86Emitter::Register;
+
+    static const X86Emitter::AluOperation hostOperations[] = {X86Emitter::ADD, X86Emitter::ADC, X86Emitter::SUB,
+                                                              X86Emitter::SBB, X86Emitter::AND, X86Emitter::XOR,
+                                                              X86Emitter::OR,  X86Emitter::CMP};
+
+    _emitter.loadByte(Reg::EAX, _offsetA);
+    if (operation == ACC_ADC || operation == ACC_SBC)
+    {
+        // Move the carry flag of the CPU to the carry flag of the host
+        _emitter.loadByte(Reg::EDX, _offsetF);
+        _emitter.shiftRight(Reg::EDX, 5);
+    }
+    _emitter.aluByte(hostOperations[operation], Reg::EAX, Reg::ECX);
+    _emitter.loadHostFlagsInEdx();
+    if (operation != ACC_CP)
+    {
+        _emitter.storeByte(_offsetA, Reg::EAX);
+    }
+
+    switch (operation)
+    {
+    case ACC_ADD:
+    case ACC_ADC:
+        emitFlags(FLAG_ZERO | FLAG_HALF_CARRY | FLAG_CARRY, 0, ALL_FLAGS);
+        break;
+    case ACC_SUB:
+    case ACC_SBC:
+    case ACC_CP:
+        emitFlags(FLAG_ZERO | FLAG_HALF_CARRY | FLAG_CARRY, FLAG_SUBSTRACTION, ALL_FLAGS);
+        break;
+    case ACC_AND:
+        emitFlags(FLAG_ZERO, FLAG_HALF_CARRY, ALL_FLAGS);
+        break;
+    default:
+        emitFlags(FLAG_ZERO, 0, ALL_FLAGS);
+        break;
+    }
+}
+
+void JitCompiler::emitJump(const DecodedInstruction& instruction, int index, word target, int conditionOpCode)
+{
+    auto nextAddress = static_cast<word>(instruction.address + instruction.length);
+    if (conditionOpCode == JR_n || conditionOpCode == JP_nn)
+    {
+        _emitter.storeWordImmediate(_offsetPC, target);
+        emitSynchronization(index, instruction.branchTicks, true);
+        return;
+    }
+
+    // Bits 3-4 of the opcode encode the condition: NZ, Z, NC, C
+    int condition = (conditionOpCode >> 3) & 0x03;
+    bool isCarryCondition = condition >= 2;
+    bool isJumpWhenSet = (condition & 0x01) != 0;
+
+    _emitter.loadByte(X86Emitter::EAX, _offsetF);
+    _emitter.testAccumulatorImmediate(isCarryCondition ? FLAG_CARRY : FLAG_ZERO);
+    // The host zero flag is set when the CPU flag is not set
+    size_t notTakenLabel = _emitter.jumpForward(isJumpWhenSet ? X86Emitter::ZERO : X86Emitter::NOT_ZERO);
+    _emitter.storeWordImmediate(_offsetPC, target);
+    _emitter.moveImmediate(X86Emitter::ESI, instruction.branchTicks);
+    size_t synchronizeLabel = _emitter.jumpForward();
+    _emitter.bindLabel(notTakenLabel);
+    _emitter.storeWordImmediate(_offsetPC, nextAddress);
+    _emitter.moveImmediate(X86Emitter::ESI, instruction.ticks);
+    _emitter.bindLabel(synchronizeLabel);
+    _emitter.callWithCpu(reinterpret_cast<const void*>(&JitCompiler::synchronize));
+    emitExit(index + 1);
+}
+
+int JitCompiler::synchronize(CPU* cpu, int ticks)
+{
+    cpu->lastInstructionTicks = ticks;
+    cpu->tick += ticks;
+    cpu->_jitExecutedTicks += ticks;
+    cpu->notifyInstructionExecuted(ticks);
+
+    bool isInterruptRequested = cpu->_interruptManager.hasInterruptToHandle();
+    bool isBlockModified = cpu->_jitEntryEpoch != cpu->_basicBlockCache.getEpoch();
+    bool isTickLimitReached = cpu->_jitExecutedTicks >= cpu->_maxExecutedTicks;
+
+    return !isInterruptRequested && !isBlockModified && !isTickLimitReached;
+}
+
+int JitCompiler::readMemory(CPU* cpu, int addr)
+{
+    if (isIORegister(addr))
+    {
+        return -1;
+    }
+
+    return cpu->mmu.read(static_cast<word>(addr));
+}
+
+int JitCompiler::writeMemory(CPU* cpu, int addr, int value)
+{
+    // Writing to the ROM talks to the memory bank controller
+    if (addr < 0x8000 || isIORegister(addr))
+    {
+        return 0;
+    }
+
+    cpu->mmu.write(static_cast<word>(addr), static_cast<byte>(value));
+    return 1;
+}
@@ -0,0 +1,232 @@
+#ifndef GBEMULATOR_JIT_COMPILER_HPP
+#define GBEMULATOR_JIT_COMPILER_HPP
+
+#include "common/types.hpp"
+#include "cpu/basic_block_cache.hpp"
+#include "cpu/jit/x86_64_emitter.hpp"
+#include <cstddef>
+#include <cstdint>
+
+// Forward declaration
+class CPU;
+
+/**
+ * Dynamic recompiler translating hot basic blocks to x86-64 machine code.
+ *
+ * The compiled code works directly on the registers of the CPU and only handles
+ * the instructions that can be translated without changing the behavior of the emulator:
+ * register operations, memory accesses outside of the I/O registers and relative/absolute jumps.
+ * A block is compiled up to its first instruction that cannot be translated,
+ * the rest of the block is left to the interpreter.
+ *
+ * After each instruction, the compiled code synchronizes the other components of the system
+ * through the CPU, and gives the control back to the interpreter when an interrupt needs to be serviced,
+ * when the block was modified (self-modifying code) or when the ticks given to CPU::fetchDecodeAndExecute()
+ * are reached.
+ * When an instruction accesses an I/O register or a memory bank controller, the compiled code
+ * exits right before it so that the interpreter can execute it.
+ *
+ * The JIT is only available on x86-64 Linux, isSupported() needs to be checked before using it.
+ */
+class JitCompiler
+{
+  public:
+    /**
+     * Signature of a compiled block.
+     * The function returns the number of instructions of the block that were executed.
+     */
+    typedef BasicBlock::CompiledCode CompiledBlock;
+
+    /**
+     * Create a new compiler generating code for the given CPU.
+     *
+     * @param cpu The CPU whose registers will be used by the compiled code
+     */
+    explicit JitCompiler(CPU& cpu);
+
+    ~JitCompiler();
+
+    JitCompiler(const JitCompiler&) = delete;
+    JitCompiler& operator=(const JitCompiler&) = delete;
+
+    /**
+     * Can the JIT be used on the host platform.
+     *
+     * @return true if the JIT is supported, false otherwise
+     */
+    static bool isSupported();
+
+    /**
+     * Can the given instruction be translated to native code.
+     *
+     * @param instruction The decoded instruction
+     * @return true if the instruction can be compiled, false otherwise
+     */
+    static bool isInstructionSupported(const DecodedInstruction& instruction);
+
+    /**
+     * Compile a block to native code, the code is stored in the block.
+     * Compiling fails if the first instruction of the block can't be translated
+     * or if there is no space left for the code, see isFull().
+     *
+     * @param block The block to compile
+     * @return true if the block was compiled, false otherwise
+     */
+    bool compile(BasicBlock& block);
+
+    /**
+     * Is the memory used to store the compiled code full.
+     * When it's full, all the blocks need to be discarded before calling reset().
+     *
+     * @return true if no more blocks can be compiled, false otherwise
+     */
+    bool isFull() const;
+
+    /**
+     * Discard all the compiled code.
+     * The blocks that were compiled before can no longer be executed.
+     */
+    void reset();
+
+    /**
+     * @return the number of blocks compiled since the last reset
+     */
+    size_t getNumberOfCompiledBlocks() const
+    {
+        return _numberOfCompiledBlocks;
+    }
+
+    /**
+     * The size of the memory used to store compiled code
+     */
+    static const size_t CODE_BUFFER_SIZE = 4 * 1024 * 1024;
+
+  private:
+    /**
+     * Translate a single instruction.
+     *
+     * @param instruction   The instruction to translate
+     * @param index         The index of the instruction in the block
+     * @param isLast        Whether this is the last instruction to be compiled
+     */
+    void compileInstruction(const DecodedInstruction& instruction, int index, bool isLast);
+
+    /**
+     * Emit the code synchronizing the system after the instruction at the given index,
+     * and exiting if the interpreter needs to take over.
+     *
+     * @param index     The index of the instruction in the block
+     * @param ticks     The number of ticks taken by the instruction
+     * @param isLast    Whether this is the last instruction to be compiled
+     */
+    void emitSynchronization(int index, int ticks, bool isLast);
+
+    /**
+     * Emit the code returning to the interpreter.
+     *
+     * @param numberOfExecutedInstructions The value to return
+     */
+    void emitExit(int numberOfExecutedInstructions);
+
+    /**
+     * Emit the code computing the CPU flags from the flags of the host after an operation.
+     *
+     * @param fromHost      The CPU flags taken from the host flags (Zero, Half-carry, Carry)
+     * @param forced        The CPU flags that are always set by the operation
+     * @param affected      The CPU flags modified by the operation, the other ones are left untouched
+     */
+    void emitFlags(byte fromHost, byte forced, byte affected);
+
+    /**
+     * Emit the code putting the value of a register pair in ESI.
+     */
+    void emitLoadRegisterPair(int32_t msbOffset, int32_t lsbOffset);
+
+    /**
+     * Emit the code incrementing or decrementing a register pair.
+     */
+    void emitIncrementRegisterPair(int32_t msbOffset, int32_t lsbOffset, bool decrement);
+
+    /**
+     * Emit the code reading the memory at the address in ESI to EAX,
+     * the block is exited if the memory needs to be read by the interpreter.
+     */
+    void emitMemoryRead(int index);
+
+    /**
+     * Emit the code writing EDX in the memory at the address in ESI,
+     * the block is exited if the memory needs to be written by the interpreter.
+     */
+    void emitMemoryWrite(int index);
+
+    /**
+     * Emit the code of an arithmetic/logical operation between A and ECX.
+     */
+    void emitAccumulatorOperation(int operation);
+
+    /**
+     * Emit the code of a conditional or unconditional jump, ending the block.
+     */
+    void emitJump(const DecodedInstruction& instruction, int index, word target, int conditionOpCode);
+
+    /**
+     * Get the offset in the CPU of the register encoded with the given 3 bits index
+     * (B, C, D, E, H, L, -, A).
+     */
+    int32_t getRegisterOffset(int registerIndex) const;
+
+    /**
+     * Called by the compiled code after each instruction to synchronize the system,
+     * the ticks are reported to the other components in a batch until their next event.
+     *
+     * @return 1 if the compiled code can continue, 0 if it needs to exit
+     */
+    static int synchronize(CPU* cpu, int ticks);
+
+    /**
+     * Called by the compiled code to read memory.
+     *
+     * @return the value or -1 if the memory needs to be read by the interpreter
+     */
+    static int readMemory(CPU* cpu, int addr);
+
+    /**
+     * Called by the compiled code to write memory.
+     *
+     * @return 1 if the value was written, 0 if the memory needs to be written by the interpreter
+     */
+    static int writeMemory(CPU* cpu, int addr, int value);
+
+    X86Emitter _emitter;
+
+    /**
+     * The executable memory storing the compiled code
+     */
+    uint8_t* _codeBuffer = nullptr;
+
+    /**
+     * The number of bytes of the code buffer that are used
+     */
+    size_t _codeBufferUsedSize = 0;
+
+    /**
+     * Whether the last block could not be compiled because the code buffer is full
+     */
+    bool _isFull = false;
+
+    size_t _numberOfCompiledBlocks = 0;
+
+    // Offsets of the CPU fields accessed by the compiled code
+    int32_t _offsetA = 0;
+    int32_t _offsetB = 0;
+    int32_t _offsetC = 0;
+    int32_t _offsetD = 0;
+    int32_t _offsetE = 0;
+    int32_t _offsetH = 0;
+    int32_t _offsetL = 0;
+    int32_t _offsetF = 0;
+    int32_t _offsetPC = 0;
+    int32_t _offsetSP = 0;
+};
+
+#endif // GBEMULATOR_JIT_COMPILER_HPP
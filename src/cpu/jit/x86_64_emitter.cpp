@@ -0,0 +1,244 @@
+#include "x86_64_emitter.hpp"
+#include <cassert>
+
+void X86Emitter::emit16(uint16_t value)
+{
+    emit(static_cast<uint8_t>(value));
+    emit(static_cast<uint8_t>(value >> 8));
+}
+
+void X86Emitter::emit32(uint32_t value)
+{
+    emit16(static_cast<uint16_t>(value));
+    emit16(static_cast<uint16_t>(value >> 16));
+}
+
+void X86Emitter::emit64(uint64_t value)
+{
+    emit32(static_cast<uint32_t>(value));
+    emit32(static_cast<uint32_t>(value >> 32));
+}
+
+void X86Emitter::emitMemoryOperand(uint8_t reg, int32_t disp)
+{
+    // mod = 10 (disp32), rm = 011 (rbx)
+    emit(static_cast<uint8_t>(0x80 | (reg << 3) | EBX));
+    emit32(static_cast<uint32_t>(disp));
+}
+
+void X86Emitter::prologue()
+{
+    // push rbx
+    emit(0x53);
+    // mov rbx, rdi
+    emit(0x48);
+    emit(0x89);
+    emitRegisterOperands(EDI, EBX);
+}
+
+void X86Emitter::epilogue()
+{
+    // pop rbx
+    emit(0x5B);
+    // ret
+    emit(0xC3);
+}
+
+void X86Emitter::loadByte(Register reg, int32_t disp)
+{
+    emit(0x0F);
+    emit(0xB6);
+    emitMemoryOperand(reg, disp);
+}
+
+void X86Emitter::loadWord(Register reg, int32_t disp)
+{
+    emit(0x0F);
+    emit(0xB7);
+    emitMemoryOperand(reg, disp);
+}
+
+void X86Emitter::storeByte(int32_t disp, Register reg)
+{
+    // Without a REX prefix only AL, CL, DL and BL are addressable
+    assert(reg <= EBX);
+    emit(0x88);
+    emitMemoryOperand(reg, disp);
+}
+
+void X86Emitter::storeWord(int32_t disp, Register reg)
+{
+    emit(0x66);
+    emit(0x89);
+    emitMemoryOperand(reg, disp);
+}
+
+void X86Emitter::storeByteImmediate(int32_t disp, uint8_t value)
+{
+    emit(0xC6);
+    emitMemoryOperand(0, disp);
+    emit(value);
+}
+
+void X86Emitter::storeWordImmediate(int32_t disp, uint16_t value)
+{
+    emit(0x66);
+    emit(0xC7);
+    emitMemoryOperand(0, disp);
+    emit16(value);
+}
+
+void X86Emitter::aluByteMemoryImmediate(AluOperation operation, int32_t disp, uint8_t value)
+{
+    emit(0x80);
+    emitMemoryOperand(operation, disp);
+    emit(value);
+}
+
+void X86Emitter::incrementWordMemory(int32_t disp, bool decrement)
+{
+    emit(0x66);
+    emit(0xFF);
+    emitMemoryOperand(decrement ? 1 : 0, disp);
+}
+
+void X86Emitter::moveImmediate(Register reg, uint32_t value)
+{
+    emit(static_cast<uint8_t>(0xB8 + reg));
+    emit32(value);
+}
+
+void X86Emitter::move(Register dst, Register src)
+{
+    emit(0x89);
+    emitRegisterOperands(src, dst);
+}
+
+void X86Emitter::aluByte(AluOperation operation, Register dst, Register src)
+{
+    assert(dst <= EBX && src <= EBX);
+    // The "op r/m8, r8" opcodes are spaced by 8 in the same order as the opcode extensions
+    emit(static_cast<uint8_t>(operation << 3));
+    emitRegisterOperands(src, dst);
+}
+
+void X86Emitter::aluByteImmediate(AluOperation operation, Register reg, uint8_t value)
+{
+    assert(reg <= EBX);
+    emit(0x80);
+    emitRegisterOperands(operation, reg);
+    emit(value);
+}
+
+void X86Emitter::alu(AluOperation operation, Register dst, Register src)
+{
+    emit(static_cast<uint8_t>((operation << 3) | 0x01));
+    emitRegisterOperands(src, dst);
+}
+
+void X86Emitter::aluImmediate(AluOperation operation, Register reg, uint32_t value)
+{
+    emit(0x81);
+    emitRegisterOperands(operation, reg);
+    emit32(value);
+}
+
+void X86Emitter::incrementByte(Register reg, bool decrement)
+{
+    assert(reg <= EBX);
+    emit(0xFE);
+    emitRegisterOperands(decrement ? 1 : 0, reg);
+}
+
+void X86Emitter::increment(Register reg, bool decrement)
+{
+    emit(0xFF);
+    emitRegisterOperands(decrement ? 1 : 0, reg);
+}
+
+void X86Emitter::notByte(Register reg)
+{
+    assert(reg <= EBX);
+    emit(0xF6);
+    emitRegisterOperands(2, reg);
+}
+
+void X86Emitter::rotateByte(RotateOperation operation, Register reg)
+{
+    assert(reg <= EBX);
+    emit(0xD0);
+    emitRegisterOperands(operation, reg);
+}
+
+void X86Emitter::shiftLeft(Register reg, uint8_t count)
+{
+    emit(0xC1);
+    emitRegisterOperands(4, reg);
+    emit(count);
+}
+
+void X86Emitter::shiftRight(Register reg, uint8_t count)
+{
+    emit(0xC1);
+    emitRegisterOperands(5, reg);
+    emit(count);
+}
+
+void X86Emitter::testAccumulatorImmediate(uint8_t value)
+{
+    emit(0xA8);
+    emit(value);
+}
+
+void X86Emitter::test(Register reg)
+{
+    emit(0x85);
+    emitRegisterOperands(reg, reg);
+}
+
+void X86Emitter::loadHostFlagsInEdx()
+{
+    // pushfq
+    emit(0x9C);
+    // pop rdx
+    emit(0x5A);
+}
+
+void X86Emitter::callWithCpu(const void* function)
+{
+    // mov rdi, rbx
+    emit(0x48);
+    emit(0x89);
+    emitRegisterOperands(EBX, EDI);
+    // mov rax, imm64
+    emit(0x48);
+    emit(0xB8);
+    emit64(reinterpret_cast<uint64_t>(function));
+    // call rax
+    emit(0xFF);
+    emit(0xD0);
+}
+
+size_t X86Emitter::jumpForward(Condition condition)
+{
+    emit(static_cast<uint8_t>(0x0F));
+    emit(static_cast<uint8_t>(0x80 | condition));
+    emit32(0);
+    return _code.size();
+}
+
+size_t X86Emitter::jumpForward()
+{
+    emit(0xE9);
+    emit32(0);
+    return _code.size();
+}
+
+void X86Emitter::bindLabel(size_t jumpPosition)
+{
+    auto offset = static_cast<uint32_t>(_code.size() - jumpPosition);
+    for (int i = 0; i < 4; ++i)
+    {
+        _code[jumpPosition - 4 + i] = static_cast<uint8_t>(offset >> (8 * i));
+    }
+}
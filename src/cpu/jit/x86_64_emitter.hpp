@@ -0,0 +1,283 @@
+#ifndef GBEMULATOR_X86_64_EMITTER_HPP
+#define GBEMULATOR_X86_64_EMITTER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Minimal x86-64 machine code emitter used by the JIT compiler.
+ *
+ * Only the handful of instructions needed to translate GameBoy instructions are supported.
+ * Memory operands are always relative to RBX, which holds the address of the CPU being emulated.
+ */
+class X86Emitter
+{
+  public:
+    /**
+     * The 32 bits general purpose registers, the low 8 bits of the first 4 ones
+     * (AL, CL, DL, BL) are used for 8 bits operations.
+     */
+    enum Register : uint8_t
+    {
+        EAX = 0,
+        ECX = 1,
+        EDX = 2,
+        EBX = 3,
+        ESP = 4,
+        EBP = 5,
+        ESI = 6,
+        EDI = 7
+    };
+
+    /**
+     * The arithmetic and logical operations sharing the same encoding,
+     * the value is the opcode extension used with immediate operands.
+     */
+    enum AluOperation : uint8_t
+    {
+        ADD = 0,
+        OR = 1,
+        ADC = 2,
+        SBB = 3,
+        AND = 4,
+        SUB = 5,
+        XOR = 6,
+        CMP = 7
+    };
+
+    /**
+     * The rotations of a 8 bits register by one bit, the value is the opcode extension.
+     */
+    enum RotateOperation : uint8_t
+    {
+        ROL = 0,
+        ROR = 1,
+        RCL = 2,
+        RCR = 3
+    };
+
+    /**
+     * The condition codes used by conditional jumps.
+     */
+    enum Condition : uint8_t
+    {
+        CARRY = 0x2,
+        NOT_CARRY = 0x3,
+        ZERO = 0x4,
+        NOT_ZERO = 0x5,
+        SIGN = 0x8,
+        NOT_SIGN = 0x9
+    };
+
+    /**
+     * @return the code emitted so far
+     */
+    const std::vector<uint8_t>& getCode() const
+    {
+        return _code;
+    }
+
+    /**
+     * @return the size in bytes of the code emitted so far
+     */
+    size_t getSize() const
+    {
+        return _code.size();
+    }
+
+    /**
+     * Remove all the code emitted so far.
+     */
+    void clear()
+    {
+        _code.clear();
+    }
+
+    /**
+     * push rbx; mov rbx, rdi
+     */
+    void prologue();
+
+    /**
+     * pop rbx; ret
+     */
+    void epilogue();
+
+    /**
+     * movzx reg, byte [rbx + disp]
+     */
+    void loadByte(Register reg, int32_t disp);
+
+    /**
+     * movzx reg, word [rbx + disp]
+     */
+    void loadWord(Register reg, int32_t disp);
+
+    /**
+     * mov byte [rbx + disp], reg8
+     */
+    void storeByte(int32_t disp, Register reg);
+
+    /**
+     * mov word [rbx + disp], reg16
+     */
+    void storeWord(int32_t disp, Register reg);
+
+    /**
+     * mov byte [rbx + disp], imm8
+     */
+    void storeByteImmediate(int32_t disp, uint8_t value);
+
+    /**
+     * mov word [rbx + disp], imm16
+     */
+    void storeWordImmediate(int32_t disp, uint16_t value);
+
+    /**
+     * op byte [rbx + disp], imm8
+     */
+    void aluByteMemoryImmediate(AluOperation operation, int32_t disp, uint8_t value);
+
+    /**
+     * inc/dec word [rbx + disp]
+     */
+    void incrementWordMemory(int32_t disp, bool decrement);
+
+    /**
+     * mov reg, imm32
+     */
+    void moveImmediate(Register reg, uint32_t value);
+
+    /**
+     * mov dst, src (32 bits)
+     */
+    void move(Register dst, Register src);
+
+    /**
+     * op dst8, src8
+     */
+    void aluByte(AluOperation operation, Register dst, Register src);
+
+    /**
+     * op dst8, imm8
+     */
+    void aluByteImmediate(AluOperation operation, Register reg, uint8_t value);
+
+    /**
+     * op dst, src (32 bits)
+     */
+    void alu(AluOperation operation, Register dst, Register src);
+
+    /**
+     * op reg, imm32 (32 bits)
+     */
+    void aluImmediate(AluOperation operation, Register reg, uint32_t value);
+
+    /**
+     * inc/dec reg8
+     */
+    void incrementByte(Register reg, bool decrement);
+
+    /**
+     * inc/dec reg (32 bits)
+     */
+    void increment(Register reg, bool decrement);
+
+    /**
+     * not reg8
+     */
+    void notByte(Register reg);
+
+    /**
+     * rol/ror/rcl/rcr reg8, 1
+     */
+    void rotateByte(RotateOperation operation, Register reg);
+
+    /**
+     * shl reg, imm8 (32 bits)
+     */
+    void shiftLeft(Register reg, uint8_t count);
+
+    /**
+     * shr reg, imm8 (32 bits)
+     */
+    void shiftRight(Register reg, uint8_t count);
+
+    /**
+     * test al, imm8
+     */
+    void testAccumulatorImmediate(uint8_t value);
+
+    /**
+     * test reg, reg (32 bits)
+     */
+    void test(Register reg);
+
+    /**
+     * pushfq; pop rdx
+     */
+    void loadHostFlagsInEdx();
+
+    /**
+     * mov rdi, rbx; mov rax, imm64; call rax
+     * The first argument of the function is the address of the emulated CPU.
+     *
+     * @param function  The address of the function to call
+     */
+    void callWithCpu(const void* function);
+
+    /**
+     * Emit a conditional jump to a label that will be bound later.
+     *
+     * @param condition The condition of the jump
+     * @return the position of the jump to give to bindLabel()
+     */
+    size_t jumpForward(Condition condition);
+
+    /**
+     * Emit an unconditional jump to a label that will be bound later.
+     *
+     * @return the position of the jump to give to bindLabel()
+     */
+    size_t jumpForward();
+
+    /**
+     * Make a forward jump land on the current position.
+     *
+     * @param jumpPosition The position returned when emitting the jump
+     */
+    void bindLabel(size_t jumpPosition);
+
+  private:
+    void emit(uint8_t value)
+    {
+        _code.push_back(value);
+    }
+
+    void emit16(uint16_t value);
+
+    void emit32(uint32_t value);
+
+    void emit64(uint64_t value);
+
+    /**
+     * Emit the ModRM byte and displacement for a [rbx + disp32] operand.
+     *
+     * @param reg   The register or opcode extension of the ModRM byte
+     * @param disp  The displacement from RBX
+     */
+    void emitMemoryOperand(uint8_t reg, int32_t disp);
+
+    /**
+     * Emit a ModRM byte with two register operands.
+     */
+    void emitRegisterOperands(uint8_t reg, uint8_t rm)
+    {
+        emit(static_cast<uint8_t>(0xC0 | (reg << 3) | rm));
+    }
+
+    std::vector<uint8_t> _code;
+};
+
+#endif // GBEMULATOR_X86_64_EMITTER_HPP
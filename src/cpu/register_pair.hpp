@@ -0,0 +1,75 @@
+#ifndef GBEMULATOR_REGISTER_PAIR_HPP
+#define GBEMULATOR_REGISTER_PAIR_HPP
+
+#include "common/types.hpp"
+
+/**
+ * A 16 bits register made of two 8 bits registers, like BC or HL.
+ *
+ * The pair is stored as a single word so that the 16 bits instructions and the addressing through
+ * the pair don't need to combine and split the 8 bits registers.
+ * The 8 bits registers are views on the bytes of the word, in the byte order of the host.
+ */
+class RegisterPair
+{
+  public:
+    /**
+     * Get the 16 bits value of the pair.
+     */
+    word value() const
+    {
+        return _value;
+    }
+
+    /**
+     * Get the 16 bits value of the pair, to be modified.
+     */
+    word& value()
+    {
+        return _value;
+    }
+
+    /**
+     * Get the 8 bits register stored in the most significant byte, like B in BC.
+     */
+    const byte& msb() const
+    {
+        return reinterpret_cast<const byte*>(&_value)[MSB_INDEX];
+    }
+
+    /**
+     * Get the 8 bits register stored in the most significant byte, to be modified.
+     */
+    byte& msb()
+    {
+        return reinterpret_cast<byte*>(&_value)[MSB_INDEX];
+    }
+
+    /**
+     * Get the 8 bits register stored in the least significant byte, like C in BC.
+     */
+    const byte& lsb() const
+    {
+        return reinterpret_cast<const byte*>(&_value)[LSB_INDEX];
+    }
+
+    /**
+     * Get the 8 bits register stored in the least significant byte, to be modified.
+     */
+    byte& lsb()
+    {
+        return reinterpret_cast<byte*>(&_value)[LSB_INDEX];
+    }
+
+  private:
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    static const int MSB_INDEX = 0;
+#else
+    static const int MSB_INDEX = 1;
+#endif
+    static const int LSB_INDEX = 1 - MSB_INDEX;
+
+    word _value = 0;
+};
+
+#endif // GBEMULATOR_REGISTER_PAIR_HPP
@@ -0,0 +1,206 @@
+#include "translation_cache.hpp"
+#include "common/utils.hpp"
+#include "cpu/basic_block_cache.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <type_traits>
+
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(__EMSCRIPTEN__)
+#define GBEMULATOR_TRANSLATION_CACHE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// The records are used in place from the file
+static_assert(std::is_trivially_copyable<DecodedInstruction>::value, "DecodedInstruction is stored as is");
+static_assert(sizeof(DecodedInstruction) == 8, "The layout of DecodedInstruction changed, increment VERSION");
+static_assert(sizeof(TranslationCache::Header) == 32, "The header must keep the records aligned");
+static_assert(sizeof(TranslationCache::BlockEntry) == 16, "The blocks must keep the instructions aligned");
+
+TranslationCache::~TranslationCache()
+{
+    unload();
+}
+
+bool TranslationCache::load(const std::string& path, uint64_t cartridgeHash)
+{
+    unload();
+
+    const byte* data = nullptr;
+    size_t size = 0;
+#ifdef GBEMULATOR_TRANSLATION_CACHE_MMAP
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat fileStatus = {};
+    if (fstat(fd, &fileStatus) == 0 && fileStatus.st_size > 0)
+    {
+        size = static_cast<size_t>(fileStatus.st_size);
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED)
+        {
+            _mapping = mapping;
+            _mappingSize = size;
+            data = static_cast<const byte*>(mapping);
+        }
+    }
+    // The mapping stays valid once the file is closed
+    close(fd);
+#else
+    if (utils::readBinaryDataFromFile(path, _fileData))
+    {
+        data = _fileData.data();
+        size = _fileData.size();
+    }
+#endif
+
+    if (data == nullptr || !isValid(data, size, cartridgeHash))
+    {
+        unload();
+        return false;
+    }
+
+    _header = reinterpret_cast<const Header*>(data);
+    _blocks = reinterpret_cast<const BlockEntry*>(data + sizeof(Header));
+    _instructions = reinterpret_cast<const DecodedInstruction*>(data + sizeof(Header) +
+                                                                _header->numberOfBlocks * sizeof(BlockEntry));
+    return true;
+}
+
+void TranslationCache::unload()
+{
+#ifdef GBEMULATOR_TRANSLATION_CACHE_MMAP
+    if (_mapping != nullptr)
+    {
+        munmap(_mapping, _mappingSize);
+    }
+#endif
+    _mapping = nullptr;
+    _mappingSize = 0;
+    _fileData.clear();
+    _header = nullptr;
+    _blocks = nullptr;
+    _instructions = nullptr;
+}
+
+bool TranslationCache::isValid(const byte* data, size_t size, uint64_t cartridgeHash)
+{
+    if (size < sizeof(Header))
+    {
+        return false;
+    }
+
+    const Header* header = reinterpret_cast<const Header*>(data);
+    bool isCompatible = header->magic == MAGIC && header->version == VERSION &&
+                        header->cartridgeHash == cartridgeHash &&
+                        header->maxInstructionsPerBlock == BasicBlockCache::MAX_INSTRUCTIONS_PER_BLOCK;
+    size_t expectedSize = sizeof(Header) + static_cast<size_t>(header->numberOfBlocks) * sizeof(BlockEntry) +
+                          static_cast<size_t>(header->numberOfInstructions) * sizeof(DecodedInstruction);
+    if (!isCompatible || size != expectedSize)
+    {
+        return false;
+    }
+
+    // A truncated or corrupted file must not make the CPU read outside of the mapping
+    const BlockEntry* blocks = reinterpret_cast<const BlockEntry*>(data + sizeof(Header));
+    for (uint32_t i = 0; i < header->numberOfBlocks; ++i)
+    {
+        const BlockEntry& block = blocks[i];
+        uint64_t endInstruction = static_cast<uint64_t>(block.firstInstruction) + block.numberOfInstructions;
+        if (block.numberOfInstructions == 0 ||
+            block.numberOfInstructions > BasicBlockCache::MAX_INSTRUCTIONS_PER_BLOCK ||
+            endInstruction > header->numberOfInstructions)
+        {
+            return false;
+        }
+
+        // The blocks are looked up by a binary search
+        if (i > 0 && std::make_pair(blocks[i - 1].bankKey, blocks[i - 1].startAddress) >=
+                         std::make_pair(block.bankKey, block.startAddress))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+const TranslationCache::BlockEntry* TranslationCache::findBlock(int bankKey, word addr) const
+{
+    if (_header == nullptr)
+    {
+        return nullptr;
+    }
+
+    const BlockEntry* end = _blocks + _header->numberOfBlocks;
+    const BlockEntry* it =
+        std::lower_bound(_blocks, end, std::make_pair(bankKey, addr), [](const BlockEntry& block, const auto& key) {
+            return std::make_pair(static_cast<int>(block.bankKey), static_cast<word>(block.startAddress)) < key;
+        });
+
+    if (it == end || it->bankKey != bankKey || it->startAddress != addr)
+    {
+        return nullptr;
+    }
+
+    return it;
+}
+
+bool TranslationCache::save(const std::string& path, uint64_t cartridgeHash, std::vector<const BasicBlock*> blocks)
+{
+    std::sort(blocks.begin(), blocks.end(), [](const BasicBlock* lhs, const BasicBlock* rhs) {
+        return std::make_pair(lhs->bankKey, lhs->startAddress) < std::make_pair(rhs->bankKey, rhs->startAddress);
+    });
+
+    Header header = {};
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.cartridgeHash = cartridgeHash;
+    header.maxInstructionsPerBlock = BasicBlockCache::MAX_INSTRUCTIONS_PER_BLOCK;
+    header.numberOfBlocks = static_cast<uint32_t>(blocks.size());
+
+    std::vector<BlockEntry> entries;
+    entries.reserve(blocks.size());
+    for (const BasicBlock* block : blocks)
+    {
+        BlockEntry entry = {};
+        entry.bankKey = block->bankKey;
+        entry.startAddress = block->startAddress;
+        entry.size = static_cast<uint16_t>(block->size);
+        entry.firstInstruction = header.numberOfInstructions;
+        entry.numberOfInstructions = static_cast<uint32_t>(block->instructions.size());
+        entries.push_back(entry);
+        header.numberOfInstructions += entry.numberOfInstructions;
+    }
+
+    std::string temporaryPath = path + ".tmp";
+    std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(entries.data()),
+               static_cast<std::streamsize>(entries.size() * sizeof(BlockEntry)));
+    for (const BasicBlock* block : blocks)
+    {
+        file.write(reinterpret_cast<const char*>(block->instructions.data()),
+                   static_cast<std::streamsize>(block->instructions.size() * sizeof(DecodedInstruction)));
+    }
+    file.close();
+
+    if (!file.good() || std::rename(temporaryPath.c_str(), path.c_str()) != 0)
+    {
+        std::remove(temporaryPath.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+std::string TranslationCache::getFilePath(const std::string& directory, uint64_t cartridgeHash)
+{
+    return directory + "/" + utils::string_format("%016llx.gbtc", static_cast<unsigned long long>(cartridgeHash));
+}
@@ -0,0 +1,194 @@
+#ifndef GBEMULATOR_TRANSLATION_CACHE_HPP
+#define GBEMULATOR_TRANSLATION_CACHE_HPP
+
+#include "common/types.hpp"
+#include "cpu/instruction_decoder.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Forward declaration
+struct BasicBlock;
+
+/**
+ * On-disk cache of the basic blocks decoded from the ROM of a cartridge, reused between runs.
+ *
+ * The file stores the entry points of the blocks that were reached in ROM along with their
+ * decoded instructions, so that a warm start of the same cartridge doesn't decode anything again.
+ * It's keyed by the hash of the cartridge data and laid out so that it can be memory-mapped
+ * and used in place, only the blocks that are executed are read from it.
+ *
+ * Layout, in the byte order of the host:
+ *  - a Header,
+ *  - the BlockEntry of every block, sorted by bank key and start address,
+ *  - the DecodedInstruction of every block, one block after the other.
+ */
+class TranslationCache
+{
+  public:
+    /**
+     * The header of the file.
+     */
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t cartridgeHash;
+        uint32_t maxInstructionsPerBlock;
+        uint32_t numberOfBlocks;
+        uint32_t numberOfInstructions;
+        uint32_t reserved;
+    };
+
+    /**
+     * A block stored in the file.
+     */
+    struct BlockEntry
+    {
+        /**
+         * The key of the ROM bank of the block, as returned by MMU::getMemoryBankKey()
+         */
+        int32_t bankKey;
+
+        /**
+         * The address of the first instruction of the block
+         */
+        uint16_t startAddress;
+
+        /**
+         * The number of bytes covered by the block
+         */
+        uint16_t size;
+
+        /**
+         * The index of the first instruction of the block in the instructions of the file
+         */
+        uint32_t firstInstruction;
+
+        uint32_t numberOfInstructions;
+    };
+
+    TranslationCache() = default;
+    ~TranslationCache();
+
+    TranslationCache(const TranslationCache&) = delete;
+    TranslationCache& operator=(const TranslationCache&) = delete;
+
+    /**
+     * Map the cache of a cartridge from a file.
+     * The file is rejected if it was written by another version or for another cartridge.
+     *
+     * @param path          The path of the file
+     * @param cartridgeHash The hash of the cartridge, see Cartridge::getHash()
+     * @return true if the file is valid and was mapped
+     */
+    bool load(const std::string& path, uint64_t cartridgeHash);
+
+    /**
+     * Unmap the file currently loaded.
+     */
+    void unload();
+
+    /**
+     * @return true if a file is currently loaded
+     */
+    bool isLoaded() const
+    {
+        return _header != nullptr;
+    }
+
+    /**
+     * Find the block starting at the given address of a ROM bank.
+     *
+     * @param bankKey   The key of the ROM bank of the block
+     * @param addr      The address of the first instruction of the block
+     * @return the block or nullptr if it's not in the file
+     */
+    const BlockEntry* findBlock(int bankKey, word addr) const;
+
+    /**
+     * @return all the blocks of the file, sorted by bank key and start address
+     */
+    const BlockEntry* getBlocks() const
+    {
+        return _blocks;
+    }
+
+    /**
+     * @return the number of blocks in the file, 0 if no file is loaded
+     */
+    size_t getNumberOfBlocks() const
+    {
+        return _header != nullptr ? _header->numberOfBlocks : 0;
+    }
+
+    /**
+     * @param block A block of the file
+     * @return the first decoded instruction of the block
+     */
+    const DecodedInstruction* getInstructions(const BlockEntry& block) const
+    {
+        return _instructions + block.firstInstruction;
+    }
+
+    /**
+     * Write the blocks decoded from the ROM of a cartridge to a file.
+     * The file is written next to the destination then renamed so that
+     * a process mapping the previous version of the file is not affected.
+     *
+     * @param path          The path of the file
+     * @param cartridgeHash The hash of the cartridge, see Cartridge::getHash()
+     * @param blocks        The blocks to write, they need to come from ROM banks
+     * @return true if the file was written
+     */
+    static bool save(const std::string& path, uint64_t cartridgeHash, std::vector<const BasicBlock*> blocks);
+
+    /**
+     * Get the path of the file used for a cartridge.
+     *
+     * @param directory     The directory where the caches are stored
+     * @param cartridgeHash The hash of the cartridge
+     * @return the path of the file
+     */
+    static std::string getFilePath(const std::string& directory, uint64_t cartridgeHash);
+
+    /**
+     * The version of the file format and of the decoding,
+     * it needs to be incremented when any of them changes.
+     */
+    static const uint32_t VERSION = 1;
+
+    /**
+     * "GBTC" in the byte order of the host, files written on a host with another byte order are rejected
+     */
+    static const uint32_t MAGIC = 0x43544247;
+
+  private:
+    /**
+     * Check that the content of a file is consistent.
+     *
+     * @param data          The content of the file
+     * @param size          The size of the file
+     * @param cartridgeHash The hash of the cartridge expected
+     * @return true if the file can be used
+     */
+    static bool isValid(const byte* data, size_t size, uint64_t cartridgeHash);
+
+    const Header* _header = nullptr;
+    const BlockEntry* _blocks = nullptr;
+    const DecodedInstruction* _instructions = nullptr;
+
+    /**
+     * The memory where the file is mapped, nullptr if it was read in _fileData
+     */
+    void* _mapping = nullptr;
+    size_t _mappingSize = 0;
+
+    /**
+     * The content of the file when it can't be mapped
+     */
+    std::vector<byte> _fileData;
+};
+
+#endif // GBEMULATOR_TRANSLATION_CACHE_HPP
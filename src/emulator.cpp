@@ -1,5 +1,7 @@
 #include "emulator.hpp"
+#include <algorithm>
 #include <fstream>
+#include <limits>
 
 Emulator::Emulator()
     : cpu(mmu), ppu(mmu, cpu.getInterruptManager()), timer(cpu.getInterruptManager()), apu(&timer, AUDIO_SAMPLING_FREQ)
@@ -10,22 +12,278 @@ Emulator::Emulator()
     mmu.setInterruptManager(cpu.getInterruptManager());
     mmu.setLcdStatusRegister(ppu.getLcdStatusRegister());
     mmu.setPPU(&ppu);
+    mmu.setTicksCounter(_scheduler.getCurrentTicksCounter());
+    mmu.setSynchronizationCallback([this](int components) {
+        // The clock is brought to the start of the instruction accessing the components
+        cpu.flushPendingTicks();
+        synchronizeComponents(components);
+        // The access can change the next events, they are computed again at the end of the instruction
+        _accessedComponents |= components;
+        _scheduler.schedule(Scheduler::SYNCHRONIZATION, 0);
+    });
+    cpu.setInstructionExecutedCallback([this](int ticks) { stepComponents(ticks); });
+    cpu.setNextEventCallback([this]() { return getTicksUntilNextEvent(); });
+    cpu.setIdleLoopDetectionEnabled(true);
+    synchronizeComponents(MMU::SYNCHRONIZE_ALL);
 }
 
-Emulator::~Emulator() = default;
+Emulator::~Emulator()
+{
+    flushBatterySave();
+}
 
 void Emulator::exec()
 {
-    // Execute current cpu instruction and retrieve the number of ticks
-    int lastInstructionTicks = cpu.fetchDecodeAndExecute();
+    // The other components are updated by the CPU after each instruction
+    cpu.fetchDecodeAndExecute();
+}
+
+template <typename Predicate>
+Emulator::RunResult Emulator::run(int64_t maxTicks, Predicate shouldStop)
+{
+    int64_t startTicks = getCurrentTicks();
+    int frameId = ppu.getFrameId();
+    bool wasSerialTransferRequested = mmu.isSerialTransferRequested();
+    bool wasAudioBufferFull = isAudioBufferFull();
+
+    // The components are up to date when the CPU can observe them, so the frame, the serial transfer
+    // and the audio buffer are checked after each step as if the components were updated every instruction
+    int64_t elapsedTicks = 0;
+    while (true)
+    {
+        // A step doesn't start instructions past the budget, or past the next one when it can be a breakpoint.
+        // The budget counts ticks at normal speed, in double speed the step stops earlier than needed.
+        int64_t maxStepTicks = _hasBreakpoints ? 1 : maxTicks - elapsedTicks;
+        cpu.fetchDecodeAndExecute(
+            static_cast<int>(std::clamp<int64_t>(maxStepTicks, 1, std::numeric_limits<int>::max())));
+        elapsedTicks = getCurrentTicks() - startTicks;
+
+        if (ppu.getFrameId() != frameId)
+        {
+            frameId = ppu.getFrameId();
+            if (shouldStop(StopReason::FRAME_COMPLETE))
+            {
+                return {StopReason::FRAME_COMPLETE, elapsedTicks};
+            }
+        }
+
+        bool isSerialTransferRequested = mmu.isSerialTransferRequested();
+        if (isSerialTransferRequested && !wasSerialTransferRequested && shouldStop(StopReason::SERIAL_BYTE))
+        {
+            return {StopReason::SERIAL_BYTE, elapsedTicks};
+        }
+        wasSerialTransferRequested = isSerialTransferRequested;
+
+        bool isAudioBufferFilled = isAudioBufferFull();
+        if (isAudioBufferFilled && !wasAudioBufferFull && shouldStop(StopReason::AUDIO_BUFFER_FULL))
+        {
+            return {StopReason::AUDIO_BUFFER_FULL, elapsedTicks};
+        }
+        wasAudioBufferFull = isAudioBufferFilled;
+
+        if (_hasBreakpoints && _breakpoints[cpu.getProgramCounter()] && shouldStop(StopReason::BREAKPOINT))
+        {
+            return {StopReason::BREAKPOINT, elapsedTicks};
+        }
+
+        if (elapsedTicks >= maxTicks)
+        {
+            return {StopReason::BUDGET_EXHAUSTED, elapsedTicks};
+        }
+    }
+}
+
+Emulator::RunResult Emulator::runFrame()
+{
+    return run(std::numeric_limits<int64_t>::max(), [](StopReason reason) {
+        return reason == StopReason::FRAME_COMPLETE || reason == StopReason::BREAKPOINT;
+    });
+}
+
+Emulator::RunResult Emulator::runTicks(int64_t ticks)
+{
+    return run(ticks, [](StopReason reason) { return reason == StopReason::BREAKPOINT; });
+}
+
+Emulator::RunResult Emulator::runUntil(const StopPredicate& shouldStop)
+{
+    return run(std::numeric_limits<int64_t>::max(), shouldStop);
+}
+
+void Emulator::addBreakpoint(word address)
+{
+    _breakpoints.set(address);
+    _hasBreakpoints = true;
+}
+
+void Emulator::removeBreakpoint(word address)
+{
+    _breakpoints.reset(address);
+    _hasBreakpoints = _breakpoints.any();
+}
+
+void Emulator::clearBreakpoints()
+{
+    _breakpoints.reset();
+    _hasBreakpoints = false;
+}
+
+void Emulator::stepComponents(int ticks)
+{
+    int64_t cycles = static_cast<int64_t>(ticks) * getCyclesPerCPUTick();
+    int64_t endCycles = _scheduler.getCurrentCycles() + cycles;
 
-    timer.tick(lastInstructionTicks);
+    // The components reaching an event during the instruction are brought up to its start first,
+    // so that they see the same steps as if they were updated after each instruction
+    int components = 0;
+    if (!_isCatchUpSynchronizationEnabled)
+    {
+        components = MMU::SYNCHRONIZE_ALL;
+    }
+    else if (endCycles >= _scheduler.getNextEventCycles())
+    {
+        components = getComponentsWithEventsUntil(endCycles);
+    }
 
-    ppu.step(lastInstructionTicks);
+    if (components != 0)
+    {
+        synchronizeComponents(components);
+        _scheduler.cancel(Scheduler::SYNCHRONIZATION);
+        _accessedComponents = 0;
+    }
 
-    apu.step(lastInstructionTicks);
+    _scheduler.advance(cycles);
+    if (components != 0)
+    {
+        synchronizeComponents(components);
+    }
 
-    currentTicks += lastInstructionTicks;
+    if (_scheduler.isEventDue(Scheduler::BATTERY_SAVE))
+    {
+        saveDirtyRAMPages();
+    }
+
+    // The CPU is stopped while the VRAM DMA copies its blocks or the speed switches, the other components keep running
+    int stalledTicks = convertToCPUTicks(mmu.consumeStalledTicks());
+    while (stalledTicks > 0)
+    {
+        int stepTicks = std::min(stalledTicks, getTicksUntilNextEvent());
+        stepComponents(stepTicks);
+        stalledTicks -= stepTicks;
+    }
+}
+
+void Emulator::synchronizeComponents(int components)
+{
+    if (components & MMU::SYNCHRONIZE_PPU)
+    {
+        synchronizePPU();
+    }
+
+    if (components & (MMU::SYNCHRONIZE_TIMER | MMU::SYNCHRONIZE_APU))
+    {
+        synchronizeTimer();
+    }
+
+    if (components & MMU::SYNCHRONIZE_APU)
+    {
+        synchronizeAPU();
+    }
+}
+
+void Emulator::synchronizePPU()
+{
+    int ticks = getCPUTicksSince(_ppuSynchronizationCycles);
+    int normalSpeedTicks = getNormalSpeedTicksSince(_ppuSynchronizationCycles);
+    // The DMA transfer can read the memory through the MMU, which brings the PPU up to date again
+    _ppuSynchronizationCycles = _scheduler.getCurrentCycles();
+
+    // The OAM is updated before the PPU reads it
+    if (ticks > 0)
+    {
+        mmu.stepDMA(ticks);
+    }
+
+    if (normalSpeedTicks > 0)
+    {
+        ppu.step(normalSpeedTicks);
+    }
+
+    if (mmu.isDMATransferActive())
+    {
+        _scheduler.schedule(Scheduler::OAM_DMA,
+                            static_cast<int64_t>(mmu.getTicksUntilNextEvent()) * getCyclesPerCPUTick());
+    }
+    else
+    {
+        _scheduler.cancel(Scheduler::OAM_DMA);
+    }
+
+    // The PPU runs at normal speed, the CPU tick left over in double speed counts toward its next tick
+    _scheduler.schedule(Scheduler::PPU, (_scheduler.getCurrentTicks() + ppu.getTicksUntilNextEvent()) *
+                                                Scheduler::CYCLES_PER_TICK -
+                                            _scheduler.getCurrentCycles());
+}
+
+void Emulator::synchronizeTimer()
+{
+    int ticks = getCPUTicksSince(_timerSynchronizationCycles);
+    _timerSynchronizationCycles = _scheduler.getCurrentCycles();
+    if (ticks > 0)
+    {
+        timer.tick(ticks);
+    }
+
+    _scheduler.schedule(Scheduler::TIMER, static_cast<int64_t>(timer.getTicksUntilNextEvent()) * getCyclesPerCPUTick());
+}
+
+void Emulator::synchronizeAPU()
+{
+    int normalSpeedTicks = getNormalSpeedTicksSince(_apuSynchronizationCycles);
+    _apuSynchronizationCycles = _scheduler.getCurrentCycles();
+    if (normalSpeedTicks > 0)
+    {
+        apu.step(normalSpeedTicks);
+    }
+
+    _scheduler.schedule(Scheduler::APU, (_scheduler.getCurrentTicks() + apu.getCyclesUntilNextEvent()) *
+                                                Scheduler::CYCLES_PER_TICK -
+                                            _scheduler.getCurrentCycles());
+}
+
+int Emulator::getComponentsWithEventsUntil(int64_t cycles) const
+{
+    int components = 0;
+    if (_scheduler.getEventCycles(Scheduler::PPU) <= cycles || _scheduler.getEventCycles(Scheduler::OAM_DMA) <= cycles)
+    {
+        components |= MMU::SYNCHRONIZE_PPU;
+    }
+    if (_scheduler.getEventCycles(Scheduler::TIMER) <= cycles)
+    {
+        components |= MMU::SYNCHRONIZE_TIMER;
+    }
+    if (_scheduler.getEventCycles(Scheduler::APU) <= cycles)
+    {
+        components |= MMU::SYNCHRONIZE_APU;
+    }
+    if (_scheduler.getEventCycles(Scheduler::SYNCHRONIZATION) <= cycles)
+    {
+        components |= _accessedComponents;
+    }
+    return components;
+}
+
+int Emulator::getTicksUntilNextEvent() const
+{
+    // The serial transfers are done instantly and don't need to be stepped
+    int64_t cycles = _scheduler.getNextEventCycles() - _scheduler.getCurrentCycles();
+    return static_cast<int>(
+        std::clamp<int64_t>(cycles / getCyclesPerCPUTick(), 1, std::numeric_limits<int>::max()));
+}
+
+int Emulator::convertToCPUTicks(int normalSpeedTicks) const
+{
+    return mmu.isDoubleSpeedEnabled() ? 2 * normalSpeedTicks : normalSpeedTicks;
 }
 
 void Emulator::reset()
@@ -34,7 +292,16 @@ void Emulator::reset()
     cpu.reset();
     mmu.reset();
     apu.reset();
-    currentTicks = 0;
+    _scheduler.reset();
+    _ppuSynchronizationCycles = 0;
+    _timerSynchronizationCycles = 0;
+    _apuSynchronizationCycles = 0;
+    _accessedComponents = 0;
+    if (_batterySave.isOpen())
+    {
+        _scheduler.schedule(Scheduler::BATTERY_SAVE, _batterySaveIntervalInTicks * Scheduler::CYCLES_PER_TICK);
+    }
+    synchronizeComponents(MMU::SYNCHRONIZE_ALL);
 }
 
 bool Emulator::saveToFile(const std::string& filepath)
@@ -65,3 +332,68 @@ bool Emulator::loadFromFile(const std::string& filepath)
 
     return mmu.unserializeCartridgeRAM(data);
 }
+
+bool Emulator::openBatterySave(const std::string& filepath)
+{
+    _batterySave.close();
+    _batterySaveController = mmu.getMemoryBankController();
+    if (_batterySaveController == nullptr ||
+        !_batterySave.open(filepath,
+                           _batterySaveController->getRAM().size() + _batterySaveController->getClockStateSize()))
+    {
+        _batterySaveController = nullptr;
+        return false;
+    }
+
+    // The content of the file replaces the RAM, nothing needs to be written back
+    _batterySaveController->unserializeRAM(_batterySave.read());
+    _batterySaveController->consumeDirtyRAMPages([](size_t, const byte*, size_t) {});
+    _scheduler.schedule(Scheduler::BATTERY_SAVE, _batterySaveIntervalInTicks * Scheduler::CYCLES_PER_TICK);
+    return true;
+}
+
+void Emulator::setBatterySaveInterval(int intervalInTicks)
+{
+    _batterySaveIntervalInTicks = std::max(intervalInTicks, 1);
+    if (_batterySave.isOpen())
+    {
+        int64_t cyclesUntilSave = _scheduler.getEventCycles(Scheduler::BATTERY_SAVE) - _scheduler.getCurrentCycles();
+        _scheduler.schedule(Scheduler::BATTERY_SAVE,
+                            std::min(cyclesUntilSave, _batterySaveIntervalInTicks * Scheduler::CYCLES_PER_TICK));
+    }
+}
+
+void Emulator::flushBatterySave()
+{
+    if (!_batterySave.isOpen())
+    {
+        return;
+    }
+
+    saveDirtyRAMPages();
+    _batterySave.flush();
+}
+
+void Emulator::saveDirtyRAMPages()
+{
+    if (mmu.getMemoryBankController() != _batterySaveController)
+    {
+        _batterySave.close();
+        _batterySaveController = nullptr;
+        _scheduler.cancel(Scheduler::BATTERY_SAVE);
+        return;
+    }
+    _scheduler.schedule(Scheduler::BATTERY_SAVE, _batterySaveIntervalInTicks * Scheduler::CYCLES_PER_TICK);
+
+    // Only the pages are copied here, the file is written by the thread of the battery save
+    _batterySaveController->consumeDirtyRAMPages(
+        [this](size_t offset, const byte* data, size_t size) { _batterySave.write(offset, data, size); });
+
+    size_t clockStateSize = _batterySaveController->getClockStateSize();
+    if (clockStateSize > 0)
+    {
+        std::vector<byte> clockState(clockStateSize);
+        _batterySaveController->saveClockState(clockState.data());
+        _batterySave.write(_batterySaveController->getRAM().size(), clockState.data(), clockState.size());
+    }
+}
@@ -5,14 +5,22 @@
 #include "cpu/cpu.hpp"
 #include "cpu/input_controller.hpp"
 #include "graphics/ppu.hpp"
+#include "memory/battery_save.hpp"
 #include "memory/mmu.hpp"
+#include "scheduler/scheduler.hpp"
 #include "serial/serial_transfer_manager.hpp"
 #include "timer/timer.hpp"
+#include <bitset>
+#include <functional>
 
 /**
  * Emulator class that wraps up all the different components of the system.
  * This class is in charge of decoding instruction from the MMU and executing them,
  * then updating the PPU in sync with the other components.
+ *
+ * The components aren't stepped after every instruction: the scheduler keeps the time of their next event
+ * and each of them records the time it was last brought up to date.
+ * A component catches up with the CPU when its event is reached, or before the CPU accesses its registers or memories.
  */
 class Emulator
 {
@@ -23,15 +31,116 @@ class Emulator
     Emulator();
 
     /**
-     * Destroy the emulator.
+     * Destroy the emulator, the battery save is flushed.
      */
     ~Emulator();
 
     /**
      * Execute the next instruction of the emulator and update the PPU.
+     * When the CPU executes a block compiled by the JIT, all the instructions of the block are executed.
      */
     void exec();
 
+    /**
+     * The reasons a run of the emulator stops.
+     */
+    enum class StopReason
+    {
+        /**
+         * The PPU completed a frame
+         */
+        FRAME_COMPLETE,
+        /**
+         * The next instruction is at a breakpoint, see addBreakpoint()
+         */
+        BREAKPOINT,
+        /**
+         * The number of ticks given to runTicks() elapsed
+         */
+        BUDGET_EXHAUSTED,
+        /**
+         * The game started a serial transfer, its byte is read and the transfer finalized by a SerialTransferManager
+         */
+        SERIAL_BYTE,
+        /**
+         * The audio buffer of the APU reached its capacity, see setAudioBufferCapacity()
+         */
+        AUDIO_BUFFER_FULL
+    };
+
+    /**
+     * The result of a run of the emulator.
+     */
+    struct RunResult
+    {
+        StopReason reason;
+
+        /**
+         * The number of ticks at normal speed elapsed during the run
+         */
+        int64_t ticks;
+    };
+
+    /**
+     * Execute instructions until the PPU completes a frame, or a breakpoint is reached.
+     *
+     * @return the result of the run
+     */
+    RunResult runFrame();
+
+    /**
+     * Execute instructions until the given number of ticks elapsed, or a breakpoint is reached.
+     * The last instruction can go past the budget, idle loops are fast-forwarded up to it.
+     *
+     * @param ticks The number of ticks at normal speed to run
+     * @return the result of the run
+     */
+    RunResult runTicks(int64_t ticks);
+
+    /**
+     * Predicate telling if a run stops when something happens.
+     */
+    typedef std::function<bool(StopReason reason)> StopPredicate;
+
+    /**
+     * Execute instructions until the predicate accepts something that happened.
+     * The predicate is only called when something happens (frame completed, breakpoint reached, serial transfer
+     * started, audio buffer full), not after every instruction. A serial transfer or a full audio buffer is
+     * signaled once, until the transfer is finalized or the buffer is reset.
+     *
+     * @param shouldStop The predicate, returning true to stop the run
+     * @return the result of the run
+     */
+    RunResult runUntil(const StopPredicate& shouldStop);
+
+    /**
+     * Stop the runs before executing the instruction at the given address.
+     * The breakpoint at the program counter when a run starts is ignored, so that the run can resume from it.
+     *
+     * @param address The address of the instruction
+     */
+    void addBreakpoint(word address);
+
+    /**
+     * @param address The address of the breakpoint to remove
+     */
+    void removeBreakpoint(word address);
+
+    /**
+     * Remove all the breakpoints.
+     */
+    void clearBreakpoints();
+
+    /**
+     * Set the size of the audio buffer of the APU from which a run stops with AUDIO_BUFFER_FULL.
+     *
+     * @param capacity The number of values in the buffer, two per sample (left and right channels)
+     */
+    void setAudioBufferCapacity(size_t capacity)
+    {
+        _audioBufferCapacity = capacity;
+    }
+
     /**
      * Resets all the components of the emulator.
      */
@@ -75,13 +184,34 @@ class Emulator
     }
 
     /**
-     * Get the number of CPU ticks elapsed since the start of the emulator.
+     * Get the number of ticks elapsed since the start of the emulator, at normal speed.
+     * In the double speed mode of the CGB, the CPU executes 2 ticks for each of those.
      *
      * @return 	the number of ticks
      */
-    int getCurrentTicks() const
+    int64_t getCurrentTicks() const
+    {
+        return _scheduler.getCurrentTicks();
+    }
+
+    /**
+     * @return the scheduler holding the clock of the emulator and the next events of the components
+     */
+    const Scheduler& getScheduler() const
     {
-        return currentTicks;
+        return _scheduler;
+    }
+
+    /**
+     * Enable or disable the catch-up synchronization of the components, it's enabled by default.
+     * When disabled, all the components are brought up to date after every instruction.
+     * The emulation is the same in both cases, it's only slower in lockstep.
+     *
+     * @param enabled true to step each component only when it's observed or one of its events is reached
+     */
+    void setCatchUpSynchronizationEnabled(bool enabled)
+    {
+        _isCatchUpSynchronizationEnabled = enabled;
     }
 
     /**
@@ -99,7 +229,153 @@ class Emulator
      */
     bool loadFromFile(const std::string& filepath);
 
+    /**
+     * Keep the RAM of the cartridge loaded in a battery save file (.sav) while the emulator runs.
+     * The RAM is loaded from the file, then the pages written by the game are saved periodically
+     * by a background thread, see setBatterySaveInterval().
+     * The state of the clock of the cartridge is saved after the RAM, with the time of the host.
+     * It needs to be opened again when another cartridge is loaded.
+     *
+     * @param filepath  the path of the file, it's created if needed
+     * @return true if the cartridge has RAM and the file was opened, false otherwise
+     */
+    bool openBatterySave(const std::string& filepath);
+
+    /**
+     * Set how often the pages of the RAM written are saved in the battery save file.
+     *
+     * @param intervalInTicks   the number of ticks at normal speed between two saves
+     */
+    void setBatterySaveInterval(int intervalInTicks);
+
+    /**
+     * Save the pages of the RAM written since the last save and wait until they are written to the disk.
+     */
+    void flushBatterySave();
+
+    /**
+     * The default interval between two saves of the battery save file, 60 frames
+     */
+    static const int DEFAULT_BATTERY_SAVE_INTERVAL_IN_TICKS = 60 * 70224;
+
+    /**
+     * The default capacity of the audio buffer, 512 samples
+     */
+    static const size_t DEFAULT_AUDIO_BUFFER_CAPACITY = 2 * 512;
+
   private:
+    /**
+     * Execute instructions until the predicate accepts something that happened or the budget is exhausted,
+     * this is the loop shared by all the runs.
+     *
+     * @tparam Predicate    A function taking a StopReason and returning true to stop the run
+     * @param maxTicks      The number of ticks at normal speed after which the run stops
+     * @param shouldStop    The predicate, only called when something happens
+     * @return the result of the run
+     */
+    template <typename Predicate>
+    RunResult run(int64_t maxTicks, Predicate shouldStop);
+
+    /**
+     * @return true if the audio buffer of the APU reached its capacity
+     */
+    bool isAudioBufferFull()
+    {
+        return apu.getAudioBuffer().size() >= _audioBufferCapacity;
+    }
+
+    /**
+     * Advance the clock after the CPU executed an instruction,
+     * the components are updated if one of their events is reached.
+     *
+     * @param ticks The number of CPU ticks taken by the instruction
+     */
+    void stepComponents(int ticks);
+
+    /**
+     * Step some components by the time elapsed since they were last updated, then schedule their next events.
+     * This time can be given at once, the components were brought up to date before any of their events.
+     *
+     * @param components A combination of MMU::SynchronizedComponent
+     */
+    void synchronizeComponents(int components);
+
+    /**
+     * Bring the OAM DMA transfer and the PPU up to date, then schedule their next events.
+     */
+    void synchronizePPU();
+
+    /**
+     * Bring the timer up to date, then schedule its next event.
+     */
+    void synchronizeTimer();
+
+    /**
+     * Bring the APU up to date, then schedule its next event.
+     * The timer needs to be up to date, the APU reads its divider register.
+     */
+    void synchronizeAPU();
+
+    /**
+     * Get the components having an event scheduled before the given time.
+     *
+     * @param cycles The time in cycles of the scheduler
+     * @return a combination of MMU::SynchronizedComponent
+     */
+    int getComponentsWithEventsUntil(int64_t cycles) const;
+
+    /**
+     * Get the number of CPU ticks until the next event of the components, used when the CPU doesn't access the memory.
+     *
+     * @return a number of ticks, at least 1
+     */
+    int getTicksUntilNextEvent() const;
+
+    /**
+     * @return the number of cycles of the scheduler in a CPU tick at the current speed
+     */
+    int getCyclesPerCPUTick() const
+    {
+        return mmu.isDoubleSpeedEnabled() ? 1 : Scheduler::CYCLES_PER_TICK;
+    }
+
+    /**
+     * Get the number of CPU ticks elapsed since a time, a component clocked by the CPU is stepped by them.
+     *
+     * @param cycles A time in cycles of the scheduler, at the current speed
+     * @return the number of CPU ticks
+     */
+    int getCPUTicksSince(int64_t cycles) const
+    {
+        return static_cast<int>((_scheduler.getCurrentCycles() - cycles) / getCyclesPerCPUTick());
+    }
+
+    /**
+     * Get the number of ticks at normal speed elapsed since a time, the PPU and the APU are stepped by them.
+     * In double speed mode, the CPU tick left over counts toward the next tick.
+     *
+     * @param cycles A time in cycles of the scheduler
+     * @return the number of ticks at normal speed
+     */
+    int getNormalSpeedTicksSince(int64_t cycles) const
+    {
+        return static_cast<int>(_scheduler.getCurrentTicks() - cycles / Scheduler::CYCLES_PER_TICK);
+    }
+
+    /**
+     * Convert ticks at normal speed to CPU ticks.
+     *
+     * @param normalSpeedTicks A number of ticks at normal speed
+     * @return the number of CPU ticks taking the same time
+     */
+    int convertToCPUTicks(int normalSpeedTicks) const;
+
+    /**
+     * Queue the pages of the RAM written since the last save in the battery save file,
+     * followed by the state of the clock of the cartridge.
+     */
+    void saveDirtyRAMPages();
+
     static const int AUDIO_SAMPLING_FREQ = 44100;
     MMU mmu;
     CPU cpu;
@@ -107,7 +383,50 @@ class Emulator
     InputController inputController;
     Timer timer;
     APU apu;
-    int currentTicks = 0;
+    Scheduler _scheduler;
+
+    /**
+     * The time in cycles the OAM DMA transfer and the PPU were last brought up to date
+     */
+    int64_t _ppuSynchronizationCycles = 0;
+
+    /**
+     * The time in cycles the timer was last brought up to date
+     */
+    int64_t _timerSynchronizationCycles = 0;
+
+    /**
+     * The time in cycles the APU was last brought up to date
+     */
+    int64_t _apuSynchronizationCycles = 0;
+
+    bool _isCatchUpSynchronizationEnabled = true;
+
+    /**
+     * The components accessed by the CPU during the current instruction, their events need to be computed again
+     */
+    int _accessedComponents = 0;
+
+    /**
+     * The addresses of the breakpoints
+     */
+    std::bitset<0x10000> _breakpoints;
+
+    /**
+     * true if at least one breakpoint is set, the program counter is only checked then
+     */
+    bool _hasBreakpoints = false;
+
+    size_t _audioBufferCapacity = DEFAULT_AUDIO_BUFFER_CAPACITY;
+
+    BatterySave _batterySave;
+
+    /**
+     * The controller whose RAM is saved, the file is closed when another cartridge is loaded
+     */
+    MemoryBankController* _batterySaveController = nullptr;
+
+    int _batterySaveIntervalInTicks = DEFAULT_BATTERY_SAVE_INTERVAL_IN_TICKS;
 };
 
 #endif
@@ -65,6 +65,7 @@ BackgroundWindowPixelFetcher::BackgroundWindowPixelFetcher(VRAM* vram, PPU* ppu,
     _tilemaps.emplace_back(_vram, ADDR_MAP_1);
 }
 
+template <HardwareModel model>
 void BackgroundWindowPixelFetcher::step()
 {
     if (_currentStep == Step::GetTile)
@@ -73,7 +74,7 @@ void BackgroundWindowPixelFetcher::step()
     }
     else if (_currentStep == Step::GetTileDataLow)
     {
-        stepGetTileDataLow();
+        stepGetTileDataLow<model>();
     }
     else if (_currentStep == Step::GetTileDataHigh)
     {
@@ -85,11 +86,15 @@ void BackgroundWindowPixelFetcher::step()
     }
 }
 
+template void BackgroundWindowPixelFetcher::step<HardwareModel::DMG>();
+template void BackgroundWindowPixelFetcher::step<HardwareModel::CGB>();
+
 void BackgroundWindowPixelFetcher::setMode(BackgroundWindowPixelFetcher::Mode mode)
 {
     _mode = mode;
 }
 
+template <HardwareModel model>
 void BackgroundWindowPixelFetcher::stepGetTileDataLow()
 {
     if (_ticksInCurrentStep == 1)
@@ -100,7 +105,7 @@ void BackgroundWindowPixelFetcher::stepGetTileDataLow()
         _flippedVertically = false;
         _priority = 0;
 
-        if (_ppu->getMMU().isColorModeSupported())
+        if constexpr (model == HardwareModel::CGB)
         {
             int tilemapId = (_mode == Mode::WINDOW) ? _ppu->windowTileMapIndex() : _ppu->backgroundTileMapIndex();
             Tilemap::TileInfo tileInfo = _tilemaps[tilemapId].getTileInfoForIndex(_tileIndex);
@@ -1,6 +1,7 @@
 #ifndef GROUBOY_BACKGROUND_WINDOW_PIXEL_FETCHER_HPP
 #define GROUBOY_BACKGROUND_WINDOW_PIXEL_FETCHER_HPP
 
+#include "common/hardware_model.hpp"
 #include "pixel_fifo.hpp"
 #include "tilemap.hpp"
 
@@ -18,7 +19,14 @@ class BackgroundWindowPixelFetcher
     };
 
     BackgroundWindowPixelFetcher(VRAM* vram, PPU* ppu, PixelFIFO& pixelFifo);
+
+    /**
+     * Perform one step of the fetcher, compiled for a hardware model.
+     * @tparam model The hardware model emulated
+     */
+    template <HardwareModel model>
     void step();
+
     void setMode(Mode mode);
     void reset();
 
@@ -33,6 +41,7 @@ class BackgroundWindowPixelFetcher
     };
 
     void stepGetTile();
+    template <HardwareModel model>
     void stepGetTileDataLow();
     void stepGetTileDataHigh();
     void pushToFifo();
@@ -7,12 +7,13 @@ PixelFifoRenderer::PixelFifoRenderer(MMU* mmu, PPU* ppu)
 {
 }
 
+template <HardwareModel model>
 void PixelFifoRenderer::step()
 {
     // If sprite fetcher is active, step it
     if (_bgFetcherPaused)
     {
-        bool spriteFetchComplete = _spritePixelFetcher.step();
+        bool spriteFetchComplete = _spritePixelFetcher.step<model>();
         if (spriteFetchComplete)
         {
             // Check if there are more sprites at the same X position
@@ -51,7 +52,7 @@ void PixelFifoRenderer::step()
     }
 
     // Step the background/window fetcher
-    _bgWindowPixelFetcher.step();
+    _bgWindowPixelFetcher.step<model>();
 
     // Pop and render pixels only when we have enough and sprite fetcher is not active
     if (_backgroundWindowFIFO.size() >= 8)
@@ -94,13 +95,13 @@ void PixelFifoRenderer::step()
         }
 
         // Mix the BG and OAM FIFOs and get the pixel to render
-        Pixel pixel = mixPixels();
+        Pixel pixel = mixPixels<model>();
 
         // Get the appropriate palette based on pixel source
         Palette* palette = nullptr;
         if (pixel.getSource() == Pixel::Source::SPRITE)
         {
-            if (_mmu->isColorModeSupported())
+            if constexpr (model == HardwareModel::CGB)
             {
                 palette = &_mmu->getColorPaletteMemoryMapperObj().getColorPalette(pixel.getPaletteId());
             }
@@ -111,7 +112,7 @@ void PixelFifoRenderer::step()
         }
         else
         {
-            if (_mmu->isColorModeSupported())
+            if constexpr (model == HardwareModel::CGB)
             {
                 palette = &_mmu->getColorPaletteMemoryMapperBackground().getColorPalette(pixel.getPaletteId());
             }
@@ -124,7 +125,7 @@ void PixelFifoRenderer::step()
         byte colorId = pixel.getColorId();
         // On DMG, if BG/Window is disabled, use color 0 for background
         // On CGB, LCDC.0 has a different meaning (BG/Window priority)
-        if (!_mmu->isColorModeSupported() && !_ppu->areBackgroundAndWindowEnabled() &&
+        if (model == HardwareModel::DMG && !_ppu->areBackgroundAndWindowEnabled() &&
             pixel.getSource() == Pixel::Source::BG_WINDOW)
         {
             colorId = 0;
@@ -135,6 +136,10 @@ void PixelFifoRenderer::step()
     }
 }
 
+template void PixelFifoRenderer::step<HardwareModel::DMG>();
+template void PixelFifoRenderer::step<HardwareModel::CGB>();
+
+template <HardwareModel model>
 Pixel PixelFifoRenderer::mixPixels()
 {
     // Pop from both FIFOs
@@ -166,7 +171,7 @@ Pixel PixelFifoRenderer::mixPixels()
     // Now we apply priority rules to determine which one wins
     bool useOamPixel = true;
 
-    if (_mmu->isColorModeSupported())
+    if constexpr (model == HardwareModel::CGB)
     {
         // CGB priority rules (when LCDC.0 is 1 - BG/Window have priority enabled):
         // 1. If LCDC.0 is 0, sprites always have priority (already handled above via color 0 transparency)
@@ -16,7 +16,15 @@ class PixelFifoRenderer
   public:
     PixelFifoRenderer(MMU* mmu, PPU* ppu);
     ~PixelFifoRenderer() = default;
+
+    /**
+     * Perform one step of the rendering, compiled for a hardware model
+     * so that the color checks aren't done for each pixel.
+     * @tparam model The hardware model emulated
+     */
+    template <HardwareModel model>
     void step();
+
     void reset();
     int getX() const;
 
@@ -68,8 +76,10 @@ class PixelFifoRenderer
     /**
      * Mix a pixel from the BG FIFO with the corresponding OAM FIFO pixel
      * and determine which one should be rendered.
+     * @tparam model The hardware model emulated, its priority rules are used
      * @return The pixel that should be rendered
      */
+    template <HardwareModel model>
     Pixel mixPixels();
 
     MMU* _mmu;
@@ -12,6 +12,24 @@ const int PPU::SCREEN_HEIGHT = 144;
 
 PPU::~PPU() = default;
 
+void PPU::step(int nbrTicks)
+{
+    (this->*_stepForHardwareModel)(nbrTicks);
+}
+
+void PPU::setHardwareModel(HardwareModel model)
+{
+    if (model == HardwareModel::CGB)
+    {
+        _stepForHardwareModel = &PPU::step<HardwareModel::CGB>;
+    }
+    else
+    {
+        _stepForHardwareModel = &PPU::step<HardwareModel::DMG>;
+    }
+}
+
+template <HardwareModel model>
 void PPU::step(int nbrTicks)
 {
     _ticksSpentInCurrentMode += nbrTicks;
@@ -31,7 +49,7 @@ void PPU::step(int nbrTicks)
 
         if (areSpritesEnabled())
         {
-            _spritesToRender = getSpritesThatShouldBeRendered(_currentScanline);
+            _spritesToRender = getSpritesThatShouldBeRendered<model>(_currentScanline);
         }
 
         setMode(VRAM_ACCESS);
@@ -40,7 +58,7 @@ void PPU::step(int nbrTicks)
     }
     else if (_currentMode == VRAM_ACCESS)
     {
-        stepFifo(nbrTicks);
+        stepFifo<model>(nbrTicks);
     }
     else if (_currentMode == HBLANK && _ticksSpentInCurrentMode >= (HBLANK_TICKS - _extraTicksSpentDrawingPixels))
     {
@@ -91,6 +109,38 @@ void PPU::step(int nbrTicks)
     _lcdStatusRegister->setScanlineRegister(_currentScanline);
 }
 
+int PPU::getTicksUntilNextEvent() const
+{
+    // The LYC interrupt is raised at the start of the step
+    if (_lcdStatusRegister->areLYCAndLYEqual() && _lcdStatusRegister->isLYCompareStatInterruptEnabled() &&
+        !_LYCInterruptRaisedDuringScanline)
+    {
+        return 1;
+    }
+
+    int ticks = 1;
+    if (_currentMode == OAM_ACCESS)
+    {
+        ticks = OAM_ACCESS_TICKS - _ticksSpentInCurrentMode;
+    }
+    else if (_currentMode == VRAM_ACCESS)
+    {
+        // At most one pixel is rendered per tick
+        ticks = SCREEN_WIDTH - _pixelFifoRenderer.getX();
+    }
+    else if (_currentMode == HBLANK)
+    {
+        ticks = HBLANK_TICKS - _extraTicksSpentDrawingPixels - _ticksSpentInCurrentMode;
+    }
+    else if (_currentMode == VBLANK)
+    {
+        ticks = VBLANK_TICKS - _ticksSpentInCurrentMode;
+    }
+
+    return std::max(ticks, 1);
+}
+
+template <HardwareModel model>
 std::vector<Sprite*> PPU::getSpritesThatShouldBeRendered(int scanline)
 {
     std::vector<Sprite*> spritesToRender = {};
@@ -137,7 +187,7 @@ std::vector<Sprite*> PPU::getSpritesThatShouldBeRendered(int scanline)
      * We sort in REVERSE priority order (lowest priority first) so that when we process sprites
      * in order, higher priority sprites overwrite lower priority ones.
      */
-    if (_mmu.isColorModeSupported())
+    if constexpr (model == HardwareModel::CGB)
     {
         // CGB: Sort by OAM index descending (higher index = lower priority, processed first)
         std::sort(spritesToRender.begin(), spritesToRender.end(),
@@ -175,6 +225,7 @@ PPU::PPU(MMU& mmu_, InterruptManager* interruptManager)
       _paletteBackground(_mmu, ADDR_PALETTE_BG), _paletteObj0(_mmu, ADDR_PALETTE_OBJ0),
       _paletteObj1(_mmu, ADDR_PALETTE_OBJ1), _pixelFifoRenderer(&_mmu, this)
 {
+    setHardwareModel(_mmu.getHardwareModel());
     reset();
 
     for (unsigned int i = 0; i < _sprites.size(); ++i)
@@ -309,12 +360,13 @@ MMU& PPU::getMMU()
     return _mmu;
 }
 
+template <HardwareModel model>
 void PPU::stepFifo(int ticks)
 {
     int ticksLeft = ticks;
     while (ticksLeft > 0)
     {
-        _pixelFifoRenderer.step();
+        _pixelFifoRenderer.step<model>();
 
         if (_pixelFifoRenderer.getX() >= SCREEN_WIDTH)
         {
@@ -333,6 +385,7 @@ void PPU::stepFifo(int ticks)
             spdlog::debug("Mode 3 last for {} ticks, extending HBLANK by {} ticks", _ticksSpentInCurrentMode,
                          _extraTicksSpentDrawingPixels);
             setMode(HBLANK);
+            _mmu.notifyHBlankStarted();
             return;
         }
 
@@ -83,6 +83,21 @@ class PPU
      */
     void step(int nbrTicks);
 
+    /**
+     * Select the rendering compiled for a hardware model, the MMU calls it when its model changes.
+     *
+     * @param model The hardware model emulated
+     */
+    void setHardwareModel(HardwareModel model);
+
+    /**
+     * Get the number of ticks that can be given at once to step() with the same result
+     * as giving them one by one, it stops at the next change of mode or scanline.
+     *
+     * @return a number of ticks, at least 1
+     */
+    int getTicksUntilNextEvent() const;
+
     /**
      * Get the current mode of the PPU.
      *
@@ -346,11 +361,29 @@ class PPU
      * The sprites will be ordered by increasing priority so that a sprite with lower priority will
      * be overridden by the next one.
      *
+     * @tparam model The hardware model emulated, which decides the priority of the sprites
      * @param scanline The scanline that the sprites will be rendered on
      * @return a list of sprites to render, ordered by increasing priority
      */
+    template <HardwareModel model>
     std::vector<Sprite*> getSpritesThatShouldBeRendered(int scanline);
 
+    /**
+     * Make the PPU work for a certain number of ticks, compiled for a hardware model.
+     *
+     * @tparam model The hardware model emulated
+     * @param nbrTicks  The number of CPU ticks the PPU should work for.
+     */
+    template <HardwareModel model>
+    void step(int nbrTicks);
+
+    /**
+     * Render the pixels of the current scanline with the pixel FIFO.
+     *
+     * @tparam model The hardware model emulated
+     * @param ticks The number of ticks to render
+     */
+    template <HardwareModel model>
     void stepFifo(int ticks);
 
     /**
@@ -405,6 +438,11 @@ class PPU
      */
     MMU& _mmu;
 
+    /**
+     * The step() compiled for the hardware model of the MMU, see setHardwareModel()
+     */
+    void (PPU::*_stepForHardwareModel)(int nbrTicks) = nullptr;
+
     /**
      * The frame currently being rendered.
      */
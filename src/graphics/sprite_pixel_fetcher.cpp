@@ -25,6 +25,7 @@ void SpritePixelFetcher::startFetching(Sprite* sprite, int scanline)
     _ticksInCurrentStep = 0;
 }
 
+template <HardwareModel model>
 bool SpritePixelFetcher::step()
 {
     if (!_active)
@@ -35,7 +36,7 @@ bool SpritePixelFetcher::step()
     switch (_currentStep)
     {
     case Step::GetTileId:
-        stepGetTileId();
+        stepGetTileId<model>();
         break;
     case Step::GetTileDataLow:
         stepGetTileDataLow();
@@ -47,13 +48,16 @@ bool SpritePixelFetcher::step()
         stepSleep();
         break;
     case Step::Push:
-        pushToFifo();
+        pushToFifo<model>();
         return true;
     }
 
     return false;
 }
 
+template bool SpritePixelFetcher::step<HardwareModel::DMG>();
+template bool SpritePixelFetcher::step<HardwareModel::CGB>();
+
 bool SpritePixelFetcher::isActive() const
 {
     return _active;
@@ -67,6 +71,7 @@ void SpritePixelFetcher::reset()
     _sprite = nullptr;
 }
 
+template <HardwareModel model>
 void SpritePixelFetcher::stepGetTileId()
 {
     if (_ticksInCurrentStep == 1)
@@ -101,7 +106,7 @@ void SpritePixelFetcher::stepGetTileId()
         _tileAddr = _tileId * SingleTile::BYTES_PER_TILE;
 
         // Get bank ID for CGB mode
-        _bankId = _ppu->getMMU().isColorModeSupported() ? _sprite->getBankId() : 0;
+        _bankId = model == HardwareModel::CGB ? _sprite->getBankId() : 0;
 
         goToStep(Step::GetTileDataLow);
     }
@@ -150,6 +155,7 @@ void SpritePixelFetcher::stepSleep()
     }
 }
 
+template <HardwareModel model>
 void SpritePixelFetcher::pushToFifo()
 {
     /*
@@ -168,7 +174,7 @@ void SpritePixelFetcher::pushToFifo()
 
     // Get palette information
     int paletteId;
-    if (_ppu->getMMU().isColorModeSupported())
+    if constexpr (model == HardwareModel::CGB)
     {
         paletteId = _sprite->getColorPaletteId();
     }
@@ -181,7 +187,7 @@ void SpritePixelFetcher::pushToFifo()
     // We need a combined priority that takes into account both X position (for DMG) or OAM index (for CGB)
     // and the BG priority flag. We use a combined value to ensure proper sorting.
     int spritePriority;
-    if (_ppu->getMMU().isColorModeSupported())
+    if constexpr (model == HardwareModel::CGB)
     {
         // CGB: OAM index is the priority (lower index = higher priority)
         spritePriority = _sprite->getId();
@@ -245,7 +251,7 @@ void SpritePixelFetcher::pushToFifo()
                 // Existing pixel is transparent, always replace
                 shouldReplace = true;
             }
-            else if (_ppu->getMMU().isColorModeSupported())
+            else if constexpr (model == HardwareModel::CGB)
             {
                 // CGB: Compare OAM indices (lower index = higher priority)
                 // Note: We use abs() because negative values indicate BG priority flag
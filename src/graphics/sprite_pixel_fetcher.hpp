@@ -1,6 +1,7 @@
 #ifndef GROUBOY_SPRITE_PIXEL_FETCHER_HPP
 #define GROUBOY_SPRITE_PIXEL_FETCHER_HPP
 
+#include "common/hardware_model.hpp"
 #include "common/types.hpp"
 #include "pixel_fifo.hpp"
 #include "sprite.hpp"
@@ -27,9 +28,11 @@ class SpritePixelFetcher
     void startFetching(Sprite* sprite, int scanline);
 
     /**
-     * Perform one step of the sprite fetcher state machine.
+     * Perform one step of the sprite fetcher state machine, compiled for a hardware model.
+     * @tparam model The hardware model emulated
      * @return true when the fetch is complete and pixels have been pushed
      */
+    template <HardwareModel model>
     bool step();
 
     /**
@@ -53,10 +56,12 @@ class SpritePixelFetcher
         Push
     };
 
+    template <HardwareModel model>
     void stepGetTileId();
     void stepGetTileDataLow();
     void stepGetTileDataHigh();
     void stepSleep();
+    template <HardwareModel model>
     void pushToFifo();
     void goToStep(Step step);
 
@@ -151,30 +151,28 @@ void EmulatorSDLGUI::mainLoop()
 
     lastFramesTicks.push_back(startFrameTime);
 
-    while (_frameId == _ppu.getFrameId())
+    // The audio is queued each time the buffer is full and at the end of the frame
+    Emulator::RunResult result;
+    do
     {
-        _emulator.exec();
+        result = _emulator.runUntil([](Emulator::StopReason reason) {
+            return reason == Emulator::StopReason::FRAME_COMPLETE || reason == Emulator::StopReason::AUDIO_BUFFER_FULL;
+        });
 
         if (_isAudioEnabled)
         {
-            auto buffer = _apu.getAudioBuffer();
+            const APU::AudioBuffer& buffer = _apu.getAudioBuffer();
             if (buffer.size() > 0)
             {
                 SDL_QueueAudio(1, buffer.data(), buffer.size() * sizeof(buffer[0]));
-                _apu.resetAudioBuffer();
             }
         }
-        else
-        {
-            _apu.resetAudioBuffer();
-        }
-    }
+        _apu.resetAudioBuffer();
+    } while (result.reason != Emulator::StopReason::FRAME_COMPLETE);
 
     Uint64 endFrameTime = SDL_GetTicks64();
     Uint64 timeToComputeFrame = (endFrameTime - startFrameTime);
 
-    _frameId = _ppu.getFrameId();
-
     auto image = _ppu.getLastRenderedFrame();
     auto data = image.getData();
     void* pixels = nullptr;
@@ -32,7 +32,6 @@ class EmulatorSDLGUI
     SDL_Renderer* _renderer = nullptr;
     SDL_Texture* _texture = nullptr;
     TTF_Font* _font = nullptr;
-    int _frameId = 0;
     bool _isAudioEnabled = true;
     bool _shouldQuit = false;
     bool _isDebugActivated = false;
@@ -2,22 +2,74 @@
 #include "gui/emulator_sdl_gui.hpp"
 #include <iostream>
 
+/**
+ * Print the command line options of the emulator.
+ *
+ * @param program   The name of the executable
+ */
+static void printUsage(const char* program)
+{
+    std::cout << "Usage: " << program << " <rom> [--cached-interpreter | --jit]" << std::endl;
+    std::cout << "       [--translation-cache <directory>] [--battery-save <file>] [--stats]" << std::endl;
+}
+
 int main(int argc, char* args[])
 {
     if (argc <= 1)
     {
         std::cout << "Please specify a rom file to load." << std::endl;
+        printUsage(args[0]);
         return EXIT_FAILURE;
     }
 
     const std::string file = args[1];
+    std::string batterySaveFile = file.substr(0, file.find_last_of('.')) + ".sav";
+    bool shouldPrintStatistics = false;
     Emulator emulator;
+
+    for (int i = 2; i < argc; ++i)
+    {
+        const std::string option = args[i];
+        if (option == "--cached-interpreter")
+        {
+            emulator.getCPU().setExecutionMode(CPU::ExecutionMode::CACHED_INTERPRETER);
+        }
+        else if (option == "--jit")
+        {
+            emulator.getCPU().setExecutionMode(CPU::ExecutionMode::JIT);
+        }
+        else if (option == "--translation-cache" && i + 1 < argc)
+        {
+            emulator.getCPU().setTranslationCacheDirectory(args[++i]);
+        }
+        else if (option == "--battery-save" && i + 1 < argc)
+        {
+            batterySaveFile = args[++i];
+        }
+        else if (option == "--stats")
+        {
+            shouldPrintStatistics = true;
+        }
+        else
+        {
+            std::cout << "Unknown option or missing value: " << option << std::endl;
+            printUsage(args[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
     if (!emulator.getMMU().loadCartridgeFromFile(file))
     {
         std::cout << "Couldn't load rom file: " << file << std::endl;
         return EXIT_FAILURE;
     }
 
+    // The file is flushed when the emulator is destroyed
+    if (emulator.getMMU().getCartridge()->hasBattery() && !emulator.openBatterySave(batterySaveFile))
+    {
+        std::cerr << "Couldn't open battery save file: " << batterySaveFile << std::endl;
+    }
+
     EmulatorSDLGUI gui(emulator);
 
     if (!gui.create())
@@ -33,5 +85,12 @@ int main(int argc, char* args[])
 
     gui.destroy();
 
+    if (shouldPrintStatistics)
+    {
+        const IdleLoopDetector::Statistics& statistics = emulator.getCPU().getIdleLoopDetector().getStatistics();
+        std::cout << emulator.getMMU().getCartridge()->getTitle() << ": " << statistics.skippedTicks
+                  << " ticks skipped in " << statistics.numberOfDetectedLoops << " idle loops" << std::endl;
+    }
+
     return 0;
 }
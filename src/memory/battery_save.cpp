@@ -0,0 +1,192 @@
+#include "battery_save.hpp"
+#include <algorithm>
+#include <cstring>
+
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(__EMSCRIPTEN__)
+#define GBEMULATOR_BATTERY_SAVE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// The browser build doesn't have threads, the data is written when it's queued
+#ifndef __EMSCRIPTEN__
+#define GBEMULATOR_BATTERY_SAVE_THREAD
+#endif
+
+BatterySave::~BatterySave()
+{
+    close();
+}
+
+bool BatterySave::open(const std::string& path, size_t size)
+{
+    close();
+    if (size == 0)
+    {
+        return false;
+    }
+
+#ifdef GBEMULATOR_BATTERY_SAVE_MMAP
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat fileStatus = {};
+    bool isValid = fstat(fd, &fileStatus) == 0 &&
+                   (static_cast<size_t>(fileStatus.st_size) >= size || ftruncate(fd, static_cast<off_t>(size)) == 0);
+    void* mapping = isValid ? mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    // The mapping stays valid once the file is closed
+    ::close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        return false;
+    }
+    _mapping = static_cast<byte*>(mapping);
+#else
+    // Create the file if it doesn't exist, without truncating it
+    std::ofstream(path, std::ios::binary | std::ios::app).close();
+    _file.open(path, std::ios::binary | std::ios::in | std::ios::out);
+    _file.seekg(0, std::ios::end);
+    size_t fileSize = static_cast<size_t>(std::max<std::streamoff>(_file.tellg(), 0));
+    if (fileSize < size)
+    {
+        std::vector<char> padding(size - fileSize, 0);
+        _file.seekp(0, std::ios::end);
+        _file.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+        _file.flush();
+    }
+    if (!_file.good())
+    {
+        _file.close();
+        return false;
+    }
+#endif
+
+    _size = size;
+    _isClosing = false;
+#ifdef GBEMULATOR_BATTERY_SAVE_THREAD
+    _thread = std::thread(&BatterySave::run, this);
+#endif
+    return true;
+}
+
+void BatterySave::close()
+{
+    if (!isOpen())
+    {
+        return;
+    }
+
+#ifdef GBEMULATOR_BATTERY_SAVE_THREAD
+    {
+        // The thread writes everything still queued before stopping
+        std::lock_guard<std::mutex> lock(_mutex);
+        _isClosing = true;
+    }
+    _condition.notify_all();
+    _thread.join();
+#endif
+
+#ifdef GBEMULATOR_BATTERY_SAVE_MMAP
+    msync(_mapping, _size, MS_SYNC);
+    munmap(_mapping, _size);
+#endif
+    _mapping = nullptr;
+    _file.close();
+    _size = 0;
+}
+
+std::vector<byte> BatterySave::read()
+{
+    flush();
+
+    std::vector<byte> data(_size);
+    if (_mapping != nullptr)
+    {
+        std::copy(_mapping, _mapping + _size, data.begin());
+    }
+    else if (isOpen())
+    {
+        _file.seekg(0);
+        _file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    }
+
+    return data;
+}
+
+void BatterySave::write(size_t offset, const byte* data, size_t size)
+{
+    if (!isOpen() || offset >= _size)
+    {
+        return;
+    }
+
+    PendingWrite pendingWrite = {offset, std::vector<byte>(data, data + std::min(size, _size - offset))};
+#ifdef GBEMULATOR_BATTERY_SAVE_THREAD
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _pendingWrites.push_back(std::move(pendingWrite));
+    }
+    _condition.notify_all();
+#else
+    writeToFile({pendingWrite});
+#endif
+}
+
+void BatterySave::flush()
+{
+#ifdef GBEMULATOR_BATTERY_SAVE_THREAD
+    std::unique_lock<std::mutex> lock(_mutex);
+    _condition.wait(lock, [this]() { return _pendingWrites.empty() && !_isWriting; });
+#endif
+}
+
+void BatterySave::run()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true)
+    {
+        _condition.wait(lock, [this]() { return !_pendingWrites.empty() || _isClosing; });
+        if (_pendingWrites.empty())
+        {
+            return;
+        }
+
+        // The emulator keeps queuing pages while the batch is written
+        std::vector<PendingWrite> writes;
+        writes.swap(_pendingWrites);
+        _isWriting = true;
+        lock.unlock();
+        writeToFile(writes);
+        lock.lock();
+        _isWriting = false;
+        _condition.notify_all();
+    }
+}
+
+void BatterySave::writeToFile(const std::vector<PendingWrite>& writes)
+{
+    if (_mapping != nullptr)
+    {
+        for (const PendingWrite& pendingWrite : writes)
+        {
+            std::memcpy(_mapping + pendingWrite.offset, pendingWrite.data.data(), pendingWrite.data.size());
+        }
+#ifdef GBEMULATOR_BATTERY_SAVE_MMAP
+        msync(_mapping, _size, MS_SYNC);
+#endif
+        return;
+    }
+
+    for (const PendingWrite& pendingWrite : writes)
+    {
+        _file.seekp(static_cast<std::streamoff>(pendingWrite.offset));
+        _file.write(reinterpret_cast<const char*>(pendingWrite.data.data()),
+                    static_cast<std::streamsize>(pendingWrite.data.size()));
+    }
+    _file.flush();
+}
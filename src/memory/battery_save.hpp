@@ -0,0 +1,132 @@
+#ifndef GBEMULATOR_BATTERY_SAVE_HPP
+#define GBEMULATOR_BATTERY_SAVE_HPP
+
+#include "common/types.hpp"
+#include <condition_variable>
+#include <cstddef>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * File keeping a copy of the battery-backed RAM of a cartridge (.sav).
+ *
+ * The emulator only hands over the pages of the RAM that were written, they are copied
+ * and written to the file by a background thread so that the emulation never waits for the disk.
+ * The file is memory-mapped when the platform allows it, the pages are then copied in the mapping
+ * and synchronized with the disk after each batch.
+ */
+class BatterySave
+{
+  public:
+    BatterySave() = default;
+
+    /**
+     * Write the pages still pending and close the file.
+     */
+    ~BatterySave();
+
+    BatterySave(const BatterySave&) = delete;
+    BatterySave& operator=(const BatterySave&) = delete;
+
+    /**
+     * Open a file, it's created if needed and grown to the given size.
+     * A file bigger than the size is kept as is, only its beginning is used.
+     *
+     * @param path  The path of the file
+     * @param size  The number of bytes of the file used, the size of the RAM
+     * @return true if the file was opened
+     */
+    bool open(const std::string& path, size_t size);
+
+    /**
+     * Write the pages still pending and close the file.
+     */
+    void close();
+
+    /**
+     * @return true if a file is currently opened
+     */
+    bool isOpen() const
+    {
+        return _size > 0;
+    }
+
+    /**
+     * Read the content of the file, once the data queued is written.
+     *
+     * @return the bytes of the file used, empty if no file is opened
+     */
+    std::vector<byte> read();
+
+    /**
+     * Queue the writing of a part of the RAM in the file, the data is copied.
+     *
+     * @param offset    The offset of the data in the file
+     * @param data      The data to write
+     * @param size      The number of bytes to write
+     */
+    void write(size_t offset, const byte* data, size_t size);
+
+    /**
+     * Wait until all the data queued is written and synchronized with the disk.
+     */
+    void flush();
+
+  private:
+    /**
+     * Data to write in the file.
+     */
+    struct PendingWrite
+    {
+        size_t offset;
+        std::vector<byte> data;
+    };
+
+    /**
+     * Write the data queued until the file is closed, executed by the thread.
+     */
+    void run();
+
+    /**
+     * Write data in the file then synchronize it with the disk.
+     *
+     * @param writes The data to write
+     */
+    void writeToFile(const std::vector<PendingWrite>& writes);
+
+    /**
+     * The number of bytes of the file used, 0 if no file is opened
+     */
+    size_t _size = 0;
+
+    /**
+     * The memory where the file is mapped, nullptr if it's written through _file
+     */
+    byte* _mapping = nullptr;
+
+    /**
+     * The file when it can't be mapped
+     */
+    std::fstream _file;
+
+    std::thread _thread;
+
+    /**
+     * Protect the members below, shared with the thread
+     */
+    std::mutex _mutex;
+
+    /**
+     * Notified when data is queued or when the thread finished writing
+     */
+    std::condition_variable _condition;
+
+    std::vector<PendingWrite> _pendingWrites;
+    bool _isWriting = false;
+    bool _isClosing = false;
+};
+
+#endif // GBEMULATOR_BATTERY_SAVE_HPP
@@ -7,7 +7,11 @@
 #include <stdexcept>
 #include <utility>
 
-Cartridge::Cartridge(std::vector<byte> binaryData) : data(std::move(binaryData))
+Cartridge::Cartridge(std::vector<byte> binaryData) : Cartridge(ROMImage::create(std::move(binaryData)))
+{
+}
+
+Cartridge::Cartridge(std::shared_ptr<const ROMImage> image) : image(std::move(image))
 {
     readHeader();
 }
@@ -22,9 +26,19 @@ const std::string& Cartridge::getManufacturerCode() const
     return manufacturerCode;
 }
 
-std::vector<byte>& Cartridge::getData()
+const ROMImage& Cartridge::getData() const
+{
+    return *image;
+}
+
+const std::shared_ptr<const ROMImage>& Cartridge::getROMImage() const
 {
-    return data;
+    return image;
+}
+
+uint64_t Cartridge::getHash() const
+{
+    return image->getHash();
 }
 
 void Cartridge::readHeader()
@@ -36,17 +50,21 @@ void Cartridge::readHeader()
 
 void Cartridge::readTitle()
 {
-    const byte* startAddr = data.data() + TITLE_START_ADDR;
     // The title can be null terminated or not if it has the max size
-    int tileLength = TITLE_LENGTH;
-    size_t len = std::min(static_cast<int>(strlen(reinterpret_cast<const char*>(startAddr))), tileLength);
-    title = std::string(startAddr, startAddr + len);
+    title.clear();
+    for (int i = 0; i < TITLE_LENGTH && readHeaderByte(TITLE_START_ADDR + i) != 0; ++i)
+    {
+        title.push_back(static_cast<char>(readHeaderByte(TITLE_START_ADDR + i)));
+    }
 }
 
 void Cartridge::readManufacturerCode()
 {
-    const byte* startAddr = data.data() + MANUFACTURER_CODE_START_ADDR;
-    manufacturerCode = std::string(startAddr, startAddr + MANUFACTURER_CODE_LENGTH);
+    manufacturerCode.clear();
+    for (int i = 0; i < MANUFACTURER_CODE_LENGTH; ++i)
+    {
+        manufacturerCode.push_back(static_cast<char>(readHeaderByte(MANUFACTURER_CODE_START_ADDR + i)));
+    }
 }
 
 std::string Cartridge::cartridgeTypeToString(CartridgeType value)
@@ -119,19 +137,24 @@ Cartridge::CartridgeType Cartridge::getType() const
     return type;
 }
 
+byte Cartridge::readHeaderByte(size_t addr) const
+{
+    return addr < image->size() ? (*image)[addr] : 0;
+}
+
 void Cartridge::readType()
 {
-    type = static_cast<CartridgeType>(data[CARTRIDGE_TYPE_ADDR]);
+    type = static_cast<CartridgeType>(readHeaderByte(CARTRIDGE_TYPE_ADDR));
 }
 
 size_t Cartridge::getROMSize() const
 {
-    return 32_KiB * (1ULL << data[CARTRIDGE_ROM_SIZE_ADDR]);
+    return 32_KiB * (1ULL << readHeaderByte(CARTRIDGE_ROM_SIZE_ADDR));
 }
 
 size_t Cartridge::getRAMSize() const
 {
-    unsigned int ramSizeValue = data[CARTRIDGE_RAM_SIZE_ADDR];
+    unsigned int ramSizeValue = readHeaderByte(CARTRIDGE_RAM_SIZE_ADDR);
 
     if (!hasRAM())
     {
@@ -170,9 +193,30 @@ bool Cartridge::hasRAM() const
     return typesWithRAM.count(type) > 0;
 }
 
+bool Cartridge::hasBattery() const
+{
+    switch (type)
+    {
+    case CartridgeType::MBC1_RAM_BATTERY:
+    case CartridgeType::MBC2_BATTERY:
+    case CartridgeType::ROM_RAM_BATTERY_1:
+    case CartridgeType::MMM01_RAM_BATTERY:
+    case CartridgeType::MBC3_TIMER_BATTERY:
+    case CartridgeType::MBC3_TIMER_RAM_BATTERY_2:
+    case CartridgeType::MBC3_RAM_BATTERY_2:
+    case CartridgeType::MBC5_RAM_BATTERY:
+    case CartridgeType::MBC5_RUMBLE_RAM_BATTERY:
+    case CartridgeType::MBC7_SENSOR_RUMBLE_RAM_BATTERY:
+    case CartridgeType::HUC1_RAM_BATTERY:
+        return true;
+    default:
+        return false;
+    }
+}
+
 bool Cartridge::isColorModeSupported() const
 {
-    byte colorFlag = data[COLOR_MODE_FLAG_ADDR];
+    byte colorFlag = readHeaderByte(COLOR_MODE_FLAG_ADDR);
     byte flagColorOnly = 0xC0;
     byte flagColorAndMono = 0x80;
     return colorFlag == flagColorOnly || colorFlag == flagColorAndMono;
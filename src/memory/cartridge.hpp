@@ -2,12 +2,16 @@
 #define GBEMULATOR_CARTRIDGE_HPP
 
 #include "common/utils.hpp"
+#include "memory/rom_image.hpp"
+#include <memory>
 #include <string>
 #include <vector>
 
 /**
  * Represents a Gameboy Cartridge, holds the ROM/RAM data
  * and information about the cartridge itself.
+ *
+ * The ROM is an immutable ROMImage, cartridges created from the same image share it without copying.
  */
 class Cartridge
 {
@@ -18,6 +22,12 @@ class Cartridge
      */
     explicit Cartridge(std::vector<byte> binaryData);
 
+    /**
+     * Create a cartridge from the image of a ROM
+     * @param image       the image of the ROM, it's shared with the caller
+     */
+    explicit Cartridge(std::shared_ptr<const ROMImage> image);
+
     ~Cartridge() = default;
 
     /**
@@ -34,9 +44,22 @@ class Cartridge
 
     /**
      * Get the binary data
-     * @return
+     * @return the image of the ROM
      */
-    std::vector<byte>& getData();
+    const ROMImage& getData() const;
+
+    /**
+     * Get the image of the ROM, to create other cartridges sharing it.
+     * @return the image of the ROM
+     */
+    const std::shared_ptr<const ROMImage>& getROMImage() const;
+
+    /**
+     * Get the hash of the binary data, identifying the ROM.
+     *
+     * @return the hash of the data, see ROMImage::getHash()
+     */
+    uint64_t getHash() const;
 
     /**
      * Get the size of the ROM in bytes
@@ -102,6 +125,12 @@ class Cartridge
      */
     bool isColorModeSupported() const;
 
+    /**
+     * Returns if the RAM of the cartridge is kept by a battery when the console is turned off.
+     * @return true if the RAM needs to be saved, false otherwise
+     */
+    bool hasBattery() const;
+
   private:
     /**
      * Read the cartridge header from the binary data
@@ -124,6 +153,14 @@ class Cartridge
      */
     void readType();
 
+    /**
+     * Read a byte of the header.
+     *
+     * @param addr The address of the byte
+     * @return the byte, or 0 if the data is too small to contain it
+     */
+    byte readHeaderByte(size_t addr) const;
+
     /**
      * Does the cartridge include RAM
      *
@@ -132,9 +169,9 @@ class Cartridge
     bool hasRAM() const;
 
     /**
-     * The binary data of the cartridge (ROM/RAM etc.)
+     * The image of the ROM of the cartridge
      */
-    std::vector<byte> data;
+    std::shared_ptr<const ROMImage> image;
 
     /**
      * The cartridge's title read from the header
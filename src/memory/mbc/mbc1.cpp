@@ -1,26 +1,12 @@
 #include "mbc1.hpp"
 #include "spdlog/spdlog.h"
+#include <algorithm>
 #include <stdexcept>
 
 MBC1::MBC1(Cartridge* cartridge) : MemoryBankController(cartridge)
 {
-    _ram.resize(cartridge->getRAMSize());
-}
-
-byte MBC1::readROM(const word& addr)
-{
-    if (fixedRomAddrRange.contains(addr))
-    {
-        return _cartridge->getData()[fixedRomAddrRange.relative(addr)];
-    }
-
-    else if (swappableRomAddrRange.contains(addr))
-    {
-        return _cartridge
-            ->getData()[_selectedROMBankId * ROM_BANK_SIZE_IN_BYTES + swappableRomAddrRange.relative(addr)];
-    }
-
-    throw std::runtime_error("Error, trying to read from bad memory location.");
+    initializeRAM(cartridge->getRAMSize());
+    updateMappedBanks();
 }
 
 void MBC1::writeROM(const word& addr, const byte& value)
@@ -68,6 +54,8 @@ void MBC1::writeROM(const word& addr, const byte& value)
         _selectedRAMBankId = (value & bitMask);
         spdlog::debug("MBC: Switching to RAM bank {}", _selectedRAMBankId);
     }
+
+    updateMappedBanks();
 }
 
 byte MBC1::readRAM(const word& addr)
@@ -89,21 +77,14 @@ void MBC1::writeRAM(const word& addr, const byte& value)
         return;
     }
 
-    _ram[_selectedRAMBankId * RAM_BANK_SIZE_IN_BYTES + addr] = value;
+    size_t ramAddr = _selectedRAMBankId * RAM_BANK_SIZE_IN_BYTES + addr;
+    _ram[ramAddr] = value;
+    markRAMDirty(ramAddr);
 }
 
-std::vector<byte> MBC1::serializeRAM()
+void MBC1::updateMappedBanks()
 {
-    return _ram;
+    size_t ramOffset = _selectedRAMBankId * RAM_BANK_SIZE_IN_BYTES;
+    bool isRAMMapped = _isRAMEnabled && ramOffset + RAM_BANK_SIZE_IN_BYTES <= _ram.size();
+    mapBanks(_selectedROMBankId, isRAMMapped ? &_ram[ramOffset] : nullptr);
 }
-
-bool MBC1::unserializeRAM(const std::vector<byte>& data)
-{
-    if (data.size() != _ram.size())
-    {
-        return false;
-    }
-
-    _ram = data;
-    return true;
-}
\ No newline at end of file
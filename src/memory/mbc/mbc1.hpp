@@ -22,23 +22,15 @@ class MBC1 : public MemoryBankController
      */
     virtual ~MBC1() = default;
 
-    byte readROM(const word& addr) override;
     void writeROM(const word& addr, const byte& value) override;
     byte readRAM(const word& addr) override;
     void writeRAM(const word& addr, const byte& value) override;
-    std::vector<byte> serializeRAM() override;
-    bool unserializeRAM(const std::vector<byte>& data) override;
 
   private:
     /**
-     * The address range that corresponds to the fixed ROM bank
+     * Map the banks currently selected.
      */
-    const utils::AddressRange fixedRomAddrRange = utils::AddressRange(0x0000, 0x3FFF);
-
-    /**
-     * The address range that corresponds to the ROM bank that can be swapped
-     */
-    const utils::AddressRange swappableRomAddrRange = utils::AddressRange(0x4000, 0x7FFF);
+    void updateMappedBanks();
 
     /**
      * The address range that allows to enable the RAM
@@ -55,16 +47,6 @@ class MBC1 : public MemoryBankController
      */
     const utils::AddressRange selectRamBankAddrRange = utils::AddressRange(0x4000, 0x5FFF);
 
-    /**
-     * The size of a ROM bank in bytes
-     */
-    static const size_t ROM_BANK_SIZE_IN_BYTES = 16_KiB;
-
-    /**
-     * The size of a RAM bank in bytes
-     */
-    static const size_t RAM_BANK_SIZE_IN_BYTES = 8_KiB;
-
     /**
      * The id of the ROM bank currently selected.
      * This value cannot be 0.
@@ -80,11 +62,6 @@ class MBC1 : public MemoryBankController
      * The id of the RAM bank currently selected.
      */
     int _selectedRAMBankId = 0;
-
-    /**
-     * Optional RAM bank.
-     */
-    std::vector<byte> _ram = {};
 };
 
 #endif // GBEMULATOR_MBC1_HPP
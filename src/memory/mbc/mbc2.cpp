@@ -1,25 +1,11 @@
 #include "mbc2.hpp"
 #include "spdlog/spdlog.h"
+#include <algorithm>
 
 MBC2::MBC2(Cartridge* cartridge) : MemoryBankController(cartridge)
 {
-    _ram.resize(RAM_SIZE_IN_BYTES);
-}
-
-byte MBC2::readROM(const word& addr)
-{
-    if (fixedRomAddrRange.contains(addr))
-    {
-        return _cartridge->getData()[fixedRomAddrRange.relative(addr)];
-    }
-
-    else if (swappableRomAddrRange.contains(addr))
-    {
-        return _cartridge
-            ->getData()[_selectedROMBankId * ROM_BANK_SIZE_IN_BYTES + swappableRomAddrRange.relative(addr)];
-    }
-
-    throw std::runtime_error("Error, trying to read from bad memory location.");
+    initializeRAM(RAM_SIZE_IN_BYTES);
+    updateMappedBanks();
 }
 
 void MBC2::writeROM(const word& addr, const byte& value)
@@ -57,6 +43,8 @@ void MBC2::writeROM(const word& addr, const byte& value)
             spdlog::debug("MBC: Switching to ROM bank {}", _selectedROMBankId);
         }
     }
+
+    updateMappedBanks();
 }
 
 byte MBC2::readRAM(const word& addr)
@@ -92,20 +80,11 @@ void MBC2::writeRAM(const word& addr, const byte& value)
     // The RAM of MBC2 is only 4 bits value
     int valueBitMask = 0xF;
     _ram[addr & addrBitMask] = value & valueBitMask;
+    markRAMDirty(addr & addrBitMask);
 }
 
-std::vector<byte> MBC2::serializeRAM()
+void MBC2::updateMappedBanks()
 {
-    return _ram;
+    // The RAM is made of 4 bits values and is mirrored, it's only accessed through readRAM() and writeRAM()
+    mapBanks(_selectedROMBankId, nullptr);
 }
-
-bool MBC2::unserializeRAM(const std::vector<byte>& data)
-{
-    if (data.size() != _ram.size())
-    {
-        return false;
-    }
-
-    _ram = data;
-    return true;
-}
\ No newline at end of file
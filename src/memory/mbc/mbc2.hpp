@@ -22,34 +22,21 @@ class MBC2 : public MemoryBankController
      */
     virtual ~MBC2() = default;
 
-    byte readROM(const word& addr) override;
     void writeROM(const word& addr, const byte& value) override;
     byte readRAM(const word& addr) override;
     void writeRAM(const word& addr, const byte& value) override;
-    std::vector<byte> serializeRAM() override;
-    bool unserializeRAM(const std::vector<byte>& data) override;
 
   private:
     /**
-     * The address range that corresponds to the fixed ROM bank
+     * Map the banks currently selected.
      */
-    const utils::AddressRange fixedRomAddrRange = utils::AddressRange(0x0000, 0x3FFF);
-
-    /**
-     * The address range that corresponds to the ROM bank that can be swapped
-     */
-    const utils::AddressRange swappableRomAddrRange = utils::AddressRange(0x4000, 0x7FFF);
+    void updateMappedBanks();
 
     /**
      * The address range that allows to enable the RAM or control which ROM Bank is active
      */
     const utils::AddressRange ramEnableBankControlAddrRange = utils::AddressRange(0x0000, 0x3FFF);
 
-    /**
-     * The size of a ROM bank in bytes
-     */
-    static const size_t ROM_BANK_SIZE_IN_BYTES = 16_KiB;
-
     /**
      * The size of the RAM in bytes
      */
@@ -65,11 +52,6 @@ class MBC2 : public MemoryBankController
      * Whether or not the RAM bank is enabled.
      */
     bool _isRAMEnabled = false;
-
-    /**
-     * 4 bits 512KiB RAM.
-     */
-    std::vector<byte> _ram = {};
 };
 
 #endif // GBEMULATOR_MBC2_HPP
@@ -1,25 +1,14 @@
 #include "mbc3.hpp"
 #include "spdlog/spdlog.h"
+#include <algorithm>
+#include <ctime>
 
 MBC3::MBC3(Cartridge* cartridge) : MemoryBankController(cartridge)
 {
-    _ram.resize(cartridge->getRAMSize());
-}
-
-byte MBC3::readROM(const word& addr)
-{
-    if (fixedRomAddrRange.contains(addr))
-    {
-        return _cartridge->getData()[fixedRomAddrRange.relative(addr)];
-    }
-
-    else if (swappableRomAddrRange.contains(addr))
-    {
-        return _cartridge
-            ->getData()[_selectedROMBankId * ROM_BANK_SIZE_IN_BYTES + swappableRomAddrRange.relative(addr)];
-    }
-
-    throw std::runtime_error("Error, trying to read from bad memory location.");
+    initializeRAM(cartridge->getRAMSize());
+    _hasRTC = cartridge->getType() == Cartridge::CartridgeType::MBC3_TIMER_BATTERY ||
+              cartridge->getType() == Cartridge::CartridgeType::MBC3_TIMER_RAM_BATTERY_2;
+    updateMappedBanks();
 }
 
 void MBC3::writeROM(const word& addr, const byte& value)
@@ -63,10 +52,24 @@ void MBC3::writeROM(const word& addr, const byte& value)
         }
         else
         {
-            // TODO: Implement RTC
             _isRTCModeEnabled = true;
+            int rtcRegister = value - FIRST_RTC_REGISTER_BANK;
+            _selectedRTCRegister = rtcRegister >= 0 && rtcRegister < RealTimeClock::NUMBER_OF_REGISTERS
+                                       ? static_cast<RealTimeClock::Register>(rtcRegister)
+                                       : RealTimeClock::NUMBER_OF_REGISTERS;
+        }
+    }
+
+    else if (latchClockAddrRange.contains(addr))
+    {
+        if (_hasRTC && _latchClockValue == 0x00 && value == 0x01)
+        {
+            _rtc.latch(getElapsedTicks());
         }
+        _latchClockValue = value;
     }
+
+    updateMappedBanks();
 }
 
 byte MBC3::readRAM(const word& addr)
@@ -82,10 +85,13 @@ byte MBC3::readRAM(const word& addr)
     {
         return _ram[_selectedRAMBankId * RAM_BANK_SIZE_IN_BYTES + addr];
     }
+    else if (_hasRTC && _selectedRTCRegister != RealTimeClock::NUMBER_OF_REGISTERS)
+    {
+        return _rtc.readLatchedRegister(_selectedRTCRegister);
+    }
     else
     {
-        // TODO: Implement RTC
-        return 0x00;
+        return 0xFF;
     }
 }
 
@@ -98,26 +104,34 @@ void MBC3::writeRAM(const word& addr, const byte& value)
 
     if (!_isRTCModeEnabled)
     {
-        _ram[_selectedRAMBankId * RAM_BANK_SIZE_IN_BYTES + addr] = value;
+        size_t ramAddr = _selectedRAMBankId * RAM_BANK_SIZE_IN_BYTES + addr;
+        _ram[ramAddr] = value;
+        markRAMDirty(ramAddr);
     }
-    else
+    else if (_hasRTC && _selectedRTCRegister != RealTimeClock::NUMBER_OF_REGISTERS)
     {
-        // TODO: Implement RTC
+        _rtc.writeRegister(_selectedRTCRegister, value, getElapsedTicks());
     }
 }
 
-std::vector<byte> MBC3::serializeRAM()
+size_t MBC3::getClockStateSize() const
 {
-    return _ram;
+    return _hasRTC ? RealTimeClock::STATE_SIZE : 0;
 }
 
-bool MBC3::unserializeRAM(const std::vector<byte>& data)
+void MBC3::saveClockState(byte* data)
 {
-    if (data.size() != _ram.size())
-    {
-        return false;
-    }
+    _rtc.saveState(data, getElapsedTicks(), static_cast<int64_t>(std::time(nullptr)));
+}
+
+void MBC3::loadClockState(const byte* data)
+{
+    _rtc.loadState(data, getElapsedTicks(), static_cast<int64_t>(std::time(nullptr)));
+}
 
-    _ram = data;
-    return true;
-}
\ No newline at end of file
+void MBC3::updateMappedBanks()
+{
+    size_t ramOffset = _selectedRAMBankId * RAM_BANK_SIZE_IN_BYTES;
+    bool isRAMMapped = _isRAMEnabled && !_isRTCModeEnabled && ramOffset + RAM_BANK_SIZE_IN_BYTES <= _ram.size();
+    mapBanks(_selectedROMBankId, isRAMMapped ? &_ram[ramOffset] : nullptr);
+}
@@ -2,6 +2,7 @@
 #define GBEMULATOR_MBC3_HPP
 
 #include "memory/mbc/memory_bank_controller.hpp"
+#include "memory/mbc/real_time_clock.hpp"
 #include <array>
 
 /**
@@ -23,23 +24,18 @@ class MBC3 : public MemoryBankController
      */
     virtual ~MBC3() = default;
 
-    byte readROM(const word& addr) override;
     void writeROM(const word& addr, const byte& value) override;
     byte readRAM(const word& addr) override;
     void writeRAM(const word& addr, const byte& value) override;
-    std::vector<byte> serializeRAM() override;
-    bool unserializeRAM(const std::vector<byte>& data) override;
+    size_t getClockStateSize() const override;
+    void saveClockState(byte* data) override;
+    void loadClockState(const byte* data) override;
 
   private:
     /**
-     * The address range that corresponds to the fixed ROM bank
+     * Map the banks currently selected.
      */
-    const utils::AddressRange fixedRomAddrRange = utils::AddressRange(0x0000, 0x3FFF);
-
-    /**
-     * The address range that corresponds to the ROM bank that can be swapped
-     */
-    const utils::AddressRange swappableRomAddrRange = utils::AddressRange(0x4000, 0x7FFF);
+    void updateMappedBanks();
 
     /**
      * The address range that allows to enable the RAM
@@ -57,19 +53,19 @@ class MBC3 : public MemoryBankController
     const utils::AddressRange selectRamBankAddrRange = utils::AddressRange(0x4000, 0x5FFF);
 
     /**
-     * The size of a ROM bank in bytes
+     * The address range that allows to latch the registers of the clock
      */
-    static const size_t ROM_BANK_SIZE_IN_BYTES = 16_KiB;
+    const utils::AddressRange latchClockAddrRange = utils::AddressRange(0x6000, 0x7FFF);
 
     /**
-     * The size of a RAM bank in bytes
+     * Maximum number of ram banks
      */
-    static const size_t RAM_BANK_SIZE_IN_BYTES = 8_KiB;
+    static const int MAX_NBR_RAM_BANKS = 4;
 
     /**
-     * Maximum number of ram banks
+     * The RAM bank number that maps the first register of the clock, the seconds
      */
-    static const int MAX_NBR_RAM_BANKS = 4;
+    static const int FIRST_RTC_REGISTER_BANK = 0x08;
 
     /**
      * The id of the ROM bank currently selected.
@@ -93,9 +89,21 @@ class MBC3 : public MemoryBankController
     int _selectedRAMBankId = 0;
 
     /**
-     * Optional RAM bank.
+     * The register of the clock mapped in RTC mode, NUMBER_OF_REGISTERS if none is
      */
-    std::vector<byte> _ram = {};
+    RealTimeClock::Register _selectedRTCRegister = RealTimeClock::NUMBER_OF_REGISTERS;
+
+    /**
+     * The last value written to latch the clock, it's latched when 0x00 then 0x01 are written
+     */
+    byte _latchClockValue = 0xFF;
+
+    /**
+     * Whether or not the cartridge has a clock, it needs a timer in its type
+     */
+    bool _hasRTC = false;
+
+    RealTimeClock _rtc;
 };
 
 #endif // GBEMULATOR_MBC3_HPP
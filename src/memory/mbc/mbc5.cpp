@@ -0,0 +1,92 @@
+#include "mbc5.hpp"
+#include "spdlog/spdlog.h"
+#include <algorithm>
+
+MBC5::MBC5(Cartridge* cartridge) : MemoryBankController(cartridge)
+{
+    Cartridge::CartridgeType type = cartridge->getType();
+    _hasRumble = type == Cartridge::CartridgeType::MBC5_RUMBLE || type == Cartridge::CartridgeType::MBC5_RUMBLE_RAM ||
+                 type == Cartridge::CartridgeType::MBC5_RUMBLE_RAM_BATTERY;
+    initializeRAM(cartridge->getRAMSize());
+    updateMappedBanks();
+}
+
+void MBC5::writeROM(const word& addr, const byte& value)
+{
+    if (ramEnableAddrRange.contains(addr))
+    {
+        // RAM is enabled only if value 0xA is written in lower 4 bits
+        _isRAMEnabled = ((value & 0x0F) == 0x0A);
+        if (_isRAMEnabled)
+        {
+            spdlog::debug("RAM was enabled for MBC.");
+        }
+        else
+        {
+            spdlog::debug("RAM was disabled for MBC.");
+        }
+    }
+    else if (selectRomBankLowAddrRange.contains(addr))
+    {
+        _selectedROMBankId = (_selectedROMBankId & 0x100) | value;
+        spdlog::debug("MBC: Switching to ROM bank {}", _selectedROMBankId);
+    }
+    else if (selectRomBankHighAddrRange.contains(addr))
+    {
+        _selectedROMBankId = ((value & 0x01) << 8) | (_selectedROMBankId & 0xFF);
+        spdlog::debug("MBC: Switching to ROM bank {}", _selectedROMBankId);
+    }
+    else if (selectRamBankAddrRange.contains(addr))
+    {
+        if (_hasRumble)
+        {
+            // The bit 3 drives the motor instead of selecting the bank
+            _isRumbleEnabled = utils::isNthBitSet(value, 3);
+            _selectedRAMBankId = value & 0x07;
+        }
+        else
+        {
+            _selectedRAMBankId = value & 0x0F;
+        }
+        spdlog::debug("MBC: Switching to RAM bank {}", _selectedRAMBankId);
+    }
+
+    updateMappedBanks();
+}
+
+byte MBC5::readRAM(const word& addr)
+{
+    size_t ramAddr = _selectedRAMBankId * RAM_BANK_SIZE_IN_BYTES + addr;
+    if (!_isRAMEnabled || ramAddr >= _ram.size())
+    {
+        // If the RAM is disabled it will read open bus values
+        // In reality value is often 0xFF
+        return 0xFF;
+    }
+
+    return _ram[ramAddr];
+}
+
+void MBC5::writeRAM(const word& addr, const byte& value)
+{
+    size_t ramAddr = _selectedRAMBankId * RAM_BANK_SIZE_IN_BYTES + addr;
+    if (!_isRAMEnabled || ramAddr >= _ram.size())
+    {
+        return;
+    }
+
+    _ram[ramAddr] = value;
+    markRAMDirty(ramAddr);
+}
+
+bool MBC5::isRumbleEnabled() const
+{
+    return _isRumbleEnabled;
+}
+
+void MBC5::updateMappedBanks()
+{
+    size_t ramOffset = _selectedRAMBankId * RAM_BANK_SIZE_IN_BYTES;
+    bool isRAMMapped = _isRAMEnabled && ramOffset + RAM_BANK_SIZE_IN_BYTES <= _ram.size();
+    mapBanks(_selectedROMBankId, isRAMMapped ? &_ram[ramOffset] : nullptr);
+}
@@ -0,0 +1,88 @@
+#ifndef GBEMULATOR_MBC5_HPP
+#define GBEMULATOR_MBC5_HPP
+
+#include "memory/mbc/memory_bank_controller.hpp"
+
+/**
+ * A controllable MBC that supports up to 8 MiB ROM with up to 128 KiB of banked RAM.
+ * Unlike the previous MBCs, the ROM bank 0 can also be mapped in the switchable ROM area.
+ * Some cartridges also have a rumble motor, controlled by a bit of the RAM bank selection.
+ */
+class MBC5 : public MemoryBankController
+{
+  public:
+    /**
+     * Create a new MBC that supports up to 8 MiB ROM with up to 128 KiB of banked RAM
+     *
+     * @param cartridge The cartridge to use to retrieve the data.
+     */
+    MBC5(Cartridge* cartridge);
+
+    /**
+     * Default destructor
+     */
+    virtual ~MBC5() = default;
+
+    void writeROM(const word& addr, const byte& value) override;
+    byte readRAM(const word& addr) override;
+    void writeRAM(const word& addr, const byte& value) override;
+
+    /**
+     * @return true if the rumble motor is turned on, false otherwise
+     */
+    bool isRumbleEnabled() const;
+
+  private:
+    /**
+     * Map the banks currently selected.
+     */
+    void updateMappedBanks();
+
+    /**
+     * The address range that allows to enable the RAM
+     */
+    const utils::AddressRange ramEnableAddrRange = utils::AddressRange(0x0000, 0x1FFF);
+
+    /**
+     * The address range that allows to select the 8 lowest bits of the ROM bank
+     */
+    const utils::AddressRange selectRomBankLowAddrRange = utils::AddressRange(0x2000, 0x2FFF);
+
+    /**
+     * The address range that allows to select the 9th bit of the ROM bank
+     */
+    const utils::AddressRange selectRomBankHighAddrRange = utils::AddressRange(0x3000, 0x3FFF);
+
+    /**
+     * The address range that allows to select which RAM bank is active
+     */
+    const utils::AddressRange selectRamBankAddrRange = utils::AddressRange(0x4000, 0x5FFF);
+
+    /**
+     * The id of the ROM bank currently selected, on 9 bits.
+     * This value can be 0.
+     */
+    int _selectedROMBankId = 1;
+
+    /**
+     * Whether or not the RAM bank is enabled.
+     */
+    bool _isRAMEnabled = false;
+
+    /**
+     * The id of the RAM bank currently selected.
+     */
+    int _selectedRAMBankId = 0;
+
+    /**
+     * Whether or not the cartridge has a rumble motor.
+     */
+    bool _hasRumble = false;
+
+    /**
+     * Whether or not the rumble motor is turned on.
+     */
+    bool _isRumbleEnabled = false;
+};
+
+#endif // GBEMULATOR_MBC5_HPP
@@ -3,7 +3,9 @@
 
 MBCRomOnly::MBCRomOnly(Cartridge* cartridge) : MemoryBankController(cartridge)
 {
-    _ram.resize(cartridge->getRAMSize());
+    initializeRAM(cartridge->getRAMSize());
+    // The second half of the ROM and the RAM, if any, are always mapped
+    mapBanks(1, _ram.size() >= RAM_BANK_SIZE_IN_BYTES ? _ram.data() : nullptr);
 }
 
 byte MBCRomOnly::readROM(const word& addr)
@@ -42,6 +44,7 @@ void MBCRomOnly::writeRAM(const word& addr, const byte& value)
     if (addr < _ram.size())
     {
         _ram[addr] = value;
+        markRAMDirty(addr);
     }
     else
     {
@@ -50,12 +53,3 @@ void MBCRomOnly::writeRAM(const word& addr, const byte& value)
     }
 }
 
-std::vector<byte> MBCRomOnly::serializeRAM()
-{
-    return std::vector<byte>();
-}
-
-bool MBCRomOnly::unserializeRAM(const std::vector<byte>& /*data*/)
-{
-    return true;
-}
\ No newline at end of file
@@ -26,14 +26,6 @@ class MBCRomOnly : public MemoryBankController
     void writeROM(const word& addr, const byte& value) override;
     byte readRAM(const word& addr) override;
     void writeRAM(const word& addr, const byte& value) override;
-    std::vector<byte> serializeRAM() override;
-    bool unserializeRAM(const std::vector<byte>& data) override;
-
-  private:
-    /**
-     * Optional RAM can be up to 8KiB
-     */
-    std::vector<byte> _ram = {};
 };
 
 #endif // GBEMULATOR_MBC_ROM_ONLY_HPP
@@ -2,9 +2,112 @@
 #include "memory/mbc/mbc1.hpp"
 #include "memory/mbc/mbc2.hpp"
 #include "memory/mbc/mbc3.hpp"
+#include "memory/mbc/mbc5.hpp"
 #include "memory/mbc/mbc_rom_only.hpp"
+#include <algorithm>
+#include <stdexcept>
 
-MemoryBankController::MemoryBankController(Cartridge* cartridge) : _cartridge(cartridge){};
+MemoryBankController::MemoryBankController(Cartridge* cartridge) : _cartridge(cartridge)
+{
+    mapBanks(1, nullptr);
+}
+
+byte MemoryBankController::readROM(const word& addr)
+{
+    const byte* bank = addr < ROM_BANK_SIZE_IN_BYTES ? _fixedROMBank : _switchableROMBank;
+    if (bank == nullptr || addr >= 2 * ROM_BANK_SIZE_IN_BYTES)
+    {
+        throw std::runtime_error("Error, trying to read from bad memory location.");
+    }
+
+    return bank[addr % ROM_BANK_SIZE_IN_BYTES];
+}
+
+void MemoryBankController::setBankSwitchedCallback(BankSwitchedCallback callback)
+{
+    _bankSwitchedCallback = std::move(callback);
+}
+
+void MemoryBankController::mapBanks(int romBankId, byte* ramBank)
+{
+    // The data can be smaller than the size announced in the header
+    size_t numberOfROMBanks = std::min(_cartridge->getData().size(), _cartridge->getROMSize()) / ROM_BANK_SIZE_IN_BYTES;
+    const byte* fixedROMBank = nullptr;
+    const byte* switchableROMBank = nullptr;
+    if (numberOfROMBanks > 0)
+    {
+        // Only the bits needed to address the banks of the ROM are used
+        romBankId = static_cast<int>(static_cast<size_t>(romBankId) % numberOfROMBanks);
+        fixedROMBank = _cartridge->getData().data();
+        switchableROMBank = numberOfROMBanks > 1 ? fixedROMBank + romBankId * ROM_BANK_SIZE_IN_BYTES : nullptr;
+    }
+
+    bool hasChanged = romBankId != _mappedROMBankId || fixedROMBank != _fixedROMBank ||
+                      switchableROMBank != _switchableROMBank || ramBank != _ramBank;
+    _mappedROMBankId = romBankId;
+    _fixedROMBank = fixedROMBank;
+    _switchableROMBank = switchableROMBank;
+    _ramBank = ramBank;
+
+    if (hasChanged && _bankSwitchedCallback != nullptr)
+    {
+        _bankSwitchedCallback();
+    }
+}
+
+void MemoryBankController::initializeRAM(size_t size)
+{
+    _ram.assign(size, 0);
+    _dirtyRAMPages.assign((size + RAM_PAGE_SIZE_IN_BYTES - 1) / RAM_PAGE_SIZE_IN_BYTES, false);
+    _hasDirtyRAMPages = false;
+}
+
+std::vector<byte> MemoryBankController::serializeRAM()
+{
+    std::vector<byte> data(_ram.size() + getClockStateSize());
+    std::copy(_ram.begin(), _ram.end(), data.begin());
+    if (getClockStateSize() > 0)
+    {
+        saveClockState(data.data() + _ram.size());
+    }
+    return data;
+}
+
+bool MemoryBankController::unserializeRAM(const std::vector<byte>& data)
+{
+    bool hasClockState = getClockStateSize() > 0 && data.size() == _ram.size() + getClockStateSize();
+    if (data.size() != _ram.size() && !hasClockState)
+    {
+        return false;
+    }
+
+    // The memory of the RAM is kept, it can be mapped
+    std::copy(data.begin(), data.begin() + _ram.size(), _ram.begin());
+    if (hasClockState)
+    {
+        loadClockState(data.data() + _ram.size());
+    }
+    return true;
+}
+
+void MemoryBankController::consumeDirtyRAMPages(const RAMPageCallback& callback)
+{
+    if (!_hasDirtyRAMPages)
+    {
+        return;
+    }
+
+    for (size_t page = 0; page < _dirtyRAMPages.size(); ++page)
+    {
+        if (_dirtyRAMPages[page])
+        {
+            size_t offset = page * RAM_PAGE_SIZE_IN_BYTES;
+            callback(offset, _ram.data() + offset, std::min(RAM_PAGE_SIZE_IN_BYTES, _ram.size() - offset));
+            _dirtyRAMPages[page] = false;
+        }
+    }
+    _hasDirtyRAMPages = false;
+}
 
 std::unique_ptr<MemoryBankController>
 MemoryBankController::createMemoryBankControllerFromCartridge(Cartridge* cartridge)
@@ -27,6 +130,13 @@ MemoryBankController::createMemoryBankControllerFromCartridge(Cartridge* cartrid
     case Cartridge::CartridgeType::MBC3_TIMER_BATTERY:
     case Cartridge::CartridgeType::MBC3_TIMER_RAM_BATTERY_2:
         return std::make_unique<MBC3>(cartridge);
+    case Cartridge::CartridgeType::MBC5:
+    case Cartridge::CartridgeType::MBC5_RAM:
+    case Cartridge::CartridgeType::MBC5_RAM_BATTERY:
+    case Cartridge::CartridgeType::MBC5_RUMBLE:
+    case Cartridge::CartridgeType::MBC5_RUMBLE_RAM:
+    case Cartridge::CartridgeType::MBC5_RUMBLE_RAM_BATTERY:
+        return std::make_unique<MBC5>(cartridge);
     default:
         return nullptr;
     }
@@ -2,11 +2,15 @@
 #define GBEMULATOR_MEMORY_BANK_CONTROLLER_HPP
 
 #include "memory/cartridge.hpp"
+#include <functional>
 #include <memory>
 
 /**
  * The memory bank controller is in charge of switching memory units
  * for the cartridge.
+ *
+ * The controller publishes the memory of the ROM and RAM banks currently mapped so that they
+ * can be accessed directly, and notifies a callback when a bank switch changes them.
  */
 class MemoryBankController
 {
@@ -16,13 +20,19 @@ class MemoryBankController
      */
     virtual ~MemoryBankController() = default;
 
+    /**
+     * Callback called when a bank switch changed the memory mapped by the controller.
+     */
+    typedef std::function<void()> BankSwitchedCallback;
+
     /**
      * Read a byte from an address in the ROM.
+     * By default it's read from the ROM banks currently mapped.
      *
      * @param addr The address to read from
      * @return  The byte stored at this address
      */
-    virtual byte readROM(const word& addr) = 0;
+    virtual byte readROM(const word& addr);
 
     /**
      * Write a byte to the given address in the ROM.
@@ -49,18 +59,135 @@ class MemoryBankController
     virtual void writeRAM(const word& addr, const byte& value) = 0;
 
     /**
-     * Serialize the current state of the RAM.
+     * Serialize the current state of the RAM, followed by the state of the clock if the cartridge has one.
      *
      * @return  a binary representation of the RAM that can be restored later
      */
-    virtual std::vector<byte> serializeRAM() = 0;
+    virtual std::vector<byte> serializeRAM();
 
     /**
      * Load a state of the RAM that was previously serialized using serializeRAM().
+     * The state of the clock is optional, the pages of the RAM are not marked as dirty.
      *
      * @param data  the serialized data to load.
      */
-    virtual bool unserializeRAM(const std::vector<byte>& data) = 0;
+    virtual bool unserializeRAM(const std::vector<byte>& data);
+
+    /**
+     * @return the content of the RAM of the cartridge
+     */
+    const std::vector<byte>& getRAM() const
+    {
+        return _ram;
+    }
+
+    /**
+     * @return true if the RAM was written since the last call to consumeDirtyRAMPages()
+     */
+    bool hasDirtyRAMPages() const
+    {
+        return _hasDirtyRAMPages;
+    }
+
+    /**
+     * Callback called with a page of the RAM, its offset in the RAM and its size in bytes.
+     */
+    typedef std::function<void(size_t offset, const byte* data, size_t size)> RAMPageCallback;
+
+    /**
+     * Call a function for each page of the RAM written since the previous call, the pages are then clean.
+     *
+     * @param callback The function to call with the content of the dirty pages
+     */
+    void consumeDirtyRAMPages(const RAMPageCallback& callback);
+
+    /**
+     * @return the size in bytes of the state of the clock of the cartridge, 0 if it has no clock
+     */
+    virtual size_t getClockStateSize() const
+    {
+        return 0;
+    }
+
+    /**
+     * Save the state of the clock of the cartridge with the current time of the host.
+     *
+     * @param data The memory where the state is saved, getClockStateSize() bytes
+     */
+    virtual void saveClockState(byte* /*data*/)
+    {
+    }
+
+    /**
+     * Load a state of the clock saved with saveClockState(), the time of the host elapsed since is added.
+     *
+     * @param data The state, getClockStateSize() bytes
+     */
+    virtual void loadClockState(const byte* /*data*/)
+    {
+    }
+
+    /**
+     * Set the counter of the ticks elapsed at normal speed since the start of the emulator,
+     * used to compute the time elapsed for the clock of the cartridge.
+     *
+     * @param ticks A pointer to the counter, nullptr if the time doesn't elapse
+     */
+    void setTicksCounter(const int64_t* ticks)
+    {
+        _ticksCounter = ticks;
+    }
+
+    /**
+     * The size of the pages of RAM tracked for the writes
+     */
+    static constexpr size_t RAM_PAGE_SIZE_IN_BYTES = 256;
+
+    /**
+     * Get the id of the ROM bank currently mapped in the switchable ROM area.
+     * The content of the bank is the ROM data at offset id * ROM_BANK_SIZE_IN_BYTES.
+     *
+     * @return the id of the ROM bank
+     */
+    int getSelectedROMBankId() const
+    {
+        return _mappedROMBankId;
+    }
+
+    /**
+     * @return the memory of the ROM bank mapped at 0x0000-0x3FFF, nullptr if the ROM is too small
+     */
+    const byte* getFixedROMBank() const
+    {
+        return _fixedROMBank;
+    }
+
+    /**
+     * @return the memory of the ROM bank mapped at 0x4000-0x7FFF, nullptr if the ROM is too small
+     */
+    const byte* getSwitchableROMBank() const
+    {
+        return _switchableROMBank;
+    }
+
+    /**
+     * Get the memory of the RAM bank mapped at 0xA000-0xBFFF.
+     * It can only be read directly, writeRAM() needs to be used to write it so that the pages written are tracked.
+     *
+     * @return the memory of the bank, or nullptr if the RAM can't be read directly
+     * (disabled, absent, registers mapped instead, ...), in which case readRAM() needs to be used
+     */
+    byte* getRAMBank() const
+    {
+        return _ramBank;
+    }
+
+    /**
+     * Set the function to call when a bank switch changes the banks mapped.
+     *
+     * @param callback The function to call, or nullptr to stop notifying
+     */
+    void setBankSwitchedCallback(BankSwitchedCallback callback);
 
     /**
      * Factory function to create a memory controller based on cartridge information.
@@ -78,10 +205,81 @@ class MemoryBankController
      */
     MemoryBankController(Cartridge* cartridge);
 
+    /**
+     * Map the banks selected, the callback is notified if they changed.
+     * The ROM bank id wraps around the number of banks of the cartridge.
+     *
+     * @param romBankId The id of the ROM bank to map at 0x4000-0x7FFF
+     * @param ramBank   The memory of the RAM bank to map at 0xA000-0xBFFF,
+     *                  nullptr if it can't be accessed directly
+     */
+    void mapBanks(int romBankId, byte* ramBank);
+
+    /**
+     * Allocate the RAM of the cartridge, all its pages are clean.
+     *
+     * @param size The size of the RAM in bytes
+     */
+    void initializeRAM(size_t size);
+
+    /**
+     * @return the number of ticks elapsed at normal speed since the start of the emulator, see setTicksCounter()
+     */
+    int64_t getElapsedTicks() const
+    {
+        return _ticksCounter != nullptr ? *_ticksCounter : 0;
+    }
+
+    /**
+     * Mark the page of the RAM containing a byte as written.
+     *
+     * @param offset The offset of the byte in the RAM
+     */
+    void markRAMDirty(size_t offset)
+    {
+        _dirtyRAMPages[offset / RAM_PAGE_SIZE_IN_BYTES] = true;
+        _hasDirtyRAMPages = true;
+    }
+
+    /**
+     * The size of a ROM bank in bytes
+     */
+    static const size_t ROM_BANK_SIZE_IN_BYTES = 16_KiB;
+
+    /**
+     * The size of a RAM bank in bytes
+     */
+    static const size_t RAM_BANK_SIZE_IN_BYTES = 8_KiB;
+
     /**
      * The cartridge object to be used to access the memory units
      */
     Cartridge* _cartridge = nullptr;
+
+    /**
+     * The RAM of the cartridge, it needs to be allocated with initializeRAM()
+     */
+    std::vector<byte> _ram = {};
+
+  private:
+    /**
+     * The id of the ROM bank mapped at 0x4000-0x7FFF
+     */
+    int _mappedROMBankId = 1;
+
+    const byte* _fixedROMBank = nullptr;
+    const byte* _switchableROMBank = nullptr;
+    byte* _ramBank = nullptr;
+
+    BankSwitchedCallback _bankSwitchedCallback = nullptr;
+
+    const int64_t* _ticksCounter = nullptr;
+
+    /**
+     * The pages of the RAM written since the last call to consumeDirtyRAMPages()
+     */
+    std::vector<bool> _dirtyRAMPages = {};
+    bool _hasDirtyRAMPages = false;
 };
 
 #endif // GBEMULATOR_MEMORY_BANK_CONTROLLER_HPP
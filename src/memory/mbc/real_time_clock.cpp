@@ -0,0 +1,154 @@
+#include "real_time_clock.hpp"
+#include "cpu/cpu.hpp"
+
+// The PPU and the APU are stepped at the frequency of the CPU clock in normal speed
+const int64_t RealTimeClock::TICKS_PER_SECOND = CPU::CLOCK_FREQUENCY_HZ;
+
+void RealTimeClock::writeRegister(Register reg, byte value, int64_t ticks)
+{
+    // The time elapsed is counted with the previous state of the halt flag
+    update(ticks);
+    _registers[reg] = value & REGISTER_MASKS[reg];
+
+    // Writing the seconds resets the divider of the clock
+    if (reg == SECONDS)
+    {
+        _subSecondTicks = 0;
+    }
+}
+
+void RealTimeClock::latch(int64_t ticks)
+{
+    update(ticks);
+    _latchedRegisters = _registers;
+}
+
+void RealTimeClock::saveState(byte* data, int64_t ticks, int64_t hostTime)
+{
+    update(ticks);
+
+    auto writeValue = [&data](uint64_t value, int size) {
+        for (int i = 0; i < size; ++i)
+        {
+            *data++ = (value >> (8 * i)) & 0xFF;
+        }
+    };
+    for (byte value : _registers)
+    {
+        writeValue(value, 4);
+    }
+    for (byte value : _latchedRegisters)
+    {
+        writeValue(value, 4);
+    }
+    writeValue(static_cast<uint64_t>(hostTime), 8);
+}
+
+void RealTimeClock::loadState(const byte* data, int64_t ticks, int64_t hostTime)
+{
+    auto readValue = [&data](int size) {
+        uint64_t value = 0;
+        for (int i = 0; i < size; ++i)
+        {
+            value |= static_cast<uint64_t>(*data++) << (8 * i);
+        }
+        return value;
+    };
+    for (int reg = 0; reg < NUMBER_OF_REGISTERS; ++reg)
+    {
+        _registers[reg] = readValue(4) & REGISTER_MASKS[reg];
+    }
+    for (int reg = 0; reg < NUMBER_OF_REGISTERS; ++reg)
+    {
+        _latchedRegisters[reg] = readValue(4) & REGISTER_MASKS[reg];
+    }
+    int64_t savedHostTime = static_cast<int64_t>(readValue(8));
+
+    _lastUpdateTicks = ticks;
+    _subSecondTicks = 0;
+
+    // The clock kept running while the emulator was closed, a file that was just created has no time
+    if (savedHostTime > 0 && hostTime > savedHostTime && !isHalted())
+    {
+        advance(static_cast<uint64_t>(hostTime - savedHostTime));
+    }
+}
+
+void RealTimeClock::update(int64_t ticks)
+{
+    int64_t elapsedTicks = ticks - _lastUpdateTicks;
+    _lastUpdateTicks = ticks;
+    // The ticks of the emulator restart from 0 when it's reset
+    if (elapsedTicks <= 0 || isHalted())
+    {
+        return;
+    }
+
+    _subSecondTicks += elapsedTicks;
+    advance(static_cast<uint64_t>(_subSecondTicks / TICKS_PER_SECOND));
+    _subSecondTicks %= TICKS_PER_SECOND;
+}
+
+bool RealTimeClock::isTimeValid() const
+{
+    return _registers[SECONDS] < 60 && _registers[MINUTES] < 60 && _registers[HOURS] < 24;
+}
+
+void RealTimeClock::advance(uint64_t seconds)
+{
+    // Counters written out of their range need to wrap around first
+    while (seconds > 0 && !isTimeValid())
+    {
+        advanceOneSecond();
+        seconds--;
+    }
+
+    if (seconds == 0)
+    {
+        return;
+    }
+
+    uint64_t days = _registers[DAYS_LOW] | ((_registers[DAYS_HIGH] & 0x01) << 8);
+    uint64_t time = seconds + _registers[SECONDS] + 60 * (_registers[MINUTES] + 60 * (_registers[HOURS] + 24 * days));
+    _registers[SECONDS] = time % 60;
+    time /= 60;
+    _registers[MINUTES] = time % 60;
+    time /= 60;
+    _registers[HOURS] = time % 24;
+    days = time / 24;
+
+    byte daysHigh = _registers[DAYS_HIGH] & ~0x01;
+    if (days >= NUMBER_OF_DAYS)
+    {
+        utils::setNthBit(daysHigh, DAY_CARRY_BIT, true);
+        days %= NUMBER_OF_DAYS;
+    }
+    _registers[DAYS_LOW] = days & 0xFF;
+    _registers[DAYS_HIGH] = daysHigh | ((days >> 8) & 0x01);
+}
+
+void RealTimeClock::advanceOneSecond()
+{
+    // Incrementing a counter returns true if the next one needs to be incremented
+    auto increment = [this](Register reg, byte limit) {
+        _registers[reg] = (_registers[reg] + 1) & REGISTER_MASKS[reg];
+        if (_registers[reg] == limit)
+        {
+            _registers[reg] = 0;
+            return true;
+        }
+        return false;
+    };
+
+    if (increment(SECONDS, 60) && increment(MINUTES, 60) && increment(HOURS, 24))
+    {
+        int days = (_registers[DAYS_LOW] | ((_registers[DAYS_HIGH] & 0x01) << 8)) + 1;
+        if (days == NUMBER_OF_DAYS)
+        {
+            days = 0;
+            utils::setNthBit(_registers[DAYS_HIGH], DAY_CARRY_BIT, true);
+        }
+        _registers[DAYS_LOW] = days & 0xFF;
+        _registers[DAYS_HIGH] = (_registers[DAYS_HIGH] & ~0x01) | ((days >> 8) & 0x01);
+    }
+}
@@ -0,0 +1,146 @@
+#ifndef GBEMULATOR_REAL_TIME_CLOCK_HPP
+#define GBEMULATOR_REAL_TIME_CLOCK_HPP
+
+#include "common/types.hpp"
+#include "common/utils.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * The real time clock of the MBC3, counting seconds, minutes, hours and days.
+ *
+ * The clock isn't stepped with the other components, the time elapsed is computed
+ * from the ticks of the emulator when its registers are latched or written.
+ */
+class RealTimeClock
+{
+  public:
+    /**
+     * The registers of the clock, in the order of their RAM bank number (0x08-0x0C).
+     */
+    enum Register
+    {
+        SECONDS = 0,
+        MINUTES,
+        HOURS,
+        DAYS_LOW,
+        /**
+         * Bit 0: bit 8 of the day counter, bit 6: halt, bit 7: day counter carry
+         */
+        DAYS_HIGH,
+        NUMBER_OF_REGISTERS
+    };
+
+    /**
+     * Read the value of a register when it was latched.
+     *
+     * @param reg The register to read
+     * @return the value latched
+     */
+    byte readLatchedRegister(Register reg) const
+    {
+        return _latchedRegisters[reg];
+    }
+
+    /**
+     * Write a register of the clock, the time elapsed until now is counted before.
+     *
+     * @param reg   The register to write
+     * @param value The value to write
+     * @param ticks The number of ticks elapsed since the start of the emulator
+     */
+    void writeRegister(Register reg, byte value, int64_t ticks);
+
+    /**
+     * Copy the current time in the latched registers.
+     *
+     * @param ticks The number of ticks elapsed since the start of the emulator
+     */
+    void latch(int64_t ticks);
+
+    /**
+     * Save the state of the clock, in the format used by the other emulators:
+     * the registers then the latched registers, each on 4 bytes, then the time of the host on 8 bytes,
+     * all in little endian.
+     *
+     * @param data      The memory where the state is saved, STATE_SIZE bytes
+     * @param ticks     The number of ticks elapsed since the start of the emulator
+     * @param hostTime  The time of the host in seconds since the Unix epoch
+     */
+    void saveState(byte* data, int64_t ticks, int64_t hostTime);
+
+    /**
+     * Load a state saved with saveState(), the time of the host elapsed since it was saved is added.
+     *
+     * @param data      The state, STATE_SIZE bytes
+     * @param ticks     The number of ticks elapsed since the start of the emulator
+     * @param hostTime  The time of the host in seconds since the Unix epoch
+     */
+    void loadState(const byte* data, int64_t ticks, int64_t hostTime);
+
+    /**
+     * The size in bytes of the state saved by saveState()
+     */
+    static const size_t STATE_SIZE = 48;
+
+  private:
+    /**
+     * Count the time elapsed since the last update.
+     *
+     * @param ticks The number of ticks elapsed since the start of the emulator
+     */
+    void update(int64_t ticks);
+
+    /**
+     * Advance the counters of the clock.
+     *
+     * @param seconds The number of seconds elapsed
+     */
+    void advance(uint64_t seconds);
+
+    /**
+     * Advance the counters of one second, each of them wraps around its number of bits
+     * without incrementing the next one when it was written with a value out of its range.
+     */
+    void advanceOneSecond();
+
+    /**
+     * @return true if the registers are in the ranges of a time of the day
+     */
+    bool isTimeValid() const;
+
+    bool isHalted() const
+    {
+        return utils::isNthBitSet(_registers[DAYS_HIGH], HALT_BIT);
+    }
+
+    /**
+     * The number of ticks at normal speed in a second
+     */
+    static const int64_t TICKS_PER_SECOND;
+
+    static const int HALT_BIT = 6;
+    static const int DAY_CARRY_BIT = 7;
+    static const int NUMBER_OF_DAYS = 512;
+
+    /**
+     * The bits of the registers that can be written
+     */
+    static constexpr std::array<byte, NUMBER_OF_REGISTERS> REGISTER_MASKS = {0x3F, 0x3F, 0x1F, 0xFF, 0xC1};
+
+    std::array<byte, NUMBER_OF_REGISTERS> _registers = {};
+    std::array<byte, NUMBER_OF_REGISTERS> _latchedRegisters = {};
+
+    /**
+     * The ticks of the emulator when the time elapsed was last counted
+     */
+    int64_t _lastUpdateTicks = 0;
+
+    /**
+     * The ticks elapsed that don't make a full second yet
+     */
+    int64_t _subSecondTicks = 0;
+};
+
+#endif // GBEMULATOR_REAL_TIME_CLOCK_HPP
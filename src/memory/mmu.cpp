@@ -1,28 +1,425 @@
 #include "mmu.hpp"
+#include <algorithm>
 #include <bitset>
 #include <cassert>
 #include <cstring>
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <stdexcept>
 #include <vector>
 
 #include "apu/apu.hpp"
 #include "cartridge.hpp"
+#include "cpu/basic_block_cache.hpp"
 #include "cpu/interrupt_manager.hpp"
 #include "graphics/lcd_status_register.hpp"
 #include "memory/bootrom.hpp"
 #include "spdlog/spdlog.h"
 
-const std::set<word> MMU::unmappedIOAddrs = {0xFF03, 0xFF08, 0xFF09, 0xFF0A, 0xFF0B, 0xFF0C, 0xFF0D, 0xFF0E};
+template <byte (APU::*getter)()>
+byte MMU::readAPURegister(MMU& mmu, word addr)
+{
+    return mmu._apu != nullptr ? (mmu._apu->*getter)() : mmu.memory[addr];
+}
 
-const std::map<word, byte> MMU::mappedIOMask = {{HardwareIOAddr::P1, static_cast<byte>(0b11000000)},
-                                                {HardwareIOAddr::SC, static_cast<byte>(0b01111110)}};
+template <void (APU::*setter)(byte)>
+void MMU::writeAPURegister(MMU& mmu, word addr, byte value)
+{
+    if (mmu._apu != nullptr)
+    {
+        (mmu._apu->*setter)(value);
+        return;
+    }
+    mmu.memory[addr] = value;
+}
+
+template <HardwareModel model>
+constexpr MMU::IORegisterTable MMU::createIORegisters()
+{
+    IORegisterTable registers = {};
+    auto at = [&registers](word addr) -> IORegister& { return registers[addr - IO_REGISTERS_START_ADDR]; };
+
+    // For unmapped IO all bits should be set to 1
+    at(0xFF03).readMask = 0xFF;
+    for (word addr = 0xFF08; addr <= 0xFF0E; ++addr)
+    {
+        at(addr).readMask = 0xFF;
+    }
+    for (word addr = 0xFF4C; addr <= 0xFF7F; ++addr)
+    {
+        at(addr).readMask = 0xFF;
+    }
+
+    // The components owning the registers are brought up to date before they are written,
+    // and before they are read if they change the value of the register on their own.
+    // Their interrupts are raised at their events, when they are always up to date, so IF doesn't need them.
+    // Resetting the divider register can clock the frame sequencer of the APU.
+    at(TIMER_DIV_ADDR).writeSynchronizedComponents = SYNCHRONIZE_TIMER | SYNCHRONIZE_APU;
+    at(TIMER_DIV_ADDR).readSynchronizedComponents = SYNCHRONIZE_TIMER;
+    for (word addr = TIMER_COUNTER_ADDR; addr <= TIMER_CONTROL_ADDR; ++addr)
+    {
+        at(addr).writeSynchronizedComponents = SYNCHRONIZE_TIMER;
+    }
+    at(TIMER_COUNTER_ADDR).readSynchronizedComponents = SYNCHRONIZE_TIMER;
+    for (word addr = APU_REGISTERS_START_ADDR; addr <= APU_REGISTERS_END_ADDR; ++addr)
+    {
+        at(addr).writeSynchronizedComponents = SYNCHRONIZE_APU;
+        at(addr).readSynchronizedComponents = SYNCHRONIZE_APU;
+    }
+    for (word addr = ADDR_LCD_PPU_CONTROL; addr <= WINDOW_ADDR_SCROLL_X; ++addr)
+    {
+        at(addr).writeSynchronizedComponents = SYNCHRONIZE_PPU;
+    }
+    at(ADDR_LCD_STATUS).readSynchronizedComponents = SYNCHRONIZE_PPU;
+    at(ADDR_SCANLINE).readSynchronizedComponents = SYNCHRONIZE_PPU;
+
+    at(JOYPAD_MAP_ADDR).readMask = 0b11000000;
+    at(JOYPAD_MAP_ADDR).read = [](MMU& mmu, word addr) -> byte {
+        return mmu.inputController != nullptr ? mmu.getJoypadMemoryRepresentation() : mmu.memory[addr];
+    };
+
+    at(SERIAL_TRANSFER_CONTROL_ADDR).readMask = 0b01111110;
+
+    at(TIMER_DIV_ADDR).read = [](MMU& mmu, word addr) -> byte {
+        return mmu._timer != nullptr ? mmu._timer->getDividerRegisterValue() : mmu.memory[addr];
+    };
+    at(TIMER_DIV_ADDR).write = [](MMU& mmu, word addr, byte value) {
+        if (mmu._timer != nullptr)
+        {
+            mmu._timer->resetDividerRegisterValue();
+            return;
+        }
+        mmu.memory[addr] = value;
+    };
+    at(TIMER_COUNTER_ADDR).read = [](MMU& mmu, word addr) -> byte {
+        return mmu._timer != nullptr ? mmu._timer->getTimerCounterValue() : mmu.memory[addr];
+    };
+    at(TIMER_COUNTER_ADDR).write = [](MMU& mmu, word addr, byte value) {
+        if (mmu._timer != nullptr)
+        {
+            mmu._timer->setTimerCounterValue(value);
+            return;
+        }
+        mmu.memory[addr] = value;
+    };
+    at(TIMER_MODULO_ADDR).read = [](MMU& mmu, word addr) -> byte {
+        return mmu._timer != nullptr ? mmu._timer->getTimerModuloValue() : mmu.memory[addr];
+    };
+    at(TIMER_MODULO_ADDR).write = [](MMU& mmu, word addr, byte value) {
+        if (mmu._timer != nullptr)
+        {
+            mmu._timer->setTimerModuloValue(value);
+            return;
+        }
+        mmu.memory[addr] = value;
+    };
+    at(TIMER_CONTROL_ADDR).read = [](MMU& mmu, word addr) -> byte {
+        if (mmu._timer != nullptr)
+        {
+            return 0b11111000 | mmu._timer->isTimerCounterEnabled() << 2 | mmu._timer->getClockDivider();
+        }
+        return mmu.memory[addr];
+    };
+    at(TIMER_CONTROL_ADDR).write = [](MMU& mmu, word addr, byte value) {
+        if (mmu._timer != nullptr)
+        {
+            mmu._timer->setTimerControlValue(value);
+            return;
+        }
+        mmu.memory[addr] = value;
+    };
+
+    at(INTERRUPT_FLAG_ADDR).read = [](MMU& mmu, word addr) -> byte {
+        if (mmu._interruptManager != nullptr)
+        {
+            return mmu._interruptManager->getInterruptFlag() | 0b11100000;
+        }
+        return mmu.memory[addr];
+    };
+    at(INTERRUPT_FLAG_ADDR).write = [](MMU& mmu, word addr, byte value) {
+        if (mmu._interruptManager != nullptr)
+        {
+            mmu._interruptManager->setInterruptFlag(value);
+            return;
+        }
+        mmu.memory[addr] = value;
+    };
+
+    // The unmapped and write-only APU registers read as 0xFF
+    for (word addr = APU_REGISTERS_START_ADDR; addr <= APU_REGISTERS_END_ADDR; ++addr)
+    {
+        at(addr).read = [](MMU& mmu, word addr) -> byte { return mmu._apu != nullptr ? 0xFF : mmu.memory[addr]; };
+        at(addr).write = [](MMU& mmu, word addr, byte value) {
+            if (mmu._apu == nullptr)
+            {
+                mmu.memory[addr] = value;
+            }
+        };
+    }
+    at(APU::CH1_SWEEP_REG_ADDR).read = &readAPURegister<&APU::getChannel1Sweep>;
+    at(APU::CH1_SWEEP_REG_ADDR).write = &writeAPURegister<&APU::setChannel1Sweep>;
+    at(APU::CH1_LENGTH_TIMER_AND_DUTY).read = &readAPURegister<&APU::getChannel1LengthTimerAndDuty>;
+    at(APU::CH1_LENGTH_TIMER_AND_DUTY).write = &writeAPURegister<&APU::setChannel1LengthTimerAndDuty>;
+    at(APU::CH1_VOLUME_CTRL_ADDR).read = &readAPURegister<&APU::getChannel1VolumeControl>;
+    at(APU::CH1_VOLUME_CTRL_ADDR).write = &writeAPURegister<&APU::setChannel1VolumeControl>;
+    at(APU::CH1_FREQUENCY_LOW_REG_ADDR).write = &writeAPURegister<&APU::setChannel1FrequencyLow>;
+    at(APU::CH1_FREQUENCY_AND_CONTROL_REG_ADDR).read = &readAPURegister<&APU::getChannel1FrequencyAndControl>;
+    at(APU::CH1_FREQUENCY_AND_CONTROL_REG_ADDR).write = &writeAPURegister<&APU::setChannel1FrequencyAndControl>;
+
+    at(APU::CH2_LENGTH_TIMER_AND_DUTY).read = &readAPURegister<&APU::getChannel2LengthTimerAndDuty>;
+    at(APU::CH2_LENGTH_TIMER_AND_DUTY).write = &writeAPURegister<&APU::setChannel2LengthTimerAndDuty>;
+    at(APU::CH2_VOLUME_CTRL_ADDR).read = &readAPURegister<&APU::getChannel2VolumeControl>;
+    at(APU::CH2_VOLUME_CTRL_ADDR).write = &writeAPURegister<&APU::setChannel2VolumeControl>;
+    at(APU::CH2_FREQUENCY_LOW_REG_ADDR).write = &writeAPURegister<&APU::setChannel2FrequencyLow>;
+    at(APU::CH2_FREQUENCY_AND_CONTROL_REG_ADDR).read = &readAPURegister<&APU::getChannel2FrequencyAndControl>;
+    at(APU::CH2_FREQUENCY_AND_CONTROL_REG_ADDR).write = &writeAPURegister<&APU::setChannel2FrequencyAndControl>;
+
+    at(APU::CH3_DAC_REG_ADDR).read = &readAPURegister<&APU::getChannel3DAC>;
+    at(APU::CH3_DAC_REG_ADDR).write = &writeAPURegister<&APU::setChannel3DAC>;
+    at(APU::CH3_LENGTH_TIMER_REG_ADDR).write = &writeAPURegister<&APU::setChannel3LengthTimer>;
+    at(APU::CH3_OUTPUT_LEVEL_ADDR).read = &readAPURegister<&APU::getChannel3OutputLevel>;
+    at(APU::CH3_OUTPUT_LEVEL_ADDR).write = &writeAPURegister<&APU::setChannel3OutputLevel>;
+    at(APU::CH3_FREQUENCY_LOW_REG_ADDR).write = &writeAPURegister<&APU::setChannel3FrequencyLow>;
+    at(APU::CH3_FREQUENCY_AND_CONTROL_REG_ADDR).read = &readAPURegister<&APU::getChannel3FrequencyAndControl>;
+    at(APU::CH3_FREQUENCY_AND_CONTROL_REG_ADDR).write = &writeAPURegister<&APU::setChannel3FrequencyAndControl>;
+    for (word addr = APU::CH3_WAVE_PATTERN_START_ADDR; addr <= APU::CH3_WAVE_PATTERN_END_ADDR; ++addr)
+    {
+        at(addr).read = [](MMU& mmu, word addr) -> byte {
+            if (mmu._apu != nullptr)
+            {
+                return mmu._apu->getChannel3WavePattern(addr - APU::CH3_WAVE_PATTERN_START_ADDR);
+            }
+            return mmu.memory[addr];
+        };
+        at(addr).write = [](MMU& mmu, word addr, byte value) {
+            if (mmu._apu != nullptr)
+            {
+                mmu._apu->setChannel3WavePattern(addr - APU::CH3_WAVE_PATTERN_START_ADDR, value);
+                return;
+            }
+            mmu.memory[addr] = value;
+        };
+    }
+
+    at(APU::CH4_LENGTH_TIMER).write = &writeAPURegister<&APU::setChannel4LengthTimer>;
+    at(APU::CH4_VOLUME_CTRL_ADDR).read = &readAPURegister<&APU::getChannel4VolumeControl>;
+    at(APU::CH4_VOLUME_CTRL_ADDR).write = &writeAPURegister<&APU::setChannel4VolumeControl>;
+    at(APU::CH4_NOISE_CTRL_ADDR).read = &readAPURegister<&APU::getChannel4NoiseControl>;
+    at(APU::CH4_NOISE_CTRL_ADDR).write = &writeAPURegister<&APU::setChannel4NoiseControl>;
+    at(APU::CH4_CHANNEL_CTRL_ADDR).read = &readAPURegister<&APU::getChannel4Control>;
+    at(APU::CH4_CHANNEL_CTRL_ADDR).write = &writeAPURegister<&APU::setChannel4Control>;
+
+    at(APU::MASTER_VOLUME_ADDR).read = &readAPURegister<&APU::getMasterVolume>;
+    at(APU::MASTER_VOLUME_ADDR).write = &writeAPURegister<&APU::setMasterVolume>;
+    at(APU::SOUND_PANNING_ADDR).read = &readAPURegister<&APU::getSoundPanning>;
+    at(APU::SOUND_PANNING_ADDR).write = &writeAPURegister<&APU::setSoundPanning>;
+    at(APU::SOUND_CTRL_ADDR).read = &readAPURegister<&APU::getSoundControl>;
+    at(APU::SOUND_CTRL_ADDR).write = &writeAPURegister<&APU::setSoundControl>;
+
+    at(ADDR_LCD_PPU_CONTROL).read = [](MMU& mmu, word addr) -> byte {
+        return mmu._ppu != nullptr ? mmu._ppu->getLcdControl() : mmu.memory[addr];
+    };
+    at(ADDR_LCD_PPU_CONTROL).write = [](MMU& mmu, word addr, byte value) {
+        if (mmu._ppu != nullptr)
+        {
+            mmu._ppu->setLcdControl(value);
+            return;
+        }
+        mmu.memory[addr] = value;
+    };
+    at(ADDR_LCD_STATUS).read = [](MMU& mmu, word addr) -> byte {
+        if (mmu._lcdStatusRegister != nullptr)
+        {
+            return mmu._lcdStatusRegister->getLcdStatusRegister() | 0b10000000;
+        }
+        return mmu.memory[addr];
+    };
+    at(ADDR_LCD_STATUS).write = [](MMU& mmu, word addr, byte value) {
+        if (mmu._lcdStatusRegister != nullptr)
+        {
+            mmu._lcdStatusRegister->setLcdStatusRegister(value);
+            return;
+        }
+        mmu.memory[addr] = value;
+    };
+    at(ADDR_SCROLL_Y).read = [](MMU& mmu, word addr) -> byte {
+        return mmu._ppu != nullptr ? mmu._ppu->getScrollY() : mmu.memory[addr];
+    };
+    at(ADDR_SCROLL_Y).write = [](MMU& mmu, word addr, byte value) {
+        if (mmu._ppu != nullptr)
+        {
+            mmu._ppu->setScrollY(value);
+            return;
+        }
+        mmu.memory[addr] = value;
+    };
+    at(ADDR_SCROLL_X).read = [](MMU& mmu, word addr) -> byte {
+        return mmu._ppu != nullptr ? mmu._ppu->getScrollX() : mmu.memory[addr];
+    };
+    at(ADDR_SCROLL_X).write = [](MMU& mmu, word addr, byte value) {
+        if (mmu._ppu != nullptr)
+        {
+            mmu._ppu->setScrollX(value);
+            return;
+        }
+        mmu.memory[addr] = value;
+    };
+    at(ADDR_SCANLINE).read = [](MMU& mmu, word addr) -> byte {
+        return mmu._lcdStatusRegister != nullptr ? mmu._lcdStatusRegister->getScanlineRegister() : mmu.memory[addr];
+    };
+    at(ADDR_SCANLINE).write = [](MMU& mmu, word addr, byte value) {
+        if (mmu._lcdStatusRegister != nullptr)
+        {
+            mmu._lcdStatusRegister->setScanlineRegister(value);
+            return;
+        }
+        mmu.memory[addr] = value;
+    };
+    at(LY_COMPARE_ADDR).read = [](MMU& mmu, word addr) -> byte {
+        return mmu._lcdStatusRegister != nullptr ? mmu._lcdStatusRegister->getLineYCompareRegister()
+                                                 : mmu.memory[addr];
+    };
+    at(LY_COMPARE_ADDR).write = [](MMU& mmu, word addr, byte value) {
+        if (mmu._lcdStatusRegister != nullptr)
+        {
+            mmu._lcdStatusRegister->setLineYCompareRegister(value);
+            return;
+        }
+        mmu.memory[addr] = value;
+    };
+    // The register reads back the last value written
+    at(DMA_TRANSFER_ADDR).write = [](MMU& mmu, word addr, byte value) {
+        mmu.memory[addr] = value;
+        mmu.startDMATransfer(value << 8);
+    };
+    at(WINDOW_ADDR_SCROLL_Y).read = [](MMU& mmu, word addr) -> byte {
+        return mmu._ppu != nullptr ? mmu._ppu->getWindowScrollY() : mmu.memory[addr];
+    };
+    at(WINDOW_ADDR_SCROLL_Y).write = [](MMU& mmu, word addr, byte value) {
+        if (mmu._ppu != nullptr)
+        {
+            mmu._ppu->setWindowScrollY(value);
+            return;
+        }
+        mmu.memory[addr] = value;
+    };
+    at(WINDOW_ADDR_SCROLL_X).read = [](MMU& mmu, word addr) -> byte {
+        return mmu._ppu != nullptr ? mmu._ppu->getWindowScrollX() : mmu.memory[addr];
+    };
+    at(WINDOW_ADDR_SCROLL_X).write = [](MMU& mmu, word addr, byte value) {
+        if (mmu._ppu != nullptr)
+        {
+            mmu._ppu->setWindowScrollX(value);
+            return;
+        }
+        mmu.memory[addr] = value;
+    };
 
-const utils::AddressRange MMU::unmappedIOAddrRange = utils::AddressRange(0xFF4C, 0xFF7F);
+    // Writing to the bootrom address deactivates it
+    at(BOOT_ROM_UNMAPPED_FLAG_ADDR).readMask = 0b11111110;
+    at(BOOT_ROM_UNMAPPED_FLAG_ADDR).read = [](MMU& mmu, word) -> byte { return !mmu.isInBootrom; };
+    at(BOOT_ROM_UNMAPPED_FLAG_ADDR).write = [](MMU& mmu, word, byte) {
+        mmu.isInBootrom = false;
+        mmu.updateHardwareModel();
+        mmu.updatePageTable();
+        mmu.notifyMemoryMappingChanged();
+    };
+
+    // The color registers are unmapped on the monochrome model
+    if constexpr (model == HardwareModel::CGB)
+    {
+        at(VRAM_BANK_ID_ADDR).readMask = 0x00;
+        at(VRAM_BANK_ID_ADDR).read = [](MMU& mmu, word) -> byte { return mmu.vram.getBankId() & 0xFE; };
+        at(VRAM_BANK_ID_ADDR).write = [](MMU& mmu, word, byte value) {
+            mmu.vram.switchBank(value & 0x01);
+            mmu.updatePageTable();
+        };
+
+        // The bank of the VRAM, the VRAM DMA and the color palettes are used by the PPU,
+        // only the progress of the VRAM DMA is changed by it
+        at(VRAM_BANK_ID_ADDR).writeSynchronizedComponents = SYNCHRONIZE_PPU;
+        for (word addr = HDMA_SOURCE_HIGH_ADDR; addr <= HDMA_CONTROL_ADDR; ++addr)
+        {
+            at(addr).writeSynchronizedComponents = SYNCHRONIZE_PPU;
+        }
+        at(HDMA_CONTROL_ADDR).readSynchronizedComponents = SYNCHRONIZE_PPU;
+        for (word addr = COLOR_PALETTE_SPECS_BACKGROUND_ADDR; addr <= COLOR_PALETTE_DATA_OBJECTS_ADDR; ++addr)
+        {
+            at(addr).writeSynchronizedComponents = SYNCHRONIZE_PPU;
+        }
+
+        // Bit 7 is the current speed, bit 0 prepares a switch
+        at(SPEED_SWITCH_ADDR).readMask = 0x00;
+        at(SPEED_SWITCH_ADDR).read = [](MMU& mmu, word) -> byte {
+            return static_cast<byte>(0x7E | (mmu._isDoubleSpeedEnabled << 7) | mmu._isSpeedSwitchRequested);
+        };
+        at(SPEED_SWITCH_ADDR).write = [](MMU& mmu, word, byte value) {
+            mmu._isSpeedSwitchRequested = utils::isNthBitSet(value, 0);
+        };
+
+        // The source and destination of the VRAM DMA are aligned on blocks, they are write-only
+        at(HDMA_SOURCE_HIGH_ADDR).write = [](MMU& mmu, word, byte value) {
+            mmu._vramDMASourceAddr = static_cast<word>((value << 8) | (mmu._vramDMASourceAddr & 0x00FF));
+        };
+        at(HDMA_SOURCE_LOW_ADDR).write = [](MMU& mmu, word, byte value) {
+            mmu._vramDMASourceAddr = static_cast<word>((mmu._vramDMASourceAddr & 0xFF00) | (value & 0xF0));
+        };
+        at(HDMA_DESTINATION_HIGH_ADDR).write = [](MMU& mmu, word, byte value) {
+            mmu._vramDMADestinationAddr =
+                static_cast<word>(((value & 0x1F) << 8) | (mmu._vramDMADestinationAddr & 0x00FF));
+        };
+        at(HDMA_DESTINATION_LOW_ADDR).write = [](MMU& mmu, word, byte value) {
+            mmu._vramDMADestinationAddr = static_cast<word>((mmu._vramDMADestinationAddr & 0x1F00) | (value & 0xF0));
+        };
+        // Bit 7 is cleared while an H-Blank transfer is in progress,
+        // the other bits are the number of blocks left minus 1
+        at(HDMA_CONTROL_ADDR).readMask = 0x00;
+        at(HDMA_CONTROL_ADDR).read = [](MMU& mmu, word) -> byte {
+            return static_cast<byte>((mmu._isHBlankDMAActive ? 0x00 : 0x80) |
+                                     ((mmu._vramDMARemainingBlocks - 1) & 0x7F));
+        };
+        at(HDMA_CONTROL_ADDR).write = [](MMU& mmu, word, byte value) { mmu.startVRAMDMATransfer(value); };
+
+        at(COLOR_PALETTE_SPECS_BACKGROUND_ADDR).write = [](MMU& mmu, word, byte value) {
+            mmu.colorPaletteMemoryMapperBackground.enableAddressAutoIncrement(utils::isNthBitSet(value, 7));
+            mmu.colorPaletteMemoryMapperBackground.setAddress(value & 0x7F);
+        };
+        at(COLOR_PALETTE_DATA_BACKGROUND_ADDR).readMask = 0x00;
+        at(COLOR_PALETTE_DATA_BACKGROUND_ADDR).read = [](MMU& mmu, word) -> byte {
+            return mmu.colorPaletteMemoryMapperBackground.readColor();
+        };
+        at(COLOR_PALETTE_DATA_BACKGROUND_ADDR).write = [](MMU& mmu, word, byte value) {
+            mmu.colorPaletteMemoryMapperBackground.writeColor(value);
+        };
+        at(COLOR_PALETTE_SPECS_OBJECTS_ADDR).write = [](MMU& mmu, word, byte value) {
+            mmu.colorPaletteMemoryMapperObjects.enableAddressAutoIncrement(utils::isNthBitSet(value, 7));
+            mmu.colorPaletteMemoryMapperObjects.setAddress(value & 0x7F);
+        };
+        at(COLOR_PALETTE_DATA_OBJECTS_ADDR).readMask = 0x00;
+        at(COLOR_PALETTE_DATA_OBJECTS_ADDR).read = [](MMU& mmu, word) -> byte {
+            return mmu.colorPaletteMemoryMapperObjects.readColor();
+        };
+        at(COLOR_PALETTE_DATA_OBJECTS_ADDR).write = [](MMU& mmu, word, byte value) {
+            mmu.colorPaletteMemoryMapperObjects.writeColor(value);
+        };
+
+        at(WRAM_BANK_ID_ADDR).readMask = 0x00;
+        at(WRAM_BANK_ID_ADDR).read = [](MMU& mmu, word) -> byte { return mmu.wramMemoryBank.getBankId() & 0xF8; };
+        at(WRAM_BANK_ID_ADDR).write = [](MMU& mmu, word, byte value) {
+            // Value 0 maps to the first bank, other value map to 1-based bank
+            mmu.wramMemoryBank.switchBank(value == 0 ? 0 : (value & 0x07) - 1);
+            mmu.updatePageTable();
+            mmu.notifyMemoryMappingChanged();
+        };
+    }
+
+    return registers;
+}
 
-const utils::AddressRange MMU::apuRegisterRange = utils::AddressRange(0xFF10, 0xFF3F);
+constexpr MMU::IORegisterTable MMU::ioRegistersDMG = MMU::createIORegisters<HardwareModel::DMG>();
+constexpr MMU::IORegisterTable MMU::ioRegistersCGB = MMU::createIORegisters<HardwareModel::CGB>();
 
 MMU::MMU()
 {
@@ -31,50 +428,60 @@ MMU::MMU()
 
 void MMU::reset()
 {
-    memory = {};
+    _dmaTicksRemaining = 0;
+    _vramDMASourceAddr = 0;
+    _vramDMADestinationAddr = 0;
+    _vramDMARemainingBlocks = 0;
+    _isHBlankDMAActive = false;
+    _stalledTicks = 0;
+    _isDoubleSpeedEnabled = false;
+    _isSpeedSwitchRequested = false;
+    // The buffer is kept, the page table points to it
+    std::fill(memory.begin(), memory.end(), 0);
     std::copy(BOOTROM.begin(), BOOTROM.end(), memory.begin());
-}
+    updatePageTable();
 
-byte MMU::read(const word& addr)
-{
-    if (cartridgeHeaderAddr.contains(addr) && cartridge != nullptr)
+    if (_basicBlockCache != nullptr)
     {
-        return cartridge->getData()[addr];
-    }
-
-    if (addr < BOOTROM.size() && isBootRomActive())
-    {
-        return memory[addr];
+        _basicBlockCache->clear();
     }
+}
 
-    else if (_interruptManager != nullptr && addr == INTERRUPT_ENABLE_ADDR)
+byte MMU::readFromHandlers(const word& addr)
+{
+    // The OAM DMA transfer is brought up to date with the PPU
+    if (_dmaTicksRemaining > 0)
     {
-        return _interruptManager->getInterruptEnableFlag();
+        synchronizeComponents(SYNCHRONIZE_PPU);
     }
 
-    else if (_interruptManager != nullptr && addr == INTERRUPT_FLAG_ADDR)
+    if (addr >= IO_REGISTERS_START_ADDR && addr < IO_REGISTERS_START_ADDR + NUMBER_OF_IO_REGISTERS)
     {
-        return _interruptManager->getInterruptFlag() | 0b11100000;
+        const IORegister& ioRegister = (*_ioRegisters)[addr - IO_REGISTERS_START_ADDR];
+        synchronizeComponents(ioRegister.readSynchronizedComponents);
+        byte value = ioRegister.read != nullptr ? ioRegister.read(*this, addr) : memory[addr];
+        return value | ioRegister.readMask;
     }
 
-    else if (addr == BOOT_ROM_UNMAPPED_FLAG_ADDR)
+    // The high RAM shares its page with the I/O registers
+    if (highRamAddressRange.contains(addr))
     {
-        return static_cast<byte>(!isInBootrom) | 0b11111110;
+        return memory[addr];
     }
 
-    else if (isColorModeSupported() && addr == VRAM_BANK_ID_ADDR)
+    if (cartridgeHeaderAddr.contains(addr) && cartridge != nullptr)
     {
-        return vram.getBankId() & 0xFE;
+        return cartridge->getData()[addr];
     }
 
-    else if (isColorModeSupported() && addr == COLOR_PALETTE_DATA_BACKGROUND_ADDR)
+    if (addr < BOOTROM.size() && isBootRomActive())
     {
-        return colorPaletteMemoryMapperBackground.readColor();
+        return memory[addr];
     }
 
-    else if (isColorModeSupported() && addr == COLOR_PALETTE_DATA_OBJECTS_ADDR)
+    else if (_interruptManager != nullptr && addr == INTERRUPT_ENABLE_ADDR)
     {
-        return colorPaletteMemoryMapperObjects.readColor();
+        return _interruptManager->getInterruptEnableFlag();
     }
 
     else if (addr < ROM_BANK_1_END_ADDR && memoryBankController != nullptr)
@@ -92,11 +499,6 @@ byte MMU::read(const word& addr)
         return memoryBankController->readRAM(externalRamAddr.relative(addr));
     }
 
-    else if (isColorModeSupported() && addr == WRAM_BANK_ID_ADDR)
-    {
-        return wramMemoryBank.getBankId() & 0xF8;
-    }
-
     else if (wramAddressRange.contains(addr))
     {
         return wramMemoryBank.read(wramAddressRange.relative(addr));
@@ -107,78 +509,6 @@ byte MMU::read(const word& addr)
         return _oam.read(_oam.addressRange.relative(addr));
     }
 
-    else if (addr == JOYPAD_MAP_ADDR && inputController != nullptr)
-    {
-        return getJoypadMemoryRepresentation();
-    }
-
-    else if (mappedIOMask.count(addr))
-    {
-        return memory[addr] | mappedIOMask.at(addr);
-    }
-
-    else if (unmappedIOAddrs.count(addr) || unmappedIOAddrRange.contains(addr))
-    {
-        // For unmapped IO all bits should be set to 1
-        return 0xFF;
-    }
-    else if (_apu != nullptr && apuRegisterRange.contains(addr))
-    {
-        return _apu->readRegister(addr);
-    }
-    else if (_timer != nullptr && addr == TIMER_DIV_ADDR)
-    {
-        return _timer->getDividerRegisterValue();
-    }
-    else if (_timer != nullptr && addr == TIMER_COUNTER_ADDR)
-    {
-        return _timer->getTimerCounterValue();
-    }
-    else if (_timer != nullptr && addr == TIMER_MODULO_ADDR)
-    {
-        return _timer->getTimerModuloValue();
-    }
-    else if (_timer != nullptr && addr == TIMER_CONTROL_ADDR)
-    {
-        return 0b11111000 | _timer->isTimerCounterEnabled() << 2 | _timer->getClockDivider();
-    }
-
-    else if (_lcdStatusRegister != nullptr && addr == LY_COMPARE_ADDR)
-    {
-        return _lcdStatusRegister->getLineYCompareRegister();
-    }
-
-    else if (_lcdStatusRegister != nullptr && addr == ADDR_LCD_STATUS)
-    {
-        return _lcdStatusRegister->getLcdStatusRegister() | 0b10000000;
-    }
-
-    else if (_lcdStatusRegister != nullptr && addr == ADDR_SCANLINE)
-    {
-        return _lcdStatusRegister->getScanlineRegister();
-    }
-
-    else if (_ppu != nullptr && addr == ADDR_LCD_PPU_CONTROL)
-    {
-        return _ppu->getLcdControl();
-    }
-    else if (_ppu != nullptr && addr == ADDR_SCROLL_Y)
-    {
-        return _ppu->getScrollY();
-    }
-    else if (_ppu != nullptr && addr == ADDR_SCROLL_X)
-    {
-        return _ppu->getScrollX();
-    }
-    else if (_ppu != nullptr && addr == WINDOW_ADDR_SCROLL_Y)
-    {
-        return _ppu->getWindowScrollY();
-    }
-    else if (_ppu != nullptr && addr == WINDOW_ADDR_SCROLL_X)
-    {
-        return _ppu->getWindowScrollX();
-    }
-
     return memory[addr];
 }
 
@@ -223,61 +553,51 @@ word MMU::readWord(const word& addr)
     return utils::createWordFromBytes(read(addr + 1), read(addr));
 }
 
-void MMU::write(const word& addr, const byte& value)
+void MMU::writeToHandlers(const word& addr, const byte& value)
 {
-    if (addr == DMA_TRANSFER_ADDR)
+    if (_basicBlockCache != nullptr)
     {
-        word sourceAddr = value << 8;
-        performDMATransfer(sourceAddr);
-        return;
+        _basicBlockCache->notifyWrite(addr);
     }
 
-    else if (_interruptManager != nullptr && addr == INTERRUPT_ENABLE_ADDR)
+    // The PPU draws from the VRAM and the OAM, the CPU only reads them directly as the PPU doesn't write them
+    bool isPPUMemory = vram.addressRange.contains(addr) || _oam.addressRange.contains(addr);
+    if (_dmaTicksRemaining > 0 || isPPUMemory)
     {
-        _interruptManager->setInterruptEnableFlag(value);
+        synchronizeComponents(SYNCHRONIZE_PPU);
     }
 
-    else if (_interruptManager != nullptr && addr == INTERRUPT_FLAG_ADDR)
+    if (addr >= IO_REGISTERS_START_ADDR && addr < IO_REGISTERS_START_ADDR + NUMBER_OF_IO_REGISTERS)
     {
-        _interruptManager->setInterruptFlag(value);
-    }
-
-    // Writing to the bootrom address deactivates it
-    else if (addr == BOOT_ROM_UNMAPPED_FLAG_ADDR)
-    {
-        isInBootrom = false;
+        const IORegister& ioRegister = (*_ioRegisters)[addr - IO_REGISTERS_START_ADDR];
+        synchronizeComponents(ioRegister.writeSynchronizedComponents);
+        if (ioRegister.write != nullptr)
+        {
+            ioRegister.write(*this, addr, value);
+        }
+        else
+        {
+            memory[addr] = value;
+        }
         return;
     }
 
-    else if (isColorModeSupported() && addr == VRAM_BANK_ID_ADDR)
-    {
-        vram.switchBank(value & 0x01);
-    }
-
-    else if (isColorModeSupported() && addr == COLOR_PALETTE_SPECS_BACKGROUND_ADDR)
-    {
-        colorPaletteMemoryMapperBackground.enableAddressAutoIncrement(utils::isNthBitSet(value, 7));
-        colorPaletteMemoryMapperBackground.setAddress(value & 0x7F);
-    }
-
-    else if (isColorModeSupported() && addr == COLOR_PALETTE_DATA_BACKGROUND_ADDR)
+    // The high RAM shares its page with the I/O registers
+    if (highRamAddressRange.contains(addr))
     {
-        colorPaletteMemoryMapperBackground.writeColor(value);
-    }
-
-    else if (isColorModeSupported() && addr == COLOR_PALETTE_SPECS_OBJECTS_ADDR)
-    {
-        colorPaletteMemoryMapperObjects.enableAddressAutoIncrement(utils::isNthBitSet(value, 7));
-        colorPaletteMemoryMapperObjects.setAddress(value & 0x7F);
+        memory[addr] = value;
+        return;
     }
 
-    else if (isColorModeSupported() && addr == COLOR_PALETTE_DATA_OBJECTS_ADDR)
+    if (_interruptManager != nullptr && addr == INTERRUPT_ENABLE_ADDR)
     {
-        colorPaletteMemoryMapperObjects.writeColor(value);
+        _interruptManager->setInterruptEnableFlag(value);
     }
 
+    // The page table is updated by the callback of the controller if the banks mapped change
     else if (addr < ROM_BANK_1_END_ADDR && memoryBankController != nullptr)
     {
+        synchronizeCartridgeClock();
         memoryBankController->writeROM(addr, value);
     }
 
@@ -288,15 +608,10 @@ void MMU::write(const word& addr, const byte& value)
 
     else if (externalRamAddr.contains(addr) && memoryBankController != nullptr)
     {
+        synchronizeCartridgeClock();
         memoryBankController->writeRAM(externalRamAddr.relative(addr), value);
     }
 
-    else if (isColorModeSupported() && addr == WRAM_BANK_ID_ADDR)
-    {
-        // Value 0 maps to the first bank, other value map to 1-based bank
-        wramMemoryBank.switchBank(value == 0 ? 0 : (value & 0x07) - 1);
-    }
-
     else if (wramAddressRange.contains(addr))
     {
         wramMemoryBank.write(wramAddressRange.relative(addr), value);
@@ -307,64 +622,6 @@ void MMU::write(const word& addr, const byte& value)
         _oam.write(_oam.addressRange.relative(addr), value);
     }
 
-    else if (_apu != nullptr && apuRegisterRange.contains(addr))
-    {
-        _apu->writeRegister(addr, value);
-    }
-    else if (_timer != nullptr && addr == TIMER_DIV_ADDR)
-    {
-        _timer->resetDividerRegisterValue();
-    }
-    else if (_timer != nullptr && addr == TIMER_COUNTER_ADDR)
-    {
-        _timer->setTimerCounterValue(value);
-    }
-    else if (_timer != nullptr && addr == TIMER_MODULO_ADDR)
-    {
-        _timer->setTimerModuloValue(value);
-    }
-    else if (_timer != nullptr && addr == TIMER_CONTROL_ADDR)
-    {
-        _timer->enableTimerCounter(utils::isNthBitSet(value, 2));
-        _timer->setClockDivider(value & 0b00000011);
-    }
-
-    else if (_lcdStatusRegister != nullptr && addr == LY_COMPARE_ADDR)
-    {
-        _lcdStatusRegister->setLineYCompareRegister(value);
-    }
-
-    else if (_lcdStatusRegister != nullptr && addr == ADDR_LCD_STATUS)
-    {
-        _lcdStatusRegister->setLcdStatusRegister(value);
-    }
-
-    else if (_lcdStatusRegister != nullptr && addr == ADDR_SCANLINE)
-    {
-        _lcdStatusRegister->setScanlineRegister(value);
-    }
-
-    else if (_ppu != nullptr && addr == ADDR_LCD_PPU_CONTROL)
-    {
-        _ppu->setLcdControl(value);
-    }
-    else if (_ppu != nullptr && addr == ADDR_SCROLL_Y)
-    {
-        _ppu->setScrollY(value);
-    }
-    else if (_ppu != nullptr && addr == ADDR_SCROLL_X)
-    {
-        _ppu->setScrollX(value);
-    }
-    else if (_ppu != nullptr && addr == WINDOW_ADDR_SCROLL_Y)
-    {
-        _ppu->setWindowScrollY(value);
-    }
-    else if (_ppu != nullptr && addr == WINDOW_ADDR_SCROLL_X)
-    {
-        _ppu->setWindowScrollX(value);
-    }
-
     else
     {
         memory[addr] = value;
@@ -384,10 +641,10 @@ void MMU::writeWord(const word& addr, const word& value)
 
 bool MMU::loadCartridgeFromFile(const std::string& filepath)
 {
-    std::vector<byte> data;
-    if (utils::readBinaryDataFromFile(filepath, data))
+    std::shared_ptr<const ROMImage> image = ROMImage::loadFromFile(filepath);
+    if (image != nullptr)
     {
-        return loadCartridgeData(data);
+        return loadCartridge(std::move(image));
     }
 
     return false;
@@ -395,7 +652,15 @@ bool MMU::loadCartridgeFromFile(const std::string& filepath)
 
 bool MMU::loadCartridgeData(std::vector<byte> data)
 {
-    cartridge = std::make_unique<Cartridge>(data);
+    return loadCartridge(ROMImage::create(std::move(data)));
+}
+
+bool MMU::loadCartridge(std::shared_ptr<const ROMImage> image)
+{
+    // The source of the transfer in progress may be the ROM being replaced
+    _dmaTicksRemaining = 0;
+    cartridge = std::make_unique<Cartridge>(std::move(image));
+    updateHardwareModel();
 
     memoryBankController = MemoryBankController::createMemoryBankControllerFromCartridge(cartridge.get());
     if (memoryBankController == nullptr)
@@ -406,6 +671,17 @@ bool MMU::loadCartridgeData(std::vector<byte> data)
         return false;
     }
 
+    memoryBankController->setTicksCounter(_ticksCounter);
+    memoryBankController->setBankSwitchedCallback([this]() {
+        updatePageTable();
+        notifyMemoryMappingChanged();
+    });
+    updatePageTable();
+    if (_basicBlockCache != nullptr)
+    {
+        _basicBlockCache->clear();
+    }
+
     return true;
 }
 
@@ -424,14 +700,163 @@ void MMU::setInputController(InputController* controller)
     inputController = controller;
 }
 
-void MMU::performDMATransfer(word sourceAddr)
+void MMU::startDMATransfer(word sourceAddr)
+{
+    // A transfer restarted before its end keeps the bytes it already transferred
+    if (_dmaTicksRemaining > 0)
+    {
+        copyTransferredDMABytes();
+    }
+
+    // The sources above the WRAM read the WRAM, like the echo RAM
+    if (sourceAddr >= ECHO_RAM_START_ADDR)
+    {
+        sourceAddr -= ECHO_RAM_START_ADDR - fixedWramAddressRange.start();
+    }
+
+    _dmaSourceAddr = sourceAddr;
+    _dmaNumberOfCopiedBytes = 0;
+    _dmaTicksRemaining = DMA_START_DELAY_IN_TICKS + DMA_TRANSFER_LENGTH;
+    updatePageTable();
+    notifyMemoryMappingChanged();
+}
+
+void MMU::advanceDMATransfer(int ticks)
 {
-    for (word i = 0; i < DMA_TRANSFER_LENGTH; ++i)
+    _dmaTicksRemaining = std::max(_dmaTicksRemaining - ticks, 0);
+
+    // The OAM is only read by the PPU when it's rendering lines
+    bool isOAMObservable = _ppu != nullptr && _ppu->isDisplayEnabled() && _ppu->getMode() != PPU::Mode::VBLANK;
+    if (isOAMObservable || _dmaTicksRemaining == 0)
+    {
+        copyTransferredDMABytes();
+    }
+
+    if (_dmaTicksRemaining == 0)
     {
-        write(DMA_TRANSFER_TARGET_ADDR + i, read(sourceAddr + i));
+        // The CPU gets the whole bus back
+        updatePageTable();
+        notifyMemoryMappingChanged();
     }
 }
 
+void MMU::copyTransferredDMABytes()
+{
+    int elapsedTicks = DMA_START_DELAY_IN_TICKS + DMA_TRANSFER_LENGTH - _dmaTicksRemaining;
+    int numberOfTransferredBytes = std::clamp(elapsedTicks - DMA_START_DELAY_IN_TICKS, 0, DMA_TRANSFER_LENGTH);
+    if (numberOfTransferredBytes <= _dmaNumberOfCopiedBytes)
+    {
+        return;
+    }
+
+    byte* oam = _oam.getData();
+    if (_dmaSource != nullptr)
+    {
+        std::memcpy(oam + _dmaNumberOfCopiedBytes, _dmaSource + _dmaNumberOfCopiedBytes,
+                    numberOfTransferredBytes - _dmaNumberOfCopiedBytes);
+    }
+    else
+    {
+        for (int i = _dmaNumberOfCopiedBytes; i < numberOfTransferredBytes; ++i)
+        {
+            oam[i] = readFromHandlers(static_cast<word>(_dmaSourceAddr + i));
+        }
+    }
+    _dmaNumberOfCopiedBytes = numberOfTransferredBytes;
+}
+
+void MMU::startVRAMDMATransfer(byte value)
+{
+    bool isHBlankTransfer = utils::isNthBitSet(value, 7);
+    if (_isHBlankDMAActive && !isHBlankTransfer)
+    {
+        // The blocks left can still be read from HDMA5
+        _isHBlankDMAActive = false;
+        return;
+    }
+
+    _vramDMARemainingBlocks = (value & 0x7F) + 1;
+    if (!isHBlankTransfer)
+    {
+        _isHBlankDMAActive = false;
+        while (_vramDMARemainingBlocks > 0)
+        {
+            copyVRAMDMABlock();
+        }
+        return;
+    }
+
+    // A transfer started during the horizontal blank copies its first block right away
+    _isHBlankDMAActive = true;
+    if (_ppu != nullptr && _ppu->isDisplayEnabled() && _ppu->getMode() == PPU::Mode::HBLANK)
+    {
+        copyVRAMDMABlock();
+    }
+}
+
+bool MMU::switchSpeedIfRequested()
+{
+    if (!_isSpeedSwitchRequested || !isColorModeSupported())
+    {
+        return false;
+    }
+
+    // The time elapsed before the switch is counted at the previous speed
+    synchronizeComponents(SYNCHRONIZE_ALL);
+    _isSpeedSwitchRequested = false;
+    _isDoubleSpeedEnabled = !_isDoubleSpeedEnabled;
+    _stalledTicks += SPEED_SWITCH_TICKS;
+    if (_timer != nullptr)
+    {
+        _timer->resetDividerRegisterValue();
+    }
+    if (_apu != nullptr)
+    {
+        _apu->setDoubleSpeedEnabled(_isDoubleSpeedEnabled);
+    }
+
+    return true;
+}
+
+void MMU::notifyHBlankStarted()
+{
+    if (_isHBlankDMAActive)
+    {
+        copyVRAMDMABlock();
+    }
+}
+
+void MMU::copyVRAMDMABlock()
+{
+    // A block never crosses a page, it's copied from the memory mapped at the source when it can be read directly
+    byte* destination = vram.getBankData() + _vramDMADestinationAddr;
+    const byte* source = _readPages[_vramDMASourceAddr / PAGE_SIZE];
+    if (source != nullptr)
+    {
+        std::memmove(destination, source + (_vramDMASourceAddr % PAGE_SIZE), VRAM_DMA_BLOCK_SIZE);
+    }
+    else
+    {
+        for (int i = 0; i < VRAM_DMA_BLOCK_SIZE; ++i)
+        {
+            destination[i] = readFromHandlers(static_cast<word>(_vramDMASourceAddr + i));
+        }
+    }
+
+    _vramDMASourceAddr = static_cast<word>(_vramDMASourceAddr + VRAM_DMA_BLOCK_SIZE);
+    _vramDMADestinationAddr = static_cast<word>((_vramDMADestinationAddr + VRAM_DMA_BLOCK_SIZE) & 0x1FF0);
+    _stalledTicks += VRAM_DMA_TICKS_PER_BLOCK;
+    if (--_vramDMARemainingBlocks == 0)
+    {
+        _isHBlankDMAActive = false;
+    }
+}
+
+int MMU::getTicksUntilNextEvent() const
+{
+    return _dmaTicksRemaining > 0 ? _dmaTicksRemaining : std::numeric_limits<int>::max();
+}
+
 std::vector<byte> MMU::serializeCartridgeRAM()
 {
     if (memoryBankController != nullptr)
@@ -477,9 +902,15 @@ ColorPaletteMemoryMapper& MMU::getColorPaletteMemoryMapperObj()
     return colorPaletteMemoryMapperObjects;
 }
 
-bool MMU::isColorModeSupported()
+void MMU::updateHardwareModel()
 {
-    return isBootRomActive() || (cartridge != nullptr && cartridge->isColorModeSupported());
+    bool isColorModeSupported = isBootRomActive() || (cartridge != nullptr && cartridge->isColorModeSupported());
+    _hardwareModel = isColorModeSupported ? HardwareModel::CGB : HardwareModel::DMG;
+    _ioRegisters = isColorModeSupported ? &ioRegistersCGB : &ioRegistersDMG;
+    if (_ppu != nullptr)
+    {
+        _ppu->setHardwareModel(_hardwareModel);
+    }
 }
 
 void MMU::setInterruptManager(InterruptManager* interruptManager)
@@ -495,9 +926,168 @@ void MMU::setLcdStatusRegister(LCDStatusRegister* lcdStatusRegister)
 void MMU::setPPU(PPU* ppu)
 {
     _ppu = ppu;
+    if (_ppu != nullptr)
+    {
+        _ppu->setHardwareModel(_hardwareModel);
+    }
+}
+
+void MMU::setTicksCounter(const int64_t* ticks)
+{
+    _ticksCounter = ticks;
+    if (memoryBankController != nullptr)
+    {
+        memoryBankController->setTicksCounter(ticks);
+    }
 }
 
 OAM& MMU::getOAM()
 {
     return _oam;
 }
+
+void MMU::setBasicBlockCache(BasicBlockCache* cache)
+{
+    _basicBlockCache = cache;
+}
+
+void MMU::setSynchronizationCallback(SynchronizationCallback callback)
+{
+    _synchronizationCallback = std::move(callback);
+}
+
+void MMU::notifyMemoryMappingChanged()
+{
+    if (_basicBlockCache != nullptr)
+    {
+        _basicBlockCache->notifyMappingChanged();
+    }
+}
+
+void MMU::updatePageTable()
+{
+    // The bytes transferred so far were read from the previous mapping
+    if (_dmaTicksRemaining > 0)
+    {
+        copyTransferredDMABytes();
+    }
+
+    _readPages.fill(nullptr);
+    _writePages.fill(nullptr);
+
+    for (int page = 0; page < ROM_BANK_1_END_ADDR / PAGE_SIZE; ++page)
+    {
+        word addr = static_cast<word>(page * PAGE_SIZE);
+        // The cartridge header is mapped over the boot rom and the ROM is read-only
+        bool isHeaderPage = cartridge != nullptr && addr <= cartridgeHeaderAddr.end() &&
+                            addr + PAGE_SIZE > cartridgeHeaderAddr.start();
+        if (memoryBankController == nullptr)
+        {
+            _writePages[page] = &memory[addr];
+        }
+
+        if (isHeaderPage)
+        {
+            continue;
+        }
+        else if (addr < BOOTROM.size() && isBootRomActive())
+        {
+            _readPages[page] = &memory[addr];
+        }
+        else if (memoryBankController != nullptr)
+        {
+            _readPages[page] = getROMPage(addr);
+        }
+        else
+        {
+            _readPages[page] = &memory[addr];
+        }
+    }
+
+    // The writes to the external RAM go through the controller so that the battery save knows the pages written
+    byte* ramBank = memoryBankController != nullptr ? memoryBankController->getRAMBank() : nullptr;
+    if (ramBank != nullptr)
+    {
+        for (int addr = externalRamAddr.start(); addr <= externalRamAddr.end(); addr += PAGE_SIZE)
+        {
+            _readPages[addr / PAGE_SIZE] = ramBank + externalRamAddr.relative(addr);
+        }
+    }
+
+    // The writes to the VRAM go through the handlers to bring the PPU up to date before
+    for (int addr = vram.addressRange.start(); addr <= vram.addressRange.end(); addr += PAGE_SIZE)
+    {
+        _readPages[addr / PAGE_SIZE] = vram.getBankData() + vram.addressRange.relative(addr);
+    }
+
+    // The echo RAM is not mirrored, it's plain memory like the fixed WRAM bank
+    for (int addr = fixedWramAddressRange.start(); addr < _oam.addressRange.start(); addr += PAGE_SIZE)
+    {
+        byte* data = wramAddressRange.contains(addr)
+                         ? wramMemoryBank.getBankData() + wramAddressRange.relative(addr)
+                         : &memory[addr];
+        _readPages[addr / PAGE_SIZE] = data;
+        _writePages[addr / PAGE_SIZE] = data;
+    }
+
+    if (_dmaTicksRemaining > 0)
+    {
+        // The CPU can only access the I/O registers and the HRAM, the rest of the memory goes through the handlers
+        _dmaSource = _readPages[_dmaSourceAddr / PAGE_SIZE];
+        _readPages.fill(nullptr);
+        _writePages.fill(nullptr);
+    }
+}
+
+const byte* MMU::getROMPage(word addr)
+{
+    const byte* bank = addr < ROM_BANK_0_END_ADDR ? memoryBankController->getFixedROMBank()
+                                                  : memoryBankController->getSwitchableROMBank();
+    // Reading outside of the ROM is left to the memory bank controller
+    if (bank == nullptr)
+    {
+        return nullptr;
+    }
+
+    return bank + (addr % ROM_BANK_0_END_ADDR);
+}
+
+int MMU::getMemoryBankKey(const word& addr)
+{
+    if (_dmaTicksRemaining > 0 && addr < IO_REGISTERS_START_ADDR)
+    {
+        return UNCACHEABLE_BANK_KEY;
+    }
+
+    if (addr < ROM_BANK_1_END_ADDR)
+    {
+        if (memoryBankController == nullptr)
+        {
+            return UNMAPPED_ROM_BANK_KEY;
+        }
+
+        if (isBootRomActive() && addr < BOOTROM.size() && !cartridgeHeaderAddr.contains(addr))
+        {
+            return BOOTROM_BANK_KEY;
+        }
+
+        return addr < ROM_BANK_0_END_ADDR ? 0 : memoryBankController->getSelectedROMBankId();
+    }
+
+    else if (fixedWramAddressRange.contains(addr))
+    {
+        return WORK_RAM_BANK_KEY;
+    }
+
+    else if (wramAddressRange.contains(addr))
+    {
+        return WORK_RAM_BANK_KEY + 1 + static_cast<int>(wramMemoryBank.getBankId());
+    }
+
+    else if (highRamAddressRange.contains(addr))
+    {
+        return HIGH_RAM_BANK_KEY;
+    }
+
+    return UNCACHEABLE_BANK_KEY;
+}
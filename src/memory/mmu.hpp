@@ -2,12 +2,14 @@
 #define MMU_H
 
 #include <array>
+#include <functional>
 #include <memory>
-#include <set>
 #include <stdexcept>
 
 #include "cartridge.hpp"
+#include "common/hardware_model.hpp"
 #include "common/types.hpp"
+#include "cpu/basic_block_cache.hpp"
 #include "cpu/input_controller.hpp"
 #include "graphics/palette/color_palette_memory_mapper.hpp"
 #include "memory/mbc/memory_bank_controller.hpp"
@@ -28,6 +30,16 @@ class PPU;
  * The MMU class is responsible for managing the memory access and mapping.
  * It handles read and write operations to various memory regions such as ROM, RAM, I/O registers,
  * and other critical areas within the Game Boy architecture.
+ *
+ * The memory is split in 256 pages of 256 bytes, a page table gives for each page a pointer to the memory
+ * currently mapped when it can be read or written directly (ROM and RAM banks of the cartridge, WRAM, VRAM, ...).
+ * The pages of the I/O registers, the parts of the ROM that are overlaid and the external RAM when the
+ * memory bank controller doesn't publish it go through the handlers. The table is updated when the mapping
+ * changes (bank switches notified by the memory bank controller, boot rom unmapped).
+ *
+ * The I/O registers are dispatched through a table built at compile time with an entry per register,
+ * instead of being compared one after the other to every mapped address.
+ * A table is built for each hardware model, the registers of the GameBoy Color are only mapped in its table.
  */
 class MMU
 {
@@ -75,7 +87,21 @@ class MMU
      * @param addr The address of the location
      * @return The value in memory
      */
-    byte read(const word& addr);
+    byte read(const word& addr)
+    {
+        const byte* page = _readPages[addr >> 8];
+        if (page != nullptr)
+        {
+            return page[addr & 0xFF];
+        }
+
+        if (_dmaTicksRemaining > 0 && addr < IO_REGISTERS_START_ADDR)
+        {
+            return DMA_BUS_CONFLICT_VALUE;
+        }
+
+        return readFromHandlers(addr);
+    }
 
     /**
      * Read the value of two consecutive memory location
@@ -89,7 +115,26 @@ class MMU
      * @param addr The address of the location
      * @param value The byte value to write
      */
-    void write(const word& addr, const byte& value);
+    void write(const word& addr, const byte& value)
+    {
+        byte* page = _writePages[addr >> 8];
+        if (page != nullptr)
+        {
+            if (_basicBlockCache != nullptr)
+            {
+                _basicBlockCache->notifyWrite(addr);
+            }
+            page[addr & 0xFF] = value;
+            return;
+        }
+
+        if (_dmaTicksRemaining > 0 && addr < IO_REGISTERS_START_ADDR)
+        {
+            return;
+        }
+
+        writeToHandlers(addr, value);
+    }
 
     /**
      * Write a given two-byte value to two consecutive memory location
@@ -98,6 +143,73 @@ class MMU
      */
     void writeWord(const word& addr, const word& value);
 
+    /**
+     * Advance the OAM DMA transfer in progress, if any.
+     * @param ticks The number of ticks elapsed since the last step
+     */
+    void stepDMA(int ticks)
+    {
+        if (_dmaTicksRemaining > 0)
+        {
+            advanceDMATransfer(ticks);
+        }
+    }
+
+    /**
+     * @return true if an OAM DMA transfer is in progress, the CPU can then only access the I/O registers and the HRAM
+     */
+    bool isDMATransferActive() const
+    {
+        return _dmaTicksRemaining > 0;
+    }
+
+    /**
+     * @return the number of ticks until the OAM DMA transfer in progress ends
+     */
+    int getTicksUntilNextEvent() const;
+
+    /**
+     * @return true if the game started a serial transfer that wasn't finalized yet, see SerialTransferManager
+     */
+    bool isSerialTransferRequested() const
+    {
+        // Bit 7 of SC is set until the transfer is finalized
+        return (memory[SERIAL_TRANSFER_CONTROL_ADDR] & 0x80) != 0;
+    }
+
+    /**
+     * @return true if the CPU runs in the double speed mode of the CGB, false in normal speed mode
+     */
+    bool isDoubleSpeedEnabled() const
+    {
+        return _isDoubleSpeedEnabled;
+    }
+
+    /**
+     * Switch between the normal and double speed modes if a switch was prepared through KEY1,
+     * called when the CPU executes STOP. The CPU is stopped while the clock settles.
+     *
+     * @return true if the speed was switched
+     */
+    bool switchSpeedIfRequested();
+
+    /**
+     * Notify the MMU that the PPU entered the horizontal blank, to copy a block of the H-Blank DMA.
+     */
+    void notifyHBlankStarted();
+
+    /**
+     * Get the ticks during which the CPU was stopped (VRAM DMA, speed switch) since the last call.
+     *
+     * @return a number of ticks at normal speed, 0 if the CPU was not stopped
+     */
+    int consumeStalledTicks()
+    {
+        int ticks = _stalledTicks;
+        _stalledTicks = 0;
+        return ticks;
+    }
+
     /**
      * Load a cartridge from a file.
      * @param filepath The location of the cartridge file.
@@ -112,6 +224,14 @@ class MMU
      */
     bool loadCartridgeData(std::vector<byte> data);
 
+    /**
+     * Load a cartridge from the image of a ROM.
+     * The image is shared, not copied, so it can be loaded by several emulators at once.
+     * @param image the image of the ROM to load
+     * @return true if loaded successfully, false otherwise
+     */
+    bool loadCartridge(std::shared_ptr<const ROMImage> image);
+
     /**
      * @return true if the boot rom is active, false otherwise
      */
@@ -151,6 +271,14 @@ class MMU
      */
     void reset();
 
+    /**
+     * @return the memory bank controller of the cartridge loaded, nullptr if no cartridge is loaded
+     */
+    MemoryBankController* getMemoryBankController() const
+    {
+        return memoryBankController.get();
+    }
+
     /**
      * Serialize the current state of the cartridge RAM.
      *
@@ -170,7 +298,22 @@ class MMU
      * the loaded rom supports color mode.
      * @return true if color is supported, false otherwise
      */
-    bool isColorModeSupported();
+    bool isColorModeSupported() const
+    {
+        return _hardwareModel == HardwareModel::CGB;
+    }
+
+    /**
+     * Get the hardware model emulated, the GameBoy Color while in the bootrom
+     * then the model supported by the cartridge.
+     * It only changes when a cartridge is loaded or the bootrom unmapped.
+     *
+     * @return the hardware model
+     */
+    HardwareModel getHardwareModel() const
+    {
+        return _hardwareModel;
+    }
 
     VRAM& getVRAM();
 
@@ -191,6 +334,94 @@ class MMU
      */
     void setPPU(PPU* ppu);
 
+    /**
+     * Set the counter of the ticks elapsed at normal speed used by the clock of the cartridges.
+     * @param ticks A pointer to the counter of the emulator
+     */
+    void setTicksCounter(const int64_t* ticks);
+
+    /**
+     * Set the cache of decoded instructions that needs to be notified of memory writes and mapping changes.
+     * @param cache A pointer to the cache, or nullptr to stop notifying
+     */
+    void setBasicBlockCache(BasicBlockCache* cache);
+
+    /**
+     * The components stepped lazily that are brought up to date before the CPU accesses them, as bit flags.
+     */
+    enum SynchronizedComponent
+    {
+        /**
+         * The PPU, with the OAM DMA transfer which fills the OAM it reads
+         */
+        SYNCHRONIZE_PPU = 1 << 0,
+        SYNCHRONIZE_TIMER = 1 << 1,
+        /**
+         * The APU, its frame sequencer is clocked by the divider register of the timer
+         */
+        SYNCHRONIZE_APU = 1 << 2,
+        SYNCHRONIZE_ALL = SYNCHRONIZE_PPU | SYNCHRONIZE_TIMER | SYNCHRONIZE_APU,
+        /**
+         * Only the counter of the ticks elapsed, read by the clock of the cartridge, see setTicksCounter()
+         */
+        SYNCHRONIZE_TICKS_COUNTER = 1 << 3
+    };
+
+    /**
+     * Callback bringing some components up to date before the CPU accesses them.
+     * The argument is a combination of SynchronizedComponent.
+     */
+    typedef std::function<void(int components)> SynchronizationCallback;
+
+    /**
+     * Set the function to call before the CPU accesses the registers or the memories of a component:
+     * the writes to the I/O registers of the PPU, the timer and the APU, the reads of the ones they change,
+     * the writes to the VRAM and the OAM, any memory during an OAM DMA transfer,
+     * and the writes to the cartridge when it has a clock.
+     * The components can then be stepped lazily, each of them only when the CPU can observe it.
+     *
+     * @param callback The function to call, or nullptr if the components are always up to date
+     */
+    void setSynchronizationCallback(SynchronizationCallback callback);
+
+    /**
+     * Get a key identifying the memory currently mapped at the given address (ROM bank, WRAM bank, HRAM, ...).
+     * Two addresses with the same key are read from the same memory unit.
+     *
+     * @param addr The address to check
+     * @return The key of the memory bank, or UNCACHEABLE_BANK_KEY if the content of this address
+     * can change without being written to by the CPU (I/O registers, VRAM, external RAM, ...)
+     */
+    int getMemoryBankKey(const word& addr);
+
+    /**
+     * Is the memory identified by the given key writable, i.e. its content can be changed by a write.
+     *
+     * @param bankKey A key returned by getMemoryBankKey()
+     * @return true if writable, false otherwise
+     */
+    static bool isWritableBankKey(int bankKey)
+    {
+        return bankKey >= WRITABLE_BANK_KEY;
+    }
+
+    /**
+     * Is the memory identified by the given key a bank of the cartridge ROM.
+     * For those keys, the key is the index of the bank in the ROM.
+     *
+     * @param bankKey A key returned by getMemoryBankKey()
+     * @return true if it's a ROM bank, false otherwise
+     */
+    static bool isROMBankKey(int bankKey)
+    {
+        return bankKey >= 0 && bankKey < BOOTROM_BANK_KEY;
+    }
+
+    /**
+     * Key returned for memory whose content cannot be cached.
+     */
+    static constexpr int UNCACHEABLE_BANK_KEY = -1;
+
     /**
      * The total size of the memory in bytes
      */
@@ -215,34 +446,152 @@ class MMU
 
   private:
     /**
-     * Addresses of Hardware IO that are mapped by the MMU
+     * Read the value of an I/O register from the component owning it.
+     * The read mask of the register is applied to the value returned.
+     */
+    typedef byte (*IORegisterReader)(MMU& mmu, word addr);
+
+    /**
+     * Write the value of an I/O register to the component owning it.
+     */
+    typedef void (*IORegisterWriter)(MMU& mmu, word addr, byte value);
+
+    /**
+     * An entry of the dispatch table of the I/O registers.
      */
-    enum HardwareIOAddr : word
+    struct IORegister
     {
-        P1 = 0xFF00,
-        SC = 0xFF02,
-        STAT = 0xFF41,
+        /**
+         * The bits that always read as 1, 0xFF for the unmapped registers
+         */
+        byte readMask = 0x00;
+
+        /**
+         * The function reading the register, nullptr if the register is read from memory
+         */
+        IORegisterReader read = nullptr;
+
+        /**
+         * The function writing the register, nullptr if the register is written to memory
+         */
+        IORegisterWriter write = nullptr;
+
+        /**
+         * The components to bring up to date before the register is read, see SynchronizedComponent
+         */
+        byte readSynchronizedComponents = 0;
+
+        /**
+         * The components to bring up to date before the register is written, see SynchronizedComponent
+         */
+        byte writeSynchronizedComponents = 0;
     };
 
     /**
-     * bitmask for unused bits for the mapped hardware IO
+     * The address of the first I/O register
+     */
+    static constexpr word IO_REGISTERS_START_ADDR = 0xFF00;
+
+    /**
+     * The number of I/O registers, from 0xFF00 to 0xFF7F
+     */
+    static constexpr int NUMBER_OF_IO_REGISTERS = 128;
+
+    /**
+     * A dispatch table with an entry for each I/O register
+     */
+    typedef std::array<IORegister, NUMBER_OF_IO_REGISTERS> IORegisterTable;
+
+    /**
+     * Build the dispatch table of the I/O registers for a hardware model.
+     * The callbacks go through the MMU to reach the component owning the register (timer, PPU, APU, ...)
+     * and fall back to the memory when this component is not set.
+     * The registers of the GameBoy Color are left unmapped in the table of the monochrome model.
+     *
+     * @tparam model The hardware model of the table
+     * @return an entry for each I/O register, indexed by its address relative to IO_REGISTERS_START_ADDR
+     */
+    template <HardwareModel model>
+    static constexpr IORegisterTable createIORegisters();
+
+    /**
+     * Read an APU register with its accessor, from memory when the APU is not set.
+     *
+     * @tparam getter The accessor of the register in the APU
+     */
+    template <byte (APU::*getter)()>
+    static byte readAPURegister(MMU& mmu, word addr);
+
+    /**
+     * Write an APU register with its accessor, to memory when the APU is not set.
+     *
+     * @tparam setter The accessor of the register in the APU
+     */
+    template <void (APU::*setter)(byte)>
+    static void writeAPURegister(MMU& mmu, word addr, byte value);
+
+    /**
+     * The dispatch tables of the I/O registers for each model, see createIORegisters()
+     */
+    static const IORegisterTable ioRegistersDMG;
+    static const IORegisterTable ioRegistersCGB;
+
+    /**
+     * Compute the hardware model from the bootrom and the cartridge, and select its dispatch table.
+     * Called each time one of them changes.
+     */
+    void updateHardwareModel();
+
+    /**
+     * Read a value from the component mapped at the given address,
+     * used for the pages that can't be read directly.
+     *
+     * @param addr The address of the location
+     * @return The value in memory
+     */
+    byte readFromHandlers(const word& addr);
+
+    /**
+     * Write a value to the component mapped at the given address,
+     * used for the pages that can't be written directly.
+     *
+     * @param addr The address of the location
+     * @param value The byte value to write
+     */
+    void writeToHandlers(const word& addr, const byte& value);
+
+    /**
+     * Point the pages of the page table to the memory currently mapped.
+     */
+    void updatePageTable();
+
+    /**
+     * Get the memory of a page of ROM currently mapped.
+     *
+     * @param addr The address of the page
+     * @return the memory of the page, or nullptr if the page is outside of the ROM
+     */
+    const byte* getROMPage(word addr);
+
+    /**
+     * The size of a page of the page table
      */
-    static const std::map<word, byte> mappedIOMask;
+    static constexpr int PAGE_SIZE = 256;
 
     /**
-     * List of non-consecutive unmapped IO addresses
+     * The number of pages in the page table
      */
-    static const std::set<word> unmappedIOAddrs;
+    static constexpr int NUMBER_OF_PAGES = MEMORY_SIZE_IN_BYTES / PAGE_SIZE;
 
     /**
-     * Range of unmapped IO addresses
+     * The memory that can be read directly for each page, nullptr if the page goes through the handlers
      */
-    static const utils::AddressRange unmappedIOAddrRange;
+    std::array<const byte*, NUMBER_OF_PAGES> _readPages = {};
 
     /**
-     * Range of APU register addresses
+     * The memory that can be written directly for each page, nullptr if the page goes through the handlers
      */
-    static const utils::AddressRange apuRegisterRange;
+    std::array<byte*, NUMBER_OF_PAGES> _writePages = {};
 
     /**
      * Get the memory representation of the joypad state.
@@ -251,16 +600,59 @@ class MMU
     byte getJoypadMemoryRepresentation();
 
     /**
-     * Perform a DMA transfer from the given source to the DMA destination
+     * Start an OAM DMA transfer from the given source to the OAM.
+     * The transfer is timed by stepDMA(), the CPU is restricted to the I/O registers and the HRAM until it ends.
+     *
      * @param sourceAddr The source address for the DMA
      */
-    void performDMATransfer(word sourceAddr);
+    void startDMATransfer(word sourceAddr);
+
+    /**
+     * Advance the OAM DMA transfer in progress, see stepDMA().
+     *
+     * @param ticks The number of ticks elapsed since the last step
+     */
+    void advanceDMATransfer(int ticks);
+
+    /**
+     * Copy the bytes of the OAM DMA transfer in progress that were transferred since the last copy.
+     * Nothing can write to the source during the transfer, so the copy can be delayed
+     * until the intermediate content of the OAM can be observed, i.e. the PPU reads it or the mapping changes.
+     */
+    void copyTransferredDMABytes();
+
+    /**
+     * Start a VRAM DMA transfer, or stop the H-Blank DMA transfer in progress.
+     *
+     * @param value The value written to HDMA5
+     */
+    void startVRAMDMATransfer(byte value);
+
+    /**
+     * Copy the next block of the VRAM DMA transfer and stop the CPU during the copy.
+     */
+    void copyVRAMDMABlock();
+
+    /**
+     * Notify the cache of decoded instructions that the memory mapping changed.
+     */
+    void notifyMemoryMappingChanged();
 
     /**
      * If the emulator is currently in the bootrom
      */
     bool isInBootrom = true;
 
+    /**
+     * The hardware model emulated, see getHardwareModel()
+     */
+    HardwareModel _hardwareModel = HardwareModel::CGB;
+
+    /**
+     * The dispatch table of the I/O registers of the hardware model
+     */
+    const IORegisterTable* _ioRegisters = &ioRegistersCGB;
+
     /**
      * The internal representation of the memory
      */
@@ -286,6 +678,11 @@ class MMU
      */
     const utils::AddressRange externalRamAddr = utils::AddressRange(0xA000, 0xBFFF);
 
+    /**
+     * The end address of the fixed ROM bank
+     */
+    static constexpr word ROM_BANK_0_END_ADDR = 0x4000;
+
     /**
      * The end address of the 1st ROM bank
      */
@@ -301,6 +698,21 @@ class MMU
      */
     static constexpr word JOYPAD_MAP_ADDR = 0xFF00;
 
+    /**
+     * The address of the serial transfer control register
+     */
+    static constexpr word SERIAL_TRANSFER_CONTROL_ADDR = 0xFF02;
+
+    /**
+     * The address of the first APU register
+     */
+    static constexpr word APU_REGISTERS_START_ADDR = 0xFF10;
+
+    /**
+     * The address of the last APU register
+     */
+    static constexpr word APU_REGISTERS_END_ADDR = 0xFF3F;
+
     /**
      * The address of the DMA control location
      */
@@ -316,6 +728,121 @@ class MMU
      */
     static constexpr word DMA_TRANSFER_TARGET_ADDR = 0xFE00;
 
+    /**
+     * The start address of the echo RAM, the DMA transfers from there read the WRAM
+     */
+    static constexpr word ECHO_RAM_START_ADDR = 0xE000;
+
+    /**
+     * The number of ticks between the write to the DMA register and the transfer of the first byte
+     */
+    static const int DMA_START_DELAY_IN_TICKS = 1;
+
+    /**
+     * The value read by the CPU outside of the I/O registers and the HRAM during a DMA transfer
+     */
+    static constexpr byte DMA_BUS_CONFLICT_VALUE = 0xFF;
+
+    /**
+     * The number of ticks left in the OAM DMA transfer in progress, 0 if there is none
+     */
+    int _dmaTicksRemaining = 0;
+
+    /**
+     * The source address of the OAM DMA transfer in progress
+     */
+    word _dmaSourceAddr = 0;
+
+    /**
+     * The memory of the source of the OAM DMA transfer if it can be read directly, nullptr otherwise
+     */
+    const byte* _dmaSource = nullptr;
+
+    /**
+     * The number of bytes of the OAM DMA transfer in progress already copied to the OAM
+     */
+    int _dmaNumberOfCopiedBytes = 0;
+
+    /**
+     * The address of the source high byte register of the VRAM DMA (HDMA1)
+     */
+    static constexpr word HDMA_SOURCE_HIGH_ADDR = 0xFF51;
+
+    /**
+     * The address of the source low byte register of the VRAM DMA (HDMA2)
+     */
+    static constexpr word HDMA_SOURCE_LOW_ADDR = 0xFF52;
+
+    /**
+     * The address of the destination high byte register of the VRAM DMA (HDMA3)
+     */
+    static constexpr word HDMA_DESTINATION_HIGH_ADDR = 0xFF53;
+
+    /**
+     * The address of the destination low byte register of the VRAM DMA (HDMA4)
+     */
+    static constexpr word HDMA_DESTINATION_LOW_ADDR = 0xFF54;
+
+    /**
+     * The address of the length, mode and start register of the VRAM DMA (HDMA5)
+     */
+    static constexpr word HDMA_CONTROL_ADDR = 0xFF55;
+
+    /**
+     * The number of bytes copied at once by a VRAM DMA transfer
+     */
+    static const int VRAM_DMA_BLOCK_SIZE = 16;
+
+    /**
+     * The number of ticks, at normal speed, the CPU is stopped for each block copied by a VRAM DMA transfer
+     */
+    static const int VRAM_DMA_TICKS_PER_BLOCK = 8;
+
+    /**
+     * The source address of the next block of the VRAM DMA transfer
+     */
+    word _vramDMASourceAddr = 0;
+
+    /**
+     * The destination of the next block of the VRAM DMA transfer, relative to the start of the VRAM
+     */
+    word _vramDMADestinationAddr = 0;
+
+    /**
+     * The number of blocks left to copy by the VRAM DMA transfer
+     */
+    int _vramDMARemainingBlocks = 0;
+
+    /**
+     * Is an H-Blank DMA transfer in progress
+     */
+    bool _isHBlankDMAActive = false;
+
+    /**
+     * The ticks during which the CPU is stopped, see consumeStalledTicks()
+     */
+    int _stalledTicks = 0;
+
+    /**
+     * The address of the speed switch register (KEY1)
+     */
+    static constexpr word SPEED_SWITCH_ADDR = 0xFF4D;
+
+    /**
+     * The number of ticks, at normal speed, during which the CPU is stopped by a speed switch
+     */
+    static const int SPEED_SWITCH_TICKS = 2050;
+
+    /**
+     * Does the CPU run in double speed mode
+     */
+    bool _isDoubleSpeedEnabled = false;
+
+    /**
+     * Was a speed switch prepared through KEY1, it happens on the next STOP
+     */
+    bool _isSpeedSwitchRequested = false;
+
     /**
      * The address in memory where the cartridge header will be mapped
      */
@@ -434,6 +961,11 @@ class MMU
      */
     PPU* _ppu = nullptr;
 
+    /**
+     * The counter of the ticks elapsed given to the memory bank controllers
+     */
+    const int64_t* _ticksCounter = nullptr;
+
     /**
      * The address of the LCD control register.
      */
@@ -460,6 +992,76 @@ class MMU
     static constexpr word WINDOW_ADDR_SCROLL_X = 0xFF4B;
 
     OAM _oam;
+
+    /**
+     * The cache of decoded instructions to notify of memory writes and mapping changes.
+     */
+    BasicBlockCache* _basicBlockCache = nullptr;
+
+    /**
+     * The function bringing the other components up to date, see setSynchronizationCallback()
+     */
+    SynchronizationCallback _synchronizationCallback;
+
+    /**
+     * Bring some components up to date before they are accessed by the CPU.
+     *
+     * @param components A combination of SynchronizedComponent, nothing is done if it's 0
+     */
+    void synchronizeComponents(int components)
+    {
+        if (components != 0 && _synchronizationCallback)
+        {
+            _synchronizationCallback(components);
+        }
+    }
+
+    /**
+     * Bring the counter of the ticks up to date before the clock of the cartridge can read it.
+     */
+    void synchronizeCartridgeClock()
+    {
+        if (memoryBankController->getClockStateSize() > 0)
+        {
+            synchronizeComponents(SYNCHRONIZE_TICKS_COUNTER);
+        }
+    }
+
+    /**
+     * The address of the fixed work RAM bank
+     */
+    const utils::AddressRange fixedWramAddressRange = utils::AddressRange(0xC000, 0xCFFF);
+
+    /**
+     * The address of the high RAM
+     */
+    const utils::AddressRange highRamAddressRange = utils::AddressRange(0xFF80, 0xFFFE);
+
+    /**
+     * Key of the boot rom when it's mapped over the cartridge.
+     * ROM banks use their bank id as key.
+     */
+    static constexpr int BOOTROM_BANK_KEY = 0x1000;
+
+    /**
+     * Keys equal or above this value identify writable memory.
+     */
+    static constexpr int WRITABLE_BANK_KEY = 0x2000;
+
+    /**
+     * Key of the ROM area when no cartridge is loaded, in which case it behaves as RAM.
+     */
+    static constexpr int UNMAPPED_ROM_BANK_KEY = WRITABLE_BANK_KEY;
+
+    /**
+     * Key of the high RAM.
+     */
+    static constexpr int HIGH_RAM_BANK_KEY = WRITABLE_BANK_KEY + 1;
+
+    /**
+     * Key of the fixed work RAM bank, switchable banks use the following keys.
+     */
+    static constexpr int WORK_RAM_BANK_KEY = WRITABLE_BANK_KEY + 2;
 };
 
 #endif
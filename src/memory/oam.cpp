@@ -9,3 +9,8 @@ void OAM::write(word addr, byte value)
 {
     _memory[addr] = value;
 }
+
+byte* OAM::getData()
+{
+    return _memory.data();
+}
@@ -14,6 +14,11 @@ class OAM
     byte read(word addr) const;
     void write(word addr, byte value);
 
+    /**
+     * @return the underlying memory, written directly by the DMA transfers
+     */
+    byte* getData();
+
     const utils::AddressRange addressRange = utils::AddressRange(0xFE00, 0xFE9F);
 
   private:
@@ -0,0 +1,104 @@
+#include "rom_image.hpp"
+#include "common/utils.hpp"
+#include <map>
+#include <mutex>
+#include <tuple>
+
+#if defined(__linux__) && !defined(__EMSCRIPTEN__)
+#define GBEMULATOR_ROM_IMAGE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+ROMImage::~ROMImage()
+{
+#ifdef GBEMULATOR_ROM_IMAGE_MMAP
+    if (_mapping != nullptr)
+    {
+        munmap(_mapping, _size);
+    }
+#endif
+}
+
+std::shared_ptr<const ROMImage> ROMImage::loadFromFile(const std::string& filepath)
+{
+#ifdef GBEMULATOR_ROM_IMAGE_MMAP
+    int fd = open(filepath.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return nullptr;
+    }
+
+    // The images of the files currently loaded, a file that changed on disk is loaded again
+    typedef std::tuple<dev_t, ino_t, off_t, time_t, long> FileKey;
+    static std::map<FileKey, std::weak_ptr<const ROMImage>> loadedImages;
+    static std::mutex loadedImagesMutex;
+
+    struct stat fileStatus = {};
+    if (fstat(fd, &fileStatus) == 0 && S_ISREG(fileStatus.st_mode) && fileStatus.st_size > 0)
+    {
+        FileKey key(fileStatus.st_dev, fileStatus.st_ino, fileStatus.st_size, fileStatus.st_mtim.tv_sec,
+                    fileStatus.st_mtim.tv_nsec);
+        std::lock_guard<std::mutex> lock(loadedImagesMutex);
+        std::shared_ptr<const ROMImage> loadedImage = loadedImages[key].lock();
+        if (loadedImage != nullptr)
+        {
+            close(fd);
+            return loadedImage;
+        }
+
+        void* mapping = mmap(nullptr, static_cast<size_t>(fileStatus.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        // The mapping stays valid once the file is closed
+        close(fd);
+        if (mapping != MAP_FAILED)
+        {
+            std::shared_ptr<ROMImage> image(new ROMImage());
+            image->_mapping = mapping;
+            image->_data = static_cast<const byte*>(mapping);
+            image->_size = static_cast<size_t>(fileStatus.st_size);
+            image->_hash = utils::computeHash(image->_data, image->_size);
+            for (auto it = loadedImages.begin(); it != loadedImages.end();)
+            {
+                it = it->second.expired() ? loadedImages.erase(it) : std::next(it);
+            }
+            loadedImages[key] = image;
+            return image;
+        }
+    }
+    else
+    {
+        close(fd);
+    }
+#endif
+
+    // Empty files and files that can't be mapped are read in a buffer
+    std::vector<byte> data;
+    if (!utils::readBinaryDataFromFile(filepath, data))
+    {
+        return nullptr;
+    }
+
+    return create(std::move(data));
+}
+
+std::shared_ptr<const ROMImage> ROMImage::create(std::vector<byte> data)
+{
+    std::shared_ptr<ROMImage> image(new ROMImage());
+    image->_buffer = std::move(data);
+    image->useBuffer();
+    return image;
+}
+
+std::shared_ptr<const ROMImage> ROMImage::create(const byte* data, size_t size)
+{
+    return create(std::vector<byte>(data, data + size));
+}
+
+void ROMImage::useBuffer()
+{
+    _data = _buffer.data();
+    _size = _buffer.size();
+    _hash = utils::computeHash(_data, _size);
+}
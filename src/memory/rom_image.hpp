@@ -0,0 +1,117 @@
+#ifndef GBEMULATOR_ROM_IMAGE_HPP
+#define GBEMULATOR_ROM_IMAGE_HPP
+
+#include "common/types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * The immutable content of a ROM, shared by all the cartridges created from it.
+ *
+ * When loaded from a file on Linux, the file is memory-mapped read-only: nothing is copied,
+ * the pages are read from the disk when they are first accessed and the physical memory is shared
+ * with every process mapping the same file. Loading a file whose image is still in use returns this image.
+ * Elsewhere, the content is read once in a buffer owned by the image.
+ *
+ * Images are reference counted through std::shared_ptr, they are released with the last cartridge using them.
+ */
+class ROMImage
+{
+  public:
+    ~ROMImage();
+
+    ROMImage(const ROMImage&) = delete;
+    ROMImage& operator=(const ROMImage&) = delete;
+
+    /**
+     * Load the image of a ROM file.
+     *
+     * @param filepath The path of the file
+     * @return the image, or nullptr if the file can't be read
+     */
+    static std::shared_ptr<const ROMImage> loadFromFile(const std::string& filepath);
+
+    /**
+     * Create an image owning the given data.
+     *
+     * @param data The content of the ROM
+     * @return the image
+     */
+    static std::shared_ptr<const ROMImage> create(std::vector<byte> data);
+
+    /**
+     * Create an image from a copy of the given data.
+     *
+     * @param data The content of the ROM
+     * @param size The size of the content in bytes
+     * @return the image
+     */
+    static std::shared_ptr<const ROMImage> create(const byte* data, size_t size);
+
+    /**
+     * @return the content of the ROM
+     */
+    const byte* data() const
+    {
+        return _data;
+    }
+
+    /**
+     * @return the size of the ROM in bytes
+     */
+    size_t size() const
+    {
+        return _size;
+    }
+
+    byte operator[](size_t index) const
+    {
+        return _data[index];
+    }
+
+    /**
+     * Get the hash of the content, identifying the ROM.
+     * It's computed once when the image is created.
+     *
+     * @return the 64 bits FNV-1a hash of the content
+     */
+    uint64_t getHash() const
+    {
+        return _hash;
+    }
+
+    /**
+     * @return true if the content is mapped from a file, false if it's owned by the image
+     */
+    bool isMemoryMapped() const
+    {
+        return _mapping != nullptr;
+    }
+
+  private:
+    ROMImage() = default;
+
+    /**
+     * Use the content of the buffer owned by the image.
+     */
+    void useBuffer();
+
+    const byte* _data = nullptr;
+    size_t _size = 0;
+    uint64_t _hash = 0;
+
+    /**
+     * The memory where the file is mapped, nullptr if the content is in _buffer
+     */
+    void* _mapping = nullptr;
+
+    /**
+     * The content of the ROM when it's not mapped from a file
+     */
+    std::vector<byte> _buffer;
+};
+
+#endif // GBEMULATOR_ROM_IMAGE_HPP
@@ -56,6 +56,16 @@ class SwitchableMemoryBank
      */
     void write(word addr, byte value);
 
+    /**
+     * Get the memory of the active bank, to access it directly.
+     *
+     * @return the MEM_SIZE bytes of the active bank
+     */
+    byte* getBankData()
+    {
+        return memory[currentBankId].data();
+    }
+
   private:
     /**
      * The underlying memory for all the banks
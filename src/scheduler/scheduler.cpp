@@ -0,0 +1,46 @@
+#include "scheduler.hpp"
+#include <algorithm>
+
+Scheduler::Scheduler()
+{
+    reset();
+}
+
+void Scheduler::reset()
+{
+    _currentCycles = 0;
+    _currentTicks = 0;
+    _eventCycles.fill(NEVER);
+    _nextEventCycles = NEVER;
+}
+
+void Scheduler::schedule(EventType type, int64_t cyclesFromNow)
+{
+    cyclesFromNow = std::max<int64_t>(cyclesFromNow, 0);
+    _eventCycles[type] = cyclesFromNow < NEVER - _currentCycles ? _currentCycles + cyclesFromNow : NEVER;
+    updateNextEvent();
+}
+
+void Scheduler::cancel(EventType type)
+{
+    _eventCycles[type] = NEVER;
+    updateNextEvent();
+}
+
+void Scheduler::updateNextEvent()
+{
+    _nextEventCycles = *std::min_element(_eventCycles.begin(), _eventCycles.end());
+}
+
+int64_t Scheduler::getNextEventCyclesIgnoring(EventType ignoredType) const
+{
+    int64_t nextEventCycles = NEVER;
+    for (int type = 0; type < NUMBER_OF_EVENT_TYPES; ++type)
+    {
+        if (type != ignoredType)
+        {
+            nextEventCycles = std::min(nextEventCycles, _eventCycles[type]);
+        }
+    }
+    return nextEventCycles;
+}
@@ -0,0 +1,159 @@
+#ifndef GBEMULATOR_SCHEDULER_HPP
+#define GBEMULATOR_SCHEDULER_HPP
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+/**
+ * Clock of the emulator and the times of the next events of its components.
+ *
+ * The clock counts cycles on 64 bits, a cycle being a tick of the CPU in the double speed mode of the CGB:
+ * there are 2 cycles per tick at normal speed, so the events of the components clocked by the CPU (timer, DMA)
+ * and of the ones running at normal speed (PPU, APU) can be scheduled exactly in both modes.
+ *
+ * Each component has at most one event scheduled, the time after which it can't be stepped at once
+ * anymore without missing something the CPU could observe (interrupt, mode change, ...).
+ * A component is brought up to date when its event is reached, the others keep running behind the CPU.
+ */
+class Scheduler
+{
+  public:
+    /**
+     * The events that can be scheduled, each type has at most one event at a time.
+     */
+    enum EventType
+    {
+        PPU = 0,
+        TIMER,
+        APU,
+        OAM_DMA,
+        BATTERY_SAVE,
+        /**
+         * The CPU accessed a component, their events need to be computed again
+         */
+        SYNCHRONIZATION,
+        NUMBER_OF_EVENT_TYPES
+    };
+
+    Scheduler();
+
+    /**
+     * Reset the clock to 0 and cancel all the events.
+     */
+    void reset();
+
+    /**
+     * Advance the clock.
+     *
+     * @param cycles The number of cycles elapsed
+     */
+    void advance(int64_t cycles)
+    {
+        _currentCycles += cycles;
+        _currentTicks = _currentCycles / CYCLES_PER_TICK;
+    }
+
+    /**
+     * @return the number of cycles elapsed since the start of the emulator
+     */
+    int64_t getCurrentCycles() const
+    {
+        return _currentCycles;
+    }
+
+    /**
+     * @return the number of ticks at normal speed elapsed since the start of the emulator
+     */
+    int64_t getCurrentTicks() const
+    {
+        return _currentTicks;
+    }
+
+    /**
+     * Get the counter of the ticks at normal speed, for the components that keep a pointer to it.
+     *
+     * @return a pointer to the counter, valid as long as the scheduler exists
+     */
+    const int64_t* getCurrentTicksCounter() const
+    {
+        return &_currentTicks;
+    }
+
+    /**
+     * Schedule the event of a type, it replaces the event previously scheduled.
+     *
+     * @param type              The type of the event
+     * @param cyclesFromNow     The number of cycles from now until the event
+     */
+    void schedule(EventType type, int64_t cyclesFromNow);
+
+    /**
+     * Cancel the event of a type.
+     *
+     * @param type  The type of the event
+     */
+    void cancel(EventType type);
+
+    /**
+     * @param type  The type of the event
+     * @return the time of the event in cycles, NEVER if it isn't scheduled
+     */
+    int64_t getEventCycles(EventType type) const
+    {
+        return _eventCycles[type];
+    }
+
+    /**
+     * @param type  The type of the event
+     * @return true if the event is scheduled and its time is reached
+     */
+    bool isEventDue(EventType type) const
+    {
+        return _eventCycles[type] <= _currentCycles;
+    }
+
+    /**
+     * @return the time in cycles of the earliest event, NEVER if no event is scheduled
+     */
+    int64_t getNextEventCycles() const
+    {
+        return _nextEventCycles;
+    }
+
+    /**
+     * Get the time of the earliest event, without the event of a type.
+     *
+     * @param ignoredType   The type of the event to ignore
+     * @return the time in cycles of the event, NEVER if no other event is scheduled
+     */
+    int64_t getNextEventCyclesIgnoring(EventType ignoredType) const;
+
+    /**
+     * The time of an event that is not scheduled
+     */
+    static constexpr int64_t NEVER = std::numeric_limits<int64_t>::max();
+
+    /**
+     * The number of cycles in a tick at normal speed
+     */
+    static constexpr int64_t CYCLES_PER_TICK = 2;
+
+  private:
+    /**
+     * Find the earliest event.
+     */
+    void updateNextEvent();
+
+    int64_t _currentCycles = 0;
+
+    /**
+     * The number of ticks at normal speed, derived from the cycles
+     */
+    int64_t _currentTicks = 0;
+
+    std::array<int64_t, NUMBER_OF_EVENT_TYPES> _eventCycles;
+    int64_t _nextEventCycles = NEVER;
+};
+
+#endif // GBEMULATOR_SCHEDULER_HPP
@@ -1,47 +1,84 @@
 #include "timer.hpp"
 #include "cpu/cpu.hpp"
+#include <algorithm>
+#include <limits>
 
 const int Timer::DIV_TIMER_CLOCK_DIVIDER = CPU::CLOCK_FREQUENCY_HZ / DIV_REGISTER_FREQUENCY_HZ;
 
 void Timer::tick(int ticks)
 {
-    int cycles = ticks * TICKS_TO_CPU_CYCLES;
-    incrementDivRegister(cycles);
+    _currentCycles += static_cast<int64_t>(ticks) * TICKS_TO_CPU_CYCLES;
 
-    if (isTimerCounterEnabled())
+    // The timer counter is reloaded at each overflow reached, the next one is computed from there
+    while (_currentCycles >= _overflowCycles)
     {
-        incrementTimerCounter(cycles);
+        _timerCounterBaseValue = _timerModulo;
+        _timerCounterBaseCycles = _overflowCycles;
+        _interruptManager->raiseInterrupt(InterruptType::TIMER);
+        scheduleOverflow();
     }
 }
 
-void Timer::incrementTimerCounter(int cycles)
+int Timer::getTicksUntilNextEvent() const
 {
-    _timerCounterCycles += cycles;
+    if (_overflowCycles == NEVER)
+    {
+        return std::numeric_limits<int>::max();
+    }
+
+    int64_t cyclesUntilOverflow = _overflowCycles - _currentCycles;
+    int64_t ticks = (cyclesUntilOverflow + TICKS_TO_CPU_CYCLES - 1) / TICKS_TO_CPU_CYCLES;
+    return static_cast<int>(std::clamp<int64_t>(ticks, 1, std::numeric_limits<int>::max()));
+}
+
+int Timer::getTicksUntilDividerIncrement() const
+{
+    int cyclesUntilIncrement =
+        DIV_TIMER_CLOCK_DIVIDER - static_cast<int>(getInternalCounter() % DIV_TIMER_CLOCK_DIVIDER);
+    return std::max((cyclesUntilIncrement + TICKS_TO_CPU_CYCLES - 1) / TICKS_TO_CPU_CYCLES, 1);
+}
+
+bool Timer::isTimerCounterInputSet() const
+{
+    // The bit watched is the upper half of the period of the timer counter
     int clockDivider = CLOCK_DIVIDER_VALUES[_timerCounterClockDivider];
-    while (_timerCounterCycles >= clockDivider)
+    return _timerCounterEnabled && getInternalCounter() % clockDivider >= clockDivider / 2;
+}
+
+void Timer::updateTimerCounterBase()
+{
+    _timerCounterBaseValue = getTimerCounterValue();
+    _timerCounterBaseCycles = _currentCycles;
+}
+
+void Timer::incrementTimerCounter()
+{
+    int maxTimerValue = 0xFF;
+    if (_timerCounterBaseValue == maxTimerValue)
     {
-        _timerCounterCycles -= clockDivider;
-        int maxTimerValue = 0xFF;
-        if (_timerCounter == maxTimerValue)
-        {
-            _timerCounter = _timerModulo;
-            _interruptManager->raiseInterrupt(InterruptType::TIMER);
-        }
-        else
-        {
-            _timerCounter++;
-        }
+        _timerCounterBaseValue = _timerModulo;
+        _interruptManager->raiseInterrupt(InterruptType::TIMER);
+    }
+    else
+    {
+        _timerCounterBaseValue++;
     }
 }
 
-void Timer::incrementDivRegister(int cycles)
+void Timer::scheduleOverflow()
 {
-    _dividerRegisterCycles += cycles;
-    if (_dividerRegisterCycles >= DIV_TIMER_CLOCK_DIVIDER)
+    if (!_timerCounterEnabled)
     {
-        _dividerRegisterCycles -= DIV_TIMER_CLOCK_DIVIDER;
-        _dividerRegisterValue++;
+        _overflowCycles = NEVER;
+        return;
     }
+
+    // The falling edges happen each time the internal counter reaches a multiple of the clock divider
+    int64_t clockDivider = CLOCK_DIVIDER_VALUES[_timerCounterClockDivider];
+    int64_t baseInternalCounter = _timerCounterBaseCycles - _internalCounterResetCycles;
+    int64_t incrementsUntilOverflow = 0x100 - _timerCounterBaseValue;
+    _overflowCycles =
+        _internalCounterResetCycles + (baseInternalCounter / clockDivider + incrementsUntilOverflow) * clockDivider;
 }
 
 bool Timer::isTimerCounterEnabled()
@@ -56,12 +93,21 @@ byte Timer::getClockDivider()
 
 byte Timer::getDividerRegisterValue() const
 {
-    return _dividerRegisterValue;
+    return static_cast<byte>(getInternalCounter() / DIV_TIMER_CLOCK_DIVIDER);
 }
 
 byte Timer::getTimerCounterValue() const
 {
-    return _timerCounter;
+    if (!_timerCounterEnabled)
+    {
+        return _timerCounterBaseValue;
+    }
+
+    // The overflows are handled by tick(), the counter is below 0x100 here
+    int64_t clockDivider = CLOCK_DIVIDER_VALUES[_timerCounterClockDivider];
+    int64_t baseInternalCounter = _timerCounterBaseCycles - _internalCounterResetCycles;
+    int64_t increments = getInternalCounter() / clockDivider - baseInternalCounter / clockDivider;
+    return static_cast<byte>(_timerCounterBaseValue + increments);
 }
 
 byte Timer::getTimerModuloValue() const
@@ -74,9 +120,25 @@ void Timer::setTimerModuloValue(byte value)
     _timerModulo = value;
 }
 
+void Timer::setTimerControlValue(byte value)
+{
+    updateTimerCounterBase();
+    bool wasInputSet = isTimerCounterInputSet();
+
+    _timerCounterEnabled = utils::isNthBitSet(value, 2);
+    _timerCounterClockDivider = value & 0b00000011;
+
+    // Disabling the timer counter or watching another bit can be a falling edge
+    if (wasInputSet && !isTimerCounterInputSet())
+    {
+        incrementTimerCounter();
+    }
+    scheduleOverflow();
+}
+
 void Timer::enableTimerCounter(bool enable)
 {
-    _timerCounterEnabled = enable;
+    setTimerControlValue(static_cast<byte>(enable << 2 | _timerCounterClockDivider));
 }
 
 void Timer::setClockDivider(byte value)
@@ -85,20 +147,27 @@ void Timer::setClockDivider(byte value)
     {
         return;
     }
-    else
-    {
-        _timerCounterClockDivider = value;
-        // When there's a change of divider, the internal counting needs to be reset.
-        _timerCounterCycles = 0;
-    }
+
+    setTimerControlValue(static_cast<byte>(_timerCounterEnabled << 2 | value));
 }
+
 void Timer::setTimerCounterValue(byte value)
 {
-    _timerCounter = value;
+    _timerCounterBaseValue = value;
+    _timerCounterBaseCycles = _currentCycles;
+    scheduleOverflow();
 }
 
 void Timer::resetDividerRegisterValue()
 {
-    _dividerRegisterValue = 0;
-    _timerCounterCycles = 0;
+    updateTimerCounterBase();
+    bool wasInputSet = isTimerCounterInputSet();
+    _internalCounterResetCycles = _currentCycles;
+
+    // The bit watched by the timer counter is cleared with the internal counter
+    if (wasInputSet)
+    {
+        incrementTimerCounter();
+    }
+    scheduleOverflow();
 }
@@ -2,6 +2,8 @@
 #define GBEMULATOR_TIMER_HPP
 
 #include "memory/mmu.hpp"
+#include <cstdint>
+#include <limits>
 
 class MMU;
 class InterruptManager;
@@ -23,6 +25,11 @@ class InterruptManager;
  *          its base frequency can be chosen from the following options:
  *          4096 Hz, 262144 Hz, 65536 Hz, 16384 Hz.
  *
+ * Both are driven by an internal 16-bit counter incremented every CPU cycle, the divider register is its upper byte
+ * and the timer counter is incremented on the falling edges of one of its bits, chosen by the clock divider.
+ * They aren't incremented one by one: the timer keeps the time its internal counter was reset and the time
+ * the timer counter was last set, their values are derived from the current time when they are read.
+ * The overflow of the timer counter is the only event, its time is computed when the registers change.
  */
 class Timer
 {
@@ -38,12 +45,26 @@ class Timer
 
     /**
      * Inform the timer that a certain number of CPU ticks has elapsed.
-     * This will update the timers according to their internal frequency and parameters.
+     * This advances the clock of the timer and handles the overflows of the timer counter reached.
      *
      * @param ticks     the number of CPU ticks that elapsed
      */
     void tick(int ticks);
 
+    /**
+     * Get the number of ticks until the next overflow of the timer counter, which raises an interrupt.
+     *
+     * @return a number of ticks, at least 1, std::numeric_limits<int>::max() if the timer counter is disabled
+     */
+    int getTicksUntilNextEvent() const;
+
+    /**
+     * Get the number of ticks until the next increment of the divider register.
+     *
+     * @return a number of ticks, at least 1
+     */
+    int getTicksUntilDividerIncrement() const;
+
     /**
      * Get the current value of the divider register.
      *
@@ -52,7 +73,8 @@ class Timer
     byte getDividerRegisterValue() const;
 
     /**
-     * Reset the divider register and associated internal counter to 0.
+     * Reset the divider register and the internal counter to 0.
+     * If the bit of the counter watched by the timer counter was set, this is a falling edge that increments it.
      */
     void resetDividerRegisterValue();
 
@@ -84,6 +106,15 @@ class Timer
      */
     void setTimerModuloValue(byte value);
 
+    /**
+     * Set the timer control register (TAC): the timer counter is enabled by bit 2, bits 0-1 are its clock divider.
+     * If the bit of the internal counter watched by the timer counter goes from set to cleared because of the change,
+     * this is a falling edge that increments it.
+     *
+     * @param value The value written to the register
+     */
+    void setTimerControlValue(byte value);
+
     /**
      * Enable or disable the timer counter.
      */
@@ -147,41 +178,70 @@ class Timer
         256};
 
     /**
-     * Increment the Divider Register value based on the number of CPU cycles elapsed.
-     * @param cycles    The number of CPU cycles elapsed
+     * The time of an overflow of the timer counter that will never happen
      */
-    void incrementDivRegister(int cycles);
+    static constexpr int64_t NEVER = std::numeric_limits<int64_t>::max();
 
     /**
-     * Increment the Timer Counter value based on the number of CPU cycles elapsed.
-     * @param cycles    The number of CPU cycles elapsed
+     * Get the value of the internal counter at the current time, without the wrap around of its 16 bits.
+     * The falling edges of its bits can be counted from it.
+     *
+     * @return the number of CPU cycles since the counter was reset
      */
-    void incrementTimerCounter(int cycles);
+    int64_t getInternalCounter() const
+    {
+        return _currentCycles - _internalCounterResetCycles;
+    }
 
     /**
-     * The number of CPU cycles accumulated for the Divider Register since the last increment of the counter.
+     * @return true if the timer counter is enabled and the bit of the internal counter it watches is set
      */
-    int _dividerRegisterCycles = 0;
+    bool isTimerCounterInputSet() const;
 
     /**
-     * The number of CPU cycles accumulated for the Timer Counter since the last increment of the counter.
+     * Keep the current value of the timer counter as the value it's derived from, before a change of the registers.
      */
-    int _timerCounterCycles = 0;
+    void updateTimerCounterBase();
 
     /**
-     * The value of the clock divider for the Timer Counter.
+     * Increment the timer counter once, it's reloaded with the timer modulo and raises an interrupt when it overflows.
      */
-    byte _timerCounterClockDivider = 0;
+    void incrementTimerCounter();
+
+    /**
+     * Compute the time of the next overflow of the timer counter, from its base value.
+     */
+    void scheduleOverflow();
+
+    /**
+     * The number of CPU cycles elapsed, the clock of the timer advanced by tick()
+     */
+    int64_t _currentCycles = 0;
+
+    /**
+     * The time in CPU cycles the internal counter was last reset
+     */
+    int64_t _internalCounterResetCycles = 0;
 
     /**
-     * The value of the Divider Register.
+     * The value of the timer counter at _timerCounterBaseCycles, it's incremented by the falling edges since then
      */
-    byte _dividerRegisterValue = 0;
+    byte _timerCounterBaseValue = 0;
 
     /**
-     * The value of the Timer Counter.
+     * The time in CPU cycles the timer counter was last set, reloaded or its clock changed
      */
-    byte _timerCounter = 0;
+    int64_t _timerCounterBaseCycles = 0;
+
+    /**
+     * The time in CPU cycles of the next overflow of the timer counter, NEVER if it's disabled
+     */
+    int64_t _overflowCycles = NEVER;
+
+    /**
+     * The value of the clock divider for the Timer Counter.
+     */
+    byte _timerCounterClockDivider = 0;
 
     /**
      * The value of the Timer Modulo.
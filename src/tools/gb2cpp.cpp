@@ -0,0 +1,41 @@
+#include "common/utils.hpp"
+#include "cpu/aot/static_recompiler.hpp"
+#include "memory/cartridge.hpp"
+#include <fstream>
+#include <iostream>
+
+/**
+ * Recompile a ROM ahead of time to a C++ source file.
+ * The generated file needs to be linked in the emulator with gbemulator_core,
+ * the code is then used automatically by the cached interpreter and the JIT when the same ROM is loaded.
+ */
+int main(int argc, char* args[])
+{
+    if (argc != 3)
+    {
+        std::cout << "Usage: " << args[0] << " <rom> <output.cpp>" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::shared_ptr<const ROMImage> image = ROMImage::loadFromFile(args[1]);
+    if (image == nullptr)
+    {
+        std::cerr << "Couldn't read the rom " << args[1] << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    Cartridge cartridge(image);
+    StaticRecompiler recompiler(cartridge);
+
+    std::ofstream output(args[2]);
+    output << recompiler.generateSource();
+    output.close();
+    if (!output.good())
+    {
+        std::cerr << "Couldn't write the output file " << args[2] << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "Recompiled " << recompiler.getBlocks().size() << " blocks of " << cartridge.getTitle() << std::endl;
+    return EXIT_SUCCESS;
+}
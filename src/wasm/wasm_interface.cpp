@@ -55,9 +55,8 @@ extern "C"
 
     EMSCRIPTEN_KEEPALIVE bool loadROM(EmulatorImpl* emulator, const unsigned char* data, int length)
     {
-        std::vector<byte> dataVector(data, data + length);
-
-        if (!emulator->emulator->getMMU().loadCartridgeData(dataVector))
+        // The data is copied once, it belongs to the JavaScript heap
+        if (!emulator->emulator->getMMU().loadCartridge(ROMImage::create(data, static_cast<size_t>(length))))
         {
             return false;
         }
@@ -0,0 +1,297 @@
+#include "cpu/basic_block_cache.hpp"
+#include "cpu/cpu.hpp"
+#include "cpu/instructions.hpp"
+#include "emulator.hpp"
+#include <gtest/gtest.h>
+
+using namespace standardInstructions;
+
+class BasicBlockCacheTest : public ::testing::Test
+{
+  protected:
+    void writeProgram(word addr, const std::vector<byte>& program)
+    {
+        for (size_t i = 0; i < program.size(); ++i)
+        {
+            mmu.write(static_cast<word>(addr + i), program[i]);
+        }
+    }
+
+    MMU mmu;
+    BasicBlockCache cache = BasicBlockCache(mmu);
+};
+
+TEST_F(BasicBlockCacheTest, BlockShouldEndAfterBranchInstruction)
+{
+    writeProgram(0xC000, {LD_B_n, 0x12, LD_HL_nn, 0x34, 0x12, INC_B, JP_nn, 0x00, 0x01, NOP});
+
+    const BasicBlock* block = cache.getBlock(0xC000);
+    ASSERT_NE(block, nullptr);
+    ASSERT_EQ(block->startAddress, 0xC000);
+    ASSERT_EQ(block->size, 9);
+    ASSERT_EQ(block->instructions.size(), 4);
+
+    ASSERT_EQ(block->instructions[0].opCode, LD_B_n);
+    ASSERT_EQ(block->instructions[0].operand, 0x12);
+    ASSERT_EQ(block->instructions[0].length, 2);
+    ASSERT_EQ(block->instructions[0].ticks, 2);
+
+    ASSERT_EQ(block->instructions[1].address, 0xC002);
+    ASSERT_EQ(block->instructions[1].operand, 0x1234);
+    ASSERT_EQ(block->instructions[1].length, 3);
+
+    ASSERT_EQ(block->instructions[3].opCode, JP_nn);
+    ASSERT_EQ(block->instructions[3].operand, 0x0100);
+    ASSERT_EQ(block->instructions[3].ticks, 4);
+}
+
+TEST_F(BasicBlockCacheTest, ExtendedInstructionShouldBeDecodedWithItsOpcodeAsOperand)
+{
+    writeProgram(0xC000, {EXT_OPS, extendedInstructions::BIT_7_H, EXT_OPS, extendedInstructions::BIT_0_HLm, HALT});
+
+    const BasicBlock* block = cache.getBlock(0xC000);
+    ASSERT_NE(block, nullptr);
+    ASSERT_EQ(block->instructions.size(), 3);
+    ASSERT_EQ(block->instructions[0].operand, extendedInstructions::BIT_7_H);
+    ASSERT_EQ(block->instructions[0].ticks, 2);
+    ASSERT_EQ(block->instructions[1].operand, extendedInstructions::BIT_0_HLm);
+    ASSERT_EQ(block->instructions[1].ticks, 3);
+}
+
+TEST_F(BasicBlockCacheTest, InvalidOpcodeShouldNotBeCached)
+{
+    writeProgram(0xC000, {0xD3});
+    ASSERT_EQ(cache.getBlock(0xC000), nullptr);
+    ASSERT_EQ(cache.getNumberOfBlocks(), 0);
+}
+
+TEST_F(BasicBlockCacheTest, IORegistersShouldNotBeCached)
+{
+    ASSERT_EQ(cache.getBlock(0xFF00), nullptr);
+}
+
+TEST_F(BasicBlockCacheTest, GettingTheSameBlockTwiceShouldReuseIt)
+{
+    writeProgram(0xC000, {INC_A, JR_n, 0xFD});
+
+    const BasicBlock* block = cache.getBlock(0xC000);
+    ASSERT_EQ(cache.getBlock(0xC000), block);
+    ASSERT_EQ(cache.getNumberOfBlocks(), 1);
+}
+
+TEST_F(BasicBlockCacheTest, WritingToCodeInRAMShouldInvalidateBlock)
+{
+    mmu.setBasicBlockCache(&cache);
+    writeProgram(0xC000, {INC_A, INC_A, JR_n, 0xFC});
+    writeProgram(0xC100, {INC_A, JR_n, 0xFD});
+    cache.getBlock(0xC000);
+    cache.getBlock(0xC100);
+    uint32_t epoch = cache.getEpoch();
+
+    mmu.write(0xC001, INC_B);
+
+    ASSERT_EQ(cache.getNumberOfBlocks(), 1);
+    ASSERT_NE(cache.getEpoch(), epoch);
+    ASSERT_EQ(cache.getBlock(0xC000)->instructions[1].opCode, INC_B);
+    mmu.setBasicBlockCache(nullptr);
+}
+
+TEST_F(BasicBlockCacheTest, WritingToRAMOutsideOfCodeShouldKeepBlocks)
+{
+    mmu.setBasicBlockCache(&cache);
+    writeProgram(0xC000, {INC_A, JR_n, 0xFD});
+    cache.getBlock(0xC000);
+    uint32_t epoch = cache.getEpoch();
+
+    mmu.write(0xC003, 0x42);
+
+    ASSERT_EQ(cache.getNumberOfBlocks(), 1);
+    ASSERT_EQ(cache.getEpoch(), epoch);
+    mmu.setBasicBlockCache(nullptr);
+}
+
+class CachedInterpreterTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        cpu.setExecutionMode(CPU::ExecutionMode::CACHED_INTERPRETER);
+    }
+
+    void writeProgram(word addr, const std::vector<byte>& program)
+    {
+        for (size_t i = 0; i < program.size(); ++i)
+        {
+            mmu.write(static_cast<word>(addr + i), program[i]);
+        }
+    }
+
+    void executeInstructions(int count)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            cpu.fetchDecodeAndExecute();
+        }
+    }
+
+    MMU mmu;
+    CPU cpu = CPU(mmu);
+};
+
+TEST_F(CachedInterpreterTest, ExecutionShouldMatchInterpreter)
+{
+    MMU interpreterMMU;
+    CPU interpreterCPU(interpreterMMU);
+
+    // Sum of 10 + 9 + ... + 1 in A
+    std::vector<byte> program = {LD_B_n, 10, XOR_A, ADD_A_B, DEC_B, JR_NZ_n, 0xFC, LD_HL_nn, 0x00, 0xD0,
+                                 LD_HLm_A, HALT};
+    writeProgram(0xC000, program);
+    for (size_t i = 0; i < program.size(); ++i)
+    {
+        interpreterMMU.write(static_cast<word>(0xC000 + i), program[i]);
+    }
+    cpu.setProgramCounter(0xC000);
+    interpreterCPU.setProgramCounter(0xC000);
+
+    // The cached interpreter executes several instructions at once, the state is compared when both CPUs reach
+    // the same tick
+    while (!cpu.isHalted())
+    {
+        cpu.fetchDecodeAndExecute();
+        // HALT takes no tick
+        while (interpreterCPU.getCurrentTick() < cpu.getCurrentTick() || interpreterCPU.isHalted() != cpu.isHalted())
+        {
+            interpreterCPU.fetchDecodeAndExecute();
+        }
+
+        ASSERT_EQ(cpu.getCurrentTick(), interpreterCPU.getCurrentTick());
+        ASSERT_EQ(cpu.getProgramCounter(), interpreterCPU.getProgramCounter());
+        ASSERT_EQ(cpu.getRegisterA(), interpreterCPU.getRegisterA());
+        ASSERT_EQ(cpu.getRegisterB(), interpreterCPU.getRegisterB());
+        ASSERT_EQ(cpu.getFlag(), interpreterCPU.getFlag());
+    }
+
+    ASSERT_TRUE(cpu.isHalted());
+    ASSERT_EQ(cpu.getRegisterA(), 55);
+    ASSERT_EQ(mmu.read(0xD000), 55);
+}
+
+TEST_F(CachedInterpreterTest, SelfModifyingCodeShouldExecuteTheNewInstruction)
+{
+    // The program replaces the NOP at 0xC007 by INC A before reaching it
+    writeProgram(0xC000, {LD_HL_nn, 0x07, 0xC0, LD_HLm_n, INC_A, NOP, NOP, NOP, JR_n, 0xFE});
+    cpu.setProgramCounter(0xC000);
+
+    executeInstructions(6);
+
+    ASSERT_EQ(cpu.getRegisterA(), 1);
+    ASSERT_EQ(cpu.getProgramCounter(), 0xC008);
+}
+
+TEST_F(CachedInterpreterTest, BlocksShouldBeKeyedByROMBank)
+{
+    std::vector<byte> rom(64_KiB);
+    rom[0x0147] = Cartridge::CartridgeType::MBC1;
+    // Value 1 corresponds to 64KiB
+    rom[0x0148] = 1;
+    rom[1 * 16_KiB] = INC_A;
+    rom[2 * 16_KiB] = INC_B;
+    ASSERT_TRUE(mmu.loadCartridgeData(rom));
+    // Unmap the bootrom
+    mmu.write(0xFF50, 1);
+
+    cpu.setProgramCounter(0x4000);
+    cpu.fetchDecodeAndExecute();
+    ASSERT_EQ(cpu.getRegisterA(), 1);
+    ASSERT_EQ(cpu.getRegisterB(), 0);
+
+    // Switch to ROM bank 2
+    mmu.write(0x2000, 2);
+    cpu.setProgramCounter(0x4000);
+    cpu.fetchDecodeAndExecute();
+    ASSERT_EQ(cpu.getRegisterA(), 1);
+    ASSERT_EQ(cpu.getRegisterB(), 1);
+
+    ASSERT_EQ(cpu.getBasicBlockCache().getNumberOfBlocks(), 2);
+}
+
+TEST(InstructionDecoderTest, DecodedLengthAndTicksShouldMatchExecution)
+{
+    for (int i = 0; i < 512; ++i)
+    {
+        bool isExtended = i >= 256;
+        byte opCode = static_cast<byte>(i);
+        std::vector<byte> program = {opCode, 0x10, 0x00};
+        if (isExtended)
+        {
+            program = {EXT_OPS, opCode};
+        }
+        else if (InstructionDecoder::getInstructionLength(opCode) == 0)
+        {
+            continue;
+        }
+
+        MMU mmu;
+        CPU cpu(mmu);
+        word addr = 0xC000;
+        for (size_t j = 0; j < program.size(); ++j)
+        {
+            mmu.write(static_cast<word>(addr + j), program[j]);
+        }
+        cpu.setProgramCounter(addr);
+        cpu.setStackPointer(0xD000);
+        DecodedInstruction instruction = InstructionDecoder::decode(mmu, addr);
+
+        int ticks = cpu.fetchDecodeAndExecute();
+
+        bool isBranchTaken = cpu.getProgramCounter() != addr + instruction.length;
+        if (isBranchTaken)
+        {
+            ASSERT_TRUE(InstructionDecoder::isBranch(instruction.opCode)) << "opcode=" << i;
+            ASSERT_EQ(ticks, instruction.branchTicks) << "opcode=" << i;
+        }
+        else
+        {
+            ASSERT_EQ(ticks, instruction.ticks) << "opcode=" << i;
+        }
+    }
+}
+
+TEST(CachedInterpreterRomTest, ExecutionShouldMatchInterpreterOnTestRom)
+{
+    std::string rom = std::string(DATADIR) + "/roms/blargg/02-interrupts.gb";
+    Emulator interpreter;
+    Emulator cachedInterpreter;
+    cachedInterpreter.getCPU().setExecutionMode(CPU::ExecutionMode::CACHED_INTERPRETER);
+    ASSERT_TRUE(interpreter.getMMU().loadCartridgeFromFile(rom));
+    ASSERT_TRUE(cachedInterpreter.getMMU().loadCartridgeFromFile(rom));
+
+    while (cachedInterpreter.getCurrentTicks() < 2000000)
+    {
+        cachedInterpreter.exec();
+        // HALT takes no tick
+        while (interpreter.getCurrentTicks() < cachedInterpreter.getCurrentTicks() ||
+               interpreter.getCPU().isHalted() != cachedInterpreter.getCPU().isHalted())
+        {
+            interpreter.exec();
+        }
+
+        int64_t ticks = cachedInterpreter.getCurrentTicks();
+        ASSERT_EQ(interpreter.getCurrentTicks(), ticks);
+        CPU& expected = interpreter.getCPU();
+        CPU& actual = cachedInterpreter.getCPU();
+        ASSERT_EQ(actual.getProgramCounter(), expected.getProgramCounter()) << "ticks=" << ticks;
+        ASSERT_EQ(actual.getStackPointer(), expected.getStackPointer()) << "ticks=" << ticks;
+        ASSERT_EQ(actual.getRegisterA(), expected.getRegisterA()) << "ticks=" << ticks;
+        ASSERT_EQ(actual.getRegisterB(), expected.getRegisterB()) << "ticks=" << ticks;
+        ASSERT_EQ(actual.getRegisterC(), expected.getRegisterC()) << "ticks=" << ticks;
+        ASSERT_EQ(actual.getRegisterD(), expected.getRegisterD()) << "ticks=" << ticks;
+        ASSERT_EQ(actual.getRegisterE(), expected.getRegisterE()) << "ticks=" << ticks;
+        ASSERT_EQ(actual.getRegisterH(), expected.getRegisterH()) << "ticks=" << ticks;
+        ASSERT_EQ(actual.getRegisterL(), expected.getRegisterL()) << "ticks=" << ticks;
+        ASSERT_EQ(actual.getFlag(), expected.getFlag()) << "ticks=" << ticks;
+    }
+
+    ASSERT_GT(cachedInterpreter.getCPU().getBasicBlockCache().getNumberOfBlocks(), 0);
+}
@@ -80,7 +80,7 @@ TEST(Cartridge, CartridgeDataIsLoadedCorrectly)
 {
     std::vector<byte> data{0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07};
     auto cartridge = Cartridge(data);
-    auto cartridgeData = cartridge.getData();
+    const ROMImage& cartridgeData = cartridge.getData();
     ASSERT_EQ(cartridgeData.size(), data.size());
     for (int i = 0; i < cartridgeData.size(); ++i)
     {
@@ -213,4 +213,13 @@ TEST_F(CartridgeTest, IsColorModeSupportedShouldReturnTrueWhenFlagisColorAndMono
 TEST_F(CartridgeTest, IsColorModeSupportedShouldReturnFalseWhenFlagisMono)
 {
     assertColorModeGivesExpectedResult(0x00, false);
-}
\ No newline at end of file
+}
+TEST(Cartridge, HasBatteryShouldReturnTrueForBatteryBackedCartridges)
+{
+    std::vector<byte> data(0x200);
+    data[0x0147] = Cartridge::CartridgeType::MBC5_RAM_BATTERY;
+    ASSERT_TRUE(Cartridge(data).hasBattery());
+
+    data[0x0147] = Cartridge::CartridgeType::MBC5_RAM;
+    ASSERT_FALSE(Cartridge(data).hasBattery());
+}
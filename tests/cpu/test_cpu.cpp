@@ -212,4 +212,71 @@ TEST_F(CpuTest, GetSetRegisterLShouldChangeValue)
     ASSERT_EQ(cpu.getRegisterL(), 0x00);
     cpu.setRegisterL(value);
     ASSERT_EQ(cpu.getRegisterL(), value);
-}
\ No newline at end of file
+}
+
+TEST_F(CpuTest, GetSetRegisterPairsShouldChangeTheirTwoRegisters)
+{
+    cpu.setRegisterBC(0x1234);
+    cpu.setRegisterDE(0x5678);
+    cpu.setRegisterHL(0x9ABC);
+    ASSERT_EQ(cpu.getRegisterB(), 0x12);
+    ASSERT_EQ(cpu.getRegisterC(), 0x34);
+    ASSERT_EQ(cpu.getRegisterD(), 0x56);
+    ASSERT_EQ(cpu.getRegisterE(), 0x78);
+    ASSERT_EQ(cpu.getRegisterH(), 0x9A);
+    ASSERT_EQ(cpu.getRegisterL(), 0xBC);
+
+    cpu.setRegisterB(0xDE);
+    cpu.setRegisterE(0xF0);
+    cpu.setRegisterL(0x01);
+    ASSERT_EQ(cpu.getRegisterBC(), 0xDE34);
+    ASSERT_EQ(cpu.getRegisterDE(), 0x56F0);
+    ASSERT_EQ(cpu.getRegisterHL(), 0x9A01);
+}
+
+TEST_F(CpuTest, SetRegisterAFShouldClearTheLowerBitsOfTheFlag)
+{
+    cpu.setRegisterAF(0x12FF);
+    ASSERT_EQ(cpu.getRegisterA(), 0x12);
+    ASSERT_EQ(cpu.getFlag(), 0xF0);
+    ASSERT_EQ(cpu.getRegisterAF(), 0x12F0);
+}
+
+TEST_F(CpuInstructionTest, IncrementAfterArithmeticOperationShouldKeepItsCarry)
+{
+    cpu.setRegisterA(0xFF);
+    cpu.setRegisterB(0x01);
+    mmu.write(0x00, standardInstructions::ADD_A_B);
+    mmu.write(0x01, standardInstructions::INC_B);
+    cpu.fetchDecodeAndExecute();
+    ASSERT_EQ(cpu.getFlag(), CPU::CpuFlags::ZERO | CPU::CpuFlags::HALF_CARRY | CPU::CpuFlags::CARRY);
+    cpu.fetchDecodeAndExecute();
+    ASSERT_EQ(cpu.getFlag(), CPU::CpuFlags::CARRY);
+}
+
+TEST_F(CpuInstructionTest, PushAFAfterArithmeticOperationShouldPushItsFlags)
+{
+    cpu.setStackPointer(0xDFF0);
+    cpu.setRegisterA(0x10);
+    mmu.write(0x00, standardInstructions::SUB_A_n);
+    mmu.write(0x01, 0x20);
+    mmu.write(0x02, standardInstructions::PUSH_AF);
+    cpu.fetchDecodeAndExecute();
+    cpu.fetchDecodeAndExecute();
+    ASSERT_EQ(mmu.read(0xDFEF), 0xF0);
+    ASSERT_EQ(mmu.read(0xDFEE), CPU::CpuFlags::SUBSTRACTION | CPU::CpuFlags::CARRY);
+}
+
+TEST_F(CpuInstructionTest, PopAFAfterArithmeticOperationShouldOverwriteItsFlags)
+{
+    cpu.setStackPointer(0xDFEE);
+    mmu.write(0xDFEE, CPU::CpuFlags::HALF_CARRY);
+    mmu.write(0xDFEF, 0x42);
+    mmu.write(0x00, standardInstructions::CP_n);
+    mmu.write(0x01, 0x01);
+    mmu.write(0x02, standardInstructions::POP_AF);
+    cpu.fetchDecodeAndExecute();
+    cpu.fetchDecodeAndExecute();
+    ASSERT_EQ(cpu.getRegisterA(), 0x42);
+    ASSERT_EQ(cpu.getFlag(), CPU::CpuFlags::HALF_CARRY);
+}
@@ -0,0 +1,120 @@
+#include "cpu/instructions.hpp"
+#include "emulator.hpp"
+#include <gtest/gtest.h>
+
+using namespace standardInstructions;
+
+class DoubleSpeedTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        loadCartridge(0xC0);
+    }
+
+    void loadCartridge(byte cgbFlag)
+    {
+        std::vector<byte> data(2 * 0x4000);
+        data[0x0143] = cgbFlag;
+        ASSERT_TRUE(mmu().loadCartridgeData(data));
+        mmu().write(0xFF50, 0x01);
+        emulator.getCPU().setIdleLoopDetectionEnabled(false);
+
+        // STOP then NOPs, the work RAM is cleared
+        mmu().write(0xC000, STOP);
+        mmu().write(0xC001, 0x00);
+        emulator.getCPU().setProgramCounter(0xC000);
+    }
+
+    MMU& mmu()
+    {
+        return emulator.getMMU();
+    }
+
+    /**
+     * Execute instructions until the CPU executed the given number of ticks.
+     */
+    void executeCPUTicks(int ticks)
+    {
+        int executedTicks = 0;
+        while (executedTicks < ticks)
+        {
+            executedTicks += emulator.getCPU().fetchDecodeAndExecute();
+        }
+    }
+
+    Emulator emulator;
+};
+
+TEST_F(DoubleSpeedTest, SpeedSwitchShouldBePreparedThroughKEY1)
+{
+    ASSERT_EQ(mmu().read(0xFF4D), 0x7E);
+    mmu().write(0xFF4D, 0x01);
+    ASSERT_EQ(mmu().read(0xFF4D), 0x7F);
+    mmu().write(0xFF4D, 0x00);
+    ASSERT_EQ(mmu().read(0xFF4D), 0x7E);
+}
+
+TEST_F(DoubleSpeedTest, StopShouldSwitchTheSpeedAndStopTheCPU)
+{
+    mmu().write(0xFF4D, 0x01);
+    emulator.exec();
+
+    ASSERT_TRUE(mmu().isDoubleSpeedEnabled());
+    ASSERT_EQ(mmu().read(0xFF4D), 0xFE);
+    ASSERT_EQ(emulator.getCPU().getProgramCounter(), 0xC002);
+    ASSERT_EQ(emulator.getCurrentTicks(), 2050);
+    // The divider register is reset by the switch, then counts the CPU ticks spent stopped
+    ASSERT_EQ(mmu().read(0xFF04), 2 * 2050 / 64);
+}
+
+TEST_F(DoubleSpeedTest, StopShouldNotSwitchTheSpeedIfNotPrepared)
+{
+    emulator.exec();
+
+    ASSERT_FALSE(mmu().isDoubleSpeedEnabled());
+    ASSERT_EQ(emulator.getCurrentTicks(), 0);
+}
+
+TEST_F(DoubleSpeedTest, StopShouldNotSwitchTheSpeedInMonochromeMode)
+{
+    loadCartridge(0x00);
+    mmu().write(0xFF4D, 0x01);
+    emulator.exec();
+
+    ASSERT_FALSE(mmu().isDoubleSpeedEnabled());
+    ASSERT_EQ(mmu().read(0xFF4D), 0xFF);
+}
+
+TEST_F(DoubleSpeedTest, CPUAndTimerShouldRunTwiceAsFastAsThePPU)
+{
+    mmu().write(0xFF4D, 0x01);
+    emulator.exec();
+    int ticksAfterSwitch = emulator.getCurrentTicks();
+    mmu().write(0xFF04, 0x00);
+    int line = mmu().read(0xFF44);
+
+    // A line of the PPU takes 456 ticks at normal speed
+    executeCPUTicks(2 * 456 * 2);
+
+    ASSERT_EQ(emulator.getCurrentTicks() - ticksAfterSwitch, 456 * 2);
+    ASSERT_EQ(mmu().read(0xFF44), (line + 2) % 154);
+    // The divider register is incremented every 64 CPU ticks
+    ASSERT_EQ(mmu().read(0xFF04), 2 * 456 * 2 / 64);
+}
+
+TEST_F(DoubleSpeedTest, SecondSwitchShouldGoBackToNormalSpeed)
+{
+    mmu().write(0xC002, STOP);
+    mmu().write(0xC003, 0x00);
+    mmu().write(0xFF4D, 0x01);
+    emulator.exec();
+    mmu().write(0xFF4D, 0x01);
+    emulator.exec();
+    ASSERT_FALSE(mmu().isDoubleSpeedEnabled());
+    ASSERT_EQ(mmu().read(0xFF4D), 0x7E);
+    int ticksAfterSwitch = emulator.getCurrentTicks();
+
+    executeCPUTicks(100);
+    ASSERT_EQ(emulator.getCurrentTicks() - ticksAfterSwitch, 100);
+}
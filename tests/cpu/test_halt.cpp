@@ -0,0 +1,176 @@
+#include "cpu/cpu.hpp"
+#include "cpu/instructions.hpp"
+#include "emulator.hpp"
+#include <gtest/gtest.h>
+
+using namespace standardInstructions;
+
+class HaltTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        // The reference emulator steps the components one tick at a time when halted
+        referenceEmulator.getCPU().setNextEventCallback(nullptr);
+        for (Emulator* emulator : {&emulator, &referenceEmulator})
+        {
+            emulator->getCPU().setIdleLoopDetectionEnabled(false);
+            emulator->getCPU().setStackPointer(0xDFF0);
+        }
+    }
+
+    void writeProgram(word addr, const std::vector<byte>& program)
+    {
+        for (Emulator* emulator : {&emulator, &referenceEmulator})
+        {
+            for (size_t i = 0; i < program.size(); ++i)
+            {
+                emulator->getMMU().write(static_cast<word>(addr + i), program[i]);
+            }
+            emulator->getCPU().setProgramCounter(addr);
+        }
+    }
+
+    void writeMemory(word addr, byte value)
+    {
+        emulator.getMMU().write(addr, value);
+        referenceEmulator.getMMU().write(addr, value);
+    }
+
+    /**
+     * Run both emulators for the given number of ticks,
+     * the state is compared everytime both emulators reach the same tick.
+     */
+    void runAndCompare(long ticks)
+    {
+        while (emulator.getCurrentTicks() < ticks)
+        {
+            emulator.exec();
+            while (referenceEmulator.getCurrentTicks() < emulator.getCurrentTicks() ||
+                   referenceEmulator.getCPU().isHalted() != emulator.getCPU().isHalted())
+            {
+                referenceEmulator.exec();
+            }
+
+            ASSERT_EQ(emulator.getCurrentTicks(), referenceEmulator.getCurrentTicks());
+            ASSERT_EQ(emulator.getCPU().getProgramCounter(), referenceEmulator.getCPU().getProgramCounter())
+                << "ticks=" << emulator.getCurrentTicks();
+            ASSERT_EQ(emulator.getCPU().getRegisterB(), referenceEmulator.getCPU().getRegisterB());
+            ASSERT_EQ(emulator.getMMU().read(0xFF44), referenceEmulator.getMMU().read(0xFF44));
+            ASSERT_EQ(emulator.getMMU().read(0xFF41), referenceEmulator.getMMU().read(0xFF41));
+            ASSERT_EQ(emulator.getMMU().read(0xFF04), referenceEmulator.getMMU().read(0xFF04));
+            ASSERT_EQ(emulator.getMMU().read(0xFF05), referenceEmulator.getMMU().read(0xFF05));
+            ASSERT_EQ(emulator.getMMU().read(0xFF0F), referenceEmulator.getMMU().read(0xFF0F));
+        }
+    }
+
+    int countExecCalls(Emulator& e, long ticks)
+    {
+        int calls = 0;
+        while (e.getCurrentTicks() < ticks)
+        {
+            e.exec();
+            calls++;
+        }
+        return calls;
+    }
+
+    Emulator emulator;
+    Emulator referenceEmulator;
+};
+
+TEST_F(HaltTest, HaltShouldWakeUpOnVBlankAtTheSameTick)
+{
+    // Count the vertical blank interrupts, the handler returns to the HALT
+    writeMemory(0xFF40, 0x91);
+    writeMemory(0xFFFF, 0x01);
+    writeProgram(0x0040, {INC_B, RETI});
+    writeProgram(0xC000, {EI, HALT, JR_n, 0xFD});
+
+    runAndCompare(5 * 70224);
+
+    ASSERT_GE(emulator.getCPU().getRegisterB(), 4);
+}
+
+TEST_F(HaltTest, HaltShouldWakeUpOnTimerAndStatAtTheSameTick)
+{
+    writeMemory(0xFF40, 0x91);
+    writeMemory(0xFF41, 0x48);
+    writeMemory(0xFF45, 0x30);
+    writeMemory(0xFF06, 0xC0);
+    writeMemory(0xFF07, 0x05);
+    writeMemory(0xFFFF, 0x06);
+    writeProgram(0x0048, {INC_B, RETI});
+    writeProgram(0x0050, {INC_B, RETI});
+    writeProgram(0xC000, {EI, HALT, JR_n, 0xFD});
+
+    runAndCompare(3 * 70224);
+
+    ASSERT_GT(emulator.getCPU().getRegisterB(), 0);
+}
+
+TEST_F(HaltTest, HaltShouldGenerateTheSameAudio)
+{
+    // Play a high frequency square wave with a length timer and a wave on channel 3
+    writeMemory(0xFF26, 0x80);
+    writeMemory(0xFF24, 0x77);
+    writeMemory(0xFF25, 0xFF);
+    writeMemory(0xFF11, 0x80);
+    writeMemory(0xFF12, 0xF1);
+    writeMemory(0xFF13, 0xF8);
+    writeMemory(0xFF14, 0xC7);
+    writeMemory(0xFF1A, 0x80);
+    writeMemory(0xFF1C, 0x20);
+    writeMemory(0xFF1D, 0xF0);
+    writeMemory(0xFF30, 0x1F);
+    writeMemory(0xFF1E, 0x87);
+    writeMemory(0xFF40, 0x91);
+    writeMemory(0xFFFF, 0x01);
+    writeProgram(0x0040, {RETI});
+    writeProgram(0xC000, {EI, HALT, JR_n, 0xFD});
+
+    runAndCompare(2 * 70224);
+
+    ASSERT_EQ(emulator.getAPU().getAudioBuffer(), referenceEmulator.getAPU().getAudioBuffer());
+}
+
+TEST_F(HaltTest, HaltShouldStepComponentsUpToTheNextEvent)
+{
+    writeMemory(0xFF40, 0x91);
+    writeMemory(0xFFFF, 0x01);
+    writeProgram(0x0040, {RETI});
+    writeProgram(0xC000, {EI, HALT, JR_n, 0xFD});
+
+    int calls = countExecCalls(emulator, 70224);
+    int referenceCalls = countExecCalls(referenceEmulator, 70224);
+
+    ASSERT_LT(calls * 10, referenceCalls);
+}
+
+TEST(HaltRomTest, ExecutionShouldMatchSteppingOneTickAtATimeOnTestRom)
+{
+    std::string rom = std::string(DATADIR) + "/roms/blargg/02-interrupts.gb";
+    Emulator reference;
+    Emulator emulator;
+    reference.getCPU().setNextEventCallback(nullptr);
+    ASSERT_TRUE(reference.getMMU().loadCartridgeFromFile(rom));
+    ASSERT_TRUE(emulator.getMMU().loadCartridgeFromFile(rom));
+
+    while (emulator.getCurrentTicks() < 2000000)
+    {
+        emulator.exec();
+        while (reference.getCurrentTicks() < emulator.getCurrentTicks() ||
+               reference.getCPU().isHalted() != emulator.getCPU().isHalted())
+        {
+            reference.exec();
+        }
+
+        ASSERT_EQ(emulator.getCurrentTicks(), reference.getCurrentTicks());
+        ASSERT_EQ(emulator.getCPU().getProgramCounter(), reference.getCPU().getProgramCounter())
+            << "ticks=" << emulator.getCurrentTicks();
+        ASSERT_EQ(emulator.getCPU().getRegisterA(), reference.getCPU().getRegisterA())
+            << "ticks=" << emulator.getCurrentTicks();
+    }
+
+    ASSERT_EQ(emulator.getPPU().getLastRenderedFrame().getData(), reference.getPPU().getLastRenderedFrame().getData());
+}
@@ -0,0 +1,173 @@
+#include "cpu/cpu.hpp"
+#include "cpu/idle_loop_detector.hpp"
+#include "cpu/instructions.hpp"
+#include "emulator.hpp"
+#include <gtest/gtest.h>
+
+using namespace standardInstructions;
+
+class IdleLoopDetectorTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        referenceEmulator.getCPU().setIdleLoopDetectionEnabled(false);
+        for (Emulator* emulator : {&emulator, &referenceEmulator})
+        {
+            // Turn the LCD on so that LY changes
+            emulator->getMMU().write(0xFF40, 0x91);
+            emulator->getCPU().setStackPointer(0xDFF0);
+        }
+    }
+
+    void writeProgram(word addr, const std::vector<byte>& program)
+    {
+        for (Emulator* emulator : {&emulator, &referenceEmulator})
+        {
+            for (size_t i = 0; i < program.size(); ++i)
+            {
+                emulator->getMMU().write(static_cast<word>(addr + i), program[i]);
+            }
+            emulator->getCPU().setProgramCounter(addr);
+        }
+    }
+
+    /**
+     * Run both emulators until they are halted,
+     * the state is compared everytime both emulators reach the same tick.
+     */
+    void runAndCompareUntilHalted()
+    {
+        while (!emulator.getCPU().isHalted())
+        {
+            emulator.exec();
+            // HALT takes no tick
+            while (referenceEmulator.getCurrentTicks() < emulator.getCurrentTicks() ||
+                   referenceEmulator.getCPU().isHalted() != emulator.getCPU().isHalted())
+            {
+                referenceEmulator.exec();
+            }
+
+            compareState();
+        }
+    }
+
+    void compareState()
+    {
+        CPU& expected = referenceEmulator.getCPU();
+        CPU& actual = emulator.getCPU();
+        ASSERT_EQ(emulator.getCurrentTicks(), referenceEmulator.getCurrentTicks());
+        ASSERT_EQ(actual.getProgramCounter(), expected.getProgramCounter()) << "ticks=" << emulator.getCurrentTicks();
+        ASSERT_EQ(actual.getStackPointer(), expected.getStackPointer()) << "ticks=" << emulator.getCurrentTicks();
+        ASSERT_EQ(actual.getRegisterA(), expected.getRegisterA()) << "ticks=" << emulator.getCurrentTicks();
+        ASSERT_EQ(actual.getRegisterB(), expected.getRegisterB()) << "ticks=" << emulator.getCurrentTicks();
+        ASSERT_EQ(actual.getRegisterC(), expected.getRegisterC()) << "ticks=" << emulator.getCurrentTicks();
+        ASSERT_EQ(actual.getRegisterD(), expected.getRegisterD()) << "ticks=" << emulator.getCurrentTicks();
+        ASSERT_EQ(actual.getRegisterE(), expected.getRegisterE()) << "ticks=" << emulator.getCurrentTicks();
+        ASSERT_EQ(actual.getRegisterH(), expected.getRegisterH()) << "ticks=" << emulator.getCurrentTicks();
+        ASSERT_EQ(actual.getRegisterL(), expected.getRegisterL()) << "ticks=" << emulator.getCurrentTicks();
+        ASSERT_EQ(actual.getFlag(), expected.getFlag()) << "ticks=" << emulator.getCurrentTicks();
+        ASSERT_EQ(emulator.getMMU().read(0xFF44), referenceEmulator.getMMU().read(0xFF44));
+        ASSERT_EQ(emulator.getMMU().read(0xFF41), referenceEmulator.getMMU().read(0xFF41));
+    }
+
+    const IdleLoopDetector::Statistics& getStatistics()
+    {
+        return emulator.getCPU().getIdleLoopDetector().getStatistics();
+    }
+
+    Emulator emulator;
+    Emulator referenceEmulator;
+};
+
+TEST_F(IdleLoopDetectorTest, LoopPollingLYShouldBeFastForwarded)
+{
+    // Wait for the start of the vertical blank twice
+    std::vector<byte> program = {LD_D_n, 0x02,    LDH_A_nm, 0x44, CP_n,  0x90, JR_NZ_n, 0xFA,
+                                 LDH_A_nm, 0x44, CP_n,     0x90, JR_Z_n, 0xFA, DEC_D,  JR_NZ_n,
+                                 0xF1,     HALT};
+    writeProgram(0xC000, program);
+
+    runAndCompareUntilHalted();
+
+    ASSERT_GT(getStatistics().numberOfDetectedLoops, 0);
+    ASSERT_GT(getStatistics().skippedTicks, 10000);
+}
+
+TEST_F(IdleLoopDetectorTest, LoopPollingSTATWithMaskShouldBeFastForwarded)
+{
+    // Wait for the horizontal blank of 0x40 lines
+    std::vector<byte> program = {LD_D_n,  0x40, LD_C_n, 0x41, LD_A_Cm, AND_n, 0x03, JR_NZ_n, 0xFB,
+                                 LD_A_Cm, AND_n, 0x03, JR_Z_n, 0xFB,   DEC_D, JR_NZ_n, 0xF3,  HALT};
+    writeProgram(0xC000, program);
+
+    runAndCompareUntilHalted();
+
+    ASSERT_GT(getStatistics().skippedTicks, 0);
+}
+
+TEST_F(IdleLoopDetectorTest, LoopPollingInterruptFlagShouldStopAtTheInterrupt)
+{
+    // Wait for the vertical blank interrupt flag to be set without servicing it
+    std::vector<byte> program = {XOR_A, LDH_nm_A, 0x0F, LDH_A_nm, 0x0F, AND_n, 0x01, JR_Z_n, 0xFA, HALT};
+    writeProgram(0xC000, program);
+
+    runAndCompareUntilHalted();
+
+    ASSERT_GT(getStatistics().skippedTicks, 0);
+}
+
+TEST_F(IdleLoopDetectorTest, CountingLoopShouldNotBeFastForwarded)
+{
+    std::vector<byte> program = {LD_B_n, 0x00, LD_C_n, 0x10, DEC_B, JR_NZ_n, 0xFD, DEC_C, JR_NZ_n, 0xFA, HALT};
+    writeProgram(0xC000, program);
+
+    runAndCompareUntilHalted();
+
+    ASSERT_EQ(getStatistics().numberOfDetectedLoops, 0);
+    ASSERT_EQ(getStatistics().skippedTicks, 0);
+}
+
+TEST_F(IdleLoopDetectorTest, LoopReadingRAMShouldNotBeFastForwarded)
+{
+    // The value polled in the work RAM is changed by the loop writing it from the outside
+    std::vector<byte> program = {LD_HL_nn, 0x00, 0xD0, LD_A_HLm, INC_B, JR_NZ_n, 0xFC, INC_HLm, LD_A_HLm,
+                                 CP_n,     0x10, JR_NZ_n, 0xF6, HALT};
+    writeProgram(0xC000, program);
+
+    runAndCompareUntilHalted();
+
+    ASSERT_EQ(getStatistics().numberOfDetectedLoops, 0);
+}
+
+TEST(IdleLoopDetectorRomTest, ExecutionShouldMatchWithoutDetectionOnTestRom)
+{
+    std::string rom = std::string(DATADIR) + "/roms/mooneye/acceptance/timer/tim00.gb";
+    Emulator reference;
+    Emulator emulator;
+    reference.getCPU().setIdleLoopDetectionEnabled(false);
+    ASSERT_TRUE(reference.getMMU().loadCartridgeFromFile(rom));
+    ASSERT_TRUE(emulator.getMMU().loadCartridgeFromFile(rom));
+
+    while (emulator.getCurrentTicks() < 2000000)
+    {
+        emulator.exec();
+        // HALT takes no tick
+        while (reference.getCurrentTicks() < emulator.getCurrentTicks() ||
+               reference.getCPU().isHalted() != emulator.getCPU().isHalted())
+        {
+            reference.exec();
+        }
+
+        CPU& expected = reference.getCPU();
+        CPU& actual = emulator.getCPU();
+        ASSERT_EQ(emulator.getCurrentTicks(), reference.getCurrentTicks());
+        ASSERT_EQ(actual.getProgramCounter(), expected.getProgramCounter()) << "ticks=" << emulator.getCurrentTicks();
+        ASSERT_EQ(actual.getRegisterA(), expected.getRegisterA()) << "ticks=" << emulator.getCurrentTicks();
+        ASSERT_EQ(actual.getFlag(), expected.getFlag()) << "ticks=" << emulator.getCurrentTicks();
+    }
+
+    ASSERT_GT(emulator.getCPU().getIdleLoopDetector().getStatistics().skippedTicks, 0);
+    ASSERT_EQ(emulator.getPPU().getFrameId(), reference.getPPU().getFrameId());
+    ASSERT_EQ(emulator.getPPU().getLastRenderedFrame().getData(), reference.getPPU().getLastRenderedFrame().getData());
+}
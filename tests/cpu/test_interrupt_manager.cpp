@@ -0,0 +1,84 @@
+#include "cpu/cpu.hpp"
+#include "cpu/interrupt_manager.hpp"
+#include <gtest/gtest.h>
+
+class InterruptManagerTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        cpu.setStackPointer(0xFFFE);
+        cpu.setProgramCounter(0x1234);
+    }
+
+    MMU mmu;
+    CPU cpu = CPU(mmu);
+    InterruptManager& interruptManager = *cpu.getInterruptManager();
+};
+
+TEST_F(InterruptManagerTest, InterruptShouldNotBeHandledWithoutInterruptMasterEnable)
+{
+    interruptManager.setInterruptEnableFlag(0x1F);
+    interruptManager.raiseInterrupt(InterruptType::TIMER);
+    ASSERT_TRUE(interruptManager.isAnyEnabledInterruptPending());
+    ASSERT_FALSE(interruptManager.hasInterruptToHandle());
+    ASSERT_FALSE(interruptManager.handleInterrupts());
+    ASSERT_EQ(cpu.getProgramCounter(), 0x1234);
+
+    interruptManager.setInterruptMasterEnable(true);
+    ASSERT_TRUE(interruptManager.hasInterruptToHandle());
+}
+
+TEST_F(InterruptManagerTest, InterruptShouldNotBeHandledWhenNotEnabled)
+{
+    interruptManager.setInterruptMasterEnable(true);
+    interruptManager.raiseInterrupt(InterruptType::TIMER);
+    ASSERT_FALSE(interruptManager.isAnyEnabledInterruptPending());
+    ASSERT_FALSE(interruptManager.hasInterruptToHandle());
+
+    interruptManager.setInterruptEnableFlag(0x04);
+    ASSERT_TRUE(interruptManager.hasInterruptToHandle());
+    interruptManager.setInterruptFlag(0x00);
+    ASSERT_FALSE(interruptManager.hasInterruptToHandle());
+}
+
+TEST_F(InterruptManagerTest, HandlingInterruptShouldCallItsRoutineAndDisableInterrupts)
+{
+    interruptManager.setInterruptMasterEnable(true);
+    interruptManager.setInterruptEnableFlag(0x1F);
+    interruptManager.raiseInterrupt(InterruptType::SERIAL);
+
+    ASSERT_TRUE(interruptManager.handleInterrupts());
+    ASSERT_EQ(cpu.getProgramCounter(), 0x58);
+    ASSERT_EQ(cpu.getStackPointer(), 0xFFFC);
+    ASSERT_EQ(mmu.readWord(0xFFFC), 0x1234);
+    ASSERT_FALSE(interruptManager.isInterruptPending(InterruptType::SERIAL));
+    ASSERT_FALSE(interruptManager.isInterruptMasterEnabled());
+    ASSERT_FALSE(interruptManager.hasInterruptToHandle());
+}
+
+TEST_F(InterruptManagerTest, InterruptsShouldBeHandledByPriority)
+{
+    interruptManager.setInterruptEnableFlag(0x1F);
+    interruptManager.setInterruptFlag(0x1F);
+
+    std::vector<word> routineAddresses;
+    for (int i = 0; i < 5; ++i)
+    {
+        interruptManager.setInterruptMasterEnable(true);
+        ASSERT_TRUE(interruptManager.handleInterrupts());
+        routineAddresses.push_back(cpu.getProgramCounter());
+    }
+
+    ASSERT_EQ(routineAddresses, std::vector<word>({0x40, 0x48, 0x50, 0x58, 0x60}));
+    ASSERT_EQ(interruptManager.getInterruptFlag(), 0x00);
+}
+
+TEST_F(InterruptManagerTest, UnusedFlagBitsShouldNotBeHandled)
+{
+    interruptManager.setInterruptMasterEnable(true);
+    interruptManager.setInterruptEnableFlag(0xFF);
+    interruptManager.setInterruptFlag(0xE0);
+    ASSERT_FALSE(interruptManager.hasInterruptToHandle());
+    ASSERT_FALSE(interruptManager.handleInterrupts());
+}
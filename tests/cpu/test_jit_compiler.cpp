@@ -0,0 +1,219 @@
+#include "cpu/cpu.hpp"
+#include "cpu/instructions.hpp"
+#include "cpu/jit/jit_compiler.hpp"
+#include "emulator.hpp"
+#include <gtest/gtest.h>
+
+using namespace standardInstructions;
+
+class JitCompilerTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        if (!JitCompiler::isSupported())
+        {
+            GTEST_SKIP() << "The JIT is not supported on this platform";
+        }
+
+        jitCPU.setExecutionMode(CPU::ExecutionMode::JIT);
+        jitCPU.setStackPointer(0xDFF0);
+        interpreterCPU.setStackPointer(0xDFF0);
+    }
+
+    void writeProgram(word addr, const std::vector<byte>& program)
+    {
+        for (size_t i = 0; i < program.size(); ++i)
+        {
+            jitMMU.write(static_cast<word>(addr + i), program[i]);
+            interpreterMMU.write(static_cast<word>(addr + i), program[i]);
+        }
+        jitCPU.setProgramCounter(addr);
+        interpreterCPU.setProgramCounter(addr);
+    }
+
+    /**
+     * Run the program on both CPUs until they are halted,
+     * the state is compared everytime both CPUs reach the same tick.
+     */
+    void runAndCompareUntilHalted()
+    {
+        while (!jitCPU.isHalted())
+        {
+            jitCPU.fetchDecodeAndExecute();
+            // HALT takes no tick
+            while (interpreterCPU.getCurrentTick() < jitCPU.getCurrentTick() ||
+                   interpreterCPU.isHalted() != jitCPU.isHalted())
+            {
+                interpreterCPU.fetchDecodeAndExecute();
+            }
+
+            ASSERT_EQ(jitCPU.getCurrentTick(), interpreterCPU.getCurrentTick());
+            ASSERT_EQ(jitCPU.getProgramCounter(), interpreterCPU.getProgramCounter());
+            ASSERT_EQ(jitCPU.getStackPointer(), interpreterCPU.getStackPointer());
+            ASSERT_EQ(jitCPU.getRegisterA(), interpreterCPU.getRegisterA()) << "pc=" << jitCPU.getProgramCounter();
+            ASSERT_EQ(jitCPU.getRegisterB(), interpreterCPU.getRegisterB());
+            ASSERT_EQ(jitCPU.getRegisterC(), interpreterCPU.getRegisterC());
+            ASSERT_EQ(jitCPU.getRegisterD(), interpreterCPU.getRegisterD());
+            ASSERT_EQ(jitCPU.getRegisterE(), interpreterCPU.getRegisterE());
+            ASSERT_EQ(jitCPU.getRegisterH(), interpreterCPU.getRegisterH());
+            ASSERT_EQ(jitCPU.getRegisterL(), interpreterCPU.getRegisterL());
+            ASSERT_EQ(jitCPU.getFlag(), interpreterCPU.getFlag()) << "pc=" << jitCPU.getProgramCounter();
+        }
+
+        ASSERT_TRUE(interpreterCPU.isHalted());
+        ASSERT_GT(jitCPU.getJitCompiler().getNumberOfCompiledBlocks(), 0);
+    }
+
+    MMU jitMMU;
+    CPU jitCPU = CPU(jitMMU);
+    MMU interpreterMMU;
+    CPU interpreterCPU = CPU(interpreterMMU);
+};
+
+TEST_F(JitCompilerTest, ArithmeticAndLogicalOperationsShouldMatchInterpreter)
+{
+    // Every operation is applied on all the combinations of D and E,
+    // each operation is in its own block so that the flags can be compared
+    std::vector<byte> program;
+    for (byte operation : {ADD_A_E, ADC_A_E, SUB_A_E, SBC_A_E, AND_E, XOR_E, OR_E, CP_E})
+    {
+        program.insert(program.end(), {LD_A_D, operation, JR_n, 0x00});
+    }
+    program.insert(program.end(), {INC_E, JR_NZ_n, static_cast<byte>(-(static_cast<int>(program.size()) + 3))});
+    program.insert(program.end(), {INC_D, JR_NZ_n, static_cast<byte>(-(static_cast<int>(program.size()) + 3)), HALT});
+    writeProgram(0xC000, program);
+
+    runAndCompareUntilHalted();
+}
+
+TEST_F(JitCompilerTest, RegisterOperationsShouldMatchInterpreter)
+{
+    std::vector<byte> program = {LD_A_D, INC_A,  JR_n,   0x00,   LD_A_E, DEC_A,  JR_n,   0x00,     LD_A_D, RL_A,
+                                 JR_n,   0x00,   LD_A_E, RR_A,    JR_n,   0x00,   LD_A_D, RLC_A,     JR_n,   0x00,
+                                 LD_A_E, RRC_A,   JR_n,   0x00,   LD_A_D, CPL,    JR_n,   0x00,     SCF,    JR_n,
+                                 0x00,   CCF,    JR_n,   0x00,   LD_B_D, LD_C_E, INC_BC, DEC_BC,   INC_BC, LD_H_B,
+                                 LD_L_C, DEC_HL, INC_SP, DEC_SP, LD_HL_nn, 0x34, 0x12,   INC_E,    JR_NZ_n, 0xCE,
+                                 INC_D,  JR_NZ_n, 0xCB,  HALT};
+    writeProgram(0xC000, program);
+
+    runAndCompareUntilHalted();
+}
+
+TEST_F(JitCompilerTest, MemoryOperationsShouldMatchInterpreter)
+{
+    // Copy 0x100 bytes from 0xC100 to 0xD000 using the different addressing modes
+    std::vector<byte> program = {LD_HL_nn, 0x00, 0xC1,     LD_DE_nn, 0x00,     0xD0,   LD_A_HLm_I, LD_DEm_A,
+                                 INC_E,    LD_A_HLm, LD_B_A, LD_A_DEm, ADD_A_HLm, XOR_HLm, LD_nnm_A,   0x00,
+                                 0xDF,     LD_A_nnm, 0x00,   0xDF,     LD_HLm_B,  INC_E,   JR_NZ_n,    0xEE,
+                                 HALT};
+    writeProgram(0xC000, program);
+    for (int i = 0; i < 0x100; ++i)
+    {
+        jitMMU.write(static_cast<word>(0xC100 + i), static_cast<byte>(i * 7));
+        interpreterMMU.write(static_cast<word>(0xC100 + i), static_cast<byte>(i * 7));
+    }
+
+    runAndCompareUntilHalted();
+
+    for (int i = 0; i < 0x200; ++i)
+    {
+        ASSERT_EQ(jitMMU.read(static_cast<word>(0xC100 + i)), interpreterMMU.read(static_cast<word>(0xC100 + i)));
+        ASSERT_EQ(jitMMU.read(static_cast<word>(0xD000 + i)), interpreterMMU.read(static_cast<word>(0xD000 + i)));
+    }
+}
+
+TEST_F(JitCompilerTest, SelfModifyingCodeShouldExecuteTheNewInstruction)
+{
+    // HL points outside of the code until the loop is compiled,
+    // then the loop writes the operand of its own LD B,n instruction
+    std::vector<byte> program = {LD_HL_nn, 0x00, 0xD0, LD_D_n, 0x40, LD_A_n, 0x55, LD_HLm_A, LD_B_n,
+                                 0x00,     INC_C,     DEC_D, JR_Z_n, 0x0B, LD_A_D, CP_n,   0x20,     JR_NZ_n,
+                                 0xF2,     LD_L_n,    0x09,  LD_H_n, 0xC0, JR_n,   0xEC,   HALT};
+    writeProgram(0xC000, program);
+
+    runAndCompareUntilHalted();
+
+    ASSERT_EQ(jitCPU.getRegisterB(), 0x55);
+    ASSERT_EQ(jitCPU.getRegisterC(), 0x40);
+}
+
+TEST_F(JitCompilerTest, IORegistersShouldBeAccessedByTheInterpreter)
+{
+    // Write to the interrupt enable register in a loop
+    std::vector<byte> program = {LD_HL_nn, 0xFF, 0xFF, LD_B_n, 0x20, LD_A_B, LD_HLm_A, DEC_B, JR_NZ_n, 0xFB, HALT};
+    writeProgram(0xC000, program);
+
+    runAndCompareUntilHalted();
+
+    ASSERT_EQ(jitMMU.read(0xFFFF), 1);
+}
+
+TEST_F(JitCompilerTest, InterruptShouldBeServicedAtTheSameInstructionAsInterpreter)
+{
+    // Raise a timer interrupt after an arbitrary number of ticks on both CPUs
+    for (CPU* cpu : {&jitCPU, &interpreterCPU})
+    {
+        int elapsedTicks = 0;
+        cpu->setInstructionExecutedCallback([cpu, elapsedTicks](int ticks) mutable {
+            elapsedTicks += ticks;
+            if (elapsedTicks >= 1001 && elapsedTicks - ticks < 1001)
+            {
+                cpu->getInterruptManager()->raiseInterrupt(InterruptType::TIMER);
+            }
+        });
+        cpu->getInterruptManager()->setInterruptEnableFlag(0x04);
+    }
+
+    // The timer interrupt handler halts the CPU
+    std::vector<byte> program = {EI, LD_A_n, 0x00, INC_A, LD_B_A, JR_n, 0xFC};
+    writeProgram(0xC000, program);
+    jitMMU.write(0x0050, HALT);
+    interpreterMMU.write(0x0050, HALT);
+
+    runAndCompareUntilHalted();
+
+    ASSERT_EQ(jitCPU.getProgramCounter(), 0x0051);
+}
+
+TEST(JitRomTest, ExecutionShouldMatchInterpreterOnTestRom)
+{
+    if (!JitCompiler::isSupported())
+    {
+        GTEST_SKIP() << "The JIT is not supported on this platform";
+    }
+
+    std::string rom = std::string(DATADIR) + "/roms/blargg/02-interrupts.gb";
+    Emulator interpreter;
+    Emulator jit;
+    jit.getCPU().setExecutionMode(CPU::ExecutionMode::JIT);
+    ASSERT_TRUE(interpreter.getMMU().loadCartridgeFromFile(rom));
+    ASSERT_TRUE(jit.getMMU().loadCartridgeFromFile(rom));
+
+    while (jit.getCurrentTicks() < 2000000)
+    {
+        jit.exec();
+        // HALT takes no tick
+        while (interpreter.getCurrentTicks() < jit.getCurrentTicks() ||
+               interpreter.getCPU().isHalted() != jit.getCPU().isHalted())
+        {
+            interpreter.exec();
+        }
+
+        CPU& expected = interpreter.getCPU();
+        CPU& actual = jit.getCPU();
+        ASSERT_EQ(jit.getCurrentTicks(), interpreter.getCurrentTicks());
+        ASSERT_EQ(actual.getProgramCounter(), expected.getProgramCounter()) << "ticks=" << jit.getCurrentTicks();
+        ASSERT_EQ(actual.getStackPointer(), expected.getStackPointer()) << "ticks=" << jit.getCurrentTicks();
+        ASSERT_EQ(actual.getRegisterA(), expected.getRegisterA()) << "ticks=" << jit.getCurrentTicks();
+        ASSERT_EQ(actual.getRegisterB(), expected.getRegisterB()) << "ticks=" << jit.getCurrentTicks();
+        ASSERT_EQ(actual.getRegisterC(), expected.getRegisterC()) << "ticks=" << jit.getCurrentTicks();
+        ASSERT_EQ(actual.getRegisterD(), expected.getRegisterD()) << "ticks=" << jit.getCurrentTicks();
+        ASSERT_EQ(actual.getRegisterE(), expected.getRegisterE()) << "ticks=" << jit.getCurrentTicks();
+        ASSERT_EQ(actual.getRegisterH(), expected.getRegisterH()) << "ticks=" << jit.getCurrentTicks();
+        ASSERT_EQ(actual.getRegisterL(), expected.getRegisterL()) << "ticks=" << jit.getCurrentTicks();
+        ASSERT_EQ(actual.getFlag(), expected.getFlag()) << "ticks=" << jit.getCurrentTicks();
+    }
+
+    ASSERT_GT(jit.getCPU().getJitCompiler().getNumberOfCompiledBlocks(), 0);
+}
@@ -1,11 +1,12 @@
 #include "emulator.hpp"
 #include <gtest/gtest.h>
 
-class MoonEyeTest : public ::testing::Test
+class MoonEyeTest : public ::testing::TestWithParam<CPU::ExecutionMode>
 {
   protected:
     void SetUp() override
     {
+        emulator.getCPU().setExecutionMode(GetParam());
         serialTransferManager = std::make_unique<SerialTransferManager>(&emulator.getMMU());
     }
 
@@ -13,14 +14,14 @@ class MoonEyeTest : public ::testing::Test
     {
         std::string rom = std::string(DATADIR) + "/roms/mooneye/" + romName;
         ASSERT_TRUE(emulator.getMMU().loadCartridgeFromFile(rom));
-        bool infiniteJRDetected = false;
-        while (!infiniteJRDetected)
+        // The serial output is read as it's sent, the end of the test is checked once per frame
+        auto shouldStop = [](Emulator::StopReason reason) {
+            return reason == Emulator::StopReason::SERIAL_BYTE || reason == Emulator::StopReason::FRAME_COMPLETE;
+        };
+        while (!isNextInstructionInfiniteJR())
         {
-
-            emulator.exec();
+            emulator.runUntil(shouldStop);
             readSerialOutput();
-
-            infiniteJRDetected = isNextInstructionInfiniteJR();
         }
 
         // A successful test will write a fibonacci sequence to the serial port
@@ -56,52 +57,67 @@ class MoonEyeTest : public ::testing::Test
     std::vector<byte> output = {};
 };
 
-TEST_F(MoonEyeTest, TestForBitsMemOamShouldBeSuccessful)
+TEST_P(MoonEyeTest, TestForBitsMemOamShouldBeSuccessful)
 {
     assertTestForRomArePassing("acceptance/bits/mem_oam.gb");
 }
 
-TEST_F(MoonEyeTest, TestForBitsRegFShouldBeSuccessful)
+TEST_P(MoonEyeTest, TestForBitsRegFShouldBeSuccessful)
 {
     assertTestForRomArePassing("acceptance/bits/reg_f.gb");
 }
 
-TEST_F(MoonEyeTest, TestForUnusedHWIOBitsShouldBeSuccessful)
+TEST_P(MoonEyeTest, TestForUnusedHWIOBitsShouldBeSuccessful)
 {
     assertTestForRomArePassing("acceptance/bits/unused_hwio-GS.gb");
 }
 
-TEST_F(MoonEyeTest, TestForDaaInstrShouldBeSuccessful)
+TEST_P(MoonEyeTest, TestForDaaInstrShouldBeSuccessful)
 {
     assertTestForRomArePassing("acceptance/instr/daa.gb");
 }
 
-TEST_F(MoonEyeTest, TestForDMABasicShouldBeSuccessful)
+TEST_P(MoonEyeTest, TestForDMABasicShouldBeSuccessful)
 {
     assertTestForRomArePassing("acceptance/oam_dma/basic.gb");
 }
 
-TEST_F(MoonEyeTest, TestForTimerDivWriteShouldBeSuccessful)
+TEST_P(MoonEyeTest, TestForTimerDivWriteShouldBeSuccessful)
 {
     assertTestForRomArePassing("acceptance/timer/div_write.gb");
 }
 
-TEST_F(MoonEyeTest, TestForTimerTim00ShouldBeSuccessful)
+TEST_P(MoonEyeTest, TestForTimerTim00ShouldBeSuccessful)
 {
     assertTestForRomArePassing("acceptance/timer/tim00.gb");
 }
 
-TEST_F(MoonEyeTest, TestForTimerTim01ShouldBeSuccessful)
+TEST_P(MoonEyeTest, TestForTimerTim01ShouldBeSuccessful)
 {
     assertTestForRomArePassing("acceptance/timer/tim01.gb");
 }
 
-TEST_F(MoonEyeTest, TestForTimerTim10ShouldBeSuccessful)
+TEST_P(MoonEyeTest, TestForTimerTim10ShouldBeSuccessful)
 {
     assertTestForRomArePassing("acceptance/timer/tim10.gb");
 }
 
-TEST_F(MoonEyeTest, TestForTimerTim11ShouldBeSuccessful)
+TEST_P(MoonEyeTest, TestForTimerTim11ShouldBeSuccessful)
 {
     assertTestForRomArePassing("acceptance/timer/tim11.gb");
-}
\ No newline at end of file
+}
+
+INSTANTIATE_TEST_SUITE_P(ExecutionModes, MoonEyeTest,
+                         ::testing::Values(CPU::ExecutionMode::INTERPRETER, CPU::ExecutionMode::CACHED_INTERPRETER,
+                                           CPU::ExecutionMode::JIT),
+                         [](const ::testing::TestParamInfo<CPU::ExecutionMode>& info) {
+                             switch (info.param)
+                             {
+                             case CPU::ExecutionMode::INTERPRETER:
+                                 return "Interpreter";
+                             case CPU::ExecutionMode::CACHED_INTERPRETER:
+                                 return "CachedInterpreter";
+                             default:
+                                 return "JIT";
+                             }
+                         });
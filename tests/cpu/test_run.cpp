@@ -0,0 +1,145 @@
+#include "cpu/instructions.hpp"
+#include "emulator.hpp"
+#include "serial/serial_transfer_manager.hpp"
+#include <gtest/gtest.h>
+
+using namespace standardInstructions;
+
+class RunTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        emulator.getMMU().write(0xFF40, 0x91);
+    }
+
+    /**
+     * Copy the program to the work RAM and jump to it.
+     */
+    void loadProgram(const std::vector<byte>& program)
+    {
+        for (size_t i = 0; i < program.size(); ++i)
+        {
+            emulator.getMMU().write(static_cast<word>(0xC000 + i), program[i]);
+        }
+        emulator.getCPU().setProgramCounter(0xC000);
+    }
+
+    Emulator emulator;
+};
+
+TEST_F(RunTest, RunFrameShouldStopWhenTheFrameIsComplete)
+{
+    loadProgram({NOP, NOP, JR_n, static_cast<byte>(-4)});
+    int frameId = emulator.getPPU().getFrameId();
+
+    Emulator::RunResult result = emulator.runFrame();
+    ASSERT_EQ(result.reason, Emulator::StopReason::FRAME_COMPLETE);
+    ASSERT_EQ(emulator.getPPU().getFrameId(), frameId + 1);
+
+    // A whole frame, 154 lines
+    int64_t ticks = emulator.getCurrentTicks();
+    result = emulator.runFrame();
+    ASSERT_EQ(result.reason, Emulator::StopReason::FRAME_COMPLETE);
+    ASSERT_EQ(emulator.getPPU().getFrameId(), frameId + 2);
+    ASSERT_EQ(result.ticks, emulator.getCurrentTicks() - ticks);
+    ASSERT_NEAR(result.ticks, 154 * 456, 456);
+}
+
+TEST_F(RunTest, RunTicksShouldStopWhenTheBudgetIsExhausted)
+{
+    loadProgram({NOP, NOP, JR_n, static_cast<byte>(-4)});
+
+    // Frames are completed during the run
+    Emulator::RunResult result = emulator.runTicks(200000);
+    ASSERT_EQ(result.reason, Emulator::StopReason::BUDGET_EXHAUSTED);
+    ASSERT_GE(result.ticks, 200000);
+    // The last instruction goes past the budget
+    ASSERT_LT(result.ticks, 200000 + 3);
+    ASSERT_EQ(emulator.getCurrentTicks(), result.ticks);
+}
+
+TEST_F(RunTest, RunTicksShouldNotFastForwardIdleLoopsPastTheBudget)
+{
+    loadProgram({NOP, NOP, JR_n, static_cast<byte>(-4)});
+
+    int64_t ticks = emulator.getCurrentTicks();
+    for (int i = 0; i < 100; ++i)
+    {
+        Emulator::RunResult result = emulator.runTicks(1000);
+        ASSERT_EQ(result.reason, Emulator::StopReason::BUDGET_EXHAUSTED);
+        ASSERT_GE(result.ticks, 1000);
+        // At most one instruction goes past the budget
+        ASSERT_LT(result.ticks, 1000 + 3);
+        ticks += result.ticks;
+        ASSERT_EQ(emulator.getCurrentTicks(), ticks);
+    }
+    ASSERT_GT(emulator.getCPU().getIdleLoopDetector().getStatistics().skippedTicks, 0);
+}
+
+TEST_F(RunTest, BreakpointInAnIdleLoopShouldStopTheRun)
+{
+    loadProgram({NOP, NOP, JR_n, static_cast<byte>(-4)});
+    emulator.runTicks(10000);
+    ASSERT_GT(emulator.getCPU().getIdleLoopDetector().getStatistics().numberOfDetectedLoops, 0);
+
+    emulator.addBreakpoint(0xC001);
+    Emulator::RunResult result = emulator.runTicks(100000);
+    ASSERT_EQ(result.reason, Emulator::StopReason::BREAKPOINT);
+    ASSERT_EQ(emulator.getCPU().getProgramCounter(), 0xC001);
+    // At most one iteration of the loop
+    ASSERT_LE(result.ticks, 5);
+}
+
+TEST_F(RunTest, BreakpointShouldStopTheRunBeforeItsInstruction)
+{
+    loadProgram({NOP, NOP, NOP, INC_A, JR_n, static_cast<byte>(-6)});
+    emulator.addBreakpoint(0xC003);
+
+    Emulator::RunResult result = emulator.runTicks(1000);
+    ASSERT_EQ(result.reason, Emulator::StopReason::BREAKPOINT);
+    ASSERT_EQ(emulator.getCPU().getProgramCounter(), 0xC003);
+    ASSERT_EQ(result.ticks, 3);
+    ASSERT_EQ(emulator.getCPU().getRegisterA(), 0);
+
+    // The run resumes from the breakpoint, then stops at it again
+    result = emulator.runTicks(1000);
+    ASSERT_EQ(result.reason, Emulator::StopReason::BREAKPOINT);
+    ASSERT_EQ(emulator.getCPU().getProgramCounter(), 0xC003);
+    ASSERT_EQ(emulator.getCPU().getRegisterA(), 1);
+
+    emulator.removeBreakpoint(0xC003);
+    result = emulator.runTicks(1000);
+    ASSERT_EQ(result.reason, Emulator::StopReason::BUDGET_EXHAUSTED);
+}
+
+TEST_F(RunTest, SerialTransferShouldBeSignaledOnce)
+{
+    // Send 0x42 on the serial port, then loop
+    loadProgram({LD_A_n, 0x42, LDH_nm_A, 0x01, LD_A_n, 0x81, LDH_nm_A, 0x02, JR_n, static_cast<byte>(-2)});
+    auto shouldStop = [](Emulator::StopReason reason) {
+        return reason == Emulator::StopReason::SERIAL_BYTE || reason == Emulator::StopReason::FRAME_COMPLETE;
+    };
+
+    Emulator::RunResult result = emulator.runUntil(shouldStop);
+    ASSERT_EQ(result.reason, Emulator::StopReason::SERIAL_BYTE);
+    SerialTransferManager serialTransferManager(&emulator.getMMU());
+    ASSERT_TRUE(serialTransferManager.isTransferRequestedOrInProgress());
+    ASSERT_EQ(serialTransferManager.getTransferData(), 0x42);
+
+    // The transfer isn't finalized, it's not signaled again
+    result = emulator.runUntil(shouldStop);
+    ASSERT_EQ(result.reason, Emulator::StopReason::FRAME_COMPLETE);
+}
+
+TEST_F(RunTest, FullAudioBufferShouldStopTheRun)
+{
+    loadProgram({NOP, NOP, JR_n, static_cast<byte>(-4)});
+    emulator.getAPU().resetAudioBuffer();
+    emulator.setAudioBufferCapacity(64);
+
+    Emulator::RunResult result = emulator.runUntil(
+        [](Emulator::StopReason reason) { return reason == Emulator::StopReason::AUDIO_BUFFER_FULL; });
+    ASSERT_EQ(result.reason, Emulator::StopReason::AUDIO_BUFFER_FULL);
+    ASSERT_EQ(emulator.getAPU().getAudioBuffer().size(), 64);
+}
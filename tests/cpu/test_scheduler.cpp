@@ -0,0 +1,134 @@
+#include "cpu/instructions.hpp"
+#include "emulator.hpp"
+#include "scheduler/scheduler.hpp"
+#include <gtest/gtest.h>
+
+using namespace standardInstructions;
+
+TEST(Scheduler, NextEventShouldBeTheEarliestEvent)
+{
+    Scheduler scheduler;
+    ASSERT_EQ(scheduler.getNextEventCycles(), Scheduler::NEVER);
+
+    scheduler.schedule(Scheduler::TIMER, 100);
+    scheduler.schedule(Scheduler::PPU, 40);
+    scheduler.schedule(Scheduler::APU, 60);
+    ASSERT_EQ(scheduler.getNextEventCycles(), 40);
+    ASSERT_EQ(scheduler.getNextEventCyclesIgnoring(Scheduler::PPU), 60);
+
+    // The event replaces the previous one of its type
+    scheduler.schedule(Scheduler::PPU, 200);
+    ASSERT_EQ(scheduler.getNextEventCycles(), 60);
+
+    scheduler.cancel(Scheduler::APU);
+    ASSERT_EQ(scheduler.getNextEventCycles(), 100);
+    ASSERT_EQ(scheduler.getEventCycles(Scheduler::APU), Scheduler::NEVER);
+}
+
+TEST(Scheduler, EventsShouldBeScheduledFromTheCurrentTime)
+{
+    Scheduler scheduler;
+    scheduler.advance(30);
+    scheduler.schedule(Scheduler::TIMER, 10);
+    ASSERT_EQ(scheduler.getEventCycles(Scheduler::TIMER), 40);
+    ASSERT_FALSE(scheduler.isEventDue(Scheduler::TIMER));
+
+    scheduler.advance(10);
+    ASSERT_TRUE(scheduler.isEventDue(Scheduler::TIMER));
+    ASSERT_FALSE(scheduler.isEventDue(Scheduler::PPU));
+}
+
+TEST(Scheduler, TicksShouldBeCountedAtNormalSpeed)
+{
+    Scheduler scheduler;
+    scheduler.advance(3);
+    ASSERT_EQ(scheduler.getCurrentCycles(), 3);
+    ASSERT_EQ(scheduler.getCurrentTicks(), 1);
+    ASSERT_EQ(*scheduler.getCurrentTicksCounter(), 1);
+
+    // The clock doesn't overflow in long sessions
+    scheduler.advance(int64_t(1) << 40);
+    ASSERT_EQ(scheduler.getCurrentTicks(), ((int64_t(1) << 40) + 3) / 2);
+
+    scheduler.reset();
+    ASSERT_EQ(scheduler.getCurrentCycles(), 0);
+    ASSERT_EQ(scheduler.getNextEventCycles(), Scheduler::NEVER);
+}
+
+TEST(Scheduler, EventsTooFarAwayShouldNeverHappen)
+{
+    Scheduler scheduler;
+    scheduler.advance(10);
+    scheduler.schedule(Scheduler::OAM_DMA, Scheduler::NEVER);
+    ASSERT_EQ(scheduler.getEventCycles(Scheduler::OAM_DMA), Scheduler::NEVER);
+}
+
+TEST(Scheduler, RegistersShouldBeUpToDateWhenTheComponentsAreSteppedLazily)
+{
+    Emulator emulator;
+    emulator.getCPU().setIdleLoopDetectionEnabled(false);
+    emulator.getCPU().setProgramCounter(0xC000);
+
+    // NOPs, the components are only updated at their next event
+    while (emulator.getCurrentTicks() < 1000)
+    {
+        emulator.exec();
+        ASSERT_GT(emulator.getScheduler().getNextEventCycles(), emulator.getScheduler().getCurrentCycles());
+    }
+
+    // The divider register is incremented every 64 ticks
+    ASSERT_EQ(emulator.getMMU().read(0xFF04), emulator.getCurrentTicks() / 64);
+}
+
+TEST(Scheduler, CatchUpSynchronizationShouldMatchTheLockstepSynchronization)
+{
+    // Write LY xor DIV to SCX and to the tiles, then STAT to the tiles, in a loop while the PPU draws
+    // clang-format off
+    std::vector<byte> program = {
+        LD_HL_nn, 0x00, 0x80,
+        LDH_A_nm, 0x44,
+        LD_B_A,
+        LDH_A_nm, 0x04,
+        XOR_B,
+        LDH_nm_A, 0x43,
+        LD_HLm_I_A,
+        LDH_A_nm, 0x41,
+        LD_HLm_I_A,
+        LD_A_H,
+        CP_n, 0x98,
+        JR_NZ_n, static_cast<byte>(-17),
+        JR_n, static_cast<byte>(-22)
+    };
+    // clang-format on
+
+    Emulator lockstep;
+    Emulator catchUp;
+    lockstep.setCatchUpSynchronizationEnabled(false);
+    for (Emulator* emulator : {&lockstep, &catchUp})
+    {
+        // Monochrome cartridge
+        ASSERT_TRUE(emulator->getMMU().loadCartridgeData(std::vector<byte>(2 * 0x4000)));
+        emulator->getMMU().write(0xFF50, 0x01);
+        emulator->getCPU().setIdleLoopDetectionEnabled(false);
+        for (size_t i = 0; i < program.size(); ++i)
+        {
+            emulator->getMMU().write(static_cast<word>(0xC000 + i), program[i]);
+        }
+        emulator->getMMU().write(0xFF47, 0xE4);
+        emulator->getMMU().write(0xFF40, 0x91);
+        emulator->getCPU().setProgramCounter(0xC000);
+
+        while (emulator->getCurrentTicks() < 3 * 70224)
+        {
+            emulator->exec();
+        }
+    }
+
+    ASSERT_EQ(lockstep.getCurrentTicks(), catchUp.getCurrentTicks());
+    ASSERT_EQ(lockstep.getPPU().getFrameId(), catchUp.getPPU().getFrameId());
+    ASSERT_EQ(lockstep.getPPU().getLastRenderedFrame().getData(), catchUp.getPPU().getLastRenderedFrame().getData());
+    for (word addr = 0x8000; addr < 0x9800; ++addr)
+    {
+        ASSERT_EQ(lockstep.getMMU().read(addr), catchUp.getMMU().read(addr)) << addr;
+    }
+}
@@ -0,0 +1,170 @@
+#include "cpu/aot/recompiled_module.hpp"
+#include "cpu/aot/static_recompiler.hpp"
+#include "cpu/instructions.hpp"
+#include "emulator.hpp"
+#include "memory/cartridge.hpp"
+#include <gtest/gtest.h>
+
+using namespace standardInstructions;
+
+class StaticRecompilerTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        // 4 banks of NOP, MBC1
+        rom.resize(4 * 0x4000, NOP);
+        rom[0x0147] = 0x01;
+        rom[0x0148] = 0x01;
+        for (word vector = 0; vector <= 0x60; vector += 8)
+        {
+            rom[vector] = RETI;
+        }
+    }
+
+    void writeProgram(size_t offset, const std::vector<byte>& program)
+    {
+        std::copy(program.begin(), program.end(), rom.begin() + offset);
+    }
+
+    std::vector<byte> rom;
+};
+
+TEST_F(StaticRecompilerTest, CodeReachableFromTheEntryPointShouldBeFound)
+{
+    writeProgram(0x0100, {CALL_nn, 0x50, 0x01, JP_nn, 0x00, 0x02});
+    writeProgram(0x0150, {LD_A_n, 0x12, RET});
+    writeProgram(0x0200, {JR_n, 0xFE});
+    Cartridge cartridge(rom);
+    StaticRecompiler recompiler(cartridge);
+
+    ASSERT_NE(recompiler.findBlock(0, 0x0100), nullptr);
+    ASSERT_EQ(recompiler.findBlock(0, 0x0100)->instructions.size(), 1);
+    ASSERT_NE(recompiler.findBlock(0, 0x0103), nullptr);
+    ASSERT_NE(recompiler.findBlock(0, 0x0150), nullptr);
+    ASSERT_EQ(recompiler.findBlock(0, 0x0150)->instructions.size(), 2);
+    ASSERT_NE(recompiler.findBlock(0, 0x0200), nullptr);
+    ASSERT_NE(recompiler.findBlock(0, 0x0048), nullptr);
+    // Nothing falls through the return and the infinite loop
+    ASSERT_EQ(recompiler.findBlock(0, 0x0152), nullptr);
+    ASSERT_EQ(recompiler.findBlock(0, 0x0153), nullptr);
+    ASSERT_EQ(recompiler.findBlock(0, 0x0202), nullptr);
+}
+
+TEST_F(StaticRecompilerTest, CallToTheSwitchableBankFromTheFixedBankShouldBeFoundInAllBanks)
+{
+    writeProgram(0x0100, {CALL_nn, 0x00, 0x40, JR_n, 0xFE});
+    // Each bank jumps to a different address of the same bank
+    for (int bank = 1; bank < 4; ++bank)
+    {
+        writeProgram(bank * 0x4000, {JP_nn, static_cast<byte>(bank), 0x50});
+        writeProgram(bank * 0x4000 + 0x1000 + bank, {RET});
+    }
+    Cartridge cartridge(rom);
+    StaticRecompiler recompiler(cartridge);
+
+    for (int bank = 1; bank < 4; ++bank)
+    {
+        ASSERT_NE(recompiler.findBlock(bank, 0x4000), nullptr);
+        ASSERT_NE(recompiler.findBlock(bank, 0x5000 + bank), nullptr);
+        for (int otherBank = 1; otherBank < 4; ++otherBank)
+        {
+            if (otherBank != bank)
+            {
+                ASSERT_EQ(recompiler.findBlock(otherBank, 0x5000 + bank), nullptr);
+            }
+        }
+    }
+}
+
+TEST_F(StaticRecompilerTest, BlocksShouldBeSplitLikeTheBasicBlockCache)
+{
+    // The fixed bank ends in the middle of the NOPs
+    writeProgram(0x0100, {JP_nn, 0xF0, 0x3F});
+    Cartridge cartridge(rom);
+    StaticRecompiler recompiler(cartridge);
+
+    const StaticRecompiler::Block* block = recompiler.findBlock(0, 0x3FF0);
+    ASSERT_NE(block, nullptr);
+    ASSERT_EQ(block->instructions.size(), 16);
+    ASSERT_NE(recompiler.findBlock(1, 0x4000), nullptr);
+    ASSERT_EQ(recompiler.findBlock(1, 0x4000)->instructions.size(),
+              static_cast<size_t>(BasicBlockCache::MAX_INSTRUCTIONS_PER_BLOCK));
+}
+
+TEST_F(StaticRecompilerTest, HaltShouldEndTheRecompiledPartOfTheBlock)
+{
+    writeProgram(0x0100, {LD_A_n, 0x01, HALT, JR_n, 0xFE});
+    Cartridge cartridge(rom);
+    StaticRecompiler recompiler(cartridge);
+
+    const StaticRecompiler::Block* block = recompiler.findBlock(0, 0x0100);
+    ASSERT_NE(block, nullptr);
+    ASSERT_EQ(block->instructions.size(), 2);
+    ASSERT_EQ(block->numberOfRecompiledInstructions, 1);
+    ASSERT_NE(recompiler.findBlock(0, 0x0103), nullptr);
+}
+
+TEST_F(StaticRecompilerTest, GeneratedSourceShouldRegisterTheModuleWithTheCartridgeHash)
+{
+    writeProgram(0x0100, {LD_A_n, 0x12, EXT_OPS, 0x7C, JR_n, 0xFE});
+    Cartridge cartridge(rom);
+    StaticRecompiler recompiler(cartridge);
+
+    std::string source = recompiler.generateSource();
+    std::string hash = utils::string_format("0x%016llXULL", static_cast<unsigned long long>(cartridge.getHash()));
+    ASSERT_NE(source.find(hash), std::string::npos);
+    ASSERT_NE(source.find("RecompiledCode::execute<0x3E>(cpu, 0x0012)"), std::string::npos);
+    ASSERT_NE(source.find("RecompiledCode::execute<0xCB, 0x7C>(cpu)"), std::string::npos);
+    ASSERT_NE(source.find("RecompiledModuleRegistration"), std::string::npos);
+}
+
+class RecompiledModuleTest : public ::testing::TestWithParam<std::string>
+{
+};
+
+TEST_P(RecompiledModuleTest, ExecutionShouldMatchTheInterpreter)
+{
+    std::string rom = std::string(DATADIR) + "/roms/" + GetParam();
+    Emulator reference;
+    Emulator emulator;
+    emulator.getCPU().setExecutionMode(CPU::ExecutionMode::CACHED_INTERPRETER);
+    // The idle loops would be fast-forwarded at different times
+    reference.getCPU().setIdleLoopDetectionEnabled(false);
+    emulator.getCPU().setIdleLoopDetectionEnabled(false);
+    ASSERT_TRUE(reference.getMMU().loadCartridgeFromFile(rom));
+    ASSERT_TRUE(emulator.getMMU().loadCartridgeFromFile(rom));
+    // The module was generated by gb2cpp when building the tests
+    ASSERT_NE(emulator.getCPU().getBasicBlockCache().getRecompiledModule(), nullptr);
+
+    int numberOfExecCalls = 0;
+    int numberOfReferenceExecCalls = 0;
+    while (emulator.getCurrentTicks() < 5000000)
+    {
+        emulator.exec();
+        numberOfExecCalls++;
+        // HALT takes no tick
+        while (reference.getCurrentTicks() < emulator.getCurrentTicks() ||
+               reference.getCPU().isHalted() != emulator.getCPU().isHalted())
+        {
+            reference.exec();
+            numberOfReferenceExecCalls++;
+        }
+
+        CPU& expected = reference.getCPU();
+        CPU& actual = emulator.getCPU();
+        ASSERT_EQ(emulator.getCurrentTicks(), reference.getCurrentTicks());
+        ASSERT_EQ(actual.getProgramCounter(), expected.getProgramCounter()) << "ticks=" << emulator.getCurrentTicks();
+        ASSERT_EQ(actual.getStackPointer(), expected.getStackPointer()) << "ticks=" << emulator.getCurrentTicks();
+        ASSERT_EQ(actual.getRegisterAF(), expected.getRegisterAF()) << "ticks=" << emulator.getCurrentTicks();
+        ASSERT_EQ(actual.getRegisterBC(), expected.getRegisterBC()) << "ticks=" << emulator.getCurrentTicks();
+        ASSERT_EQ(actual.getRegisterDE(), expected.getRegisterDE()) << "ticks=" << emulator.getCurrentTicks();
+        ASSERT_EQ(actual.getRegisterHL(), expected.getRegisterHL()) << "ticks=" << emulator.getCurrentTicks();
+    }
+
+    // Some instructions were executed by blocks of recompiled code
+    ASSERT_LT(numberOfExecCalls, numberOfReferenceExecCalls);
+}
+
+INSTANTIATE_TEST_SUITE_P(RecompiledModuleTests, RecompiledModuleTest,
+                         ::testing::Values("acid/dmg-acid2.gb", "mooneye/acceptance/instr/daa.gb"));
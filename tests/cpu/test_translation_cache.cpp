@@ -0,0 +1,223 @@
+#include "cpu/translation_cache.hpp"
+#include "cpu/basic_block_cache.hpp"
+#include "emulator.hpp"
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+
+class TranslationCacheTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        directory = ::testing::TempDir();
+        std::remove(TranslationCache::getFilePath(directory, CARTRIDGE_HASH).c_str());
+    }
+
+    void TearDown() override
+    {
+        std::remove(TranslationCache::getFilePath(directory, CARTRIDGE_HASH).c_str());
+    }
+
+    static BasicBlock createBlock(int bankKey, word addr, const std::vector<byte>& opCodes)
+    {
+        BasicBlock block;
+        block.bankKey = bankKey;
+        block.startAddress = addr;
+        for (byte opCode : opCodes)
+        {
+            DecodedInstruction instruction;
+            instruction.address = static_cast<word>(addr + block.size);
+            instruction.opCode = opCode;
+            instruction.length = 1;
+            instruction.ticks = 1;
+            block.instructions.push_back(instruction);
+            block.size++;
+        }
+        return block;
+    }
+
+    /**
+     * Overwrite a value in a saved file, as a corrupted file would contain
+     */
+    template <typename T>
+    static void patchFile(const std::string& path, size_t offset, T value)
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(static_cast<std::streamoff>(offset));
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    static size_t getBlockOffset(int index)
+    {
+        return sizeof(TranslationCache::Header) + index * sizeof(TranslationCache::BlockEntry);
+    }
+
+    std::string directory;
+    static constexpr uint64_t CARTRIDGE_HASH = 0x0123456789ABCDEFULL;
+};
+
+TEST_F(TranslationCacheTest, SavedBlocksShouldBeLoaded)
+{
+    BasicBlock first = createBlock(3, 0x4000, {0x00, 0x3C, 0xC9});
+    BasicBlock second = createBlock(0, 0x0150, {0x04, 0xC9});
+    std::string path = TranslationCache::getFilePath(directory, CARTRIDGE_HASH);
+    ASSERT_TRUE(TranslationCache::save(path, CARTRIDGE_HASH, {&first, &second}));
+
+    TranslationCache cache;
+    ASSERT_TRUE(cache.load(path, CARTRIDGE_HASH));
+    ASSERT_EQ(cache.getNumberOfBlocks(), 2);
+    // Sorted by bank
+    ASSERT_EQ(cache.getBlocks()[0].startAddress, 0x0150);
+    ASSERT_EQ(cache.findBlock(3, 0x4001), nullptr);
+    ASSERT_EQ(cache.findBlock(2, 0x4000), nullptr);
+
+    const TranslationCache::BlockEntry* entry = cache.findBlock(3, 0x4000);
+    ASSERT_NE(entry, nullptr);
+    ASSERT_EQ(entry->size, 3);
+    ASSERT_EQ(entry->numberOfInstructions, 3);
+    const DecodedInstruction* instructions = cache.getInstructions(*entry);
+    ASSERT_EQ(instructions[1].address, 0x4001);
+    ASSERT_EQ(instructions[1].opCode, 0x3C);
+    ASSERT_EQ(instructions[2].opCode, 0xC9);
+}
+
+TEST_F(TranslationCacheTest, FileOfAnotherCartridgeShouldBeRejected)
+{
+    BasicBlock block = createBlock(0, 0x0100, {0x00});
+    std::string path = TranslationCache::getFilePath(directory, CARTRIDGE_HASH);
+    ASSERT_TRUE(TranslationCache::save(path, CARTRIDGE_HASH, {&block}));
+
+    TranslationCache cache;
+    ASSERT_FALSE(cache.load(path, CARTRIDGE_HASH + 1));
+    ASSERT_FALSE(cache.isLoaded());
+    ASSERT_EQ(cache.findBlock(0, 0x0100), nullptr);
+}
+
+TEST_F(TranslationCacheTest, FileOfAnotherVersionShouldBeRejected)
+{
+    BasicBlock block = createBlock(0, 0x0100, {0x00});
+    std::string path = TranslationCache::getFilePath(directory, CARTRIDGE_HASH);
+    ASSERT_TRUE(TranslationCache::save(path, CARTRIDGE_HASH, {&block}));
+
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    uint32_t version = TranslationCache::VERSION + 1;
+    file.seekp(offsetof(TranslationCache::Header, version));
+    file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    file.close();
+
+    TranslationCache cache;
+    ASSERT_FALSE(cache.load(path, CARTRIDGE_HASH));
+}
+
+TEST_F(TranslationCacheTest, TruncatedFileShouldBeRejected)
+{
+    BasicBlock block = createBlock(0, 0x0100, {0x00, 0x00, 0xC9});
+    std::string path = TranslationCache::getFilePath(directory, CARTRIDGE_HASH);
+    ASSERT_TRUE(TranslationCache::save(path, CARTRIDGE_HASH, {&block}));
+
+    std::ifstream input(path, std::ios::binary);
+    std::vector<char> content((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    input.close();
+    std::ofstream output(path, std::ios::binary | std::ios::trunc);
+    output.write(content.data(), static_cast<std::streamsize>(content.size() - sizeof(DecodedInstruction)));
+    output.close();
+
+    TranslationCache cache;
+    ASSERT_FALSE(cache.load(path, CARTRIDGE_HASH));
+}
+
+TEST_F(TranslationCacheTest, TruncatedFileWithMatchingHeaderShouldBeRejected)
+{
+    BasicBlock block = createBlock(0, 0x0100, {0x00, 0x00, 0xC9});
+    std::string path = TranslationCache::getFilePath(directory, CARTRIDGE_HASH);
+    ASSERT_TRUE(TranslationCache::save(path, CARTRIDGE_HASH, {&block}));
+
+    std::ifstream input(path, std::ios::binary);
+    std::vector<char> content((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    input.close();
+    std::ofstream output(path, std::ios::binary | std::ios::trunc);
+    output.write(content.data(), static_cast<std::streamsize>(content.size() - sizeof(DecodedInstruction)));
+    output.close();
+    // The size of the file matches the header, but the block still has 3 instructions
+    patchFile<uint32_t>(path, offsetof(TranslationCache::Header, numberOfInstructions), 2);
+
+    TranslationCache cache;
+    ASSERT_FALSE(cache.load(path, CARTRIDGE_HASH));
+}
+
+TEST_F(TranslationCacheTest, BlockWithMoreInstructionsThanTheFileShouldBeRejected)
+{
+    BasicBlock block = createBlock(0, 0x0100, {0x00, 0x00, 0xC9});
+    std::string path = TranslationCache::getFilePath(directory, CARTRIDGE_HASH);
+    ASSERT_TRUE(TranslationCache::save(path, CARTRIDGE_HASH, {&block}));
+    patchFile<uint32_t>(path, getBlockOffset(0) + offsetof(TranslationCache::BlockEntry, numberOfInstructions), 4);
+
+    TranslationCache cache;
+    ASSERT_FALSE(cache.load(path, CARTRIDGE_HASH));
+}
+
+TEST_F(TranslationCacheTest, UnsortedBlocksShouldBeRejected)
+{
+    BasicBlock first = createBlock(0, 0x0100, {0xC9});
+    BasicBlock second = createBlock(0, 0x0200, {0xC9});
+    std::string path = TranslationCache::getFilePath(directory, CARTRIDGE_HASH);
+    ASSERT_TRUE(TranslationCache::save(path, CARTRIDGE_HASH, {&first, &second}));
+    patchFile<uint16_t>(path, getBlockOffset(1) + offsetof(TranslationCache::BlockEntry, startAddress), 0x0050);
+
+    TranslationCache cache;
+    ASSERT_FALSE(cache.load(path, CARTRIDGE_HASH));
+}
+
+TEST_F(TranslationCacheTest, WarmStartShouldNotDecodeTheROMAgain)
+{
+    std::string rom = std::string(DATADIR) + "/roms/mooneye/acceptance/instr/daa.gb";
+    Emulator reference;
+    ASSERT_TRUE(reference.getMMU().loadCartridgeFromFile(rom));
+    uint64_t cartridgeHash = reference.getMMU().getCartridge()->getHash();
+    std::string path = TranslationCache::getFilePath(directory, cartridgeHash);
+    std::remove(path.c_str());
+
+    size_t numberOfDecodedBlocks = 0;
+    {
+        // The blocks are saved when the emulator is destroyed
+        Emulator cold;
+        cold.getCPU().setExecutionMode(CPU::ExecutionMode::CACHED_INTERPRETER);
+        cold.getCPU().setTranslationCacheDirectory(directory);
+        ASSERT_TRUE(cold.getMMU().loadCartridgeFromFile(rom));
+        ASSERT_FALSE(cold.getCPU().getBasicBlockCache().getTranslationCache().isLoaded());
+        while (cold.getCurrentTicks() < 1000000)
+        {
+            cold.exec();
+        }
+        numberOfDecodedBlocks = cold.getCPU().getBasicBlockCache().getNumberOfDecodedROMBlocks();
+        ASSERT_GT(numberOfDecodedBlocks, 0);
+    }
+
+    Emulator warm;
+    warm.getCPU().setExecutionMode(CPU::ExecutionMode::CACHED_INTERPRETER);
+    warm.getCPU().setTranslationCacheDirectory(directory);
+    ASSERT_TRUE(warm.getMMU().loadCartridgeFromFile(rom));
+    const BasicBlockCache& cache = warm.getCPU().getBasicBlockCache();
+    ASSERT_TRUE(cache.getTranslationCache().isLoaded());
+    ASSERT_EQ(cache.getTranslationCache().getNumberOfBlocks(), numberOfDecodedBlocks);
+
+    while (warm.getCurrentTicks() < 1000000)
+    {
+        warm.exec();
+    }
+    while (reference.getCurrentTicks() < warm.getCurrentTicks())
+    {
+        reference.exec();
+    }
+
+    ASSERT_EQ(cache.getNumberOfDecodedROMBlocks(), 0);
+    ASSERT_EQ(warm.getCurrentTicks(), reference.getCurrentTicks());
+    ASSERT_EQ(warm.getCPU().getProgramCounter(), reference.getCPU().getProgramCounter());
+    ASSERT_EQ(warm.getCPU().getRegisterAF(), reference.getCPU().getRegisterAF());
+    ASSERT_EQ(warm.getCPU().getRegisterBC(), reference.getCPU().getRegisterBC());
+    ASSERT_EQ(warm.getCPU().getRegisterDE(), reference.getCPU().getRegisterDE());
+    ASSERT_EQ(warm.getCPU().getRegisterHL(), reference.getCPU().getRegisterHL());
+    std::remove(path.c_str());
+}
@@ -0,0 +1,193 @@
+#include "common/utils.hpp"
+#include "emulator.hpp"
+#include "memory/battery_save.hpp"
+#include "memory/mbc/real_time_clock.hpp"
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+
+class BatterySaveTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        path = ::testing::TempDir() + "/grouboy_battery_save_test.sav";
+        std::remove(path.c_str());
+
+        // MBC5 with a battery and 32 KiB of RAM
+        std::vector<byte> data(2 * 0x4000);
+        data[0x0147] = Cartridge::CartridgeType::MBC5_RAM_BATTERY;
+        data[0x0149] = 0x03;
+        ASSERT_TRUE(emulator.getMMU().loadCartridgeData(data));
+        emulator.getMMU().write(0xFF50, 0x01);
+        emulator.getCPU().setIdleLoopDetectionEnabled(false);
+    }
+
+    void TearDown() override
+    {
+        std::remove(path.c_str());
+    }
+
+    MMU& mmu()
+    {
+        return emulator.getMMU();
+    }
+
+    void enableRAM()
+    {
+        mmu().write(0x0000, 0x0A);
+    }
+
+    std::vector<byte> readFile()
+    {
+        std::vector<byte> content;
+        utils::readBinaryDataFromFile(path, content);
+        return content;
+    }
+
+    std::vector<size_t> consumeDirtyPages()
+    {
+        std::vector<size_t> offsets;
+        mmu().getMemoryBankController()->consumeDirtyRAMPages(
+            [&offsets](size_t offset, const byte*, size_t size) {
+                EXPECT_EQ(size, MemoryBankController::RAM_PAGE_SIZE_IN_BYTES);
+                offsets.push_back(offset);
+            });
+        return offsets;
+    }
+
+    std::string path;
+    Emulator emulator;
+};
+
+TEST_F(BatterySaveTest, WritesToTheRAMShouldMarkTheirPageAsDirty)
+{
+    enableRAM();
+    ASSERT_FALSE(mmu().getMemoryBankController()->hasDirtyRAMPages());
+
+    mmu().write(0xA001, 0x12);
+    mmu().write(0xA0FF, 0x34);
+    // RAM bank 2
+    mmu().write(0x4000, 0x02);
+    mmu().write(0xB000, 0x56);
+    ASSERT_TRUE(mmu().getMemoryBankController()->hasDirtyRAMPages());
+    ASSERT_EQ(mmu().read(0xB000), 0x56);
+
+    ASSERT_EQ(consumeDirtyPages(), std::vector<size_t>({0x0000, 2 * 0x2000 + 0x1000}));
+    ASSERT_FALSE(mmu().getMemoryBankController()->hasDirtyRAMPages());
+    ASSERT_TRUE(consumeDirtyPages().empty());
+}
+
+TEST_F(BatterySaveTest, LoadedRAMShouldNotBeDirty)
+{
+    std::vector<byte> ram(32 * 1024, 0x42);
+    ASSERT_TRUE(mmu().unserializeCartridgeRAM(ram));
+    ASSERT_FALSE(mmu().getMemoryBankController()->hasDirtyRAMPages());
+}
+
+TEST_F(BatterySaveTest, QueuedPagesShouldBeWrittenToTheFile)
+{
+    BatterySave batterySave;
+    ASSERT_TRUE(batterySave.open(path, 1024));
+    std::vector<byte> page(256, 0xAB);
+    batterySave.write(512, page.data(), page.size());
+    // Truncated to the size of the file
+    batterySave.write(1000, page.data(), page.size());
+    batterySave.flush();
+
+    std::vector<byte> content = readFile();
+    ASSERT_EQ(content.size(), 1024);
+    ASSERT_EQ(content[511], 0x00);
+    ASSERT_EQ(content[512], 0xAB);
+    ASSERT_EQ(content[767], 0xAB);
+    ASSERT_EQ(content[768], 0x00);
+    ASSERT_EQ(content[1023], 0xAB);
+    ASSERT_EQ(batterySave.read(), content);
+}
+
+TEST_F(BatterySaveTest, ExistingFileShouldBeKept)
+{
+    std::ofstream(path, std::ios::binary) << "GROUBOY";
+
+    BatterySave batterySave;
+    ASSERT_TRUE(batterySave.open(path, 16));
+    std::vector<byte> content = batterySave.read();
+    ASSERT_EQ(content.size(), 16);
+    ASSERT_EQ(std::string(content.begin(), content.begin() + 7), "GROUBOY");
+    ASSERT_EQ(content[7], 0x00);
+}
+
+TEST_F(BatterySaveTest, RAMShouldBeLoadedFromTheBatterySave)
+{
+    std::vector<byte> ram(32 * 1024, 0x00);
+    ram[0x0010] = 0x99;
+    std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(ram.data()), ram.size());
+
+    ASSERT_TRUE(emulator.openBatterySave(path));
+    enableRAM();
+    ASSERT_EQ(mmu().read(0xA010), 0x99);
+}
+
+TEST_F(BatterySaveTest, DirtyPagesShouldBeSavedPeriodically)
+{
+    ASSERT_TRUE(emulator.openBatterySave(path));
+    emulator.setBatterySaveInterval(100);
+    enableRAM();
+    mmu().write(0xA123, 0x77);
+    emulator.getCPU().setProgramCounter(0xC000);
+
+    // NOPs until the interval elapsed
+    while (emulator.getCurrentTicks() < 100)
+    {
+        emulator.exec();
+    }
+    ASSERT_FALSE(mmu().getMemoryBankController()->hasDirtyRAMPages());
+
+    emulator.flushBatterySave();
+    ASSERT_EQ(readFile()[0x0123], 0x77);
+}
+
+TEST_F(BatterySaveTest, BatterySaveShouldBeFlushedWhenTheEmulatorIsDestroyed)
+{
+    {
+        Emulator other;
+        std::vector<byte> data(2 * 0x4000);
+        data[0x0147] = Cartridge::CartridgeType::MBC5_RAM_BATTERY;
+        data[0x0149] = 0x03;
+        ASSERT_TRUE(other.getMMU().loadCartridgeData(data));
+        ASSERT_TRUE(other.openBatterySave(path));
+        other.getMMU().write(0x0000, 0x0A);
+        other.getMMU().write(0xBFFF, 0x55);
+    }
+
+    std::vector<byte> content = readFile();
+    ASSERT_EQ(content.size(), 32 * 1024);
+    ASSERT_EQ(content[0x1FFF], 0x55);
+}
+
+TEST_F(BatterySaveTest, CartridgeWithoutRAMShouldNotOpenABatterySave)
+{
+    std::vector<byte> data(2 * 0x4000);
+    data[0x0147] = Cartridge::CartridgeType::MBC5;
+    ASSERT_TRUE(mmu().loadCartridgeData(data));
+    ASSERT_FALSE(emulator.openBatterySave(path));
+}
+
+TEST_F(BatterySaveTest, ClockStateShouldBeSavedAfterTheRAM)
+{
+    std::vector<byte> data(2 * 0x4000);
+    data[0x0147] = Cartridge::CartridgeType::MBC3_TIMER_RAM_BATTERY_2;
+    data[0x0149] = 0x03;
+    ASSERT_TRUE(mmu().loadCartridgeData(data));
+    ASSERT_TRUE(emulator.openBatterySave(path));
+
+    // Set 42 minutes
+    enableRAM();
+    mmu().write(0x4000, 0x09);
+    mmu().write(0xA000, 42);
+    emulator.flushBatterySave();
+
+    std::vector<byte> content = readFile();
+    ASSERT_EQ(content.size(), 32 * 1024 + RealTimeClock::STATE_SIZE);
+    ASSERT_EQ(content[32 * 1024 + 4], 42);
+}
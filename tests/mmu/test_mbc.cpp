@@ -1,6 +1,7 @@
 #include "memory/mbc/mbc1.hpp"
 #include "memory/mbc/mbc2.hpp"
 #include "memory/mbc/mbc3.hpp"
+#include "memory/mbc/mbc5.hpp"
 #include "memory/mbc/mbc_rom_only.hpp"
 #include "memory/mbc/memory_bank_controller.hpp"
 #include <gtest/gtest.h>
@@ -31,7 +32,11 @@ TEST_F(MBCROMOnlyTest, ReadROMInBoundsShouldReturnValue)
 {
     word addr = 0x1234;
     int value = 0x42;
-    cartridge->getData()[addr] = value;
+    // The ROM of a cartridge is immutable
+    std::vector<byte> data(cartridge->getData().data(), cartridge->getData().data() + romSize);
+    data[addr] = value;
+    cartridge = std::make_unique<Cartridge>(data);
+    mbc = std::make_unique<MBCRomOnly>(cartridge.get());
     ASSERT_EQ(mbc->readROM(addr), value);
 }
 
@@ -615,4 +620,188 @@ TEST_F(MBC3Test, SerializeUnserializedRAMShouldLoadStateCorrectly)
         mbc->writeRAM(i, i + 1);
         ASSERT_EQ(mbc->readRAM(i), static_cast<byte>(i + 1));
     }
-}
\ No newline at end of file
+}
+
+TEST_F(MBC3Test, ClockRegistersShouldBeReadWhenLatched)
+{
+    int64_t ticks = 0;
+    mbc->setTicksCounter(&ticks);
+    enableRam();
+
+    // Set 59 seconds
+    switchRAMBank(0x08);
+    mbc->writeRAM(0x0000, 59);
+    ticks = 3 * 4194304;
+
+    mbc->writeROM(0x6000, 0x00);
+    mbc->writeROM(0x6000, 0x01);
+    ASSERT_EQ(mbc->readRAM(0x0000), 2);
+    switchRAMBank(0x09);
+    ASSERT_EQ(mbc->readRAM(0x0000), 1);
+
+    // The registers keep their latched value until the next latch
+    ticks += 10 * 4194304;
+    ASSERT_EQ(mbc->readRAM(0x0000), 1);
+    mbc->writeROM(0x6000, 0x01);
+    ASSERT_EQ(mbc->readRAM(0x0000), 1);
+    mbc->writeROM(0x6000, 0x00);
+    mbc->writeROM(0x6000, 0x01);
+    switchRAMBank(0x08);
+    ASSERT_EQ(mbc->readRAM(0x0000), 12);
+}
+
+TEST_F(MBC3Test, ClockStateShouldBeSavedAfterTheRAM)
+{
+    int64_t ticks = 0;
+    mbc->setTicksCounter(&ticks);
+    enableRam();
+    switchRAMBank(0x0A);
+    mbc->writeRAM(0x0000, 5);
+
+    auto serialized = mbc->serializeRAM();
+    ASSERT_EQ(serialized.size(), 32_KiB + RealTimeClock::STATE_SIZE);
+    ASSERT_EQ(serialized[32_KiB + 2 * 4], 5);
+
+    switchRAMBank(0x0A);
+    mbc->writeRAM(0x0000, 0);
+    ASSERT_TRUE(mbc->unserializeRAM(serialized));
+    mbc->writeROM(0x6000, 0x00);
+    mbc->writeROM(0x6000, 0x01);
+    ASSERT_EQ(mbc->readRAM(0x0000), 5);
+
+    // The saves without the clock are accepted
+    serialized.resize(32_KiB);
+    ASSERT_TRUE(mbc->unserializeRAM(serialized));
+}
+class MBC5Test : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        std::vector<byte> data{};
+        data.resize(romSize);
+        for (int bank = 0; bank < romSize / romBankSize; ++bank)
+        {
+            // We store the 9 bits rom bank id in each bank
+            data[bank * romBankSize + bankIdAddr] = bank & 0xFF;
+            data[bank * romBankSize + bankIdAddr + 1] = bank >> 8;
+        }
+
+        int cartridgeTypeAddr = 0x0147;
+        data[cartridgeTypeAddr] = Cartridge::CartridgeType::MBC5_RAM_BATTERY;
+        int cartridgeSizeAddr = 0x0148;
+        // Value 8 corresponds to 8MiB
+        int cartridgeSizeValue = 8;
+        data[cartridgeSizeAddr] = cartridgeSizeValue;
+
+        int cartridgeRamSizeAddr = 0x0149;
+        // Value 4 corresponds to 128KiB
+        int cartridgeRamSizeValue = 4;
+        data[cartridgeRamSizeAddr] = cartridgeRamSizeValue;
+        cartridge = std::make_unique<Cartridge>(data);
+        mbc = std::make_unique<MBC5>(cartridge.get());
+    }
+
+    void switchROMBank(int bankId)
+    {
+        mbc->writeROM(0x2000, bankId & 0xFF);
+        mbc->writeROM(0x3000, bankId >> 8);
+    }
+
+    void switchRAMBank(int bankId)
+    {
+        mbc->writeROM(0x4000, bankId);
+    }
+
+    void enableRam()
+    {
+        mbc->writeROM(0x0000, 0x0A);
+    }
+
+    int readSwitchableBankId()
+    {
+        return mbc->readROM(0x4000 + bankIdAddr) | (mbc->readROM(0x4000 + bankIdAddr + 1) << 8);
+    }
+
+    int romSize = 8_MiB;
+    int romBankSize = 16_KiB;
+    int bankIdAddr = 0x1000;
+    std::unique_ptr<Cartridge> cartridge = nullptr;
+    std::unique_ptr<MBC5> mbc = nullptr;
+};
+
+TEST_F(MBC5Test, FactoryShouldCreateMBC5)
+{
+    auto controller = MemoryBankController::createMemoryBankControllerFromCartridge(cartridge.get());
+    ASSERT_NE(dynamic_cast<MBC5*>(controller.get()), nullptr);
+}
+
+TEST_F(MBC5Test, ReadROMInSwappableBankShouldReturnBank1ByDefault)
+{
+    ASSERT_EQ(readSwitchableBankId(), 1);
+    ASSERT_EQ(mbc->getSelectedROMBankId(), 1);
+}
+
+TEST_F(MBC5Test, ReadROMInSwappableBankAfterSwappedToBank0ShouldReturnBank0)
+{
+    switchROMBank(0);
+    ASSERT_EQ(readSwitchableBankId(), 0);
+}
+
+TEST_F(MBC5Test, AllBanksOf8MiBROMShouldBeSelectable)
+{
+    for (int bank : {2, 0xFF, 0x100, 0x155, 0x1FF})
+    {
+        switchROMBank(bank);
+        ASSERT_EQ(readSwitchableBankId(), bank);
+        ASSERT_EQ(mbc->getSelectedROMBankId(), bank);
+        ASSERT_EQ(mbc->getSwitchableROMBank(), cartridge->getData().data() + bank * romBankSize);
+    }
+
+    // The fixed bank is not affected
+    ASSERT_EQ(mbc->readROM(bankIdAddr), 0);
+}
+
+TEST_F(MBC5Test, SwappingRAMBankShouldRetainBankValue)
+{
+    word addr = 0x0001;
+    enableRam();
+    for (int bank = 0; bank < 16; ++bank)
+    {
+        switchRAMBank(bank);
+        mbc->writeRAM(addr, bank + 1);
+    }
+
+    for (int bank = 0; bank < 16; ++bank)
+    {
+        switchRAMBank(bank);
+        ASSERT_EQ(mbc->readRAM(addr), bank + 1);
+        ASSERT_EQ(mbc->getRAMBank()[addr], bank + 1);
+    }
+}
+
+TEST_F(MBC5Test, RAMShouldOnlyBeMappedWhenEnabled)
+{
+    ASSERT_EQ(mbc->getRAMBank(), nullptr);
+    ASSERT_EQ(mbc->readRAM(0x0000), 0xFF);
+    enableRam();
+    ASSERT_NE(mbc->getRAMBank(), nullptr);
+    mbc->writeROM(0x0000, 0x00);
+    ASSERT_EQ(mbc->getRAMBank(), nullptr);
+}
+
+TEST_F(MBC5Test, BankSwitchShouldOnlyBeNotifiedWhenTheMappingChanges)
+{
+    int numberOfNotifications = 0;
+    mbc->setBankSwitchedCallback([&numberOfNotifications]() { numberOfNotifications++; });
+
+    switchROMBank(1);
+    ASSERT_EQ(numberOfNotifications, 0);
+    switchROMBank(0x123);
+    // The low bits then the high bit changed
+    ASSERT_EQ(numberOfNotifications, 2);
+    enableRam();
+    ASSERT_EQ(numberOfNotifications, 3);
+    switchRAMBank(0);
+    ASSERT_EQ(numberOfNotifications, 3);
+}
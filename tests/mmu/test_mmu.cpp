@@ -97,8 +97,12 @@ TEST(MMU, DMATransferShouldCopyDataToOAM)
         value++;
     }
 
-    // Start DMA transfer
+    // Start DMA transfer, it takes 1 tick to start then 1 tick per byte
     mmu.write(0xFF46, dmaTransferSourceAddrStart >> 8);
+    mmu.stepDMA(160);
+    ASSERT_TRUE(mmu.isDMATransferActive());
+    mmu.stepDMA(1);
+    ASSERT_FALSE(mmu.isDMATransferActive());
 
     int expectedValue = 1;
     for (int addr = startOAMAddr; addr <= endOAMAddr; addr++)
@@ -106,4 +110,272 @@ TEST(MMU, DMATransferShouldCopyDataToOAM)
         ASSERT_EQ(mmu.read(addr), expectedValue) << addr;
         expectedValue++;
     }
-}
\ No newline at end of file
+}
+TEST(MMU, CPUShouldOnlyAccessHighRAMDuringDMATransfer)
+{
+    auto mmu = MMU();
+    mmu.write(0xC000, 0x12);
+    mmu.write(0xFF80, 0x34);
+    mmu.write(0xFF46, 0xC0);
+    ASSERT_EQ(mmu.getTicksUntilNextEvent(), 161);
+
+    mmu.stepDMA(100);
+    ASSERT_EQ(mmu.getTicksUntilNextEvent(), 61);
+    ASSERT_EQ(mmu.read(0xC000), 0xFF);
+    ASSERT_EQ(mmu.read(0xFE00), 0xFF);
+    ASSERT_EQ(mmu.getMemoryBankKey(0xC000), MMU::UNCACHEABLE_BANK_KEY);
+    mmu.write(0xC000, 0x56);
+    ASSERT_EQ(mmu.read(0xFF80), 0x34);
+    mmu.write(0xFF81, 0x78);
+    ASSERT_EQ(mmu.read(0xFF81), 0x78);
+    ASSERT_EQ(mmu.read(0xFF46), 0xC0);
+
+    mmu.stepDMA(61);
+    ASSERT_FALSE(mmu.isDMATransferActive());
+    ASSERT_EQ(mmu.read(0xC000), 0x12);
+    ASSERT_EQ(mmu.read(0xFE00), 0x12);
+}
+
+TEST(MMU, DMATransferFromEchoRAMShouldReadTheWorkRAM)
+{
+    auto mmu = MMU();
+    for (int i = 0; i < 160; ++i)
+    {
+        mmu.write(0xC100 + i, i);
+        mmu.write(0xE100 + i, 0);
+    }
+
+    mmu.write(0xFF46, 0xE1);
+    mmu.stepDMA(1000);
+
+    for (int i = 0; i < 160; ++i)
+    {
+        ASSERT_EQ(mmu.read(0xFE00 + i), i);
+    }
+}
+
+TEST(MMU, RestartedDMATransferShouldKeepTheBytesAlreadyTransferred)
+{
+    auto mmu = MMU();
+    for (int i = 0; i < 160; ++i)
+    {
+        mmu.write(0xC000 + i, 0x11);
+        mmu.write(0xD000 + i, 0x22);
+    }
+
+    mmu.write(0xFF46, 0xC0);
+    mmu.stepDMA(51);
+    mmu.write(0xFF46, 0xD0);
+    ASSERT_EQ(mmu.getOAM().read(49), 0x11);
+    ASSERT_EQ(mmu.getOAM().read(50), 0x00);
+
+    mmu.stepDMA(161);
+    ASSERT_FALSE(mmu.isDMATransferActive());
+    ASSERT_EQ(mmu.read(0xFE00), 0x22);
+    ASSERT_EQ(mmu.read(0xFE00 + 159), 0x22);
+}
+
+class MMUPageTableTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        // 4 banks of MBC1 ROM, each byte is the id of its bank
+        std::vector<byte> data(4 * romBankSize);
+        for (size_t i = 0; i < data.size(); ++i)
+        {
+            data[i] = static_cast<byte>(i / romBankSize);
+        }
+        data[0x0147] = Cartridge::CartridgeType::MBC1;
+        data[0x0148] = 1;
+        // CGB only cartridge to be able to switch the VRAM and WRAM banks
+        data[0x0143] = 0xC0;
+        data[0x0134] = 0x42;
+        ASSERT_TRUE(mmu.loadCartridgeData(data));
+    }
+
+    MMU mmu;
+    static constexpr int romBankSize = 0x4000;
+};
+
+TEST_F(MMUPageTableTest, ReadingROMShouldReturnTheBankSelected)
+{
+    // Unmap the boot rom
+    mmu.write(0xFF50, 1);
+    ASSERT_EQ(mmu.read(0x0000), 0);
+    ASSERT_EQ(mmu.read(0x3FFF), 0);
+    ASSERT_EQ(mmu.read(0x4000), 1);
+
+    mmu.write(0x2000, 3);
+    ASSERT_EQ(mmu.read(0x4000), 3);
+    ASSERT_EQ(mmu.read(0x7FFF), 3);
+    ASSERT_EQ(mmu.read(0x3FFF), 0);
+}
+
+TEST_F(MMUPageTableTest, UnmappingTheBootRomShouldMapTheROM)
+{
+    ASSERT_EQ(mmu.read(0x0000), MMU::BOOTROM[0]);
+    ASSERT_EQ(mmu.read(0x0200), MMU::BOOTROM[0x0200]);
+    // The cartridge header is always mapped
+    ASSERT_EQ(mmu.read(0x0134), 0x42);
+
+    mmu.write(0xFF50, 1);
+    ASSERT_EQ(mmu.read(0x0000), 0);
+    ASSERT_EQ(mmu.read(0x0200), 0);
+    ASSERT_EQ(mmu.read(0x0134), 0x42);
+}
+
+TEST_F(MMUPageTableTest, WritingROMShouldNotChangeIt)
+{
+    mmu.write(0xFF50, 1);
+    mmu.write(0x6000, 0x12);
+    ASSERT_EQ(mmu.read(0x6000), 1);
+}
+
+TEST_F(MMUPageTableTest, SwitchingWRAMBankShouldKeepTheValueOfEachBank)
+{
+    mmu.write(0xFF70, 1);
+    mmu.write(0xC000, 0x12);
+    mmu.write(0xD000, 0x34);
+    mmu.write(0xFF70, 2);
+    ASSERT_EQ(mmu.read(0xC000), 0x12);
+    ASSERT_EQ(mmu.read(0xD000), 0x00);
+    mmu.write(0xD000, 0x56);
+
+    mmu.write(0xFF70, 1);
+    ASSERT_EQ(mmu.read(0xD000), 0x34);
+    mmu.write(0xFF70, 2);
+    ASSERT_EQ(mmu.read(0xD000), 0x56);
+}
+
+TEST_F(MMUPageTableTest, SwitchingVRAMBankShouldKeepTheValueOfEachBank)
+{
+    mmu.write(0x8000, 0x12);
+    mmu.write(0xFF4F, 1);
+    ASSERT_EQ(mmu.read(0x8000), 0x00);
+    mmu.write(0x9FFF, 0x34);
+    ASSERT_EQ(mmu.getVRAM().readFromBank(0x1FFF, 1), 0x34);
+
+    mmu.write(0xFF4F, 0);
+    ASSERT_EQ(mmu.read(0x8000), 0x12);
+    ASSERT_EQ(mmu.read(0x9FFF), 0x00);
+}
+
+TEST_F(MMUPageTableTest, HighRAMShouldBeReadableAndWritable)
+{
+    for (int addr = 0xFF80; addr <= 0xFFFE; ++addr)
+    {
+        mmu.write(addr, static_cast<byte>(addr));
+    }
+
+    for (int addr = 0xFF80; addr <= 0xFFFE; ++addr)
+    {
+        ASSERT_EQ(mmu.read(addr), static_cast<byte>(addr));
+    }
+}
+
+TEST(MMU, UnmappedIORegistersShouldReadAsFF)
+{
+    auto mmu = MMU();
+
+    for (int addr : {0xFF03, 0xFF08, 0xFF0E, 0xFF4C, 0xFF4E, 0xFF68, 0xFF6A, 0xFF7F})
+    {
+        mmu.write(addr, 0x00);
+        ASSERT_EQ(mmu.read(addr), 0xFF) << addr;
+    }
+}
+
+TEST(MMU, UnusedBitsOfIORegistersShouldReadAsOne)
+{
+    auto mmu = MMU();
+
+    mmu.write(0xFF00, 0x00);
+    ASSERT_EQ(mmu.read(0xFF00), 0xC0);
+    mmu.write(0xFF02, 0x00);
+    ASSERT_EQ(mmu.read(0xFF02), 0x7E);
+    // Serial data register has no unused bits
+    mmu.write(0xFF01, 0x00);
+    ASSERT_EQ(mmu.read(0xFF01), 0x00);
+
+    ASSERT_EQ(mmu.read(0xFF50), 0xFE);
+    mmu.write(0xFF50, 0x01);
+    ASSERT_EQ(mmu.read(0xFF50), 0xFF);
+}
+
+TEST(MMU, ColorIORegistersShouldBeUnmappedInMonochromeMode)
+{
+    auto mmu = MMU();
+    std::vector<byte> data(0x8000);
+    ASSERT_TRUE(mmu.loadCartridgeData(data));
+    mmu.write(0xFF50, 0x01);
+    ASSERT_FALSE(mmu.isColorModeSupported());
+
+    for (int addr : {0xFF4D, 0xFF4F, 0xFF55, 0xFF69, 0xFF6B, 0xFF70})
+    {
+        mmu.write(addr, 0x00);
+        ASSERT_EQ(mmu.read(addr), 0xFF) << addr;
+    }
+}
+
+TEST(MMU, HardwareModelShouldFollowTheBootromThenTheCartridge)
+{
+    auto mmu = MMU();
+    ASSERT_EQ(mmu.getHardwareModel(), HardwareModel::CGB);
+
+    std::vector<byte> data(0x8000);
+    ASSERT_TRUE(mmu.loadCartridgeData(data));
+    // The bootrom runs in color mode, the VRAM banks can be switched
+    ASSERT_EQ(mmu.getHardwareModel(), HardwareModel::CGB);
+    mmu.write(0xFF4F, 0x01);
+    mmu.write(0x8000, 0x42);
+    mmu.write(0xFF4F, 0x00);
+    ASSERT_EQ(mmu.read(0x8000), 0x00);
+
+    mmu.write(0xFF50, 0x01);
+    ASSERT_EQ(mmu.getHardwareModel(), HardwareModel::DMG);
+    ASSERT_FALSE(mmu.isColorModeSupported());
+    mmu.write(0xFF4F, 0x01);
+    ASSERT_EQ(mmu.read(0xFF4F), 0xFF);
+    ASSERT_EQ(mmu.read(0x8000), 0x00);
+
+    // CGB compatible cartridge
+    data[0x0143] = 0x80;
+    ASSERT_TRUE(mmu.loadCartridgeData(data));
+    ASSERT_EQ(mmu.getHardwareModel(), HardwareModel::CGB);
+    mmu.write(0xFF4F, 0x01);
+    ASSERT_EQ(mmu.read(0x8000), 0x42);
+}
+
+TEST(MMU, CartridgeBanksShouldFollowTheMemoryBankController)
+{
+    auto mmu = MMU();
+    // 64 banks of MBC5 ROM with 32KiB of RAM, each bank starts with its id
+    std::vector<byte> data(64 * 0x4000);
+    for (size_t bank = 0; bank < 64; ++bank)
+    {
+        data[bank * 0x4000] = static_cast<byte>(bank);
+    }
+    data[0x0147] = Cartridge::CartridgeType::MBC5_RAM;
+    data[0x0148] = 5;
+    data[0x0149] = 3;
+    ASSERT_TRUE(mmu.loadCartridgeData(data));
+    mmu.write(0xFF50, 1);
+
+    mmu.write(0x2000, 42);
+    ASSERT_EQ(mmu.read(0x4000), 42);
+    mmu.write(0x2000, 0);
+    ASSERT_EQ(mmu.read(0x4000), 0);
+
+    // Disabled RAM reads open bus
+    ASSERT_EQ(mmu.read(0xA000), 0xFF);
+    mmu.write(0x0000, 0x0A);
+    mmu.write(0xA000, 0x12);
+    mmu.write(0x4000, 1);
+    mmu.write(0xBFFF, 0x34);
+    ASSERT_EQ(mmu.read(0xA000), 0x00);
+    mmu.write(0x4000, 0);
+    ASSERT_EQ(mmu.read(0xA000), 0x12);
+    ASSERT_EQ(mmu.read(0xBFFF), 0x00);
+    mmu.write(0x0000, 0x00);
+    ASSERT_EQ(mmu.read(0xA000), 0xFF);
+}
@@ -0,0 +1,126 @@
+#include "memory/mbc/real_time_clock.hpp"
+#include <gtest/gtest.h>
+
+class RealTimeClockTest : public ::testing::Test
+{
+  protected:
+    byte readAfterLatch(RealTimeClock::Register reg)
+    {
+        clock.latch(ticks);
+        return clock.readLatchedRegister(reg);
+    }
+
+    void advanceSeconds(int64_t seconds)
+    {
+        ticks += seconds * TICKS_PER_SECOND;
+    }
+
+    static constexpr int64_t TICKS_PER_SECOND = 4194304;
+    int64_t ticks = 0;
+    RealTimeClock clock;
+};
+
+TEST_F(RealTimeClockTest, TimeShouldBeComputedFromTheTicksElapsed)
+{
+    advanceSeconds(2 * 24 * 60 * 60 + 3 * 60 * 60 + 4 * 60 + 5);
+    ticks += TICKS_PER_SECOND - 1;
+    ASSERT_EQ(readAfterLatch(RealTimeClock::SECONDS), 5);
+    ASSERT_EQ(readAfterLatch(RealTimeClock::MINUTES), 4);
+    ASSERT_EQ(readAfterLatch(RealTimeClock::HOURS), 3);
+    ASSERT_EQ(readAfterLatch(RealTimeClock::DAYS_LOW), 2);
+    ASSERT_EQ(readAfterLatch(RealTimeClock::DAYS_HIGH), 0);
+
+    // The part of a second elapsed is kept
+    ticks += 1;
+    ASSERT_EQ(readAfterLatch(RealTimeClock::SECONDS), 6);
+}
+
+TEST_F(RealTimeClockTest, HaltedClockShouldNotCount)
+{
+    clock.writeRegister(RealTimeClock::DAYS_HIGH, 0x40, ticks);
+    advanceSeconds(10);
+    ASSERT_EQ(readAfterLatch(RealTimeClock::SECONDS), 0);
+
+    clock.writeRegister(RealTimeClock::DAYS_HIGH, 0x00, ticks);
+    advanceSeconds(10);
+    ASSERT_EQ(readAfterLatch(RealTimeClock::SECONDS), 10);
+}
+
+TEST_F(RealTimeClockTest, DayCounterOverflowShouldSetTheCarry)
+{
+    clock.writeRegister(RealTimeClock::DAYS_LOW, 0xFF, ticks);
+    clock.writeRegister(RealTimeClock::DAYS_HIGH, 0x01, ticks);
+    clock.writeRegister(RealTimeClock::HOURS, 23, ticks);
+    clock.writeRegister(RealTimeClock::MINUTES, 59, ticks);
+    clock.writeRegister(RealTimeClock::SECONDS, 59, ticks);
+    advanceSeconds(1);
+    ASSERT_EQ(readAfterLatch(RealTimeClock::DAYS_LOW), 0);
+    ASSERT_EQ(readAfterLatch(RealTimeClock::DAYS_HIGH), 0x80);
+
+    // The carry stays set until it's written
+    advanceSeconds(24 * 60 * 60);
+    ASSERT_EQ(readAfterLatch(RealTimeClock::DAYS_LOW), 1);
+    ASSERT_EQ(readAfterLatch(RealTimeClock::DAYS_HIGH), 0x80);
+    clock.writeRegister(RealTimeClock::DAYS_HIGH, 0x00, ticks);
+    ASSERT_EQ(readAfterLatch(RealTimeClock::DAYS_HIGH), 0x00);
+}
+
+TEST_F(RealTimeClockTest, OutOfRangeValuesShouldWrapAroundWithoutCarry)
+{
+    clock.writeRegister(RealTimeClock::SECONDS, 62, ticks);
+    advanceSeconds(1);
+    ASSERT_EQ(readAfterLatch(RealTimeClock::SECONDS), 63);
+    advanceSeconds(1);
+    ASSERT_EQ(readAfterLatch(RealTimeClock::SECONDS), 0);
+    ASSERT_EQ(readAfterLatch(RealTimeClock::MINUTES), 0);
+
+    // Only the bits of the registers are kept
+    clock.writeRegister(RealTimeClock::HOURS, 0xFF, ticks);
+    ASSERT_EQ(readAfterLatch(RealTimeClock::HOURS), 0x1F);
+    advanceSeconds(60 * 60);
+    ASSERT_EQ(readAfterLatch(RealTimeClock::HOURS), 0);
+    ASSERT_EQ(readAfterLatch(RealTimeClock::DAYS_LOW), 0);
+}
+
+TEST_F(RealTimeClockTest, WritingTheSecondsShouldResetTheDivider)
+{
+    ticks += TICKS_PER_SECOND / 2;
+    clock.writeRegister(RealTimeClock::SECONDS, 0, ticks);
+    ticks += TICKS_PER_SECOND / 2;
+    ASSERT_EQ(readAfterLatch(RealTimeClock::SECONDS), 0);
+}
+
+TEST_F(RealTimeClockTest, ResetOfTheTicksShouldNotMoveTheClockBack)
+{
+    advanceSeconds(5);
+    ASSERT_EQ(readAfterLatch(RealTimeClock::SECONDS), 5);
+    ticks = 0;
+    ASSERT_EQ(readAfterLatch(RealTimeClock::SECONDS), 5);
+    advanceSeconds(1);
+    ASSERT_EQ(readAfterLatch(RealTimeClock::SECONDS), 6);
+}
+
+TEST_F(RealTimeClockTest, HostTimeElapsedShouldBeAddedOnLoad)
+{
+    advanceSeconds(30);
+    std::array<byte, RealTimeClock::STATE_SIZE> state = {};
+    clock.saveState(state.data(), ticks, 1000000);
+    ASSERT_EQ(state[0], 30);
+    ASSERT_EQ(state[40], 1000000 & 0xFF);
+
+    RealTimeClock loaded;
+    loaded.loadState(state.data(), 0, 1000000 + 2 * 60 * 60 + 45);
+    loaded.latch(0);
+    ASSERT_EQ(loaded.readLatchedRegister(RealTimeClock::SECONDS), 15);
+    ASSERT_EQ(loaded.readLatchedRegister(RealTimeClock::MINUTES), 1);
+    ASSERT_EQ(loaded.readLatchedRegister(RealTimeClock::HOURS), 2);
+}
+
+TEST_F(RealTimeClockTest, LoadedStateWithoutHostTimeShouldNotAdvance)
+{
+    std::array<byte, RealTimeClock::STATE_SIZE> state = {};
+    state[4] = 12;
+    clock.loadState(state.data(), ticks, 1000000);
+    ASSERT_EQ(readAfterLatch(RealTimeClock::MINUTES), 12);
+    ASSERT_EQ(readAfterLatch(RealTimeClock::SECONDS), 0);
+}
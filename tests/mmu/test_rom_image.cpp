@@ -0,0 +1,84 @@
+#include "memory/mmu.hpp"
+#include "memory/rom_image.hpp"
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+
+class ROMImageTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        path = ::testing::TempDir() + "/rom_image_test.gb";
+        rom.resize(4 * 0x4000);
+        for (size_t i = 0; i < rom.size(); ++i)
+        {
+            rom[i] = static_cast<byte>(i / 0x4000);
+        }
+        rom[0x0147] = Cartridge::CartridgeType::MBC1;
+        rom[0x0148] = 1;
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(rom.data()), static_cast<std::streamsize>(rom.size()));
+    }
+
+    void TearDown() override
+    {
+        std::remove(path.c_str());
+    }
+
+    std::string path;
+    std::vector<byte> rom;
+};
+
+TEST_F(ROMImageTest, ImageLoadedFromFileShouldHaveTheContentOfTheFile)
+{
+    std::shared_ptr<const ROMImage> image = ROMImage::loadFromFile(path);
+    ASSERT_NE(image, nullptr);
+    ASSERT_EQ(image->size(), rom.size());
+    ASSERT_TRUE(std::equal(rom.begin(), rom.end(), image->data()));
+    ASSERT_EQ(image->getHash(), utils::computeHash(rom));
+#if defined(__linux__)
+    ASSERT_TRUE(image->isMemoryMapped());
+    // The image is shared while it's in use
+    ASSERT_EQ(ROMImage::loadFromFile(path), image);
+#endif
+}
+
+TEST_F(ROMImageTest, MissingFileShouldNotBeLoaded)
+{
+    ASSERT_EQ(ROMImage::loadFromFile(path + ".missing"), nullptr);
+}
+
+TEST_F(ROMImageTest, ImageCreatedFromDataShouldOwnIt)
+{
+    std::shared_ptr<const ROMImage> image = ROMImage::create(rom.data(), rom.size());
+    ASSERT_FALSE(image->isMemoryMapped());
+    ASSERT_NE(image->data(), rom.data());
+    ASSERT_EQ((*image)[0x4000], 1);
+    ASSERT_EQ(image->getHash(), utils::computeHash(rom));
+}
+
+TEST_F(ROMImageTest, EmulatorsShouldShareTheImageOfTheROM)
+{
+    std::shared_ptr<const ROMImage> image = ROMImage::loadFromFile(path);
+    ASSERT_NE(image, nullptr);
+    {
+        MMU first;
+        MMU second;
+        ASSERT_TRUE(first.loadCartridge(image));
+        ASSERT_TRUE(second.loadCartridge(image));
+        ASSERT_EQ(first.getCartridge()->getData().data(), image->data());
+        ASSERT_EQ(second.getCartridge()->getData().data(), image->data());
+        ASSERT_EQ(image.use_count(), 3);
+
+        first.write(0xFF50, 1);
+        first.write(0x2000, 3);
+        ASSERT_EQ(first.read(0x4000), 3);
+        second.write(0xFF50, 1);
+        ASSERT_EQ(second.read(0x4000), 1);
+    }
+
+    // Released with the cartridges
+    ASSERT_EQ(image.use_count(), 1);
+}
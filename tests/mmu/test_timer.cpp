@@ -192,20 +192,120 @@ TEST_F(TimerTest, TimerCounterShouldRaiseTimerInterruptOnOverflow)
     ASSERT_TRUE(interruptManager->isInterruptPending(InterruptType::TIMER));
 }
 
-TEST_F(TimerTest, InternalTimerCounterShouldResetWhenChangingClockDivider)
+TEST_F(TimerTest, ChangingClockDividerShouldKeepTheInternalCounter)
 {
     timer->enableTimerCounter(true);
-    int clockDivider = 3;
-    int ticksToIncrement = 64;
-    timer->setClockDivider(clockDivider);
+    timer->setClockDivider(3);
+    timer->tick(63);
     ASSERT_EQ(timer->getTimerCounterValue(), 0);
-    timer->tick(ticksToIncrement - 1);
+
+    // The bit watched goes from set to cleared, it's a falling edge
+    timer->setClockDivider(0);
+    ASSERT_EQ(timer->getTimerCounterValue(), 1);
+
+    // The next increment is at the next multiple of 1024 cycles of the internal counter
+    timer->tick(192);
+    ASSERT_EQ(timer->getTimerCounterValue(), 1);
+    timer->tick(1);
+    ASSERT_EQ(timer->getTimerCounterValue(), 2);
+}
+
+TEST_F(TimerTest, DisablingTimerCounterShouldIncrementItOnFallingEdge)
+{
+    timer->enableTimerCounter(true);
+    timer->setClockDivider(1);
+    timer->tick(2);
     ASSERT_EQ(timer->getTimerCounterValue(), 0);
-    clockDivider = 0;
-    ticksToIncrement = 256;
-    timer->setClockDivider(clockDivider);
+
+    timer->enableTimerCounter(false);
+    ASSERT_EQ(timer->getTimerCounterValue(), 1);
+    timer->tick(100);
+    ASSERT_EQ(timer->getTimerCounterValue(), 1);
+}
+
+TEST_F(TimerTest, DisablingTimerCounterShouldNotIncrementItWithoutFallingEdge)
+{
+    timer->enableTimerCounter(true);
+    timer->setClockDivider(1);
     timer->tick(1);
+
+    timer->enableTimerCounter(false);
     ASSERT_EQ(timer->getTimerCounterValue(), 0);
-    timer->tick(ticksToIncrement);
+}
+
+TEST_F(TimerTest, ResettingDivRegisterShouldIncrementTimerCounterOnFallingEdge)
+{
+    timer->enableTimerCounter(true);
+    timer->setClockDivider(1);
+    timer->tick(2);
+    ASSERT_EQ(timer->getTimerCounterValue(), 0);
+
+    mmu.write(DIV_ADDR, 0x12);
+    ASSERT_EQ(timer->getTimerCounterValue(), 1);
+
+    // The internal counter was reset, the next increment is a whole period away
+    timer->tick(3);
     ASSERT_EQ(timer->getTimerCounterValue(), 1);
-}
\ No newline at end of file
+    timer->tick(1);
+    ASSERT_EQ(timer->getTimerCounterValue(), 2);
+}
+
+TEST_F(TimerTest, ResettingDivRegisterShouldNotIncrementTimerCounterWithoutFallingEdge)
+{
+    timer->enableTimerCounter(true);
+    timer->setClockDivider(1);
+    timer->tick(1);
+
+    mmu.write(DIV_ADDR, 0x12);
+    ASSERT_EQ(timer->getTimerCounterValue(), 0);
+}
+
+TEST_F(TimerTest, WritingTimerControlShouldIncrementTimerCounterOnFallingEdge)
+{
+    mmu.write(CONTROL_ADDR, 0b101);
+    timer->tick(2);
+
+    // The bit 7 of the internal counter is cleared
+    mmu.write(CONTROL_ADDR, 0b111);
+    ASSERT_EQ(timer->getTimerCounterValue(), 1);
+}
+
+TEST_F(TimerTest, TicksUntilNextEventShouldStopAtTimerCounterOverflow)
+{
+    timer->enableTimerCounter(true);
+    timer->setClockDivider(1);
+    timer->setTimerCounterValue(0xFE);
+    timer->tick(1);
+
+    // 2 increments of 4 ticks, one was already done
+    int ticks = timer->getTicksUntilNextEvent();
+    ASSERT_EQ(ticks, 7);
+    timer->tick(ticks - 1);
+    ASSERT_FALSE(interruptManager->isInterruptPending(InterruptType::TIMER));
+    timer->tick(1);
+    ASSERT_TRUE(interruptManager->isInterruptPending(InterruptType::TIMER));
+}
+
+TEST_F(TimerTest, TickingUntilNextEventShouldMatchTickingOneByOne)
+{
+    Timer reference(interruptManager.get());
+    for (Timer* t : {timer.get(), &reference})
+    {
+        t->enableTimerCounter(true);
+        t->setClockDivider(2);
+        t->setTimerModuloValue(0xF0);
+    }
+
+    for (int i = 0; i < 100; ++i)
+    {
+        int ticks = timer->getTicksUntilNextEvent();
+        ASSERT_GE(ticks, 1);
+        timer->tick(ticks);
+        for (int j = 0; j < ticks; ++j)
+        {
+            reference.tick(1);
+        }
+        ASSERT_EQ(timer->getDividerRegisterValue(), reference.getDividerRegisterValue());
+        ASSERT_EQ(timer->getTimerCounterValue(), reference.getTimerCounterValue());
+    }
+}
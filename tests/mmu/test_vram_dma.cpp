@@ -0,0 +1,174 @@
+#include "cpu/instructions.hpp"
+#include "emulator.hpp"
+#include <gtest/gtest.h>
+
+using namespace standardInstructions;
+
+class VRAMDMATest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        // CGB only cartridge, the VRAM DMA registers are unmapped otherwise
+        std::vector<byte> data(2 * 0x4000);
+        data[0x0143] = 0xC0;
+        ASSERT_TRUE(emulator.getMMU().loadCartridgeData(data));
+        emulator.getMMU().write(0xFF50, 0x01);
+        emulator.getCPU().setIdleLoopDetectionEnabled(false);
+
+        for (int i = 0; i < 0x100; ++i)
+        {
+            mmu().write(static_cast<word>(0xD000 + i), static_cast<byte>(i + 1));
+        }
+    }
+
+    MMU& mmu()
+    {
+        return emulator.getMMU();
+    }
+
+    void setSourceAndDestination(word source, word destination)
+    {
+        mmu().write(0xFF51, source >> 8);
+        mmu().write(0xFF52, source & 0xFF);
+        mmu().write(0xFF53, destination >> 8);
+        mmu().write(0xFF54, destination & 0xFF);
+    }
+
+    void writeProgram(word addr, const std::vector<byte>& program)
+    {
+        for (size_t i = 0; i < program.size(); ++i)
+        {
+            mmu().write(static_cast<word>(addr + i), program[i]);
+        }
+        emulator.getCPU().setProgramCounter(addr);
+    }
+
+    Emulator emulator;
+};
+
+TEST_F(VRAMDMATest, GeneralPurposeDMAShouldCopyAllTheBlocksAtOnce)
+{
+    // The lower bits of the addresses are ignored
+    setSourceAndDestination(0xD00F, 0x8105);
+    mmu().write(0xFF55, 0x02);
+
+    ASSERT_EQ(mmu().read(0xFF55), 0xFF);
+    ASSERT_EQ(mmu().read(0x80FF), 0x00);
+    for (int i = 0; i < 3 * 16; ++i)
+    {
+        ASSERT_EQ(mmu().read(static_cast<word>(0x8100 + i)), i + 1) << i;
+    }
+    ASSERT_EQ(mmu().read(0x8130), 0x00);
+    ASSERT_EQ(mmu().consumeStalledTicks(), 3 * 8);
+    ASSERT_EQ(mmu().consumeStalledTicks(), 0);
+
+    // The next transfer continues where the previous one stopped
+    mmu().write(0xFF55, 0x00);
+    ASSERT_EQ(mmu().read(0x8130), 3 * 16 + 1);
+}
+
+TEST_F(VRAMDMATest, GeneralPurposeDMAShouldWriteTheSelectedVRAMBank)
+{
+    setSourceAndDestination(0xD000, 0x8000);
+    mmu().write(0xFF4F, 0x01);
+    mmu().write(0xFF55, 0x00);
+
+    ASSERT_EQ(mmu().read(0x8000), 0x01);
+    mmu().write(0xFF4F, 0x00);
+    ASSERT_EQ(mmu().read(0x8000), 0x00);
+}
+
+TEST_F(VRAMDMATest, HBlankDMAShouldCopyABlockPerHorizontalBlank)
+{
+    setSourceAndDestination(0xD000, 0x8000);
+    mmu().write(0xFF55, 0x82);
+    ASSERT_EQ(mmu().read(0xFF55), 0x02);
+    ASSERT_EQ(mmu().read(0x8000), 0x00);
+
+    mmu().notifyHBlankStarted();
+    ASSERT_EQ(mmu().read(0xFF55), 0x01);
+    ASSERT_EQ(mmu().read(0x800F), 0x10);
+    ASSERT_EQ(mmu().read(0x8010), 0x00);
+    ASSERT_EQ(mmu().consumeStalledTicks(), 8);
+
+    mmu().notifyHBlankStarted();
+    mmu().notifyHBlankStarted();
+    ASSERT_EQ(mmu().read(0xFF55), 0xFF);
+    ASSERT_EQ(mmu().read(0x802F), 0x30);
+
+    mmu().notifyHBlankStarted();
+    ASSERT_EQ(mmu().read(0x8030), 0x00);
+}
+
+TEST_F(VRAMDMATest, StoppedHBlankDMAShouldKeepTheNumberOfBlocksLeft)
+{
+    setSourceAndDestination(0xD000, 0x8000);
+    mmu().write(0xFF55, 0x83);
+    mmu().notifyHBlankStarted();
+    mmu().write(0xFF55, 0x00);
+
+    ASSERT_EQ(mmu().read(0xFF55), 0x82);
+    mmu().notifyHBlankStarted();
+    ASSERT_EQ(mmu().read(0x8010), 0x00);
+}
+
+TEST_F(VRAMDMATest, RegistersShouldBeUnmappedInNonColorMode)
+{
+    std::vector<byte> data(2 * 0x4000);
+    ASSERT_TRUE(mmu().loadCartridgeData(data));
+    mmu().write(0xFF50, 0x01);
+
+    setSourceAndDestination(0xD000, 0x8000);
+    mmu().write(0xFF55, 0x00);
+    ASSERT_EQ(mmu().read(0xFF55), 0xFF);
+    ASSERT_EQ(mmu().read(0x8000), 0x00);
+}
+
+TEST_F(VRAMDMATest, GeneralPurposeDMAShouldStopTheCPU)
+{
+    setSourceAndDestination(0xD000, 0x8000);
+    writeProgram(0xC000, {LD_A_n, 0x03, LDH_nm_A, 0x55, NOP});
+
+    emulator.exec();
+    int ticksBeforeTransfer = emulator.getCurrentTicks();
+    emulator.exec();
+
+    // The instruction takes 3 ticks, then 8 ticks for each of the 4 blocks
+    ASSERT_EQ(emulator.getCurrentTicks() - ticksBeforeTransfer, 3 + 4 * 8);
+    ASSERT_EQ(emulator.getCPU().getProgramCounter(), 0xC004);
+    ASSERT_EQ(mmu().read(0x803F), 0x40);
+}
+
+TEST_F(VRAMDMATest, HBlankDMAShouldBeCopiedWhenThePPUEntersTheHorizontalBlank)
+{
+    // Infinite loop while the display renders the lines
+    setSourceAndDestination(0xD000, 0x8000);
+    writeProgram(0xC000, {JR_n, 0xFE});
+    mmu().write(0xFF40, 0x80);
+    while (emulator.getPPU().getMode() != PPU::Mode::OAM_ACCESS)
+    {
+        emulator.exec();
+    }
+    mmu().write(0xFF55, 0x81);
+
+    int numberOfHBlanks = 0;
+    PPU::Mode previousMode = emulator.getPPU().getMode();
+    while (numberOfHBlanks < 2)
+    {
+        emulator.exec();
+        PPU::Mode mode = emulator.getPPU().getMode();
+        if (mode == PPU::Mode::HBLANK && previousMode != PPU::Mode::HBLANK)
+        {
+            numberOfHBlanks++;
+            ASSERT_EQ(mmu().read(0x800F), 0x10);
+            ASSERT_EQ(mmu().read(0x801F), numberOfHBlanks == 2 ? 0x20 : 0x00);
+        }
+        else if (mode != PPU::Mode::HBLANK && numberOfHBlanks == 0)
+        {
+            ASSERT_EQ(mmu().read(0x8000), 0x00);
+        }
+        previousMode = mode;
+    }
+    ASSERT_EQ(mmu().read(0xFF55), 0xFF);
+}
@@ -22,7 +22,7 @@ class AcidTest : public ::testing::Test
         int expectedFrameId = 500;
         while (emulator.getPPU().getFrameId() < expectedFrameId)
         {
-            emulator.exec();
+            emulator.runFrame();
         }
 
         const RGBImage& image = emulator.getPPU().getLastRenderedFrame();
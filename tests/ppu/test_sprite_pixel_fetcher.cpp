@@ -65,7 +65,7 @@ TEST_F(SpritePixelFetcherTest, ResetShouldDeactivateFetcher)
 TEST_F(SpritePixelFetcherTest, StepShouldReturnTrueWhenInactive)
 {
     SpritePixelFetcher fetcher(&mmu.getVRAM(), &ppu, oamFifo);
-    ASSERT_TRUE(fetcher.step());
+    ASSERT_TRUE(fetcher.step<HardwareModel::CGB>());
 }
 
 TEST_F(SpritePixelFetcherTest, FetchShouldCompleteAfterCorrectNumberOfSteps)
@@ -85,7 +85,7 @@ TEST_F(SpritePixelFetcherTest, FetchShouldCompleteAfterCorrectNumberOfSteps)
     // 2 for GetTileId, 2 for GetTileDataLow, 2 for GetTileDataHigh, 2 for Sleep
     // Then Push is immediate
     int stepCount = 0;
-    while (!fetcher.step())
+    while (!fetcher.step<HardwareModel::CGB>())
     {
         stepCount++;
         ASSERT_LT(stepCount, 12); // Safety check to prevent infinite loop
@@ -116,7 +116,7 @@ TEST_F(SpritePixelFetcherTest, FetchShouldPushSpritePixelsToOAMFifo)
     fetcher.startFetching(&sprite, 0);
 
     // Run until complete
-    while (!fetcher.step())
+    while (!fetcher.step<HardwareModel::CGB>())
     {
     }
 
@@ -151,7 +151,7 @@ TEST_F(SpritePixelFetcherTest, TransparentSpritePixelsShouldRemainTransparent)
     Sprite sprite(mmu.getOAM(), 0);
     fetcher.startFetching(&sprite, 0);
 
-    while (!fetcher.step())
+    while (!fetcher.step<HardwareModel::CGB>())
     {
     }
 
@@ -182,7 +182,7 @@ TEST_F(SpritePixelFetcherTest, SpriteBehindBGShouldHaveNegativePriority)
     Sprite sprite(mmu.getOAM(), 0);
     fetcher.startFetching(&sprite, 0);
 
-    while (!fetcher.step())
+    while (!fetcher.step<HardwareModel::CGB>())
     {
     }
 
@@ -214,7 +214,7 @@ TEST_F(SpritePixelFetcherTest, SpriteShouldPushToOAMFifoRegardlessOfBGPriority)
     Sprite sprite(mmu.getOAM(), 0);
     fetcher.startFetching(&sprite, 0);
 
-    while (!fetcher.step())
+    while (!fetcher.step<HardwareModel::CGB>())
     {
     }
 
@@ -247,7 +247,7 @@ TEST_F(SpritePixelFetcherTest, HorizontallyFlippedSpriteShouldReversePixels)
     Sprite sprite(mmu.getOAM(), 0);
     fetcher.startFetching(&sprite, 0);
 
-    while (!fetcher.step())
+    while (!fetcher.step<HardwareModel::CGB>())
     {
     }
 
@@ -288,7 +288,7 @@ TEST_F(SpritePixelFetcherTest, HigherPriorityExistingSpriteShouldNotBeReplaced)
     Sprite sprite(mmu.getOAM(), 1); // OAM index 1 = lower priority
     fetcher.startFetching(&sprite, 0);
 
-    while (!fetcher.step())
+    while (!fetcher.step<HardwareModel::CGB>())
     {
     }
 
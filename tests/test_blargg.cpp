@@ -1,11 +1,12 @@
 #include "emulator.hpp"
 #include <gtest/gtest.h>
 
-class BlarggTest : public ::testing::Test
+class BlarggTest : public ::testing::TestWithParam<CPU::ExecutionMode>
 {
   protected:
     void SetUp() override
     {
+        emulator.getCPU().setExecutionMode(GetParam());
         serialTransferManager = std::make_unique<SerialTransferManager>(&emulator.getMMU());
     }
 
@@ -13,14 +14,14 @@ class BlarggTest : public ::testing::Test
     {
         std::string rom = std::string(DATADIR) + "/roms/blargg/" + romName;
         ASSERT_TRUE(emulator.getMMU().loadCartridgeFromFile(rom));
-        bool infiniteJRDetected = false;
-        while (!infiniteJRDetected)
+        // The serial output is read as it's sent, the end of the test is checked once per frame
+        auto shouldStop = [](Emulator::StopReason reason) {
+            return reason == Emulator::StopReason::SERIAL_BYTE || reason == Emulator::StopReason::FRAME_COMPLETE;
+        };
+        while (!isNextInstructionInfiniteJR())
         {
-
-            emulator.exec();
+            emulator.runUntil(shouldStop);
             readSerialOutput();
-
-            infiniteJRDetected = isNextInstructionInfiniteJR();
         }
 
         std::string failureKeyword = "Failed";
@@ -55,82 +56,97 @@ class BlarggTest : public ::testing::Test
     std::string output = "";
 };
 
-TEST_F(BlarggTest, TestForSpecialInstructionShouldBeSuccessful)
+TEST_P(BlarggTest, TestForSpecialInstructionShouldBeSuccessful)
 {
     assertTestForRomArePassing("01-special.gb");
 }
 
-TEST_F(BlarggTest, TestForInterruptsShouldBeSuccessful)
+TEST_P(BlarggTest, TestForInterruptsShouldBeSuccessful)
 {
     assertTestForRomArePassing("02-interrupts.gb");
 }
 
-TEST_F(BlarggTest, TestForOperationsSPHLShouldBeSuccessful)
+TEST_P(BlarggTest, TestForOperationsSPHLShouldBeSuccessful)
 {
     assertTestForRomArePassing("03-op sp,hl.gb");
 }
 
-TEST_F(BlarggTest, TestForOperationsRegisterImmediateShouldBeSuccessful)
+TEST_P(BlarggTest, TestForOperationsRegisterImmediateShouldBeSuccessful)
 {
     assertTestForRomArePassing("04-op r,imm.gb");
 }
 
-TEST_F(BlarggTest, TestForOperationsRPShouldBeSuccessful)
+TEST_P(BlarggTest, TestForOperationsRPShouldBeSuccessful)
 {
     assertTestForRomArePassing("05-op rp.gb");
 }
 
-TEST_F(BlarggTest, TestForLoadRRShouldBeSuccessful)
+TEST_P(BlarggTest, TestForLoadRRShouldBeSuccessful)
 {
     assertTestForRomArePassing("06-ld r,r.gb");
 }
 
-TEST_F(BlarggTest, TestForJumpRelativeJumpCallRetRstShouldBeSuccessful)
+TEST_P(BlarggTest, TestForJumpRelativeJumpCallRetRstShouldBeSuccessful)
 {
     assertTestForRomArePassing("07-jr,jp,call,ret,rst.gb");
 }
 
-TEST_F(BlarggTest, TestForMiscInstructionsShouldBeSuccessful)
+TEST_P(BlarggTest, TestForMiscInstructionsShouldBeSuccessful)
 {
     assertTestForRomArePassing("08-misc instrs.gb");
 }
 
-TEST_F(BlarggTest, TestForOperationsRRShouldBeSuccessful)
+TEST_P(BlarggTest, TestForOperationsRRShouldBeSuccessful)
 {
     assertTestForRomArePassing("09-op r,r.gb");
 }
 
-TEST_F(BlarggTest, TestForBitOperationsShouldBeSuccessful)
+TEST_P(BlarggTest, TestForBitOperationsShouldBeSuccessful)
 {
     assertTestForRomArePassing("10-bit ops.gb");
 }
 
-TEST_F(BlarggTest, TestForBitOperationsAHLShouldBeSuccessful)
+TEST_P(BlarggTest, TestForBitOperationsAHLShouldBeSuccessful)
 {
     assertTestForRomArePassing("11-op a,(hl).gb");
 }
 
-TEST_F(BlarggTest, TestForInstrTimingShouldBeSuccessful)
+TEST_P(BlarggTest, TestForInstrTimingShouldBeSuccessful)
 {
     assertTestForRomArePassing("instr_timing.gb");
 }
 
-TEST_F(BlarggTest, TestForSoundRegistersShouldBeSuccessful)
+TEST_P(BlarggTest, TestForSoundRegistersShouldBeSuccessful)
 {
     assertTestForRomArePassing("sound/01-registers.gb");
 }
 
-TEST_F(BlarggTest, TestForSoundLengthTimerShouldBeSuccessful)
+TEST_P(BlarggTest, TestForSoundLengthTimerShouldBeSuccessful)
 {
     assertTestForRomArePassing("sound/02-len ctr.gb");
 }
 
-TEST_F(BlarggTest, TestForSoundWavelengthSweepShouldBeSuccessful)
+TEST_P(BlarggTest, TestForSoundWavelengthSweepShouldBeSuccessful)
 {
     assertTestForRomArePassing("sound/04-sweep.gb");
 }
 
-TEST_F(BlarggTest, TestForSoundOverflowOnTriggerShouldBeSuccessful)
+TEST_P(BlarggTest, TestForSoundOverflowOnTriggerShouldBeSuccessful)
 {
     assertTestForRomArePassing("sound/06-overflow on trigger.gb");
-}
\ No newline at end of file
+}
+
+INSTANTIATE_TEST_SUITE_P(ExecutionModes, BlarggTest,
+                         ::testing::Values(CPU::ExecutionMode::INTERPRETER, CPU::ExecutionMode::CACHED_INTERPRETER,
+                                           CPU::ExecutionMode::JIT),
+                         [](const ::testing::TestParamInfo<CPU::ExecutionMode>& info) {
+                             switch (info.param)
+                             {
+                             case CPU::ExecutionMode::INTERPRETER:
+                                 return "Interpreter";
+                             case CPU::ExecutionMode::CACHED_INTERPRETER:
+                                 return "CachedInterpreter";
+                             default:
+                                 return "JIT";
+                             }
+                         });
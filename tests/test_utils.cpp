@@ -111,6 +111,14 @@ TEST(UtilsTest, TestBitForGivenValueShouldGivesExpectedResult)
     ASSERT_EQ(utils::isNthBitSet(value, 15), true);
 }
 
+TEST(UtilsTest, LowestSetBitPositionShouldIgnoreTheHigherBits)
+{
+    ASSERT_EQ(utils::getLowestSetBitPosition(0b1), 0);
+    ASSERT_EQ(utils::getLowestSetBitPosition(0b10110), 1);
+    ASSERT_EQ(utils::getLowestSetBitPosition(0b10000), 4);
+    ASSERT_EQ(utils::getLowestSetBitPosition(0x80000000), 31);
+}
+
 TEST(UtilsTest, AddressRangeShouldSetStartAndEndAddrCorrectly)
 {
     word startAddr = 0x1234;